@@ -52,6 +52,7 @@
 // and pairable_mask is either 0 if static, or set to all if non static
 
 #include "bvh_tree.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/mutex.h"
 
 #define BVHTREE_CLASS BVH_Tree<T, NUM_TREES, 2, MAX_ITEMS, USER_PAIR_TEST_FUNCTION, USER_CULL_TEST_FUNCTION, USE_PAIRS, BOUNDS, POINT>
@@ -205,6 +206,69 @@ public:
 		}
 	}
 
+	// Moves many items at once, such as all the bodies moved by a physics step.
+	// Items staying within their parent node are moved in place on the WorkerThreadPool and their
+	// leaves are refitted in parallel, the others are reinserted like with move().
+	// Pairing is done for the whole batch on the next update().
+	void move_batch(const BVHHandle *p_handles, const BOUNDS *p_aabbs, uint32_t p_count, int p_tasks = -1) {
+		BVH_LOCKED_FUNCTION
+		if (!p_count) {
+			return;
+		}
+
+		move_batch_handles = p_handles;
+		move_batch_aabbs = p_aabbs;
+		move_batch_results.resize(p_count);
+
+		if (p_count < MOVE_BATCH_MIN_PARALLEL_ITEMS) {
+			for (uint32_t n = 0; n < p_count; n++) {
+				_move_batch_item(n, nullptr);
+			}
+		} else {
+			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &BVH_Manager::_move_batch_item, nullptr, p_count, p_tasks, true, SNAME("BVHMoveBatch"));
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+		}
+
+		// Several items can share a leaf, each leaf is only refitted once.
+		move_batch_refit_nodes.clear();
+		for (uint32_t n = 0; n < p_count; n++) {
+			if (move_batch_results[n].refit_node_id != BVHCommon::INVALID) {
+				move_batch_refit_nodes.push_back(move_batch_results[n].refit_node_id);
+			}
+		}
+
+		if (move_batch_refit_nodes.size()) {
+			move_batch_refit_nodes.sort();
+			uint32_t unique_count = 1;
+			for (uint32_t n = 1; n < move_batch_refit_nodes.size(); n++) {
+				if (move_batch_refit_nodes[n] != move_batch_refit_nodes[unique_count - 1]) {
+					move_batch_refit_nodes[unique_count++] = move_batch_refit_nodes[n];
+				}
+			}
+			move_batch_refit_nodes.resize(unique_count);
+
+			if (unique_count < MOVE_BATCH_MIN_PARALLEL_NODES) {
+				for (uint32_t n = 0; n < unique_count; n++) {
+					_move_batch_refit_node(n, nullptr);
+				}
+			} else {
+				WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &BVH_Manager::_move_batch_refit_node, nullptr, unique_count, p_tasks, true, SNAME("BVHMoveBatchRefit"));
+				WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+			}
+		}
+
+		for (uint32_t n = 0; n < p_count; n++) {
+			const MoveBatchResult &result = move_batch_results[n];
+			bool changed = result.in_place ? result.changed : tree.item_move(p_handles[n], p_aabbs[n]);
+			if (USE_PAIRS && changed) {
+				_add_changed_item(p_handles[n], p_aabbs[n]);
+			}
+		}
+
+		move_batch_handles = nullptr;
+		move_batch_aabbs = nullptr;
+	}
+
 	void recheck_pairs(BVHHandle p_handle) {
 		DEV_ASSERT(!p_handle.is_invalid());
 		force_collision_check(p_handle);
@@ -428,6 +492,15 @@ public:
 	}
 
 private:
+	void _move_batch_item(uint32_t p_index, void *p_userdata) {
+		MoveBatchResult &result = move_batch_results[p_index];
+		result.in_place = tree.item_move_in_place(move_batch_handles[p_index], move_batch_aabbs[p_index], result.changed, result.refit_node_id);
+	}
+
+	void _move_batch_refit_node(uint32_t p_index, void *p_userdata) {
+		tree.node_update_aabb(tree._nodes[move_batch_refit_nodes[p_index]]);
+	}
+
 	// do this after moving etc.
 	void _check_for_collisions(bool p_full_check = false) {
 		if (!changed_items.size()) {
@@ -773,6 +846,23 @@ private:
 	LocalVector<BVHHandle, uint32_t, true> changed_items;
 	uint32_t _tick = 1; // Start from 1 so items with 0 indicate never updated.
 
+	// Smaller batches are processed on the calling thread.
+	enum {
+		MOVE_BATCH_MIN_PARALLEL_ITEMS = 512,
+		MOVE_BATCH_MIN_PARALLEL_NODES = 64,
+	};
+
+	struct MoveBatchResult {
+		bool in_place = false;
+		bool changed = false;
+		uint32_t refit_node_id = BVHCommon::INVALID;
+	};
+
+	const BVHHandle *move_batch_handles = nullptr;
+	const BOUNDS *move_batch_aabbs = nullptr;
+	LocalVector<MoveBatchResult> move_batch_results;
+	LocalVector<uint32_t> move_batch_refit_nodes;
+
 	class BVHLockedFunction {
 	public:
 		BVHLockedFunction(Mutex *p_mutex, bool p_thread_safe) {
@@ -254,6 +254,8 @@
 		cmd->instance = p_instance;                                          \
 		cmd->method = p_method;                                              \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                 \
+		if (push_semaphore)                                                  \
+			push_semaphore->post();                                          \
 		unlock();                                                            \
 		if (sync)                                                            \
 			sync->post();                                                    \
@@ -271,6 +273,8 @@
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                                   \
 		cmd->ret = r_ret;                                                                      \
 		cmd->sync_sem = ss;                                                                    \
+		if (push_semaphore)                                                                    \
+			push_semaphore->post();                                                            \
 		unlock();                                                                              \
 		if (sync)                                                                              \
 			sync->post();                                                                      \
@@ -289,6 +293,8 @@
 		cmd->method = p_method;                                                       \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                          \
 		cmd->sync_sem = ss;                                                           \
+		if (push_semaphore)                                                           \
+			push_semaphore->post();                                                   \
 		unlock();                                                                     \
 		if (sync)                                                                     \
 			sync->post();                                                             \
@@ -340,6 +346,7 @@ class CommandQueueMT {
 	SyncSemaphore sync_sems[SYNC_SEMAPHORES];
 	Mutex mutex;
 	Semaphore *sync = nullptr;
+	Semaphore *push_semaphore = nullptr;
 
 	template <class T>
 	T *allocate() {
@@ -408,6 +415,14 @@ public:
 		_flush();
 	}
 
+	// Posted with the queue locked on each push, so the thread flushing an unsynced queue can wait for commands
+	// instead of polling. Pass nullptr to stop, the semaphore isn't used anymore once this returns.
+	void set_push_semaphore(Semaphore *p_semaphore) {
+		lock();
+		push_semaphore = p_semaphore;
+		unlock();
+	}
+
 	void wait_and_flush() {
 		ERR_FAIL_COND(!sync);
 		sync->wait();
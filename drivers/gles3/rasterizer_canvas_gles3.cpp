@@ -1143,6 +1143,9 @@ void RasterizerCanvasGLES3::_record_item_commands(const Item *p_item, RID p_rend
 					if (GLES3::MeshStorage::get_singleton()->multimesh_uses_custom_data(mm->multimesh)) {
 						state.instance_data_array[r_index].flags |= FLAGS_INSTANCING_HAS_CUSTOM_DATA;
 					}
+					if (mm->sprite_batch) {
+						state.instance_data_array[r_index].flags |= FLAGS_INSTANCING_CUSTOM_IS_REGION;
+					}
 				} else if (c->type == Item::Command::TYPE_PARTICLES) {
 					GLES3::ParticlesStorage *particles_storage = GLES3::ParticlesStorage::get_singleton();
 					GLES3::TextureStorage *texture_storage = GLES3::TextureStorage::get_singleton();
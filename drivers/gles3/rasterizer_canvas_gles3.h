@@ -70,6 +70,8 @@ class RasterizerCanvasGLES3 : public RendererCanvasRender {
 		FLAGS_NINEPATCH_V_MODE_SHIFT = 18,
 		FLAGS_LIGHT_COUNT_SHIFT = 20,
 
+		FLAGS_INSTANCING_CUSTOM_IS_REGION = (1 << 24),
+
 		FLAGS_DEFAULT_NORMAL_MAP_USED = (1 << 26),
 		FLAGS_DEFAULT_SPECULAR_MAP_USED = (1 << 27),
 
@@ -169,6 +169,10 @@ void main() {
 	if (bool(read_draw_data_flags & FLAGS_INSTANCING_HAS_CUSTOM_DATA)) {
 		instance_custom = vec4(unpackHalf2x16(instance_color_custom_data.z), unpackHalf2x16(instance_color_custom_data.w));
 	}
+	if (bool(read_draw_data_flags & FLAGS_INSTANCING_CUSTOM_IS_REGION)) {
+		// Sprite batch, custom data is the source region in pixels.
+		uv = (instance_custom.xy + uv * instance_custom.zw) * read_draw_data_color_texture_pixel_size;
+	}
 #endif
 
 #else
@@ -21,6 +21,8 @@
 
 #define FLAGS_LIGHT_COUNT_SHIFT 20
 
+#define FLAGS_INSTANCING_CUSTOM_IS_REGION uint(1 << 24)
+
 #define FLAGS_DEFAULT_NORMAL_MAP_USED uint(1 << 26)
 #define FLAGS_DEFAULT_SPECULAR_MAP_USED uint(1 << 27)
 
@@ -295,6 +295,14 @@ void TextureStorage::canvas_texture_set_texture_repeat(RID p_canvas_texture, RS:
 	ct->texture_repeat = p_repeat;
 }
 
+RID TextureStorage::canvas_texture_get_diffuse(RID p_texture) {
+	CanvasTexture *ct = canvas_texture_owner.get_or_null(p_texture);
+	if (!ct) {
+		return p_texture;
+	}
+	return ct->diffuse;
+}
+
 /* Texture API */
 
 Ref<Image> TextureStorage::_get_gl_image_and_format(const Ref<Image> &p_image, Image::Format p_format, Image::Format &r_real_format, GLenum &r_gl_format, GLenum &r_gl_internal_format, GLenum &r_gl_type, bool &r_compressed, bool p_force_decompress) const {
@@ -482,6 +482,7 @@ public:
 
 	virtual void canvas_texture_set_texture_filter(RID p_item, RS::CanvasItemTextureFilter p_filter) override;
 	virtual void canvas_texture_set_texture_repeat(RID p_item, RS::CanvasItemTextureRepeat p_repeat) override;
+	virtual RID canvas_texture_get_diffuse(RID p_texture) override;
 
 	/* Texture API */
 
@@ -70,6 +70,9 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PHYSICS_2D_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(PHYSICS_2D_ISLAND_COUNT);
 	BIND_ENUM_CONSTANT(AUDIO_OUTPUT_LATENCY);
+	BIND_ENUM_CONSTANT(RENDER_TOTAL_CANVAS_ITEMS_IN_FRAME);
+	BIND_ENUM_CONSTANT(RENDER_TOTAL_CANVAS_BATCHES_IN_FRAME);
+	BIND_ENUM_CONSTANT(RENDER_TOTAL_CANVAS_SHADOW_UPDATES_SKIPPED_IN_FRAME);
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
 
@@ -105,6 +108,9 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"physics_2d/collision_pairs",
 		"physics_2d/islands",
 		"audio/driver/output_latency",
+		"raster/total_canvas_items_drawn",
+		"raster/total_canvas_batches",
+		"raster/total_canvas_shadow_updates_skipped",
 	};
 
 	return names[p_monitor];
@@ -146,6 +152,12 @@ double Performance::get_monitor(Monitor p_monitor) const {
 			return PhysicsServer2D::get_singleton()->get_process_info(PhysicsServer2D::INFO_ISLAND_COUNT);
 		case AUDIO_OUTPUT_LATENCY:
 			return AudioServer::get_singleton()->get_output_latency();
+		case RENDER_TOTAL_CANVAS_ITEMS_IN_FRAME:
+			return RS::get_singleton()->get_rendering_info(RS::RENDERING_INFO_TOTAL_CANVAS_ITEMS_IN_FRAME);
+		case RENDER_TOTAL_CANVAS_BATCHES_IN_FRAME:
+			return RS::get_singleton()->get_rendering_info(RS::RENDERING_INFO_TOTAL_CANVAS_BATCHES_IN_FRAME);
+		case RENDER_TOTAL_CANVAS_SHADOW_UPDATES_SKIPPED_IN_FRAME:
+			return RS::get_singleton()->get_rendering_info(RS::RENDERING_INFO_TOTAL_CANVAS_SHADOW_UPDATES_SKIPPED_IN_FRAME);
 		default: {
 		}
 	}
@@ -177,6 +189,9 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
 	};
 
 	return types[p_monitor];
@@ -86,6 +86,9 @@ public:
 		PHYSICS_2D_COLLISION_PAIRS,
 		PHYSICS_2D_ISLAND_COUNT,
 		AUDIO_OUTPUT_LATENCY,
+		RENDER_TOTAL_CANVAS_ITEMS_IN_FRAME,
+		RENDER_TOTAL_CANVAS_BATCHES_IN_FRAME,
+		RENDER_TOTAL_CANVAS_SHADOW_UPDATES_SKIPPED_IN_FRAME,
 		MONITOR_MAX
 	};
 
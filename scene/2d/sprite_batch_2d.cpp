@@ -0,0 +1,251 @@
+/**************************************************************************/
+/*  sprite_batch_2d.cpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "sprite_batch_2d.h"
+
+#include "core/core_string_names.h"
+
+void SpriteBatch2D::_notification(int p_what) {
+	switch (p_what) {
+		case NOTIFICATION_DRAW: {
+			if (texture.is_null() || transforms.is_empty()) {
+				return;
+			}
+
+			RS::get_singleton()->canvas_item_add_sprite_batch(get_canvas_item(), texture->get_rid(), transforms, regions, colors, centered);
+		} break;
+	}
+}
+
+void SpriteBatch2D::set_texture(const Ref<Texture2D> &p_texture) {
+	if (p_texture == texture) {
+		return;
+	}
+
+	if (texture.is_valid()) {
+		texture->disconnect(CoreStringNames::get_singleton()->changed, callable_mp(this, &SpriteBatch2D::_texture_changed));
+	}
+
+	texture = p_texture;
+
+	if (texture.is_valid()) {
+		texture->connect(CoreStringNames::get_singleton()->changed, callable_mp(this, &SpriteBatch2D::_texture_changed));
+	}
+
+	queue_redraw();
+}
+
+Ref<Texture2D> SpriteBatch2D::get_texture() const {
+	return texture;
+}
+
+void SpriteBatch2D::set_centered(bool p_center) {
+	centered = p_center;
+	queue_redraw();
+}
+
+bool SpriteBatch2D::is_centered() const {
+	return centered;
+}
+
+void SpriteBatch2D::set_instance_count(int p_count) {
+	ERR_FAIL_COND(p_count < 0);
+	int prev_count = get_instance_count();
+	if (p_count == prev_count) {
+		return;
+	}
+
+	transforms.resize(p_count * 6);
+	regions.resize(p_count * 4);
+	colors.resize(p_count);
+
+	float *t = transforms.ptrw();
+	float *r = regions.ptrw();
+	Color *c = colors.ptrw();
+	for (int i = prev_count; i < p_count; i++) {
+		t[i * 6 + 0] = 1;
+		t[i * 6 + 1] = 0;
+		t[i * 6 + 2] = 0;
+		t[i * 6 + 3] = 1;
+		t[i * 6 + 4] = 0;
+		t[i * 6 + 5] = 0;
+		for (int j = 0; j < 4; j++) {
+			r[i * 4 + j] = 0;
+		}
+		c[i] = Color(1, 1, 1);
+	}
+
+	queue_redraw();
+}
+
+int SpriteBatch2D::get_instance_count() const {
+	return transforms.size() / 6;
+}
+
+int SpriteBatch2D::add_instance(const Transform2D &p_transform, const Rect2 &p_region, const Color &p_color) {
+	int index = get_instance_count();
+	set_instance_count(index + 1);
+	set_instance_transform(index, p_transform);
+	set_instance_region(index, p_region);
+	set_instance_color(index, p_color);
+	return index;
+}
+
+void SpriteBatch2D::clear_instances() {
+	set_instance_count(0);
+}
+
+void SpriteBatch2D::set_instance_transform(int p_index, const Transform2D &p_transform) {
+	ERR_FAIL_INDEX(p_index, get_instance_count());
+	float *t = transforms.ptrw() + p_index * 6;
+	t[0] = p_transform.columns[0].x;
+	t[1] = p_transform.columns[0].y;
+	t[2] = p_transform.columns[1].x;
+	t[3] = p_transform.columns[1].y;
+	t[4] = p_transform.columns[2].x;
+	t[5] = p_transform.columns[2].y;
+	queue_redraw();
+}
+
+Transform2D SpriteBatch2D::get_instance_transform(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, get_instance_count(), Transform2D());
+	const float *t = transforms.ptr() + p_index * 6;
+	return Transform2D(t[0], t[1], t[2], t[3], t[4], t[5]);
+}
+
+void SpriteBatch2D::set_instance_region(int p_index, const Rect2 &p_region) {
+	ERR_FAIL_INDEX(p_index, get_instance_count());
+	float *r = regions.ptrw() + p_index * 4;
+	r[0] = p_region.position.x;
+	r[1] = p_region.position.y;
+	r[2] = p_region.size.x;
+	r[3] = p_region.size.y;
+	queue_redraw();
+}
+
+Rect2 SpriteBatch2D::get_instance_region(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, get_instance_count(), Rect2());
+	const float *r = regions.ptr() + p_index * 4;
+	return Rect2(r[0], r[1], r[2], r[3]);
+}
+
+void SpriteBatch2D::set_instance_color(int p_index, const Color &p_color) {
+	ERR_FAIL_INDEX(p_index, get_instance_count());
+	colors.write[p_index] = p_color;
+	queue_redraw();
+}
+
+Color SpriteBatch2D::get_instance_color(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, get_instance_count(), Color());
+	return colors[p_index];
+}
+
+void SpriteBatch2D::set_transforms(const Vector<float> &p_transforms) {
+	ERR_FAIL_COND_MSG(p_transforms.size() % 6 != 0, "Transforms must contain 6 floats per instance.");
+	// Resize first, so regions and colors of new instances get their defaults.
+	set_instance_count(p_transforms.size() / 6);
+	transforms = p_transforms;
+	queue_redraw();
+}
+
+Vector<float> SpriteBatch2D::get_transforms() const {
+	return transforms;
+}
+
+void SpriteBatch2D::set_regions(const Vector<float> &p_regions) {
+	ERR_FAIL_COND_MSG(p_regions.size() != get_instance_count() * 4, "Regions must contain 4 floats per instance.");
+	regions = p_regions;
+	queue_redraw();
+}
+
+Vector<float> SpriteBatch2D::get_regions() const {
+	return regions;
+}
+
+void SpriteBatch2D::set_colors(const Vector<Color> &p_colors) {
+	ERR_FAIL_COND_MSG(p_colors.size() != get_instance_count(), "Colors must contain one color per instance.");
+	colors = p_colors;
+	queue_redraw();
+}
+
+Vector<Color> SpriteBatch2D::get_colors() const {
+	return colors;
+}
+
+void SpriteBatch2D::_texture_changed() {
+	if (texture.is_valid()) {
+		queue_redraw();
+	}
+}
+
+void SpriteBatch2D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_texture", "texture"), &SpriteBatch2D::set_texture);
+	ClassDB::bind_method(D_METHOD("get_texture"), &SpriteBatch2D::get_texture);
+
+	ClassDB::bind_method(D_METHOD("set_centered", "centered"), &SpriteBatch2D::set_centered);
+	ClassDB::bind_method(D_METHOD("is_centered"), &SpriteBatch2D::is_centered);
+
+	ClassDB::bind_method(D_METHOD("set_instance_count", "count"), &SpriteBatch2D::set_instance_count);
+	ClassDB::bind_method(D_METHOD("get_instance_count"), &SpriteBatch2D::get_instance_count);
+
+	ClassDB::bind_method(D_METHOD("add_instance", "transform", "region", "color"), &SpriteBatch2D::add_instance, DEFVAL(Rect2()), DEFVAL(Color(1, 1, 1)));
+	ClassDB::bind_method(D_METHOD("clear_instances"), &SpriteBatch2D::clear_instances);
+
+	ClassDB::bind_method(D_METHOD("set_instance_transform", "index", "transform"), &SpriteBatch2D::set_instance_transform);
+	ClassDB::bind_method(D_METHOD("get_instance_transform", "index"), &SpriteBatch2D::get_instance_transform);
+
+	ClassDB::bind_method(D_METHOD("set_instance_region", "index", "region"), &SpriteBatch2D::set_instance_region);
+	ClassDB::bind_method(D_METHOD("get_instance_region", "index"), &SpriteBatch2D::get_instance_region);
+
+	ClassDB::bind_method(D_METHOD("set_instance_color", "index", "color"), &SpriteBatch2D::set_instance_color);
+	ClassDB::bind_method(D_METHOD("get_instance_color", "index"), &SpriteBatch2D::get_instance_color);
+
+	ClassDB::bind_method(D_METHOD("set_transforms", "transforms"), &SpriteBatch2D::set_transforms);
+	ClassDB::bind_method(D_METHOD("get_transforms"), &SpriteBatch2D::get_transforms);
+
+	ClassDB::bind_method(D_METHOD("set_regions", "regions"), &SpriteBatch2D::set_regions);
+	ClassDB::bind_method(D_METHOD("get_regions"), &SpriteBatch2D::get_regions);
+
+	ClassDB::bind_method(D_METHOD("set_colors", "colors"), &SpriteBatch2D::set_colors);
+	ClassDB::bind_method(D_METHOD("get_colors"), &SpriteBatch2D::get_colors);
+
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "texture", PROPERTY_HINT_RESOURCE_TYPE, "Texture2D"), "set_texture", "get_texture");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "centered"), "set_centered", "is_centered");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "instance_count", PROPERTY_HINT_RANGE, "0,16384,1,or_greater", PROPERTY_USAGE_EDITOR), "set_instance_count", "get_instance_count");
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_FLOAT32_ARRAY, "transforms", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "set_transforms", "get_transforms");
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_FLOAT32_ARRAY, "regions", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "set_regions", "get_regions");
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_COLOR_ARRAY, "colors", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "set_colors", "get_colors");
+}
+
+SpriteBatch2D::SpriteBatch2D() {
+}
+
+SpriteBatch2D::~SpriteBatch2D() {
+}
@@ -0,0 +1,91 @@
+/**************************************************************************/
+/*  sprite_batch_2d.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SPRITE_BATCH_2D_H
+#define SPRITE_BATCH_2D_H
+
+#include "scene/2d/node_2d.h"
+#include "scene/resources/texture.h"
+
+class SpriteBatch2D : public Node2D {
+	GDCLASS(SpriteBatch2D, Node2D);
+
+	Ref<Texture2D> texture;
+	bool centered = true;
+
+	// Packed the way RenderingServer::canvas_item_add_sprite_batch() takes them:
+	// 6 floats per transform, 4 per region and one color per instance.
+	Vector<float> transforms;
+	Vector<float> regions;
+	Vector<Color> colors;
+
+	void _texture_changed();
+
+protected:
+	void _notification(int p_what);
+
+	static void _bind_methods();
+
+public:
+	void set_texture(const Ref<Texture2D> &p_texture);
+	Ref<Texture2D> get_texture() const;
+
+	void set_centered(bool p_center);
+	bool is_centered() const;
+
+	void set_instance_count(int p_count);
+	int get_instance_count() const;
+
+	int add_instance(const Transform2D &p_transform, const Rect2 &p_region = Rect2(), const Color &p_color = Color(1, 1, 1));
+	void clear_instances();
+
+	void set_instance_transform(int p_index, const Transform2D &p_transform);
+	Transform2D get_instance_transform(int p_index) const;
+
+	void set_instance_region(int p_index, const Rect2 &p_region);
+	Rect2 get_instance_region(int p_index) const;
+
+	void set_instance_color(int p_index, const Color &p_color);
+	Color get_instance_color(int p_index) const;
+
+	void set_transforms(const Vector<float> &p_transforms);
+	Vector<float> get_transforms() const;
+
+	void set_regions(const Vector<float> &p_regions);
+	Vector<float> get_regions() const;
+
+	void set_colors(const Vector<Color> &p_colors);
+	Vector<Color> get_colors() const;
+
+	SpriteBatch2D();
+	~SpriteBatch2D();
+};
+
+#endif // SPRITE_BATCH_2D_H
@@ -31,6 +31,8 @@
 #include "tile_map.h"
 
 #include "core/io/marshalls.h"
+#include "core/math/geometry_2d.h"
+#include "core/object/worker_thread_pool.h"
 #include "scene/resources/world_2d.h"
 
 HashMap<Vector2i, TileSet::CellNeighbor> TileMap::TerrainConstraint::get_overlapping_coords_and_peering_bits() const {
@@ -751,6 +753,29 @@ bool TileMap::is_collision_animatable() const {
 	return collision_animatable;
 }
 
+void TileMap::set_collision_merged(bool p_enabled) {
+	if (collision_merged == p_enabled) {
+		return;
+	}
+	collision_merged = p_enabled;
+	_clear_internals();
+	_recreate_internals();
+	emit_signal(SNAME("changed"));
+}
+
+bool TileMap::is_collision_merged() const {
+	return collision_merged;
+}
+
+void TileMap::set_update_cells_per_frame(int p_cells) {
+	ERR_FAIL_COND(p_cells < 0);
+	update_cells_per_frame = p_cells;
+}
+
+int TileMap::get_update_cells_per_frame() const {
+	return update_cells_per_frame;
+}
+
 void TileMap::set_collision_visibility_mode(TileMap::VisibilityMode p_show_collision) {
 	if (collision_visibility_mode == p_show_collision) {
 		return;
@@ -846,18 +871,39 @@ void TileMap::_update_dirty_quadrants() {
 		return;
 	}
 
+	last_update_threaded_quadrants = 0;
+	// Without a budget, every dirty quadrant is updated right away.
+	int cell_budget = update_cells_per_frame > 0 ? update_cells_per_frame : INT32_MAX;
+	bool has_remaining_quadrants = false;
+
 	for (unsigned int layer = 0; layer < layers.size(); layer++) {
-		SelfList<TileMapQuadrant>::List &dirty_quadrant_list = layers[layer].dirty_quadrant_list;
+		// Take the quadrants updated this frame out of the dirty list, the others wait for the next frames.
+		SelfList<TileMapQuadrant>::List dirty_quadrant_list;
+		LocalVector<TileMapQuadrant *> dirty_quadrants;
+		while (layers[layer].dirty_quadrant_list.first() && cell_budget > 0) {
+			TileMapQuadrant *q = layers[layer].dirty_quadrant_list.first()->self();
+			cell_budget -= MAX(1, q->cells.size());
+			layers[layer].dirty_quadrant_list.remove(&q->dirty_list_element);
+			dirty_quadrant_list.add_last(&q->dirty_list_element);
+			dirty_quadrants.push_back(q);
+		}
+		if (layers[layer].dirty_quadrant_list.first()) {
+			has_remaining_quadrants = true;
+		}
+		if (dirty_quadrants.is_empty()) {
+			continue;
+		}
 
-		// Update the coords cache.
-		for (SelfList<TileMapQuadrant> *q = dirty_quadrant_list.first(); q; q = q->next()) {
-			q->self()->map_to_local.clear();
-			q->self()->local_to_map.clear();
-			for (const Vector2i &E : q->self()->cells) {
-				Vector2i pk = E;
-				Vector2 pk_local_coords = map_to_local(pk);
-				q->self()->map_to_local[pk] = pk_local_coords;
-				q->self()->local_to_map[pk_local_coords] = pk;
+		// Update the coords cache and resolve the cells. This only reads the TileMap and the TileSet, so
+		// quadrants can be processed in parallel. The results are applied below, on this thread.
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		if (dirty_quadrants.size() >= THREADED_UPDATE_MIN_QUADRANTS && pool->get_thread_count() > 1) {
+			WorkerThreadPool::GroupID group_task = pool->add_template_group_task(this, &TileMap::_update_quadrant_cells_threaded, dirty_quadrants.ptr(), dirty_quadrants.size(), -1, true, SNAME("TileMapQuadrantCells"));
+			pool->wait_for_group_task_completion(group_task);
+			last_update_threaded_quadrants += dirty_quadrants.size();
+		} else {
+			for (TileMapQuadrant *q : dirty_quadrants) {
+				_update_quadrant_cells(q);
 			}
 		}
 
@@ -888,14 +934,71 @@ void TileMap::_update_dirty_quadrants() {
 			for (const KeyValue<Vector2i, TileData *> &kv : dirty_quadrant_list.first()->self()->runtime_tile_data_cache) {
 				memdelete(kv.value);
 			}
+			dirty_quadrant_list.first()->self()->resolved_cells.reset();
+			dirty_quadrant_list.first()->self()->resolved_cells_by_coords.reset();
 
 			dirty_quadrant_list.remove(dirty_quadrant_list.first());
 		}
 	}
 
-	pending_update = false;
-
 	_recompute_rect_cache();
+
+	if (has_remaining_quadrants) {
+		// Deferred calls queued while flushing run in the same flush, so wait for the next frame instead.
+		Callable update_callable = callable_mp(this, &TileMap::_update_dirty_quadrants);
+		if (!get_tree()->is_connected(SNAME("process_frame"), update_callable)) {
+			get_tree()->connect(SNAME("process_frame"), update_callable, CONNECT_ONE_SHOT);
+		}
+	} else {
+		pending_update = false;
+	}
+}
+
+void TileMap::_update_quadrant_cells(TileMapQuadrant *p_quadrant) const {
+	// Sort the cells by local position, as it is needed by rendering.
+	p_quadrant->map_to_local.clear();
+	p_quadrant->local_to_map.clear();
+	for (const Vector2i &E : p_quadrant->cells) {
+		Vector2 local_coords = map_to_local(E);
+		p_quadrant->map_to_local[E] = local_coords;
+		p_quadrant->local_to_map[local_coords] = E;
+	}
+
+	// Resolve the atlas tiles, so the rendering and physics updates don't have to look them up again.
+	p_quadrant->resolved_cells.clear();
+	for (const KeyValue<Vector2, Vector2i> &E_cell : p_quadrant->local_to_map) {
+		TileMapCell c = get_cell(p_quadrant->layer, E_cell.value, true);
+		if (!tile_set->has_source(c.source_id)) {
+			continue;
+		}
+
+		TileSetSource *source = *tile_set->get_source(c.source_id);
+		if (!source->has_tile(c.get_atlas_coords()) || !source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
+			continue;
+		}
+
+		TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(source);
+		if (atlas_source) {
+			TileMapQuadrant::ResolvedCell resolved;
+			resolved.local_position = E_cell.key;
+			resolved.coords = E_cell.value;
+			resolved.cell = c;
+			resolved.tile_data = atlas_source->get_tile_data(c.get_atlas_coords(), c.alternative_tile);
+			p_quadrant->resolved_cells.push_back(resolved);
+		}
+	}
+
+	p_quadrant->resolved_cells_by_coords.resize(p_quadrant->resolved_cells.size());
+	for (uint32_t i = 0; i < p_quadrant->resolved_cells.size(); i++) {
+		p_quadrant->resolved_cells_by_coords[i] = i;
+	}
+	SortArray<uint32_t, TileMapQuadrant::ResolvedCellCoordsComparator> sorter;
+	sorter.compare.resolved_cells = p_quadrant->resolved_cells.ptr();
+	sorter.sort(p_quadrant->resolved_cells_by_coords.ptr(), p_quadrant->resolved_cells_by_coords.size());
+}
+
+void TileMap::_update_quadrant_cells_threaded(uint32_t p_index, TileMapQuadrant **p_quadrants) {
+	_update_quadrant_cells(p_quadrants[p_index]);
 }
 
 void TileMap::_recreate_layer_internals(int p_layer) {
@@ -948,10 +1051,8 @@ void TileMap::_erase_quadrant(HashMap<Vector2i, TileMapQuadrant>::Iterator Q) {
 		_scenes_cleanup_quadrant(q);
 	}
 
-	// Remove the quadrant from the dirty_list if it is there.
-	if (q->dirty_list_element.in_list()) {
-		layers[q->layer].dirty_quadrant_list.remove(&(q->dirty_list_element));
-	}
+	// Remove the quadrant from the dirty_list if it is there, or from the list being updated.
+	q->dirty_list_element.remove_from_list();
 
 	// Free the debug canvas item.
 	RenderingServer *rs = RenderingServer::get_singleton();
@@ -1173,91 +1274,81 @@ void TileMap::_rendering_update_dirty_quadrants(SelfList<TileMapQuadrant>::List
 		int prev_z_index = 0;
 		RID prev_ci;
 
-		// Iterate over the cells of the quadrant.
-		for (const KeyValue<Vector2, Vector2i> &E_cell : q.local_to_map) {
-			TileMapCell c = get_cell(q.layer, E_cell.value, true);
-
-			TileSetSource *source;
-			if (tile_set->has_source(c.source_id)) {
-				source = *tile_set->get_source(c.source_id);
+		// Iterate over the resolved cells of the quadrant, sorted by local position.
+		for (const TileMapQuadrant::ResolvedCell &E_cell : q.resolved_cells) {
+			const TileMapCell &c = E_cell.cell;
 
-				if (!source->has_tile(c.get_atlas_coords()) || !source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
-					continue;
-				}
-
-				TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(source);
-				if (atlas_source) {
-					// Get the tile data.
-					const TileData *tile_data;
-					if (q.runtime_tile_data_cache.has(E_cell.value)) {
-						tile_data = q.runtime_tile_data_cache[E_cell.value];
-					} else {
-						tile_data = atlas_source->get_tile_data(c.get_atlas_coords(), c.alternative_tile);
-					}
+			// Get the tile data.
+			const TileData *tile_data;
+			if (q.runtime_tile_data_cache.has(E_cell.coords)) {
+				tile_data = q.runtime_tile_data_cache[E_cell.coords];
+			} else {
+				tile_data = E_cell.tile_data;
+			}
 
-					Ref<Material> mat = tile_data->get_material();
-					int tile_z_index = tile_data->get_z_index();
+			Ref<Material> mat = tile_data->get_material();
+			int tile_z_index = tile_data->get_z_index();
 
-					// Quandrant pos.
-					Vector2 tile_position = map_to_local(q.coords * get_effective_quadrant_size(q.layer));
-					if (is_y_sort_enabled() && layers[q.layer].y_sort_enabled) {
-						// When Y-sorting, the quandrant size is sure to be 1, we can thus offset the CanvasItem.
-						tile_position.y += layers[q.layer].y_sort_origin + tile_data->get_y_sort_origin();
-					}
+			// Quandrant pos.
+			Vector2 tile_position = map_to_local(q.coords * get_effective_quadrant_size(q.layer));
+			if (is_y_sort_enabled() && layers[q.layer].y_sort_enabled) {
+				// When Y-sorting, the quandrant size is sure to be 1, we can thus offset the CanvasItem.
+				tile_position.y += layers[q.layer].y_sort_origin + tile_data->get_y_sort_origin();
+			}
 
-					// --- CanvasItems ---
-					// Create two canvas items, for rendering and debug.
-					RID ci;
+			// --- CanvasItems ---
+			// Create two canvas items, for rendering and debug.
+			RID ci;
 
-					// Check if the material or the z_index changed.
-					if (prev_ci == RID() || prev_material != mat || prev_z_index != tile_z_index) {
-						// If so, create a new CanvasItem.
-						ci = rs->canvas_item_create();
-						if (mat.is_valid()) {
-							rs->canvas_item_set_material(ci, mat->get_rid());
-						}
-						rs->canvas_item_set_parent(ci, layers[q.layer].canvas_item);
-						rs->canvas_item_set_use_parent_material(ci, get_use_parent_material() || get_material().is_valid());
+			// Check if the material or the z_index changed.
+			if (prev_ci == RID() || prev_material != mat || prev_z_index != tile_z_index) {
+				// If so, create a new CanvasItem.
+				ci = rs->canvas_item_create();
+				if (mat.is_valid()) {
+					rs->canvas_item_set_material(ci, mat->get_rid());
+				}
+				rs->canvas_item_set_parent(ci, layers[q.layer].canvas_item);
+				rs->canvas_item_set_use_parent_material(ci, get_use_parent_material() || get_material().is_valid());
+				// Quadrants are leaves that only move with the TileMap, let culling skip the ones off screen.
+				rs->canvas_item_set_static(ci, true);
 
-						Transform2D xform;
-						xform.set_origin(tile_position);
-						rs->canvas_item_set_transform(ci, xform);
+				Transform2D xform;
+				xform.set_origin(tile_position);
+				rs->canvas_item_set_transform(ci, xform);
 
-						rs->canvas_item_set_light_mask(ci, get_light_mask());
-						rs->canvas_item_set_z_as_relative_to_parent(ci, true);
-						rs->canvas_item_set_z_index(ci, tile_z_index);
+				rs->canvas_item_set_light_mask(ci, get_light_mask());
+				rs->canvas_item_set_z_as_relative_to_parent(ci, true);
+				rs->canvas_item_set_z_index(ci, tile_z_index);
 
-						rs->canvas_item_set_default_texture_filter(ci, RS::CanvasItemTextureFilter(get_texture_filter_in_tree()));
-						rs->canvas_item_set_default_texture_repeat(ci, RS::CanvasItemTextureRepeat(get_texture_repeat_in_tree()));
+				rs->canvas_item_set_default_texture_filter(ci, RS::CanvasItemTextureFilter(get_texture_filter_in_tree()));
+				rs->canvas_item_set_default_texture_repeat(ci, RS::CanvasItemTextureRepeat(get_texture_repeat_in_tree()));
 
-						q.canvas_items.push_back(ci);
+				q.canvas_items.push_back(ci);
 
-						prev_ci = ci;
-						prev_material = mat;
-						prev_z_index = tile_z_index;
+				prev_ci = ci;
+				prev_material = mat;
+				prev_z_index = tile_z_index;
 
-					} else {
-						// Keep the same canvas_item to draw on.
-						ci = prev_ci;
-					}
-
-					// Drawing the tile in the canvas item.
-					draw_tile(ci, E_cell.key - tile_position, tile_set, c.source_id, c.get_atlas_coords(), c.alternative_tile, -1, get_self_modulate(), tile_data);
+			} else {
+				// Keep the same canvas_item to draw on.
+				ci = prev_ci;
+			}
 
-					// --- Occluders ---
-					for (int i = 0; i < tile_set->get_occlusion_layers_count(); i++) {
-						Transform2D xform;
-						xform.set_origin(E_cell.key);
-						if (tile_data->get_occluder(i).is_valid()) {
-							RID occluder_id = rs->canvas_light_occluder_create();
-							rs->canvas_light_occluder_set_enabled(occluder_id, node_visible);
-							rs->canvas_light_occluder_set_transform(occluder_id, get_global_transform() * xform);
-							rs->canvas_light_occluder_set_polygon(occluder_id, tile_data->get_occluder(i)->get_rid());
-							rs->canvas_light_occluder_attach_to_canvas(occluder_id, get_canvas());
-							rs->canvas_light_occluder_set_light_mask(occluder_id, tile_set->get_occlusion_layer_light_mask(i));
-							q.occluders[E_cell.value] = occluder_id;
-						}
-					}
+			// Drawing the tile in the canvas item.
+			draw_tile(ci, E_cell.local_position - tile_position, tile_set, c.source_id, c.get_atlas_coords(), c.alternative_tile, -1, get_self_modulate(), tile_data);
+
+			// --- Occluders ---
+			for (int i = 0; i < tile_set->get_occlusion_layers_count(); i++) {
+				Transform2D xform;
+				xform.set_origin(E_cell.local_position);
+				if (tile_data->get_occluder(i).is_valid()) {
+					RID occluder_id = rs->canvas_light_occluder_create();
+					rs->canvas_light_occluder_set_enabled(occluder_id, node_visible);
+					rs->canvas_light_occluder_set_transform(occluder_id, get_global_transform() * xform);
+					rs->canvas_light_occluder_set_polygon(occluder_id, tile_data->get_occluder(i)->get_rid());
+					rs->canvas_light_occluder_attach_to_canvas(occluder_id, get_canvas());
+					rs->canvas_light_occluder_set_light_mask(occluder_id, tile_set->get_occlusion_layer_light_mask(i));
+					q.occluders[E_cell.coords] = occluder_id;
 				}
 			}
 		}
@@ -1522,6 +1613,24 @@ void TileMap::_physics_update_dirty_quadrants(SelfList<TileMapQuadrant>::List &r
 	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
 	RID space = get_world_2d()->get_space();
 
+	// Merge the collision polygons of each quadrant first. This only reads the quadrants and the TileSet.
+	if (collision_merged) {
+		LocalVector<TileMapQuadrant *> dirty_quadrants;
+		for (SelfList<TileMapQuadrant> *q = r_dirty_quadrant_list.first(); q; q = q->next()) {
+			dirty_quadrants.push_back(q->self());
+		}
+
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		if (dirty_quadrants.size() >= THREADED_UPDATE_MIN_QUADRANTS && pool->get_thread_count() > 1) {
+			WorkerThreadPool::GroupID group_task = pool->add_template_group_task(this, &TileMap::_physics_merge_quadrant_collisions_threaded, dirty_quadrants.ptr(), dirty_quadrants.size(), -1, true, SNAME("TileMapMergeCollisions"));
+			pool->wait_for_group_task_completion(group_task);
+		} else {
+			for (TileMapQuadrant *q : dirty_quadrants) {
+				_physics_merge_quadrant_collisions(q);
+			}
+		}
+	}
+
 	SelfList<TileMapQuadrant> *q_list_element = r_dirty_quadrant_list.first();
 	while (q_list_element) {
 		TileMapQuadrant &q = *q_list_element->self();
@@ -1532,86 +1641,288 @@ void TileMap::_physics_update_dirty_quadrants(SelfList<TileMapQuadrant>::List &r
 			ps->free(body);
 		}
 		q.bodies.clear();
+		for (const RID &shape : q.merged_collision_shapes) {
+			ps->free(shape);
+		}
+		q.merged_collision_shapes.clear();
+
+		// Recreate bodies and shapes, in the order of the quadrant cells.
+		for (uint32_t index : q.resolved_cells_by_coords) {
+			const TileMapQuadrant::ResolvedCell &E_cell = q.resolved_cells[index];
+			const TileData *tile_data;
+			if (q.runtime_tile_data_cache.has(E_cell.coords)) {
+				tile_data = q.runtime_tile_data_cache[E_cell.coords];
+			} else {
+				tile_data = E_cell.tile_data;
+			}
 
-		// Recreate bodies and shapes.
-		for (const Vector2i &E_cell : q.cells) {
-			TileMapCell c = get_cell(q.layer, E_cell, true);
+			for (int tile_set_physics_layer = 0; tile_set_physics_layer < tile_set->get_physics_layers_count(); tile_set_physics_layer++) {
+				if (collision_merged && _physics_is_tile_collision_mergeable(tile_data, tile_set_physics_layer)) {
+					// Part of the quadrant's merged body.
+					continue;
+				}
 
-			TileSetSource *source;
-			if (tile_set->has_source(c.source_id)) {
-				source = *tile_set->get_source(c.source_id);
+				// Create the body.
+				RID body = _physics_create_body(&q, tile_set_physics_layer, E_cell.coords, E_cell.local_position, gl_transform, space);
+				ps->body_set_state(body, PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY, tile_data->get_constant_linear_velocity(tile_set_physics_layer));
+				ps->body_set_state(body, PhysicsServer2D::BODY_STATE_ANGULAR_VELOCITY, tile_data->get_constant_angular_velocity(tile_set_physics_layer));
+
+				// Add the shapes to the body.
+				int body_shape_index = 0;
+				for (int polygon_index = 0; polygon_index < tile_data->get_collision_polygons_count(tile_set_physics_layer); polygon_index++) {
+					// Iterate over the polygons.
+					bool one_way_collision = tile_data->is_collision_polygon_one_way(tile_set_physics_layer, polygon_index);
+					float one_way_collision_margin = tile_data->get_collision_polygon_one_way_margin(tile_set_physics_layer, polygon_index);
+					int shapes_count = tile_data->get_collision_polygon_shapes_count(tile_set_physics_layer, polygon_index);
+					for (int shape_index = 0; shape_index < shapes_count; shape_index++) {
+						// Add decomposed convex shapes.
+						Ref<ConvexPolygonShape2D> shape = tile_data->get_collision_polygon_shape(tile_set_physics_layer, polygon_index, shape_index);
+						ps->body_add_shape(body, shape->get_rid());
+						ps->body_set_shape_as_one_way_collision(body, body_shape_index, one_way_collision, one_way_collision_margin);
+
+						body_shape_index++;
+					}
+				}
+			}
+		}
 
-				if (!source->has_tile(c.get_atlas_coords()) || !source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
+		// Create one body per physics layer for the merged shapes, placed at the quadrant's first cell.
+		if (collision_merged) {
+			Vector2i quadrant_origin = q.coords * get_effective_quadrant_size(q.layer);
+			for (uint32_t tile_set_physics_layer = 0; tile_set_physics_layer < q.merged_collision_polygons.size(); tile_set_physics_layer++) {
+				const LocalVector<Vector<Vector2>> &polygons = q.merged_collision_polygons[tile_set_physics_layer];
+				if (polygons.is_empty()) {
 					continue;
 				}
 
-				TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(source);
-				if (atlas_source) {
-					const TileData *tile_data;
-					if (q.runtime_tile_data_cache.has(E_cell)) {
-						tile_data = q.runtime_tile_data_cache[E_cell];
-					} else {
-						tile_data = atlas_source->get_tile_data(c.get_atlas_coords(), c.alternative_tile);
+				RID body = _physics_create_body(&q, tile_set_physics_layer, quadrant_origin, map_to_local(quadrant_origin), gl_transform, space);
+				for (const Vector<Vector2> &polygon : polygons) {
+					RID shape = ps->convex_polygon_shape_create();
+					ps->shape_set_data(shape, polygon);
+					ps->body_add_shape(body, shape);
+					q.merged_collision_shapes.push_back(shape);
+				}
+			}
+			q.merged_collision_polygons.reset();
+		}
+
+		q_list_element = q_list_element->next();
+	}
+}
+
+RID TileMap::_physics_create_body(TileMapQuadrant *p_quadrant, int p_tile_set_physics_layer, const Vector2i &p_coords, const Vector2 &p_local_position, const Transform2D &p_gl_transform, RID p_space) {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+
+	Ref<PhysicsMaterial> physics_material = tile_set->get_physics_layer_physics_material(p_tile_set_physics_layer);
+	uint32_t physics_layer = tile_set->get_physics_layer_collision_layer(p_tile_set_physics_layer);
+	uint32_t physics_mask = tile_set->get_physics_layer_collision_mask(p_tile_set_physics_layer);
+
+	RID body = ps->body_create();
+	bodies_coords[body] = p_coords;
+	bodies_layers[body] = p_quadrant->layer;
+	ps->body_set_mode(body, collision_animatable ? PhysicsServer2D::BODY_MODE_KINEMATIC : PhysicsServer2D::BODY_MODE_STATIC);
+	ps->body_set_space(body, p_space);
+
+	Transform2D xform;
+	xform.set_origin(p_local_position);
+	xform = p_gl_transform * xform;
+	ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, xform);
+
+	ps->body_attach_object_instance_id(body, get_instance_id());
+	ps->body_set_collision_layer(body, physics_layer);
+	ps->body_set_collision_mask(body, physics_mask);
+	ps->body_set_pickable(body, false);
+
+	if (!physics_material.is_valid()) {
+		ps->body_set_param(body, PhysicsServer2D::BODY_PARAM_BOUNCE, 0);
+		ps->body_set_param(body, PhysicsServer2D::BODY_PARAM_FRICTION, 1);
+	} else {
+		ps->body_set_param(body, PhysicsServer2D::BODY_PARAM_BOUNCE, physics_material->computed_bounce());
+		ps->body_set_param(body, PhysicsServer2D::BODY_PARAM_FRICTION, physics_material->computed_friction());
+	}
+
+	p_quadrant->bodies.push_back(body);
+	return body;
+}
+
+bool TileMap::_physics_is_tile_collision_mergeable(const TileData *p_tile_data, int p_tile_set_physics_layer) const {
+	// Moving and one-way collisions need their own body.
+	if (p_tile_data->get_constant_linear_velocity(p_tile_set_physics_layer) != Vector2() || p_tile_data->get_constant_angular_velocity(p_tile_set_physics_layer) != 0.0) {
+		return false;
+	}
+	for (int polygon_index = 0; polygon_index < p_tile_data->get_collision_polygons_count(p_tile_set_physics_layer); polygon_index++) {
+		if (p_tile_data->is_collision_polygon_one_way(p_tile_set_physics_layer, polygon_index)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void TileMap::_physics_merge_quadrant_collisions(TileMapQuadrant *p_quadrant) const {
+	int physics_layers_count = tile_set->get_physics_layers_count();
+	p_quadrant->merged_collision_polygons.clear();
+	p_quadrant->merged_collision_polygons.resize(physics_layers_count);
+
+	// Polygons are expressed relative to the quadrant's first cell, where the merged body is placed.
+	int quadrant_size = get_effective_quadrant_size(p_quadrant->layer);
+	Vector2i quadrant_origin = p_quadrant->coords * quadrant_size;
+	Vector2 quadrant_origin_local = map_to_local(quadrant_origin);
+	Vector2 tile_size = tile_set->get_tile_size();
+	Rect2 full_tile_rect(-tile_size / 2, tile_size);
+
+	// Tiles fully covered by a single square polygon are merged into rectangles, which only works on square grids.
+	bool merge_rectangles = tile_set->get_tile_shape() == TileSet::TILE_SHAPE_SQUARE;
+	LocalVector<uint8_t> full_cells;
+
+	for (int tile_set_physics_layer = 0; tile_set_physics_layer < physics_layers_count; tile_set_physics_layer++) {
+		LocalVector<Vector<Vector2>> &merged = p_quadrant->merged_collision_polygons[tile_set_physics_layer];
+		LocalVector<Vector<Vector2>> polygons;
+
+		if (merge_rectangles) {
+			full_cells.resize(quadrant_size * quadrant_size);
+			memset(full_cells.ptr(), 0, full_cells.size());
+		}
+
+		for (const TileMapQuadrant::ResolvedCell &E_cell : p_quadrant->resolved_cells) {
+			const TileData *tile_data = E_cell.tile_data;
+			TileData *const *runtime_tile_data = p_quadrant->runtime_tile_data_cache.getptr(E_cell.coords);
+			if (runtime_tile_data) {
+				tile_data = *runtime_tile_data;
+			}
+			if (!_physics_is_tile_collision_mergeable(tile_data, tile_set_physics_layer)) {
+				continue;
+			}
+
+			int polygons_count = tile_data->get_collision_polygons_count(tile_set_physics_layer);
+			if (merge_rectangles && polygons_count == 1) {
+				Vector<Vector2> points = tile_data->get_collision_polygon_points(tile_set_physics_layer, 0);
+				if (points.size() == 4) {
+					Rect2 bounds(points[0], Size2());
+					for (const Vector2 &point : points) {
+						bounds.expand_to(point);
+					}
+					real_t area = 0.0;
+					for (int i = 0; i < 4; i++) {
+						area += points[i].cross(points[(i + 1) % 4]);
 					}
-					for (int tile_set_physics_layer = 0; tile_set_physics_layer < tile_set->get_physics_layers_count(); tile_set_physics_layer++) {
-						Ref<PhysicsMaterial> physics_material = tile_set->get_physics_layer_physics_material(tile_set_physics_layer);
-						uint32_t physics_layer = tile_set->get_physics_layer_collision_layer(tile_set_physics_layer);
-						uint32_t physics_mask = tile_set->get_physics_layer_collision_mask(tile_set_physics_layer);
-
-						// Create the body.
-						RID body = ps->body_create();
-						bodies_coords[body] = E_cell;
-						bodies_layers[body] = q.layer;
-						ps->body_set_mode(body, collision_animatable ? PhysicsServer2D::BODY_MODE_KINEMATIC : PhysicsServer2D::BODY_MODE_STATIC);
-						ps->body_set_space(body, space);
+					if (bounds.is_equal_approx(full_tile_rect) && Math::is_equal_approx(ABS(area) * (real_t)0.5, full_tile_rect.get_area())) {
+						Vector2i grid_coords = E_cell.coords - quadrant_origin;
+						full_cells[grid_coords.y * quadrant_size + grid_coords.x] = 1;
+						continue;
+					}
+				}
+			}
 
-						Transform2D xform;
-						xform.set_origin(map_to_local(E_cell));
-						xform = gl_transform * xform;
-						ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, xform);
-
-						ps->body_attach_object_instance_id(body, get_instance_id());
-						ps->body_set_collision_layer(body, physics_layer);
-						ps->body_set_collision_mask(body, physics_mask);
-						ps->body_set_pickable(body, false);
-						ps->body_set_state(body, PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY, tile_data->get_constant_linear_velocity(tile_set_physics_layer));
-						ps->body_set_state(body, PhysicsServer2D::BODY_STATE_ANGULAR_VELOCITY, tile_data->get_constant_angular_velocity(tile_set_physics_layer));
-
-						if (!physics_material.is_valid()) {
-							ps->body_set_param(body, PhysicsServer2D::BODY_PARAM_BOUNCE, 0);
-							ps->body_set_param(body, PhysicsServer2D::BODY_PARAM_FRICTION, 1);
-						} else {
-							ps->body_set_param(body, PhysicsServer2D::BODY_PARAM_BOUNCE, physics_material->computed_bounce());
-							ps->body_set_param(body, PhysicsServer2D::BODY_PARAM_FRICTION, physics_material->computed_friction());
-						}
+			Vector2 offset = E_cell.local_position - quadrant_origin_local;
+			for (int polygon_index = 0; polygon_index < polygons_count; polygon_index++) {
+				Vector<Vector2> polygon = tile_data->get_collision_polygon_points(tile_set_physics_layer, polygon_index);
+				if (polygon.size() < 3) {
+					continue;
+				}
+				for (Vector2 &point : polygon) {
+					point += offset;
+				}
+				polygons.push_back(polygon);
+			}
+		}
 
-						q.bodies.push_back(body);
-
-						// Add the shapes to the body.
-						int body_shape_index = 0;
-						for (int polygon_index = 0; polygon_index < tile_data->get_collision_polygons_count(tile_set_physics_layer); polygon_index++) {
-							// Iterate over the polygons.
-							bool one_way_collision = tile_data->is_collision_polygon_one_way(tile_set_physics_layer, polygon_index);
-							float one_way_collision_margin = tile_data->get_collision_polygon_one_way_margin(tile_set_physics_layer, polygon_index);
-							int shapes_count = tile_data->get_collision_polygon_shapes_count(tile_set_physics_layer, polygon_index);
-							for (int shape_index = 0; shape_index < shapes_count; shape_index++) {
-								// Add decomposed convex shapes.
-								Ref<ConvexPolygonShape2D> shape = tile_data->get_collision_polygon_shape(tile_set_physics_layer, polygon_index, shape_index);
-								ps->body_add_shape(body, shape->get_rid());
-								ps->body_set_shape_as_one_way_collision(body, body_shape_index, one_way_collision, one_way_collision_margin);
-
-								body_shape_index++;
+		// Greedily merge the full cells into rectangles, growing right then down.
+		if (merge_rectangles) {
+			for (int y = 0; y < quadrant_size; y++) {
+				for (int x = 0; x < quadrant_size; x++) {
+					if (!full_cells[y * quadrant_size + x]) {
+						continue;
+					}
+
+					int width = 1;
+					while (x + width < quadrant_size && full_cells[y * quadrant_size + x + width]) {
+						width++;
+					}
+					int height = 1;
+					while (y + height < quadrant_size) {
+						bool row_full = true;
+						for (int i = x; i < x + width; i++) {
+							if (!full_cells[(y + height) * quadrant_size + i]) {
+								row_full = false;
+								break;
 							}
 						}
+						if (!row_full) {
+							break;
+						}
+						height++;
+					}
+					for (int j = y; j < y + height; j++) {
+						memset(full_cells.ptr() + j * quadrant_size + x, 0, width);
+					}
+
+					Vector2 from = map_to_local(quadrant_origin + Vector2i(x, y)) - quadrant_origin_local - tile_size / 2;
+					Vector2 to = map_to_local(quadrant_origin + Vector2i(x + width - 1, y + height - 1)) - quadrant_origin_local + tile_size / 2;
+					Vector<Vector2> rectangle;
+					rectangle.push_back(from);
+					rectangle.push_back(Vector2(from.x, to.y));
+					rectangle.push_back(to);
+					rectangle.push_back(Vector2(to.x, from.y));
+					if (Geometry2D::is_polygon_clockwise(rectangle)) {
+						rectangle.reverse();
 					}
+					merged.push_back(rectangle);
 				}
 			}
 		}
 
-		q_list_element = q_list_element->next();
+		// Union the remaining polygons. Unions that would create holes or split are skipped, so each result stays a simple polygon.
+		LocalVector<Vector<Vector2>> unions;
+		LocalVector<Rect2> unions_bounds;
+		for (Vector<Vector2> &polygon : polygons) {
+			Rect2 bounds(polygon[0], Size2());
+			for (const Vector2 &point : polygon) {
+				bounds.expand_to(point);
+			}
+
+			bool merged_any = true;
+			while (merged_any) {
+				merged_any = false;
+				for (uint32_t i = 0; i < unions.size(); i++) {
+					if (!unions_bounds[i].intersects(bounds, true)) {
+						continue;
+					}
+					Vector<Vector<Vector2>> result = Geometry2D::merge_polygons(unions[i], polygon);
+					if (result.size() != 1) {
+						continue;
+					}
+
+					// Merged, take the union out and try again against the others.
+					polygon = result[0];
+					bounds = bounds.merge(unions_bounds[i]);
+					unions.remove_at_unordered(i);
+					unions_bounds.remove_at_unordered(i);
+					merged_any = true;
+					break;
+				}
+			}
+
+			unions.push_back(polygon);
+			unions_bounds.push_back(bounds);
+		}
+
+		// Convex shapes are needed, decompose the unions and make them counter-clockwise.
+		for (const Vector<Vector2> &polygon : unions) {
+			Vector<Vector<Vector2>> convex_polygons = Geometry2D::decompose_polygon_in_convex(polygon);
+			for (Vector<Vector2> &convex_polygon : convex_polygons) {
+				if (Geometry2D::is_polygon_clockwise(convex_polygon)) {
+					convex_polygon.reverse();
+				}
+				merged.push_back(convex_polygon);
+			}
+		}
 	}
 }
 
+void TileMap::_physics_merge_quadrant_collisions_threaded(uint32_t p_index, TileMapQuadrant **p_quadrants) {
+	_physics_merge_quadrant_collisions(p_quadrants[p_index]);
+}
+
 void TileMap::_physics_cleanup_quadrant(TileMapQuadrant *p_quadrant) {
 	// Remove a quadrant.
 	ERR_FAIL_NULL(PhysicsServer2D::get_singleton());
@@ -1621,6 +1932,10 @@ void TileMap::_physics_cleanup_quadrant(TileMapQuadrant *p_quadrant) {
 		PhysicsServer2D::get_singleton()->free(body);
 	}
 	p_quadrant->bodies.clear();
+	for (const RID &shape : p_quadrant->merged_collision_shapes) {
+		PhysicsServer2D::get_singleton()->free(shape);
+	}
+	p_quadrant->merged_collision_shapes.clear();
 }
 
 void TileMap::_physics_draw_quadrant_debug(TileMapQuadrant *p_quadrant) {
@@ -1881,6 +2196,142 @@ void TileMap::set_cell(int p_layer, const Vector2i &p_coords, int p_source_id, c
 	}
 }
 
+void TileMap::_set_cell_bulk(int p_layer, const Vector2i &p_coords, TileMapCell p_cell, HashMap<Vector2i, TileMapQuadrant>::Iterator &r_quadrant, HashSet<Vector2i> &r_touched_quadrants) {
+	TileMapLayer &layer = layers[p_layer];
+
+	// Same as in set_cell(), a partially invalid cell is an empty cell.
+	bool empty = p_cell.source_id == TileSet::INVALID_SOURCE || p_cell.get_atlas_coords() == TileSetSource::INVALID_ATLAS_COORDS || p_cell.alternative_tile == TileSetSource::INVALID_TILE_ALTERNATIVE;
+
+	HashMap<Vector2i, TileMapCell>::Iterator E = layer.tile_map.find(p_coords);
+	if (!E && empty) {
+		return;
+	}
+
+	// Consecutive cells are most often in the same quadrant, avoid looking it up again.
+	Vector2i qk = _coords_to_quadrant_coords(p_layer, p_coords);
+	if (!r_quadrant || r_quadrant->key != qk) {
+		r_quadrant = layer.quadrant_map.find(qk);
+	}
+
+	if (empty) {
+		layer.tile_map.remove(E);
+		ERR_FAIL_COND(!r_quadrant);
+		r_quadrant->value.cells.erase(p_coords);
+	} else if (!E) {
+		layer.tile_map.insert(p_coords, p_cell);
+		if (!r_quadrant) {
+			r_quadrant = _create_quadrant(p_layer, qk);
+		}
+		r_quadrant->value.cells.insert(p_coords);
+	} else {
+		if (E->value == p_cell) {
+			return;
+		}
+		E->value = p_cell;
+	}
+
+	r_touched_quadrants.insert(qk);
+}
+
+void TileMap::_finish_cells_bulk(int p_layer, const HashSet<Vector2i> &p_touched_quadrants) {
+	if (p_touched_quadrants.is_empty()) {
+		return;
+	}
+
+	for (const Vector2i &qk : p_touched_quadrants) {
+		HashMap<Vector2i, TileMapQuadrant>::Iterator Q = layers[p_layer].quadrant_map.find(qk);
+		if (!Q) {
+			continue;
+		}
+		if (Q->value.cells.is_empty()) {
+			_erase_quadrant(Q);
+		} else {
+			_make_quadrant_dirty(Q);
+		}
+	}
+	used_rect_cache_dirty = true;
+}
+
+void TileMap::set_cells(int p_layer, const PackedInt32Array &p_coords, const PackedInt32Array &p_cells) {
+	ERR_FAIL_INDEX(p_layer, (int)layers.size());
+	ERR_FAIL_COND_MSG(p_coords.size() % 2 != 0, "Coordinates must be given as pairs of ints.");
+	ERR_FAIL_COND_MSG(p_cells.size() != int64_t(p_coords.size()) * 2, "Cells must be given as four ints per coordinates.");
+
+	const int32_t *coords = p_coords.ptr();
+	const int32_t *cells = p_cells.ptr();
+	HashMap<Vector2i, TileMapQuadrant>::Iterator Q;
+	HashSet<Vector2i> touched_quadrants;
+	for (int i = 0; i < p_coords.size() / 2; i++) {
+		const int32_t *c = cells + i * 4;
+		_set_cell_bulk(p_layer, Vector2i(coords[i * 2], coords[i * 2 + 1]), TileMapCell(c[0], Vector2i(c[1], c[2]), c[3]), Q, touched_quadrants);
+	}
+	_finish_cells_bulk(p_layer, touched_quadrants);
+}
+
+void TileMap::set_cells_rect(int p_layer, const Rect2i &p_rect, const PackedInt32Array &p_cells) {
+	ERR_FAIL_INDEX(p_layer, (int)layers.size());
+	ERR_FAIL_COND(p_rect.size.x < 0 || p_rect.size.y < 0);
+	int64_t cell_count = int64_t(p_rect.size.x) * p_rect.size.y;
+	ERR_FAIL_COND_MSG(cell_count > INT32_MAX / 4, "The rect has too many cells.");
+	ERR_FAIL_COND_MSG(p_cells.size() != cell_count * 4, "Cells must be given as four ints per cell of the rect.");
+
+	const int32_t *c = p_cells.ptr();
+	HashMap<Vector2i, TileMapQuadrant>::Iterator Q;
+	HashSet<Vector2i> touched_quadrants;
+	for (int y = p_rect.position.y; y < p_rect.get_end().y; y++) {
+		for (int x = p_rect.position.x; x < p_rect.get_end().x; x++) {
+			_set_cell_bulk(p_layer, Vector2i(x, y), TileMapCell(c[0], Vector2i(c[1], c[2]), c[3]), Q, touched_quadrants);
+			c += 4;
+		}
+	}
+	_finish_cells_bulk(p_layer, touched_quadrants);
+}
+
+void TileMap::fill_rect(int p_layer, const Rect2i &p_rect, int p_source_id, const Vector2i p_atlas_coords, int p_alternative_tile) {
+	ERR_FAIL_INDEX(p_layer, (int)layers.size());
+	ERR_FAIL_COND(p_rect.size.x < 0 || p_rect.size.y < 0);
+
+	TileMapCell cell(p_source_id, p_atlas_coords, p_alternative_tile);
+	HashMap<Vector2i, TileMapQuadrant>::Iterator Q;
+	HashSet<Vector2i> touched_quadrants;
+	for (int y = p_rect.position.y; y < p_rect.get_end().y; y++) {
+		for (int x = p_rect.position.x; x < p_rect.get_end().x; x++) {
+			_set_cell_bulk(p_layer, Vector2i(x, y), cell, Q, touched_quadrants);
+		}
+	}
+	_finish_cells_bulk(p_layer, touched_quadrants);
+}
+
+PackedInt32Array TileMap::get_cells_rect(int p_layer, const Rect2i &p_rect) const {
+	ERR_FAIL_INDEX_V(p_layer, (int)layers.size(), PackedInt32Array());
+	ERR_FAIL_COND_V(p_rect.size.x < 0 || p_rect.size.y < 0, PackedInt32Array());
+	int64_t cell_count = int64_t(p_rect.size.x) * p_rect.size.y;
+	ERR_FAIL_COND_V_MSG(cell_count > INT32_MAX / 4, PackedInt32Array(), "The rect has too many cells.");
+
+	const HashMap<Vector2i, TileMapCell> &tile_map = layers[p_layer].tile_map;
+	PackedInt32Array cells;
+	ERR_FAIL_COND_V(cells.resize(cell_count * 4) != OK, PackedInt32Array());
+	int32_t *w = cells.ptrw();
+	for (int y = p_rect.position.y; y < p_rect.get_end().y; y++) {
+		for (int x = p_rect.position.x; x < p_rect.get_end().x; x++) {
+			const TileMapCell *c = tile_map.getptr(Vector2i(x, y));
+			if (c) {
+				w[0] = c->source_id;
+				w[1] = c->coord_x;
+				w[2] = c->coord_y;
+				w[3] = c->alternative_tile;
+			} else {
+				w[0] = TileSet::INVALID_SOURCE;
+				w[1] = TileSetSource::INVALID_ATLAS_COORDS.x;
+				w[2] = TileSetSource::INVALID_ATLAS_COORDS.y;
+				w[3] = TileSetSource::INVALID_TILE_ALTERNATIVE;
+			}
+			w += 4;
+		}
+	}
+	return cells;
+}
+
 void TileMap::erase_cell(int p_layer, const Vector2i &p_coords) {
 	set_cell(p_layer, p_coords, TileSet::INVALID_SOURCE, TileSetSource::INVALID_ATLAS_COORDS, TileSetSource::INVALID_TILE_ALTERNATIVE);
 }
@@ -2605,6 +3056,151 @@ int TileMap::get_layer_for_body_rid(RID p_physics_body) {
 	return bodies_layers[p_physics_body];
 }
 
+void TileMap::set_chunk_stream_path(const String &p_path) {
+	if (chunk_stream_path == p_path) {
+		return;
+	}
+
+	// Cells from the previous file are not valid anymore.
+	while (!loaded_chunks.is_empty()) {
+		Vector3i key = *loaded_chunks.begin();
+		unload_chunk(key.z, Vector2i(key.x, key.y));
+	}
+	chunk_stream.close();
+
+	chunk_stream_path = p_path;
+	if (!chunk_stream_path.is_empty()) {
+		chunk_stream.open(chunk_stream_path);
+	}
+}
+
+String TileMap::get_chunk_stream_path() const {
+	return chunk_stream_path;
+}
+
+int TileMap::get_chunk_size() const {
+	return chunk_stream.get_chunk_size();
+}
+
+Error TileMap::save_chunks(const String &p_path, int p_chunk_size) const {
+	ERR_FAIL_COND_V(p_chunk_size <= 0 || p_chunk_size > TileMapChunkStream::MAX_CHUNK_SIZE, ERR_INVALID_PARAMETER);
+
+	// Gather the cells of all layers into dense chunks.
+	HashMap<Vector3i, Vector<TileMapCell>> chunks;
+	for (unsigned int layer = 0; layer < layers.size(); layer++) {
+		for (const KeyValue<Vector2i, TileMapCell> &E : layers[layer].tile_map) {
+			Vector2i chunk_coords = TileMapChunkStream::get_chunk_coords(E.key, p_chunk_size);
+			Vector3i key(chunk_coords.x, chunk_coords.y, layer);
+
+			HashMap<Vector3i, Vector<TileMapCell>>::Iterator C = chunks.find(key);
+			if (!C) {
+				Vector<TileMapCell> cells;
+				cells.resize(p_chunk_size * p_chunk_size);
+				cells.fill(TileMapCell());
+				C = chunks.insert(key, cells);
+			}
+
+			Vector2i in_chunk = E.key - chunk_coords * p_chunk_size;
+			C->value.write[in_chunk.y * p_chunk_size + in_chunk.x] = E.value;
+		}
+	}
+
+	return TileMapChunkStream::save(p_path, p_chunk_size, chunks);
+}
+
+bool TileMap::load_chunk(int p_layer, const Vector2i &p_chunk_coords) {
+	ERR_FAIL_INDEX_V(p_layer, (int)layers.size(), false);
+	ERR_FAIL_COND_V_MSG(!chunk_stream.is_open(), false, "No chunks file is open, set chunk_stream_path first.");
+
+	Vector3i key(p_chunk_coords.x, p_chunk_coords.y, p_layer);
+	if (loaded_chunks.has(key)) {
+		return true;
+	}
+	if (!chunk_stream.has_chunk(p_layer, p_chunk_coords)) {
+		return false;
+	}
+
+	Vector<TileMapCell> cells;
+	Error err = chunk_stream.read_chunk(p_layer, p_chunk_coords, cells);
+	ERR_FAIL_COND_V(err != OK, false);
+
+	int chunk_size = chunk_stream.get_chunk_size();
+	Vector2i origin = p_chunk_coords * chunk_size;
+	const TileMapCell *cells_ptr = cells.ptr();
+	HashMap<Vector2i, TileMapQuadrant>::Iterator Q;
+	HashSet<Vector2i> touched_quadrants;
+	for (int y = 0; y < chunk_size; y++) {
+		for (int x = 0; x < chunk_size; x++) {
+			const TileMapCell &c = cells_ptr[y * chunk_size + x];
+			if (c.source_id != TileSet::INVALID_SOURCE) {
+				_set_cell_bulk(p_layer, origin + Vector2i(x, y), c, Q, touched_quadrants);
+			}
+		}
+	}
+	_finish_cells_bulk(p_layer, touched_quadrants);
+
+	loaded_chunks.insert(key);
+	emit_signal(SNAME("chunk_loaded"), p_layer, p_chunk_coords);
+	return true;
+}
+
+void TileMap::unload_chunk(int p_layer, const Vector2i &p_chunk_coords) {
+	ERR_FAIL_INDEX(p_layer, (int)layers.size());
+
+	Vector3i key(p_chunk_coords.x, p_chunk_coords.y, p_layer);
+	if (!loaded_chunks.has(key)) {
+		return;
+	}
+
+	int chunk_size = chunk_stream.get_chunk_size();
+	fill_rect(p_layer, Rect2i(p_chunk_coords * chunk_size, Vector2i(chunk_size, chunk_size)));
+
+	loaded_chunks.erase(key);
+	emit_signal(SNAME("chunk_unloaded"), p_layer, p_chunk_coords);
+}
+
+bool TileMap::is_chunk_loaded(int p_layer, const Vector2i &p_chunk_coords) const {
+	return loaded_chunks.has(Vector3i(p_chunk_coords.x, p_chunk_coords.y, p_layer));
+}
+
+TypedArray<Vector2i> TileMap::get_loaded_chunks(int p_layer) const {
+	TypedArray<Vector2i> a;
+	for (const Vector3i &E : loaded_chunks) {
+		if (E.z == p_layer) {
+			a.push_back(Vector2i(E.x, E.y));
+		}
+	}
+	return a;
+}
+
+void TileMap::update_chunks(const Vector2 &p_local_position, int p_radius) {
+	ERR_FAIL_COND_MSG(!chunk_stream.is_open(), "No chunks file is open, set chunk_stream_path first.");
+	ERR_FAIL_COND(p_radius < 0);
+
+	int chunk_size = chunk_stream.get_chunk_size();
+	Vector2i center = TileMapChunkStream::get_chunk_coords(local_to_map(p_local_position), chunk_size);
+	Rect2i area(center - Vector2i(p_radius, p_radius), Vector2i(p_radius, p_radius) * 2 + Vector2i(1, 1));
+
+	// Unload the chunks out of range first, to keep the memory use bounded.
+	LocalVector<Vector3i> to_unload;
+	for (const Vector3i &E : loaded_chunks) {
+		if (!area.has_point(Vector2i(E.x, E.y))) {
+			to_unload.push_back(E);
+		}
+	}
+	for (const Vector3i &E : to_unload) {
+		unload_chunk(E.z, Vector2i(E.x, E.y));
+	}
+
+	for (unsigned int layer = 0; layer < layers.size(); layer++) {
+		for (int y = area.position.y; y < area.get_end().y; y++) {
+			for (int x = area.position.x; x < area.get_end().x; x++) {
+				load_chunk(layer, Vector2i(x, y));
+			}
+		}
+	}
+}
+
 void TileMap::fix_invalid_tiles() {
 	ERR_FAIL_COND_MSG(tile_set.is_null(), "Cannot fix invalid tiles if Tileset is not open.");
 
@@ -2656,7 +3252,7 @@ void TileMap::force_update(int p_layer) {
 
 void TileMap::_set_tile_data(int p_layer, const Vector<int> &p_data) {
 	ERR_FAIL_INDEX(p_layer, (int)layers.size());
-	ERR_FAIL_COND(format > FORMAT_3);
+	ERR_FAIL_COND(format > FORMAT_4);
 
 	// Set data for a given tile from raw data.
 
@@ -2669,7 +3265,7 @@ void TileMap::_set_tile_data(int p_layer, const Vector<int> &p_data) {
 	clear_layer(p_layer);
 
 #ifdef DISABLE_DEPRECATED
-	ERR_FAIL_COND_MSG(format != FORMAT_3, vformat("Cannot handle deprecated TileMap data format version %d. This Godot version was compiled with no support for deprecated data.", format));
+	ERR_FAIL_COND_MSG(format < FORMAT_3, vformat("Cannot handle deprecated TileMap data format version %d. This Godot version was compiled with no support for deprecated data.", format));
 #endif
 
 	for (int i = 0; i < c; i += offset) {
@@ -2695,7 +3291,7 @@ void TileMap::_set_tile_data(int p_layer, const Vector<int> &p_data) {
 		int16_t x = decode_uint16(&local[0]);
 		int16_t y = decode_uint16(&local[2]);
 
-		if (format == FORMAT_3) {
+		if (format >= FORMAT_3) {
 			uint16_t source_id = decode_uint16(&local[4]);
 			uint16_t atlas_coords_x = decode_uint16(&local[6]);
 			uint16_t atlas_coords_y = decode_uint16(&local[8]);
@@ -2737,6 +3333,30 @@ void TileMap::_set_tile_data(int p_layer, const Vector<int> &p_data) {
 	emit_signal(SNAME("changed"));
 }
 
+void TileMap::_set_compressed_tile_data(int p_layer, const Vector<uint8_t> &p_data) {
+	ERR_FAIL_INDEX(p_layer, (int)layers.size());
+
+	// Decode the cells straight into the layer, then build the quadrants a single time.
+	_clear_layer_internals(p_layer);
+	HashMap<Vector2i, TileMapCell> &tile_map = layers[p_layer].tile_map;
+	tile_map.clear();
+	Error err = TileMapChunkStream::decode_cell_map(p_data, tile_map);
+	if (err != OK) {
+		// Don't keep the cells decoded before the corrupted chunk.
+		tile_map.clear();
+	}
+	_recreate_layer_internals(p_layer);
+	used_rect_cache_dirty = true;
+
+	emit_signal(SNAME("changed"));
+	ERR_FAIL_COND(err != OK);
+}
+
+Vector<uint8_t> TileMap::_get_compressed_tile_data(int p_layer) const {
+	ERR_FAIL_INDEX_V(p_layer, (int)layers.size(), Vector<uint8_t>());
+	return TileMapChunkStream::encode_cell_map(layers[p_layer].tile_map);
+}
+
 Vector<int> TileMap::_get_tile_data(int p_layer) const {
 	ERR_FAIL_INDEX_V(p_layer, (int)layers.size(), Vector<int>());
 
@@ -2862,7 +3482,11 @@ bool TileMap::_set(const StringName &p_name, const Variant &p_value) {
 			set_layer_z_index(index, p_value);
 			return true;
 		} else if (components[1] == "tile_data") {
-			_set_tile_data(index, p_value);
+			if (p_value.get_type() == Variant::PACKED_BYTE_ARRAY) {
+				_set_compressed_tile_data(index, p_value);
+			} else {
+				_set_tile_data(index, p_value);
+			}
 			return true;
 		} else {
 			return false;
@@ -2874,7 +3498,7 @@ bool TileMap::_set(const StringName &p_name, const Variant &p_value) {
 bool TileMap::_get(const StringName &p_name, Variant &r_ret) const {
 	Vector<String> components = String(p_name).split("/", true, 2);
 	if (p_name == "format") {
-		r_ret = FORMAT_3; // When saving, always save highest format
+		r_ret = FORMAT_4; // When saving, always save highest format
 		return true;
 	} else if (components.size() == 2 && components[0].begins_with("layer_") && components[0].trim_prefix("layer_").is_valid_int()) {
 		int index = components[0].trim_prefix("layer_").to_int();
@@ -2901,7 +3525,7 @@ bool TileMap::_get(const StringName &p_name, Variant &r_ret) const {
 			r_ret = get_layer_z_index(index);
 			return true;
 		} else if (components[1] == "tile_data") {
-			r_ret = _get_tile_data(index);
+			r_ret = _get_compressed_tile_data(index);
 			return true;
 		} else {
 			return false;
@@ -3847,6 +4471,11 @@ void TileMap::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("set_collision_animatable", "enabled"), &TileMap::set_collision_animatable);
 	ClassDB::bind_method(D_METHOD("is_collision_animatable"), &TileMap::is_collision_animatable);
+	ClassDB::bind_method(D_METHOD("set_collision_merged", "enabled"), &TileMap::set_collision_merged);
+	ClassDB::bind_method(D_METHOD("is_collision_merged"), &TileMap::is_collision_merged);
+	ClassDB::bind_method(D_METHOD("set_update_cells_per_frame", "cells"), &TileMap::set_update_cells_per_frame);
+	ClassDB::bind_method(D_METHOD("get_update_cells_per_frame"), &TileMap::get_update_cells_per_frame);
+
 	ClassDB::bind_method(D_METHOD("set_collision_visibility_mode", "collision_visibility_mode"), &TileMap::set_collision_visibility_mode);
 	ClassDB::bind_method(D_METHOD("get_collision_visibility_mode"), &TileMap::get_collision_visibility_mode);
 
@@ -3855,6 +4484,10 @@ void TileMap::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_cell_source_id", "layer", "coords", "use_proxies"), &TileMap::get_cell_source_id, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_cell_atlas_coords", "layer", "coords", "use_proxies"), &TileMap::get_cell_atlas_coords, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_cell_alternative_tile", "layer", "coords", "use_proxies"), &TileMap::get_cell_alternative_tile, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("set_cells", "layer", "coords", "cells"), &TileMap::set_cells);
+	ClassDB::bind_method(D_METHOD("set_cells_rect", "layer", "rect", "cells"), &TileMap::set_cells_rect);
+	ClassDB::bind_method(D_METHOD("fill_rect", "layer", "rect", "source_id", "atlas_coords", "alternative_tile"), &TileMap::fill_rect, DEFVAL(TileSet::INVALID_SOURCE), DEFVAL(TileSetSource::INVALID_ATLAS_COORDS), DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("get_cells_rect", "layer", "rect"), &TileMap::get_cells_rect);
 	ClassDB::bind_method(D_METHOD("get_cell_tile_data", "layer", "coords", "use_proxies"), &TileMap::get_cell_tile_data, DEFVAL(false));
 
 	ClassDB::bind_method(D_METHOD("get_coords_for_body_rid", "body"), &TileMap::get_coords_for_body_rid);
@@ -3867,6 +4500,16 @@ void TileMap::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_cells_terrain_connect", "layer", "cells", "terrain_set", "terrain", "ignore_empty_terrains"), &TileMap::set_cells_terrain_connect, DEFVAL(true));
 	ClassDB::bind_method(D_METHOD("set_cells_terrain_path", "layer", "path", "terrain_set", "terrain", "ignore_empty_terrains"), &TileMap::set_cells_terrain_path, DEFVAL(true));
 
+	ClassDB::bind_method(D_METHOD("set_chunk_stream_path", "path"), &TileMap::set_chunk_stream_path);
+	ClassDB::bind_method(D_METHOD("get_chunk_stream_path"), &TileMap::get_chunk_stream_path);
+	ClassDB::bind_method(D_METHOD("get_chunk_size"), &TileMap::get_chunk_size);
+	ClassDB::bind_method(D_METHOD("save_chunks", "path", "chunk_size"), &TileMap::save_chunks, DEFVAL(64));
+	ClassDB::bind_method(D_METHOD("load_chunk", "layer", "chunk_coords"), &TileMap::load_chunk);
+	ClassDB::bind_method(D_METHOD("unload_chunk", "layer", "chunk_coords"), &TileMap::unload_chunk);
+	ClassDB::bind_method(D_METHOD("is_chunk_loaded", "layer", "chunk_coords"), &TileMap::is_chunk_loaded);
+	ClassDB::bind_method(D_METHOD("get_loaded_chunks", "layer"), &TileMap::get_loaded_chunks);
+	ClassDB::bind_method(D_METHOD("update_chunks", "local_position", "radius"), &TileMap::update_chunks);
+
 	ClassDB::bind_method(D_METHOD("fix_invalid_tiles"), &TileMap::fix_invalid_tiles);
 	ClassDB::bind_method(D_METHOD("clear_layer", "layer"), &TileMap::clear_layer);
 	ClassDB::bind_method(D_METHOD("clear"), &TileMap::clear);
@@ -3894,13 +4537,18 @@ void TileMap::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "tile_set", PROPERTY_HINT_RESOURCE_TYPE, "TileSet"), "set_tileset", "get_tileset");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "cell_quadrant_size", PROPERTY_HINT_RANGE, "1,128,1"), "set_quadrant_size", "get_quadrant_size");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "collision_animatable"), "set_collision_animatable", "is_collision_animatable");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "collision_merged"), "set_collision_merged", "is_collision_merged");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "collision_visibility_mode", PROPERTY_HINT_ENUM, "Default,Force Show,Force Hide"), "set_collision_visibility_mode", "get_collision_visibility_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING, "chunk_stream_path", PROPERTY_HINT_FILE, "*.tmchunks"), "set_chunk_stream_path", "get_chunk_stream_path");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "update_cells_per_frame", PROPERTY_HINT_RANGE, "0,65536,1,or_greater"), "set_update_cells_per_frame", "get_update_cells_per_frame");
 
 	ADD_ARRAY("layers", "layer_");
 
 	ADD_PROPERTY_DEFAULT("format", FORMAT_1);
 
 	ADD_SIGNAL(MethodInfo("changed"));
+	ADD_SIGNAL(MethodInfo("chunk_loaded", PropertyInfo(Variant::INT, "layer"), PropertyInfo(Variant::VECTOR2I, "chunk_coords")));
+	ADD_SIGNAL(MethodInfo("chunk_unloaded", PropertyInfo(Variant::INT, "layer"), PropertyInfo(Variant::VECTOR2I, "chunk_coords")));
 
 	BIND_ENUM_CONSTANT(VISIBILITY_MODE_DEFAULT);
 	BIND_ENUM_CONSTANT(VISIBILITY_MODE_FORCE_HIDE);
@@ -32,6 +32,7 @@
 #define TILE_MAP_H
 
 #include "scene/2d/node_2d.h"
+#include "scene/2d/tile_map_chunk_stream.h"
 #include "scene/gui/control.h"
 #include "scene/resources/tile_set.h"
 
@@ -63,6 +64,25 @@ struct TileMapQuadrant {
 	RBMap<Vector2i, Vector2> map_to_local;
 	RBMap<Vector2, Vector2i, CoordsWorldComparator> local_to_map;
 
+	// Atlas cells resolved to their tile data, sorted by local position.
+	// Built while updating the quadrant, possibly on a worker thread.
+	struct ResolvedCell {
+		Vector2 local_position;
+		Vector2i coords;
+		TileMapCell cell;
+		const TileData *tile_data = nullptr;
+	};
+	LocalVector<ResolvedCell> resolved_cells;
+	struct ResolvedCellCoordsComparator {
+		const ResolvedCell *resolved_cells = nullptr;
+
+		_FORCE_INLINE_ bool operator()(uint32_t p_a, uint32_t p_b) const {
+			return resolved_cells[p_a].coords < resolved_cells[p_b].coords;
+		}
+	};
+	// Indices of resolved_cells in coords order, the order of cells. Bodies are created in this order.
+	LocalVector<uint32_t> resolved_cells_by_coords;
+
 	// Debug.
 	RID debug_canvas_item;
 
@@ -72,6 +92,9 @@ struct TileMapQuadrant {
 
 	// Physics.
 	List<RID> bodies;
+	// Merged collision polygons per TileSet physics layer, and the shapes created from them.
+	LocalVector<LocalVector<Vector<Vector2>>> merged_collision_polygons;
+	LocalVector<RID> merged_collision_shapes;
 
 	// Scenes.
 	HashMap<Vector2i, String> scenes;
@@ -86,6 +109,7 @@ struct TileMapQuadrant {
 		canvas_items = q.canvas_items;
 		occluders = q.occluders;
 		bodies = q.bodies;
+		merged_collision_shapes = q.merged_collision_shapes;
 	}
 
 	TileMapQuadrant(const TileMapQuadrant &q) :
@@ -96,6 +120,7 @@ struct TileMapQuadrant {
 		canvas_items = q.canvas_items;
 		occluders = q.occluders;
 		bodies = q.bodies;
+		merged_collision_shapes = q.merged_collision_shapes;
 	}
 
 	TileMapQuadrant() :
@@ -172,9 +197,10 @@ private:
 	enum DataFormat {
 		FORMAT_1 = 0,
 		FORMAT_2,
-		FORMAT_3
+		FORMAT_3,
+		FORMAT_4, // Layers tile data saved as compressed chunks.
 	};
-	mutable DataFormat format = FORMAT_3;
+	mutable DataFormat format = FORMAT_4;
 
 	static constexpr float FP_ADJUST = 0.00001;
 
@@ -182,7 +208,9 @@ private:
 	Ref<TileSet> tile_set;
 	int quadrant_size = 16;
 	bool collision_animatable = false;
+	bool collision_merged = false;
 	VisibilityMode collision_visibility_mode = VISIBILITY_MODE_DEFAULT;
+	int update_cells_per_frame = 0;
 
 	// Updates.
 	bool pending_update = false;
@@ -209,6 +237,11 @@ private:
 	LocalVector<TileMapLayer> layers;
 	int selected_layer = -1;
 
+	// Chunk streaming. Loaded chunks are keyed by chunk coords, with the layer as z.
+	String chunk_stream_path;
+	TileMapChunkStream chunk_stream;
+	HashSet<Vector3i> loaded_chunks;
+
 	// Mapping for RID to coords.
 	HashMap<RID, Vector2i> bodies_coords;
 	// Mapping for RID to tile layer.
@@ -225,6 +258,15 @@ private:
 
 	void _update_dirty_quadrants();
 
+	// Cells of the dirty quadrants are sorted and resolved on the worker thread pool when there are enough of them.
+	// With update_cells_per_frame set, large updates are spread over several frames so they don't stall a single one.
+	enum {
+		THREADED_UPDATE_MIN_QUADRANTS = 4,
+	};
+	int last_update_threaded_quadrants = 0;
+	void _update_quadrant_cells(TileMapQuadrant *p_quadrant) const;
+	void _update_quadrant_cells_threaded(uint32_t p_index, TileMapQuadrant **p_quadrants);
+
 	void _recreate_layer_internals(int p_layer);
 	void _recreate_internals();
 
@@ -237,6 +279,10 @@ private:
 	// Rect caching.
 	void _recompute_rect_cache();
 
+	// Bulk cell edition. Cells are written directly to the layer, quadrants are updated once at the end.
+	void _set_cell_bulk(int p_layer, const Vector2i &p_coords, TileMapCell p_cell, HashMap<Vector2i, TileMapQuadrant>::Iterator &r_quadrant, HashSet<Vector2i> &r_touched_quadrants);
+	void _finish_cells_bulk(int p_layer, const HashSet<Vector2i> &p_touched_quadrants);
+
 	// Per-system methods.
 	bool _rendering_quadrant_order_dirty = false;
 	void _rendering_notification(int p_what);
@@ -251,6 +297,10 @@ private:
 	Transform2D new_transform;
 	void _physics_notification(int p_what);
 	void _physics_update_dirty_quadrants(SelfList<TileMapQuadrant>::List &r_dirty_quadrant_list);
+	RID _physics_create_body(TileMapQuadrant *p_quadrant, int p_tile_set_physics_layer, const Vector2i &p_coords, const Vector2 &p_local_position, const Transform2D &p_gl_transform, RID p_space);
+	bool _physics_is_tile_collision_mergeable(const TileData *p_tile_data, int p_tile_set_physics_layer) const;
+	void _physics_merge_quadrant_collisions(TileMapQuadrant *p_quadrant) const;
+	void _physics_merge_quadrant_collisions_threaded(uint32_t p_index, TileMapQuadrant **p_quadrants);
 	void _physics_cleanup_quadrant(TileMapQuadrant *p_quadrant);
 	void _physics_draw_quadrant_debug(TileMapQuadrant *p_quadrant);
 
@@ -266,6 +316,8 @@ private:
 	// Set and get tiles from data arrays.
 	void _set_tile_data(int p_layer, const Vector<int> &p_data);
 	Vector<int> _get_tile_data(int p_layer) const;
+	void _set_compressed_tile_data(int p_layer, const Vector<uint8_t> &p_data);
+	Vector<uint8_t> _get_compressed_tile_data(int p_layer) const;
 
 	void _build_runtime_update_tile_data(SelfList<TileMapQuadrant>::List &r_dirty_quadrant_list);
 
@@ -323,10 +375,16 @@ public:
 	void set_collision_animatable(bool p_enabled);
 	bool is_collision_animatable() const;
 
+	void set_collision_merged(bool p_enabled);
+	bool is_collision_merged() const;
+
 	// Debug visibility modes.
 	void set_collision_visibility_mode(VisibilityMode p_show_collision);
 	VisibilityMode get_collision_visibility_mode();
 
+	void set_update_cells_per_frame(int p_cells);
+	int get_update_cells_per_frame() const;
+
 	// Cells accessors.
 	void set_cell(int p_layer, const Vector2i &p_coords, int p_source_id = TileSet::INVALID_SOURCE, const Vector2i p_atlas_coords = TileSetSource::INVALID_ATLAS_COORDS, int p_alternative_tile = 0);
 	void erase_cell(int p_layer, const Vector2i &p_coords);
@@ -336,6 +394,12 @@ public:
 	// Helper method to make accessing the data easier.
 	TileData *get_cell_tile_data(int p_layer, const Vector2i &p_coords, bool p_use_proxies = false) const;
 
+	// Bulk cells accessors. Cells are packed as four ints: source ID, atlas coords x and y, alternative tile.
+	void set_cells(int p_layer, const PackedInt32Array &p_coords, const PackedInt32Array &p_cells);
+	void set_cells_rect(int p_layer, const Rect2i &p_rect, const PackedInt32Array &p_cells);
+	void fill_rect(int p_layer, const Rect2i &p_rect, int p_source_id = TileSet::INVALID_SOURCE, const Vector2i p_atlas_coords = TileSetSource::INVALID_ATLAS_COORDS, int p_alternative_tile = 0);
+	PackedInt32Array get_cells_rect(int p_layer, const Rect2i &p_rect) const;
+
 	// Patterns.
 	Ref<TileMapPattern> get_pattern(int p_layer, TypedArray<Vector2i> p_coords_array);
 	Vector2i map_pattern(const Vector2i &p_position_in_tilemap, const Vector2i &p_coords_in_pattern, Ref<TileMapPattern> p_pattern);
@@ -353,6 +417,7 @@ public:
 	// Not exposed to users
 	TileMapCell get_cell(int p_layer, const Vector2i &p_coords, bool p_use_proxies = false) const;
 	HashMap<Vector2i, TileMapQuadrant> *get_quadrant_map(int p_layer);
+	int get_last_update_threaded_quadrants() const { return last_update_threaded_quadrants; }
 	int get_effective_quadrant_size(int p_layer) const;
 	//---
 
@@ -380,6 +445,17 @@ public:
 	// For getting their layers as well.
 	int get_layer_for_body_rid(RID p_physics_body);
 
+	// Chunk streaming.
+	void set_chunk_stream_path(const String &p_path);
+	String get_chunk_stream_path() const;
+	int get_chunk_size() const;
+	Error save_chunks(const String &p_path, int p_chunk_size = 64) const;
+	bool load_chunk(int p_layer, const Vector2i &p_chunk_coords);
+	void unload_chunk(int p_layer, const Vector2i &p_chunk_coords);
+	bool is_chunk_loaded(int p_layer, const Vector2i &p_chunk_coords) const;
+	TypedArray<Vector2i> get_loaded_chunks(int p_layer) const;
+	void update_chunks(const Vector2 &p_local_position, int p_radius);
+
 	// Fixing and clearing methods.
 	void fix_invalid_tiles();
 
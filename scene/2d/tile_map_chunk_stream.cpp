@@ -0,0 +1,292 @@
+/**************************************************************************/
+/*  tile_map_chunk_stream.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "tile_map_chunk_stream.h"
+
+#include "core/io/compression.h"
+#include "core/io/marshalls.h"
+
+void TileMapChunkStream::encode_cells(const TileMapCell *p_cells, int p_count, uint8_t *r_buffer) {
+	for (int i = 0; i < p_count; i++) {
+		const TileMapCell &c = p_cells[i];
+		uint8_t *dst = r_buffer + i * ENCODED_CELL_SIZE;
+		encode_uint16(c.source_id, dst);
+		encode_uint16(c.coord_x, dst + 2);
+		encode_uint16(c.coord_y, dst + 4);
+		encode_uint16(c.alternative_tile, dst + 6);
+	}
+}
+
+void TileMapChunkStream::decode_cells(const uint8_t *p_buffer, int p_count, TileMapCell *r_cells) {
+	for (int i = 0; i < p_count; i++) {
+		const uint8_t *src = p_buffer + i * ENCODED_CELL_SIZE;
+		TileMapCell &c = r_cells[i];
+		c.source_id = (int16_t)decode_uint16(src);
+		c.coord_x = (int16_t)decode_uint16(src + 2);
+		c.coord_y = (int16_t)decode_uint16(src + 4);
+		c.alternative_tile = (int16_t)decode_uint16(src + 6);
+	}
+}
+
+Vector<uint8_t> TileMapChunkStream::compress_cells(const TileMapCell *p_cells, int p_count) {
+	Vector<uint8_t> encoded;
+	encoded.resize(p_count * ENCODED_CELL_SIZE);
+	encode_cells(p_cells, p_count, encoded.ptrw());
+
+	Vector<uint8_t> compressed;
+	compressed.resize(Compression::get_max_compressed_buffer_size(encoded.size(), Compression::MODE_ZSTD));
+	int compressed_size = Compression::compress(compressed.ptrw(), encoded.ptr(), encoded.size(), Compression::MODE_ZSTD);
+	ERR_FAIL_COND_V(compressed_size < 0, Vector<uint8_t>());
+	compressed.resize(compressed_size);
+	return compressed;
+}
+
+Error TileMapChunkStream::decompress_cells(const uint8_t *p_data, int p_size, int p_count, TileMapCell *r_cells) {
+	Vector<uint8_t> encoded;
+	encoded.resize(p_count * ENCODED_CELL_SIZE);
+	int decompressed_size = Compression::decompress(encoded.ptrw(), encoded.size(), p_data, p_size, Compression::MODE_ZSTD);
+	ERR_FAIL_COND_V_MSG(decompressed_size != encoded.size(), ERR_FILE_CORRUPT, "Corrupted TileMap cell data.");
+	decode_cells(encoded.ptr(), p_count, r_cells);
+	return OK;
+}
+
+Vector2i TileMapChunkStream::get_chunk_coords(const Vector2i &p_coords, int p_chunk_size) {
+	// Rounding down, instead of simply rounding towards zero (truncating)
+	return Vector2i(
+			p_coords.x > 0 ? p_coords.x / p_chunk_size : (p_coords.x - (p_chunk_size - 1)) / p_chunk_size,
+			p_coords.y > 0 ? p_coords.y / p_chunk_size : (p_coords.y - (p_chunk_size - 1)) / p_chunk_size);
+}
+
+Vector<uint8_t> TileMapChunkStream::encode_cell_map(const HashMap<Vector2i, TileMapCell> &p_cells, int p_chunk_size) {
+	ERR_FAIL_COND_V(p_chunk_size <= 0 || p_chunk_size > MAX_CHUNK_SIZE, Vector<uint8_t>());
+
+	// Spread the cells in dense chunks.
+	int cell_count = p_chunk_size * p_chunk_size;
+	HashMap<Vector2i, Vector<TileMapCell>> chunks;
+	for (const KeyValue<Vector2i, TileMapCell> &E : p_cells) {
+		Vector2i chunk_coords = get_chunk_coords(E.key, p_chunk_size);
+		HashMap<Vector2i, Vector<TileMapCell>>::Iterator C = chunks.find(chunk_coords);
+		if (!C) {
+			Vector<TileMapCell> cells;
+			cells.resize(cell_count);
+			cells.fill(TileMapCell());
+			C = chunks.insert(chunk_coords, cells);
+		}
+		Vector2i in_chunk = E.key - chunk_coords * p_chunk_size;
+		C->value.write[in_chunk.y * p_chunk_size + in_chunk.x] = E.value;
+	}
+
+	// Chunks are written in coordinates order, so the same cells always give the same data.
+	LocalVector<Vector2i> chunk_keys;
+	chunk_keys.reserve(chunks.size());
+	for (const KeyValue<Vector2i, Vector<TileMapCell>> &E : chunks) {
+		chunk_keys.push_back(E.key);
+	}
+	chunk_keys.sort();
+
+	LocalVector<Vector<uint8_t>> chunks_data;
+	chunks_data.reserve(chunks.size());
+	int size = 8;
+	for (const Vector2i &key : chunk_keys) {
+		chunks_data.push_back(compress_cells(chunks[key].ptr(), cell_count));
+		size += 12 + chunks_data[chunks_data.size() - 1].size();
+	}
+
+	Vector<uint8_t> data;
+	data.resize(size);
+	uint8_t *w = data.ptrw();
+	encode_uint32(p_chunk_size, w);
+	encode_uint32(chunks.size(), w + 4);
+	w += 8;
+	for (uint32_t i = 0; i < chunk_keys.size(); i++) {
+		const Vector<uint8_t> &chunk_data = chunks_data[i];
+		encode_uint32(chunk_keys[i].x, w);
+		encode_uint32(chunk_keys[i].y, w + 4);
+		encode_uint32(chunk_data.size(), w + 8);
+		memcpy(w + 12, chunk_data.ptr(), chunk_data.size());
+		w += 12 + chunk_data.size();
+	}
+
+	return data;
+}
+
+Error TileMapChunkStream::decode_cell_map(const Vector<uint8_t> &p_data, HashMap<Vector2i, TileMapCell> &r_cells) {
+	ERR_FAIL_COND_V_MSG(p_data.size() < 8, ERR_FILE_CORRUPT, "Corrupted TileMap cell data.");
+
+	const uint8_t *r = p_data.ptr();
+	const uint8_t *end = r + p_data.size();
+	int chunk_size = decode_uint32(r);
+	uint32_t chunk_count = decode_uint32(r + 4);
+	ERR_FAIL_COND_V_MSG(chunk_size <= 0 || chunk_size > MAX_CHUNK_SIZE, ERR_FILE_CORRUPT, "Corrupted TileMap cell data.");
+	r += 8;
+	// Each chunk has at least its 12 bytes header.
+	ERR_FAIL_COND_V_MSG((uint64_t)chunk_count * 12 > (uint64_t)(end - r), ERR_FILE_CORRUPT, "Corrupted TileMap cell data.");
+
+	int cell_count = chunk_size * chunk_size;
+	Vector<TileMapCell> cells;
+	ERR_FAIL_COND_V(cells.resize(cell_count) != OK, ERR_OUT_OF_MEMORY);
+	TileMapCell *cells_ptr = cells.ptrw();
+
+	for (uint32_t chunk = 0; chunk < chunk_count; chunk++) {
+		ERR_FAIL_COND_V_MSG(end - r < 12, ERR_FILE_CORRUPT, "Corrupted TileMap cell data.");
+		Vector2i origin = Vector2i((int32_t)decode_uint32(r), (int32_t)decode_uint32(r + 4)) * chunk_size;
+		uint32_t size = decode_uint32(r + 8);
+		r += 12;
+		ERR_FAIL_COND_V_MSG((uint32_t)(end - r) < size, ERR_FILE_CORRUPT, "Corrupted TileMap cell data.");
+
+		Error err = decompress_cells(r, size, cell_count, cells_ptr);
+		ERR_FAIL_COND_V(err != OK, err);
+		r += size;
+
+		for (int i = 0; i < cell_count; i++) {
+			if (cells_ptr[i].source_id != TileSet::INVALID_SOURCE) {
+				r_cells.insert(origin + Vector2i(i % chunk_size, i / chunk_size), cells_ptr[i]);
+			}
+		}
+	}
+
+	return OK;
+}
+
+Error TileMapChunkStream::save(const String &p_path, int p_chunk_size, const HashMap<Vector3i, Vector<TileMapCell>> &p_chunks) {
+	ERR_FAIL_COND_V(p_chunk_size <= 0 || p_chunk_size > MAX_CHUNK_SIZE, ERR_INVALID_PARAMETER);
+
+	Error err;
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Cannot save TileMap chunks to file '" + p_path + "'.");
+
+	f->store_buffer((const uint8_t *)"GDTC", 4);
+	f->store_32(FORMAT_VERSION);
+	f->store_32(p_chunk_size);
+	f->store_32(p_chunks.size());
+
+	// Chunks are written in coordinates order, so the same cells always give the same file.
+	LocalVector<Vector3i> chunk_keys;
+	chunk_keys.reserve(p_chunks.size());
+	for (const KeyValue<Vector3i, Vector<TileMapCell>> &E : p_chunks) {
+		chunk_keys.push_back(E.key);
+	}
+	chunk_keys.sort();
+
+	// Compress everything first, the index needs the data sizes.
+	int cell_count = p_chunk_size * p_chunk_size;
+	LocalVector<Vector<uint8_t>> chunks_data;
+	chunks_data.reserve(p_chunks.size());
+	uint64_t offset = f->get_position() + (uint64_t)p_chunks.size() * INDEX_ENTRY_SIZE;
+	for (const Vector3i &key : chunk_keys) {
+		const Vector<TileMapCell> &cells = p_chunks[key];
+		ERR_FAIL_COND_V(cells.size() != cell_count, ERR_INVALID_DATA);
+		Vector<uint8_t> data = compress_cells(cells.ptr(), cell_count);
+
+		f->store_32(key.z);
+		f->store_32(key.x);
+		f->store_32(key.y);
+		f->store_64(offset);
+		f->store_32(data.size());
+
+		offset += data.size();
+		chunks_data.push_back(data);
+	}
+
+	for (const Vector<uint8_t> &data : chunks_data) {
+		f->store_buffer(data);
+	}
+
+	return OK;
+}
+
+Error TileMapChunkStream::open(const String &p_path) {
+	close();
+
+	Error err;
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Cannot open TileMap chunks file '" + p_path + "'.");
+
+	uint8_t magic[4];
+	f->get_buffer(magic, 4);
+	ERR_FAIL_COND_V_MSG(magic[0] != 'G' || magic[1] != 'D' || magic[2] != 'T' || magic[3] != 'C', ERR_FILE_UNRECOGNIZED, "File '" + p_path + "' is not a TileMap chunks file.");
+	uint32_t version = f->get_32();
+	ERR_FAIL_COND_V_MSG(version > FORMAT_VERSION, ERR_FILE_UNRECOGNIZED, "TileMap chunks file '" + p_path + "' uses an unsupported format version.");
+
+	int size = f->get_32();
+	ERR_FAIL_COND_V_MSG(size <= 0 || size > MAX_CHUNK_SIZE, ERR_FILE_CORRUPT, "TileMap chunks file '" + p_path + "' has an invalid chunk size.");
+	uint32_t chunk_count = f->get_32();
+	// Don't trust the count before reserving for it, the whole index must fit in the file.
+	ERR_FAIL_COND_V_MSG(f->eof_reached() || (uint64_t)chunk_count * INDEX_ENTRY_SIZE > f->get_length() - f->get_position(), ERR_FILE_CORRUPT, "TileMap chunks file '" + p_path + "' is truncated.");
+
+	HashMap<Vector3i, ChunkEntry> entries;
+	entries.reserve(chunk_count);
+	for (uint32_t i = 0; i < chunk_count; i++) {
+		Vector3i key;
+		key.z = (int32_t)f->get_32();
+		key.x = (int32_t)f->get_32();
+		key.y = (int32_t)f->get_32();
+		ChunkEntry entry;
+		entry.offset = f->get_64();
+		entry.size = f->get_32();
+		entries[key] = entry;
+	}
+	ERR_FAIL_COND_V_MSG(f->eof_reached(), ERR_FILE_CORRUPT, "TileMap chunks file '" + p_path + "' is truncated.");
+
+	// Keep the file open, chunks are read from it when requested.
+	file = f;
+	chunk_size = size;
+	chunks = entries;
+	return OK;
+}
+
+void TileMapChunkStream::close() {
+	file.unref();
+	chunk_size = 0;
+	chunks.clear();
+}
+
+bool TileMapChunkStream::has_chunk(int p_layer, const Vector2i &p_chunk_coords) const {
+	return chunks.has(Vector3i(p_chunk_coords.x, p_chunk_coords.y, p_layer));
+}
+
+Error TileMapChunkStream::read_chunk(int p_layer, const Vector2i &p_chunk_coords, Vector<TileMapCell> &r_cells) const {
+	ERR_FAIL_COND_V(file.is_null(), ERR_UNCONFIGURED);
+	const ChunkEntry *entry = chunks.getptr(Vector3i(p_chunk_coords.x, p_chunk_coords.y, p_layer));
+	if (!entry) {
+		return ERR_DOES_NOT_EXIST;
+	}
+
+	uint64_t length = file->get_length();
+	ERR_FAIL_COND_V(entry->offset > length || entry->size > length - entry->offset, ERR_FILE_CORRUPT);
+
+	file->seek(entry->offset);
+	Vector<uint8_t> data = file->get_buffer(entry->size);
+	ERR_FAIL_COND_V(data.size() != (int)entry->size, ERR_FILE_CORRUPT);
+
+	// chunk_size is bounded by open(), so this can't overflow.
+	ERR_FAIL_COND_V(r_cells.resize(chunk_size * chunk_size) != OK, ERR_OUT_OF_MEMORY);
+	return decompress_cells(data.ptr(), data.size(), r_cells.size(), r_cells.ptrw());
+}
@@ -0,0 +1,96 @@
+/**************************************************************************/
+/*  tile_map_chunk_stream.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TILE_MAP_CHUNK_STREAM_H
+#define TILE_MAP_CHUNK_STREAM_H
+
+#include "core/io/file_access.h"
+#include "core/templates/hash_map.h"
+#include "scene/resources/tile_set.h"
+
+// Stores TileMap cells as square chunks of dense cell arrays, each compressed on its own.
+// Chunks are read from the file on demand, so only the parts of a large map in use need to be in memory.
+//
+// File layout, little endian:
+// - Header: "GDTC", format version, chunk size, chunk count.
+// - Index, one entry per chunk: layer, chunk coords, data offset and data size.
+// - Chunk data: chunk_size * chunk_size cells, row by row, compressed with zstd.
+//
+// The same chunks are used to save the cells of a TileMap layer in a single buffer:
+// - Header: chunk size, chunk count.
+// - Each chunk: chunk coords, data size, then the compressed data.
+class TileMapChunkStream {
+public:
+	static constexpr uint32_t FORMAT_VERSION = 1;
+	// A cell is stored as the four 16 bits values of TileMapCell.
+	static constexpr int ENCODED_CELL_SIZE = 8;
+	static constexpr int CELL_MAP_CHUNK_SIZE = 32;
+	// Bounds the chunk size read from files, so chunk buffers can't overflow.
+	static constexpr int MAX_CHUNK_SIZE = 1024;
+	// Layer, chunk coords, 64 bits data offset and data size.
+	static constexpr int INDEX_ENTRY_SIZE = 3 * 4 + 8 + 4;
+
+private:
+	struct ChunkEntry {
+		uint64_t offset = 0;
+		uint32_t size = 0;
+	};
+
+	Ref<FileAccess> file;
+	int chunk_size = 0;
+	// Keyed by chunk coords, with the layer as z.
+	HashMap<Vector3i, ChunkEntry> chunks;
+
+public:
+	static void encode_cells(const TileMapCell *p_cells, int p_count, uint8_t *r_buffer);
+	static void decode_cells(const uint8_t *p_buffer, int p_count, TileMapCell *r_cells);
+
+	static Vector<uint8_t> compress_cells(const TileMapCell *p_cells, int p_count);
+	static Error decompress_cells(const uint8_t *p_data, int p_size, int p_count, TileMapCell *r_cells);
+
+	static Vector2i get_chunk_coords(const Vector2i &p_coords, int p_chunk_size);
+
+	// Encodes all cells of a layer in a single buffer, and decodes them back. Empty cells are skipped when decoding.
+	static Vector<uint8_t> encode_cell_map(const HashMap<Vector2i, TileMapCell> &p_cells, int p_chunk_size = CELL_MAP_CHUNK_SIZE);
+	static Error decode_cell_map(const Vector<uint8_t> &p_data, HashMap<Vector2i, TileMapCell> &r_cells);
+
+	// Chunks are keyed like above and must hold chunk_size * chunk_size cells.
+	static Error save(const String &p_path, int p_chunk_size, const HashMap<Vector3i, Vector<TileMapCell>> &p_chunks);
+
+	Error open(const String &p_path);
+	void close();
+	bool is_open() const { return file.is_valid(); }
+
+	int get_chunk_size() const { return chunk_size; }
+	bool has_chunk(int p_layer, const Vector2i &p_chunk_coords) const;
+	Error read_chunk(int p_layer, const Vector2i &p_chunk_coords, Vector<TileMapCell> &r_cells) const;
+};
+
+#endif // TILE_MAP_CHUNK_STREAM_H
@@ -31,6 +31,8 @@
 #include "canvas_item.h"
 
 #include "core/object/message_queue.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
 #include "scene/2d/canvas_group.h"
 #include "scene/main/canvas_layer.h"
 #include "scene/main/window.h"
@@ -121,7 +123,20 @@ bool CanvasItem::is_visible() const {
 	return visible;
 }
 
-CanvasItem *CanvasItem::current_item_drawn = nullptr;
+thread_local CanvasItem *CanvasItem::current_item_drawn = nullptr;
+BinaryMutex CanvasItem::threaded_redraw_mutex;
+LocalVector<ObjectID> CanvasItem::threaded_redraw_queue;
+
+struct CanvasItemThreadedRedraw {
+	CanvasItem **items = nullptr;
+	SafeNumeric<uint32_t> finished;
+	bool post_finished = false;
+};
+
+// Posted when a redraw task finishes or queues a RenderingServer call. Static, as tasks can still post it after the
+// main thread saw them finish.
+static Semaphore threaded_redraw_semaphore;
+
 CanvasItem *CanvasItem::get_current_item_drawn() {
 	return current_item_drawn;
 }
@@ -132,9 +147,13 @@ void CanvasItem::_redraw_callback() {
 		return;
 	}
 
+	_redraw(is_visible_in_tree());
+}
+
+void CanvasItem::_redraw(bool p_visible) {
 	RenderingServer::get_singleton()->canvas_item_clear(get_canvas_item());
 	//todo updating = true - only allow drawing here
-	if (is_visible_in_tree()) {
+	if (p_visible) {
 		drawing = true;
 		current_item_drawn = this;
 		notification(NOTIFICATION_DRAW);
@@ -147,6 +166,82 @@ void CanvasItem::_redraw_callback() {
 	pending_update = false; // don't change to false until finished drawing (avoid recursive update)
 }
 
+void CanvasItem::_redraw_threaded(void *p_redraw, uint32_t p_index) {
+	CanvasItemThreadedRedraw *redraw = (CanvasItemThreadedRedraw *)p_redraw;
+	CanvasItem *ci = redraw->items[p_index];
+
+	// The item promised its drawing code only touches itself, let it pass the node thread guards.
+	bool safe_for_nodes_backup = is_current_thread_safe_for_nodes();
+	set_current_thread_safe_for_nodes(true);
+	ci->_redraw(true);
+	set_current_thread_safe_for_nodes(safe_for_nodes_backup);
+
+	redraw->finished.increment();
+	if (redraw->post_finished) {
+		threaded_redraw_semaphore.post();
+	}
+}
+
+void CanvasItem::_flush_threaded_redraws() {
+	LocalVector<ObjectID> queue;
+	{
+		MutexLock lock(threaded_redraw_mutex);
+		queue = threaded_redraw_queue;
+		threaded_redraw_queue.reset();
+	}
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	bool threaded = queue.size() >= THREADED_REDRAW_MIN_ITEMS && pool->get_thread_count() >= 2 && Thread::is_main_thread();
+
+	// Hidden items are only cleared. The visibility of the others is checked here, as it reads their parents.
+	LocalVector<CanvasItem *> items;
+	items.reserve(queue.size());
+	for (const ObjectID &id : queue) {
+		CanvasItem *ci = Object::cast_to<CanvasItem>(ObjectDB::get_instance(id));
+		if (!ci) {
+			continue;
+		}
+		if (threaded && (!ci->is_inside_tree() || !ci->is_visible_in_tree())) {
+			ci->_redraw_callback();
+		} else {
+			items.push_back(ci);
+		}
+	}
+
+	if (!threaded || items.size() < THREADED_REDRAW_MIN_ITEMS) {
+		for (CanvasItem *ci : items) {
+			ci->_redraw_callback();
+		}
+		return;
+	}
+
+	CanvasItemThreadedRedraw redraw;
+	redraw.items = items.ptr();
+
+	// Without a rendering thread, queued calls that return a value wait for the main thread to flush them.
+	// Sleep until a task queues a call or finishes, and flush the queue each time.
+	redraw.post_finished = OS::get_singleton()->get_render_thread_mode() != OS::RENDER_SEPARATE_THREAD;
+	if (redraw.post_finished) {
+		while (threaded_redraw_semaphore.try_wait()) {
+			// Posts left from the previous flush.
+		}
+		RenderingServer::get_singleton()->set_command_queued_semaphore(&threaded_redraw_semaphore);
+	}
+
+	// Each item is drawn whole by one task. Draw commands sent from worker threads are queued by the
+	// RenderingServer and replayed in order for each item, so no other synchronization is needed.
+	WorkerThreadPool::GroupID group_task = pool->add_native_group_task(&CanvasItem::_redraw_threaded, &redraw, items.size(), -1, true, SNAME("CanvasItemRedraw"));
+
+	if (redraw.post_finished) {
+		while (redraw.finished.get() < items.size()) {
+			threaded_redraw_semaphore.wait();
+			RenderingServer::get_singleton()->sync();
+		}
+		RenderingServer::get_singleton()->set_command_queued_semaphore(nullptr);
+	}
+	pool->wait_for_group_task_completion(group_task);
+}
+
 void CanvasItem::_invalidate_global_transform() {
 	_set_global_invalid(true);
 }
@@ -401,6 +496,15 @@ void CanvasItem::queue_redraw() {
 
 	pending_update = true;
 
+	if (thread_safe_draw) {
+		MutexLock lock(threaded_redraw_mutex);
+		if (threaded_redraw_queue.is_empty()) {
+			MessageQueue::get_singleton()->push_callable(callable_mp_static(&CanvasItem::_flush_threaded_redraws));
+		}
+		threaded_redraw_queue.push_back(get_instance_id());
+		return;
+	}
+
 	MessageQueue::get_singleton()->push_callable(callable_mp(this, &CanvasItem::_redraw_callback));
 }
 
@@ -987,6 +1091,16 @@ bool CanvasItem::is_draw_behind_parent_enabled() const {
 	return behind;
 }
 
+void CanvasItem::set_thread_safe_draw(bool p_enable) {
+	ERR_THREAD_GUARD;
+	thread_safe_draw = p_enable;
+}
+
+bool CanvasItem::is_thread_safe_draw_enabled() const {
+	ERR_READ_THREAD_GUARD_V(false);
+	return thread_safe_draw;
+}
+
 void CanvasItem::set_material(const Ref<Material> &p_material) {
 	ERR_THREAD_GUARD;
 	material = p_material;
@@ -1120,6 +1234,9 @@ void CanvasItem::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_draw_behind_parent", "enable"), &CanvasItem::set_draw_behind_parent);
 	ClassDB::bind_method(D_METHOD("is_draw_behind_parent_enabled"), &CanvasItem::is_draw_behind_parent_enabled);
 
+	ClassDB::bind_method(D_METHOD("set_thread_safe_draw", "enable"), &CanvasItem::set_thread_safe_draw);
+	ClassDB::bind_method(D_METHOD("is_thread_safe_draw_enabled"), &CanvasItem::is_thread_safe_draw_enabled);
+
 	ClassDB::bind_method(D_METHOD("draw_line", "from", "to", "color", "width", "antialiased"), &CanvasItem::draw_line, DEFVAL(-1.0), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("draw_dashed_line", "from", "to", "color", "width", "dash", "aligned"), &CanvasItem::draw_dashed_line, DEFVAL(-1.0), DEFVAL(2.0), DEFVAL(true));
 	ClassDB::bind_method(D_METHOD("draw_polyline", "points", "color", "width", "antialiased"), &CanvasItem::draw_polyline, DEFVAL(-1.0), DEFVAL(false));
@@ -1218,6 +1335,9 @@ void CanvasItem::_bind_methods() {
 	ADD_GROUP("Material", "");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "material", PROPERTY_HINT_RESOURCE_TYPE, "CanvasItemMaterial,ShaderMaterial"), "set_material", "get_material");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_parent_material"), "set_use_parent_material", "get_use_parent_material");
+
+	ADD_GROUP("Drawing", "");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "thread_safe_draw"), "set_thread_safe_draw", "is_thread_safe_draw_enabled");
 	// ADD_PROPERTY(PropertyInfo(Variant::BOOL,"transform/notify"),"set_transform_notify","is_transform_notify_enabled");
 
 	ADD_SIGNAL(MethodInfo("draw"));
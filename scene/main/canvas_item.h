@@ -107,6 +107,7 @@ private:
 	bool notify_local_transform = false;
 	bool notify_transform = false;
 	bool hide_clip_children = false;
+	bool thread_safe_draw = false;
 
 	ClipChildrenMode clip_children_mode = CLIP_CHILDREN_DISABLED;
 
@@ -132,6 +133,7 @@ private:
 	virtual void _top_level_changed_on_parent();
 
 	void _redraw_callback();
+	void _redraw(bool p_visible);
 	void _invalidate_global_transform();
 
 	void _enter_canvas();
@@ -141,7 +143,19 @@ private:
 
 	void _notify_transform(CanvasItem *p_node);
 
-	static CanvasItem *current_item_drawn;
+	static thread_local CanvasItem *current_item_drawn;
+
+	// Redraws of items with thread safe drawing are collected, then run together on the worker thread pool.
+	enum {
+		THREADED_REDRAW_MIN_ITEMS = 4,
+	};
+
+	static BinaryMutex threaded_redraw_mutex;
+	static LocalVector<ObjectID> threaded_redraw_queue;
+
+	static void _redraw_threaded(void *p_redraw, uint32_t p_index);
+	static void _flush_threaded_redraws();
+
 	friend class Viewport;
 	void _refresh_texture_repeat_cache() const;
 	void _update_texture_repeat_changed(bool p_propagate);
@@ -310,6 +324,9 @@ public:
 	void set_draw_behind_parent(bool p_enable);
 	bool is_draw_behind_parent_enabled() const;
 
+	void set_thread_safe_draw(bool p_enable);
+	bool is_thread_safe_draw_enabled() const;
+
 	CanvasItem *get_parent_item() const;
 
 	virtual Transform2D get_transform() const = 0;
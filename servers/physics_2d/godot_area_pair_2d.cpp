@@ -89,6 +89,14 @@ void GodotAreaPair2D::solve(real_t p_step) {
 	// Nothing to do.
 }
 
+GodotConstraint2D::OrderKey GodotAreaPair2D::get_order_key() const {
+	OrderKey key;
+	key.objects[0] = area->get_self().get_id();
+	key.objects[1] = body->get_self().get_id();
+	key.sub_key = (uint64_t(area_shape) << 32) | uint32_t(body_shape);
+	return key;
+}
+
 GodotAreaPair2D::GodotAreaPair2D(GodotBody2D *p_body, int p_body_shape, GodotArea2D *p_area, int p_area_shape) {
 	body = p_body;
 	area = p_area;
@@ -171,6 +179,22 @@ void GodotArea2Pair2D::solve(real_t p_step) {
 	// Nothing to do.
 }
 
+GodotConstraint2D::OrderKey GodotArea2Pair2D::get_order_key() const {
+	OrderKey key;
+	uint64_t id_a = area_a->get_self().get_id();
+	uint64_t id_b = area_b->get_self().get_id();
+	if (id_a < id_b) {
+		key.objects[0] = id_a;
+		key.objects[1] = id_b;
+		key.sub_key = (uint64_t(shape_a) << 32) | uint32_t(shape_b);
+	} else {
+		key.objects[0] = id_b;
+		key.objects[1] = id_a;
+		key.sub_key = (uint64_t(shape_b) << 32) | uint32_t(shape_a);
+	}
+	return key;
+}
+
 GodotArea2Pair2D::GodotArea2Pair2D(GodotArea2D *p_area_a, int p_shape_a, GodotArea2D *p_area_b, int p_shape_b) {
 	area_a = p_area_a;
 	area_b = p_area_b;
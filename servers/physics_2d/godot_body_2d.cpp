@@ -401,6 +401,9 @@ void GodotBody2D::set_space(GodotSpace2D *p_space) {
 		if (direct_state_query_list.in_list()) {
 			get_space()->body_remove_from_state_query_list(&direct_state_query_list);
 		}
+		if (ccd_list.in_list()) {
+			get_space()->body_remove_from_ccd_list(&ccd_list);
+		}
 	}
 
 	_set_space(p_space);
@@ -417,6 +420,46 @@ void GodotBody2D::_update_transform_dependent() {
 	center_of_mass = get_transform().basis_xform(center_of_mass_local);
 }
 
+void GodotBody2D::get_snapshot_state(SnapshotState &r_state) const {
+	r_state.transform = get_transform();
+	r_state.new_transform = new_transform;
+	r_state.linear_velocity = linear_velocity;
+	r_state.constant_linear_velocity = constant_linear_velocity;
+	r_state.applied_force = applied_force;
+	r_state.constant_force = constant_force;
+	r_state.angular_velocity = angular_velocity;
+	r_state.constant_angular_velocity = constant_angular_velocity;
+	r_state.applied_torque = applied_torque;
+	r_state.constant_torque = constant_torque;
+	r_state.still_time = still_time;
+	r_state.active = active;
+}
+
+void GodotBody2D::set_snapshot_state(const SnapshotState &p_state) {
+	new_transform = p_state.new_transform;
+	if (p_state.transform != get_transform()) {
+		_set_transform(p_state.transform);
+		// Same inverse as the step computes, so the restored state is bit identical.
+		if (mode > PhysicsServer2D::BODY_MODE_KINEMATIC) {
+			_set_inv_transform(get_transform().inverse());
+		} else {
+			_set_inv_transform(get_transform().affine_inverse());
+		}
+		_update_transform_dependent();
+	}
+
+	linear_velocity = p_state.linear_velocity;
+	constant_linear_velocity = p_state.constant_linear_velocity;
+	applied_force = p_state.applied_force;
+	constant_force = p_state.constant_force;
+	angular_velocity = p_state.angular_velocity;
+	constant_angular_velocity = p_state.constant_angular_velocity;
+	applied_torque = p_state.applied_torque;
+	constant_torque = p_state.constant_torque;
+	still_time = p_state.still_time;
+	set_active(p_state.active);
+}
+
 void GodotBody2D::integrate_forces(real_t p_step) {
 	if (mode == PhysicsServer2D::BODY_MODE_STATIC) {
 		return;
@@ -628,6 +671,11 @@ void GodotBody2D::integrate_velocities(real_t p_step) {
 		return;
 	}
 
+	if (continuous_cd_mode != PhysicsServer2D::CCD_MODE_DISABLED) {
+		ccd_from_transform = get_transform();
+		get_space()->body_add_to_ccd_list(&ccd_list);
+	}
+
 	real_t total_angular_velocity = angular_velocity + biased_angular_velocity;
 	Vector2 total_linear_velocity = linear_velocity + biased_linear_velocity;
 
@@ -650,6 +698,13 @@ void GodotBody2D::integrate_velocities(real_t p_step) {
 	_update_transform_dependent();
 }
 
+void GodotBody2D::set_ccd_transform(const Transform2D &p_transform) {
+	_set_transform(p_transform);
+	_set_inv_transform(get_transform().inverse());
+	new_transform = get_transform();
+	_update_transform_dependent();
+}
+
 void GodotBody2D::wakeup_neighbours() {
 	for (const Pair<GodotConstraint2D *, int> &E : constraint_list) {
 		const GodotConstraint2D *c = E.first;
@@ -746,7 +801,8 @@ GodotBody2D::GodotBody2D() :
 		GodotCollisionObject2D(TYPE_BODY),
 		active_list(this),
 		mass_properties_update_list(this),
-		direct_state_query_list(this) {
+		direct_state_query_list(this),
+		ccd_list(this) {
 	_set_static(false);
 }
 
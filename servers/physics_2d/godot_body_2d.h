@@ -95,6 +95,7 @@ class GodotBody2D : public GodotCollisionObject2D {
 	SelfList<GodotBody2D> active_list;
 	SelfList<GodotBody2D> mass_properties_update_list;
 	SelfList<GodotBody2D> direct_state_query_list;
+	SelfList<GodotBody2D> ccd_list;
 
 	VSet<RID> exceptions;
 	PhysicsServer2D::CCDMode continuous_cd_mode = PhysicsServer2D::CCD_MODE_DISABLED;
@@ -105,6 +106,7 @@ class GodotBody2D : public GodotCollisionObject2D {
 	void _mass_properties_changed();
 	virtual void _shapes_changed() override;
 	Transform2D new_transform;
+	Transform2D ccd_from_transform;
 
 	List<Pair<GodotConstraint2D *, int>> constraint_list;
 
@@ -151,12 +153,34 @@ class GodotBody2D : public GodotCollisionObject2D {
 	GodotPhysicsDirectBodyState2D *direct_state = nullptr;
 
 	uint64_t island_step = 0;
+	uint64_t solver_color_mask = 0;
+	uint64_t solver_step = 0;
+	uint32_t solver_index = 0;
 
 	void _update_transform_dependent();
 
 	friend class GodotPhysicsDirectBodyState2D; // i give up, too many functions to expose
 
 public:
+	// Simulation state saved in space snapshots, the body settings aren't part of it.
+	struct SnapshotState {
+		Transform2D transform;
+		Transform2D new_transform;
+		Vector2 linear_velocity;
+		Vector2 constant_linear_velocity;
+		Vector2 applied_force;
+		Vector2 constant_force;
+		real_t angular_velocity = 0.0;
+		real_t constant_angular_velocity = 0.0;
+		real_t applied_torque = 0.0;
+		real_t constant_torque = 0.0;
+		real_t still_time = 0.0;
+		bool active = false;
+	};
+
+	void get_snapshot_state(SnapshotState &r_state) const;
+	void set_snapshot_state(const SnapshotState &p_state);
+
 	void set_state_sync_callback(const Callable &p_callable);
 	void set_force_integration_callback(const Callable &p_callable, const Variant &p_udata = Variant());
 
@@ -202,6 +226,15 @@ public:
 	_FORCE_INLINE_ uint64_t get_island_step() const { return island_step; }
 	_FORCE_INLINE_ void set_island_step(uint64_t p_step) { island_step = p_step; }
 
+	_FORCE_INLINE_ uint64_t get_solver_color_mask() const { return solver_color_mask; }
+	_FORCE_INLINE_ void set_solver_color_mask(uint64_t p_mask) { solver_color_mask = p_mask; }
+
+	_FORCE_INLINE_ uint64_t get_solver_step() const { return solver_step; }
+	_FORCE_INLINE_ void set_solver_step(uint64_t p_step) { solver_step = p_step; }
+
+	_FORCE_INLINE_ uint32_t get_solver_index() const { return solver_index; }
+	_FORCE_INLINE_ void set_solver_index(uint32_t p_index) { solver_index = p_index; }
+
 	_FORCE_INLINE_ void add_constraint(GodotConstraint2D *p_constraint, int p_pos) { constraint_list.push_back({ p_constraint, p_pos }); }
 	_FORCE_INLINE_ void remove_constraint(GodotConstraint2D *p_constraint, int p_pos) { constraint_list.erase({ p_constraint, p_pos }); }
 	const List<Pair<GodotConstraint2D *, int>> &get_constraint_list() const { return constraint_list; }
@@ -303,6 +336,10 @@ public:
 	_FORCE_INLINE_ void set_continuous_collision_detection_mode(PhysicsServer2D::CCDMode p_mode) { continuous_cd_mode = p_mode; }
 	_FORCE_INLINE_ PhysicsServer2D::CCDMode get_continuous_collision_detection_mode() const { return continuous_cd_mode; }
 
+	// Transform at the start of the last velocity integration, for bodies with continuous collision detection.
+	_FORCE_INLINE_ const Transform2D &get_ccd_from_transform() const { return ccd_from_transform; }
+	void set_ccd_transform(const Transform2D &p_transform);
+
 	void set_space(GodotSpace2D *p_space) override;
 
 	void update_mass_properties();
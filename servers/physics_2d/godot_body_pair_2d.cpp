@@ -31,6 +31,7 @@
 #include "godot_body_pair_2d.h"
 
 #include "godot_collision_solver_2d.h"
+#include "godot_simd_2d.h"
 #include "godot_space_2d.h"
 
 #define ACCUMULATE_IMPULSES
@@ -119,6 +120,82 @@ void GodotBodyPair2D::_contact_added_callback(const Vector2 &p_point_A, const Ve
 	contact_count++;
 }
 
+void GodotBodyPair2D::_store_cached_contacts() const {
+	GodotSpace2D::CachedContactManifold manifold;
+	save_snapshot_state(reinterpret_cast<uint8_t *>(&manifold));
+
+	// The manifold is in RID order, like the cache keys.
+	if (B->get_self() < A->get_self()) {
+		space->contact_cache_store(B, shape_B, A, shape_A, manifold);
+	} else {
+		space->contact_cache_store(A, shape_A, B, shape_B, manifold);
+	}
+}
+
+void GodotBodyPair2D::_restore_cached_contacts() {
+	GodotSpace2D::CachedContactManifold manifold;
+	bool swapped = B->get_self() < A->get_self();
+	if (!space->contact_cache_take(swapped ? B : A, swapped ? shape_B : shape_A, swapped ? A : B, swapped ? shape_A : shape_B, manifold)) {
+		return;
+	}
+
+	restore_snapshot_state(reinterpret_cast<const uint8_t *>(&manifold));
+}
+
+uint32_t GodotBodyPair2D::get_snapshot_state_size() const {
+	return sizeof(GodotSpace2D::CachedContactManifold);
+}
+
+void GodotBodyPair2D::save_snapshot_state(uint8_t *r_state) const {
+	static_assert((int)MAX_CONTACTS <= (int)GodotSpace2D::CONTACT_CACHE_MAX_CONTACTS);
+
+	// Contacts are saved from the point of view of the body with the lowest RID, like the order key.
+	bool swapped = B->get_self() < A->get_self();
+
+	// Zeroed so the padding and the unused contacts of the saved bytes don't depend on the memory.
+	GodotSpace2D::CachedContactManifold manifold;
+	memset((void *)&manifold, 0, sizeof(manifold));
+	for (int i = 0; i < contact_count; i++) {
+		const Contact &c = contacts[i];
+		GodotSpace2D::CachedContact &cached = manifold.contacts[manifold.contact_count++];
+		cached.local_A = swapped ? c.local_B : c.local_A;
+		cached.local_B = swapped ? c.local_A : c.local_B;
+		cached.normal = swapped ? -c.normal : c.normal;
+		cached.acc_normal_impulse = c.acc_normal_impulse;
+		cached.acc_tangent_impulse = c.acc_tangent_impulse;
+		cached.acc_bias_impulse = c.acc_bias_impulse;
+		cached.acc_bias_impulse_center_of_mass = c.acc_bias_impulse_center_of_mass;
+	}
+
+	memcpy(r_state, &manifold, sizeof(manifold));
+}
+
+void GodotBodyPair2D::restore_snapshot_state(const uint8_t *p_state) {
+	contact_count = 0;
+	if (!p_state) {
+		return;
+	}
+
+	GodotSpace2D::CachedContactManifold manifold;
+	memcpy(&manifold, p_state, sizeof(manifold));
+	bool swapped = B->get_self() < A->get_self();
+
+	// Restored contacts go through _validate_contacts() like the ones from the previous step,
+	// new contacts within the recycle radius then inherit their accumulated impulses.
+	for (int i = 0; i < MIN(manifold.contact_count, (int)MAX_CONTACTS); i++) {
+		const GodotSpace2D::CachedContact &cached = manifold.contacts[i];
+		Contact &c = contacts[contact_count++];
+		c.local_A = swapped ? cached.local_B : cached.local_A;
+		c.local_B = swapped ? cached.local_A : cached.local_B;
+		c.normal = swapped ? -cached.normal : cached.normal;
+		c.acc_normal_impulse = cached.acc_normal_impulse;
+		c.acc_tangent_impulse = cached.acc_tangent_impulse;
+		c.acc_bias_impulse = cached.acc_bias_impulse;
+		c.acc_bias_impulse_center_of_mass = cached.acc_bias_impulse_center_of_mass;
+		c.used = true;
+	}
+}
+
 void GodotBodyPair2D::_validate_contacts() {
 	// Make sure to erase contacts that are no longer valid.
 	real_t max_separation = space->get_contact_max_separation();
@@ -161,82 +238,6 @@ void GodotBodyPair2D::_validate_contacts() {
 	}
 }
 
-// _test_ccd prevents tunneling by slowing down a high velocity body that is about to collide so that next frame it will be at an appropriate location to collide (i.e. slight overlap)
-// Warning: the way velocity is adjusted down to cause a collision means the momentum will be weaker than it should for a bounce!
-// Process: only proceed if body A's motion is high relative to its size.
-// cast forward along motion vector to see if A is going to enter/pass B's collider next frame, only proceed if it does.
-// adjust the velocity of A down so that it will just slightly intersect the collider instead of blowing right past it.
-bool GodotBodyPair2D::_test_ccd(real_t p_step, GodotBody2D *p_A, int p_shape_A, const Transform2D &p_xform_A, GodotBody2D *p_B, int p_shape_B, const Transform2D &p_xform_B) {
-	Vector2 motion = p_A->get_linear_velocity() * p_step;
-	real_t mlen = motion.length();
-	if (mlen < CMP_EPSILON) {
-		return false;
-	}
-
-	Vector2 mnormal = motion / mlen;
-
-	real_t min = 0.0, max = 0.0;
-	p_A->get_shape(p_shape_A)->project_rangev(mnormal, p_xform_A, min, max);
-
-	// Did it move enough in this direction to even attempt raycast?
-	// Let's say it should move more than 1/3 the size of the object in that axis.
-	bool fast_object = mlen > (max - min) * 0.3;
-	if (!fast_object) {
-		return false;
-	}
-
-	// A is moving fast enough that tunneling might occur. See if it's really about to collide.
-
-	// Roughly predict body B's position in the next frame (ignoring collisions).
-	Transform2D predicted_xform_B = p_xform_B.translated(p_B->get_linear_velocity() * p_step);
-
-	// Cast a segment from support in motion normal, in the same direction of motion by motion length.
-	// Support point will the farthest forward collision point along the movement vector.
-	// i.e. the point that should hit B first if any collision does occur.
-
-	// convert mnormal into body A's local xform because get_support requires (and returns) local coordinates.
-	int a;
-	Vector2 s[2];
-	p_A->get_shape(p_shape_A)->get_supports(p_xform_A.basis_xform_inv(mnormal).normalized(), s, a);
-	Vector2 from = p_xform_A.xform(s[0]);
-	// Back up 10% of the per-frame motion behind the support point and use that as the beginning of our cast.
-	// This should ensure the calculated new velocity will really cause a bit of overlap instead of just getting us very close.
-	Vector2 to = from + motion;
-
-	Transform2D from_inv = predicted_xform_B.affine_inverse();
-
-	// Back up 10% of the per-frame motion behind the support point and use that as the beginning of our cast.
-	// At high speeds, this may mean we're actually casting from well behind the body instead of inside it, which is odd. But it still works out.
-	Vector2 local_from = from_inv.xform(from - motion * 0.1);
-	Vector2 local_to = from_inv.xform(to);
-
-	Vector2 rpos, rnorm;
-	if (!p_B->get_shape(p_shape_B)->intersect_segment(local_from, local_to, rpos, rnorm)) {
-		// there was no hit. Since the segment is the length of per-frame motion, this means the bodies will not
-		// actually collide yet on next frame. We'll probably check again next frame once they're closer.
-		return false;
-	}
-
-	// Check one-way collision based on motion direction.
-	if (p_A->get_shape(p_shape_A)->allows_one_way_collision() && p_B->is_shape_set_as_one_way_collision(p_shape_B)) {
-		Vector2 direction = predicted_xform_B.columns[1].normalized();
-		if (direction.dot(mnormal) < CMP_EPSILON) {
-			collided = false;
-			oneway_disabled = true;
-			return false;
-		}
-	}
-
-	// Shorten the linear velocity so it does not hit, but gets close enough,
-	// next frame will hit softly or soft enough.
-	Vector2 hitpos = predicted_xform_B.xform(rpos);
-
-	real_t newlen = hitpos.distance_to(from) + (max - min) * 0.01; // adding 1% of body length to the distance between collision and support point should cause body A's support point to arrive just within B's collider next frame.
-	p_A->set_linear_velocity(mnormal * (newlen / p_step));
-
-	return true;
-}
-
 real_t combine_bounce(GodotBody2D *A, GodotBody2D *B) {
 	return CLAMP(A->get_bounce() + B->get_bounce(), 0, 1);
 }
@@ -246,8 +247,6 @@ real_t combine_friction(GodotBody2D *A, GodotBody2D *B) {
 }
 
 bool GodotBodyPair2D::setup(real_t p_step) {
-	check_ccd = false;
-
 	if (!A->interacts_with(B) || A->has_exception(B->get_self()) || B->has_exception(A->get_self())) {
 		collided = false;
 		return false;
@@ -296,17 +295,6 @@ bool GodotBodyPair2D::setup(real_t p_step) {
 	collided = GodotCollisionSolver2D::solve(shape_A_ptr, xform_A, motion_A, shape_B_ptr, xform_B, motion_B, _add_contact, this, &sep_axis);
 	if (!collided) {
 		oneway_disabled = false;
-
-		if (A->get_continuous_collision_detection_mode() == PhysicsServer2D::CCD_MODE_CAST_RAY && collide_A) {
-			check_ccd = true;
-			return true;
-		}
-
-		if (B->get_continuous_collision_detection_mode() == PhysicsServer2D::CCD_MODE_CAST_RAY && collide_B) {
-			check_ccd = true;
-			return true;
-		}
-
 		return false;
 	}
 
@@ -361,24 +349,6 @@ bool GodotBodyPair2D::pre_solve(real_t p_step) {
 	}
 
 	if (!collided) {
-		if (check_ccd) {
-			const Vector2 &offset_A = A->get_transform().get_origin();
-			Transform2D xform_Au = A->get_transform().untranslated();
-			Transform2D xform_A = xform_Au * A->get_shape_transform(shape_A);
-
-			Transform2D xform_Bu = B->get_transform();
-			xform_Bu.columns[2] -= offset_A;
-			Transform2D xform_B = xform_Bu * B->get_shape_transform(shape_B);
-
-			if (A->get_continuous_collision_detection_mode() == PhysicsServer2D::CCD_MODE_CAST_RAY && collide_A) {
-				_test_ccd(p_step, A, shape_A, xform_A, B, shape_B, xform_B);
-			}
-
-			if (B->get_continuous_collision_detection_mode() == PhysicsServer2D::CCD_MODE_CAST_RAY && collide_B) {
-				_test_ccd(p_step, B, shape_B, xform_B, A, shape_A, xform_A);
-			}
-		}
-
 		return false;
 	}
 
@@ -413,6 +383,8 @@ bool GodotBodyPair2D::pre_solve(real_t p_step) {
 	real_t inv_mass_A = collide_A ? A->get_inv_mass() : 0.0;
 	real_t inv_mass_B = collide_B ? B->get_inv_mass() : 0.0;
 
+	friction = combine_friction(A, B);
+
 	for (int i = 0; i < contact_count; i++) {
 		Contact &c = contacts[i];
 		c.active = false;
@@ -508,8 +480,12 @@ void GodotBodyPair2D::solve(real_t p_step) {
 
 	const real_t max_bias_av = MAX_BIAS_ROTATION / p_step;
 
-	real_t inv_mass_A = collide_A ? A->get_inv_mass() : 0.0;
-	real_t inv_mass_B = collide_B ? B->get_inv_mass() : 0.0;
+	GodotSolverBodies2D &bodies = get_solver_bodies();
+	const uint32_t index_A = get_solver_body_index(0);
+	const uint32_t index_B = get_solver_body_index(1);
+
+	real_t inv_mass_A = collide_A ? bodies.inv_mass[index_A] : 0.0;
+	real_t inv_mass_B = collide_B ? bodies.inv_mass[index_B] : 0.0;
 
 	for (int i = 0; i < contact_count; ++i) {
 		Contact &c = contacts[i];
@@ -520,13 +496,8 @@ void GodotBodyPair2D::solve(real_t p_step) {
 
 		// Relative velocity at contact
 
-		Vector2 crA(-A->get_angular_velocity() * c.rA.y, A->get_angular_velocity() * c.rA.x);
-		Vector2 crB(-B->get_angular_velocity() * c.rB.y, B->get_angular_velocity() * c.rB.x);
-		Vector2 dv = B->get_linear_velocity() + crB - A->get_linear_velocity() - crA;
-
-		Vector2 crbA(-A->get_biased_angular_velocity() * c.rA.y, A->get_biased_angular_velocity() * c.rA.x);
-		Vector2 crbB(-B->get_biased_angular_velocity() * c.rB.y, B->get_biased_angular_velocity() * c.rB.x);
-		Vector2 dbv = B->get_biased_linear_velocity() + crbB - A->get_biased_linear_velocity() - crbA;
+		Vector2 dv = bodies.get_velocity_at(index_B, c.rB) - bodies.get_velocity_at(index_A, c.rA);
+		Vector2 dbv = bodies.get_biased_velocity_at(index_B, c.rB) - bodies.get_biased_velocity_at(index_A, c.rA);
 
 		real_t vn = dv.dot(c.normal);
 		real_t vbn = dbv.dot(c.normal);
@@ -541,15 +512,13 @@ void GodotBodyPair2D::solve(real_t p_step) {
 		Vector2 jb = c.normal * (c.acc_bias_impulse - jbnOld);
 
 		if (collide_A) {
-			A->apply_bias_impulse(-jb, c.rA + A->get_center_of_mass(), max_bias_av);
+			bodies.apply_bias_impulse(index_A, -jb, c.rA, max_bias_av);
 		}
 		if (collide_B) {
-			B->apply_bias_impulse(jb, c.rB + B->get_center_of_mass(), max_bias_av);
+			bodies.apply_bias_impulse(index_B, jb, c.rB, max_bias_av);
 		}
 
-		crbA = Vector2(-A->get_biased_angular_velocity() * c.rA.y, A->get_biased_angular_velocity() * c.rA.x);
-		crbB = Vector2(-B->get_biased_angular_velocity() * c.rB.y, B->get_biased_angular_velocity() * c.rB.x);
-		dbv = B->get_biased_linear_velocity() + crbB - A->get_biased_linear_velocity() - crbA;
+		dbv = bodies.get_biased_velocity_at(index_B, c.rB) - bodies.get_biased_velocity_at(index_A, c.rA);
 
 		vbn = dbv.dot(c.normal);
 
@@ -561,10 +530,10 @@ void GodotBodyPair2D::solve(real_t p_step) {
 			Vector2 jb_com = c.normal * (c.acc_bias_impulse_center_of_mass - jbnOld_com);
 
 			if (collide_A) {
-				A->apply_bias_impulse(-jb_com, A->get_center_of_mass(), 0.0f);
+				bodies.apply_bias_impulse(index_A, -jb_com, Vector2(), 0.0f);
 			}
 			if (collide_B) {
-				B->apply_bias_impulse(jb_com, B->get_center_of_mass(), 0.0f);
+				bodies.apply_bias_impulse(index_B, jb_com, Vector2(), 0.0f);
 			}
 		}
 
@@ -572,8 +541,6 @@ void GodotBodyPair2D::solve(real_t p_step) {
 		real_t jnOld = c.acc_normal_impulse;
 		c.acc_normal_impulse = MAX(jnOld + jn, 0.0f);
 
-		real_t friction = combine_friction(A, B);
-
 		real_t jtMax = friction * c.acc_normal_impulse;
 		real_t jt = -vt * c.mass_tangent;
 		real_t jtOld = c.acc_tangent_impulse;
@@ -582,15 +549,287 @@ void GodotBodyPair2D::solve(real_t p_step) {
 		Vector2 j = c.normal * (c.acc_normal_impulse - jnOld) + tangent * (c.acc_tangent_impulse - jtOld);
 
 		if (collide_A) {
-			A->apply_impulse(-j, c.rA + A->get_center_of_mass());
+			bodies.apply_impulse(index_A, -j, c.rA);
 		}
 		if (collide_B) {
-			B->apply_impulse(j, c.rB + B->get_center_of_mass());
+			bodies.apply_impulse(index_B, j, c.rB);
 		}
 		c.acc_impulse -= j;
 	}
 }
 
+void GodotBodyPair2D::pack(GodotBodyPair2D *const *p_pairs, PackedGroup &r_group) {
+	const GodotSolverBodies2D &bodies = p_pairs[0]->get_solver_bodies();
+
+	r_group.contact_count = 0;
+
+	for (int lane = 0; lane < PACKED_WIDTH; lane++) {
+		GodotBodyPair2D *pair = p_pairs[lane];
+		r_group.pairs[lane] = pair;
+
+		const uint32_t index_A = pair->get_solver_body_index(0);
+		const uint32_t index_B = pair->get_solver_body_index(1);
+		r_group.index_A[lane] = index_A;
+		r_group.index_B[lane] = index_B;
+
+		// Bodies that don't collide are never pushed, a null inverse mass has the same effect.
+		r_group.inv_mass_A[lane] = pair->collide_A ? bodies.inv_mass[index_A] : 0.0;
+		r_group.inv_mass_B[lane] = pair->collide_B ? bodies.inv_mass[index_B] : 0.0;
+		r_group.inv_inertia_A[lane] = pair->collide_A ? bodies.inv_inertia[index_A] : 0.0;
+		r_group.inv_inertia_B[lane] = pair->collide_B ? bodies.inv_inertia[index_B] : 0.0;
+
+		real_t inv_mass_sum = r_group.inv_mass_A[lane] + r_group.inv_mass_B[lane];
+		r_group.inv_mass_sum_rcp[lane] = inv_mass_sum > 0.0 ? 1.0 / inv_mass_sum : 0.0;
+		r_group.friction[lane] = pair->friction;
+
+		r_group.contact_count = MAX(r_group.contact_count, pair->contact_count);
+
+		for (int i = 0; i < MAX_CONTACTS; i++) {
+			PackedContacts &packed = r_group.contacts[i];
+
+			if (i >= pair->contact_count || !pair->contacts[i].active) {
+				// A null normal makes all the impulses of this lane null.
+				packed.normal_x[lane] = 0.0;
+				packed.normal_y[lane] = 0.0;
+				packed.rA_x[lane] = 0.0;
+				packed.rA_y[lane] = 0.0;
+				packed.rB_x[lane] = 0.0;
+				packed.rB_y[lane] = 0.0;
+				packed.mass_normal[lane] = 0.0;
+				packed.mass_tangent[lane] = 0.0;
+				packed.bias[lane] = 0.0;
+				packed.bounce[lane] = 0.0;
+				packed.acc_normal_impulse[lane] = 0.0;
+				packed.acc_tangent_impulse[lane] = 0.0;
+				packed.acc_bias_impulse[lane] = 0.0;
+				packed.acc_bias_impulse_center_of_mass[lane] = 0.0;
+				packed.acc_impulse_x[lane] = 0.0;
+				packed.acc_impulse_y[lane] = 0.0;
+				continue;
+			}
+
+			const Contact &c = pair->contacts[i];
+			packed.normal_x[lane] = c.normal.x;
+			packed.normal_y[lane] = c.normal.y;
+			packed.rA_x[lane] = c.rA.x;
+			packed.rA_y[lane] = c.rA.y;
+			packed.rB_x[lane] = c.rB.x;
+			packed.rB_y[lane] = c.rB.y;
+			packed.mass_normal[lane] = c.mass_normal;
+			packed.mass_tangent[lane] = c.mass_tangent;
+			packed.bias[lane] = c.bias;
+			packed.bounce[lane] = c.bounce;
+			packed.acc_normal_impulse[lane] = c.acc_normal_impulse;
+			packed.acc_tangent_impulse[lane] = c.acc_tangent_impulse;
+			packed.acc_bias_impulse[lane] = c.acc_bias_impulse;
+			packed.acc_bias_impulse_center_of_mass[lane] = c.acc_bias_impulse_center_of_mass;
+			packed.acc_impulse_x[lane] = c.acc_impulse.x;
+			packed.acc_impulse_y[lane] = c.acc_impulse.y;
+		}
+	}
+}
+
+void GodotBodyPair2D::solve_packed(PackedGroup &p_group, real_t p_step) {
+	GodotSolverBodies2D &bodies = p_group.pairs[0]->get_solver_bodies();
+
+	real_t lane_data[12][PACKED_WIDTH];
+	for (int lane = 0; lane < PACKED_WIDTH; lane++) {
+		const uint32_t index_A = p_group.index_A[lane];
+		const uint32_t index_B = p_group.index_B[lane];
+		lane_data[0][lane] = bodies.linear_velocity[index_A].x;
+		lane_data[1][lane] = bodies.linear_velocity[index_A].y;
+		lane_data[2][lane] = bodies.angular_velocity[index_A];
+		lane_data[3][lane] = bodies.biased_linear_velocity[index_A].x;
+		lane_data[4][lane] = bodies.biased_linear_velocity[index_A].y;
+		lane_data[5][lane] = bodies.biased_angular_velocity[index_A];
+		lane_data[6][lane] = bodies.linear_velocity[index_B].x;
+		lane_data[7][lane] = bodies.linear_velocity[index_B].y;
+		lane_data[8][lane] = bodies.angular_velocity[index_B];
+		lane_data[9][lane] = bodies.biased_linear_velocity[index_B].x;
+		lane_data[10][lane] = bodies.biased_linear_velocity[index_B].y;
+		lane_data[11][lane] = bodies.biased_angular_velocity[index_B];
+	}
+
+	GodotReal4 lv_A_x = GodotReal4::load(lane_data[0]);
+	GodotReal4 lv_A_y = GodotReal4::load(lane_data[1]);
+	GodotReal4 av_A = GodotReal4::load(lane_data[2]);
+	GodotReal4 blv_A_x = GodotReal4::load(lane_data[3]);
+	GodotReal4 blv_A_y = GodotReal4::load(lane_data[4]);
+	GodotReal4 bav_A = GodotReal4::load(lane_data[5]);
+	GodotReal4 lv_B_x = GodotReal4::load(lane_data[6]);
+	GodotReal4 lv_B_y = GodotReal4::load(lane_data[7]);
+	GodotReal4 av_B = GodotReal4::load(lane_data[8]);
+	GodotReal4 blv_B_x = GodotReal4::load(lane_data[9]);
+	GodotReal4 blv_B_y = GodotReal4::load(lane_data[10]);
+	GodotReal4 bav_B = GodotReal4::load(lane_data[11]);
+
+	const GodotReal4 inv_mass_A = GodotReal4::load(p_group.inv_mass_A);
+	const GodotReal4 inv_mass_B = GodotReal4::load(p_group.inv_mass_B);
+	const GodotReal4 inv_inertia_A = GodotReal4::load(p_group.inv_inertia_A);
+	const GodotReal4 inv_inertia_B = GodotReal4::load(p_group.inv_inertia_B);
+	const GodotReal4 inv_mass_sum_rcp = GodotReal4::load(p_group.inv_mass_sum_rcp);
+	const GodotReal4 friction = GodotReal4::load(p_group.friction);
+
+	const GodotReal4 zero(0.0);
+	const GodotReal4 min_velocity(MIN_VELOCITY);
+	const GodotReal4 max_bias_av(MAX_BIAS_ROTATION / p_step);
+
+	for (int i = 0; i < p_group.contact_count; i++) {
+		PackedContacts &c = p_group.contacts[i];
+
+		const GodotReal4 n_x = GodotReal4::load(c.normal_x);
+		const GodotReal4 n_y = GodotReal4::load(c.normal_y);
+		const GodotReal4 rA_x = GodotReal4::load(c.rA_x);
+		const GodotReal4 rA_y = GodotReal4::load(c.rA_y);
+		const GodotReal4 rB_x = GodotReal4::load(c.rB_x);
+		const GodotReal4 rB_y = GodotReal4::load(c.rB_y);
+		const GodotReal4 bias = GodotReal4::load(c.bias);
+		const GodotReal4 mass_normal = GodotReal4::load(c.mass_normal);
+
+		// Relative velocity at contact, same as GodotBodyPair2D::solve().
+
+		GodotReal4 dv_x = (lv_B_x - av_B * rB_y) - (lv_A_x - av_A * rA_y);
+		GodotReal4 dv_y = (lv_B_y + av_B * rB_x) - (lv_A_y + av_A * rA_x);
+		GodotReal4 dbv_x = (blv_B_x - bav_B * rB_y) - (blv_A_x - bav_A * rA_y);
+		GodotReal4 dbv_y = (blv_B_y + bav_B * rB_x) - (blv_A_y + bav_A * rA_x);
+
+		GodotReal4 vn = dv_x * n_x + dv_y * n_y;
+		GodotReal4 vbn = dbv_x * n_x + dbv_y * n_y;
+
+		// Tangent is the normal's orthogonal, (n.y, -n.x).
+		GodotReal4 vt = dv_x * n_y - dv_y * n_x;
+
+		GodotReal4 jbn = (bias - vbn) * mass_normal;
+		GodotReal4 jbn_old = GodotReal4::load(c.acc_bias_impulse);
+		GodotReal4 acc_bias = GodotReal4::max(jbn_old + jbn, zero);
+		acc_bias.store(c.acc_bias_impulse);
+
+		GodotReal4 jbn_delta = acc_bias - jbn_old;
+		GodotReal4 jb_x = n_x * jbn_delta;
+		GodotReal4 jb_y = n_y * jbn_delta;
+
+		blv_A_x = blv_A_x - jb_x * inv_mass_A;
+		blv_A_y = blv_A_y - jb_y * inv_mass_A;
+		bav_A = bav_A + GodotReal4::min(inv_inertia_A * (rA_y * jb_x - rA_x * jb_y), max_bias_av);
+		blv_B_x = blv_B_x + jb_x * inv_mass_B;
+		blv_B_y = blv_B_y + jb_y * inv_mass_B;
+		bav_B = bav_B + GodotReal4::min(inv_inertia_B * (rB_x * jb_y - rB_y * jb_x), max_bias_av);
+
+		dbv_x = (blv_B_x - bav_B * rB_y) - (blv_A_x - bav_A * rA_y);
+		dbv_y = (blv_B_y + bav_B * rB_x) - (blv_A_y + bav_A * rA_x);
+		vbn = dbv_x * n_x + dbv_y * n_y;
+
+		GodotReal4 bias_error = bias - vbn;
+		GodotReal4 jbn_com_old = GodotReal4::load(c.acc_bias_impulse_center_of_mass);
+		GodotReal4 acc_bias_com = GodotReal4::max(jbn_com_old + bias_error * inv_mass_sum_rcp, zero);
+		acc_bias_com = GodotReal4::select_greater(GodotReal4::abs(bias_error), min_velocity, acc_bias_com, jbn_com_old);
+		acc_bias_com.store(c.acc_bias_impulse_center_of_mass);
+
+		GodotReal4 jbn_com_delta = acc_bias_com - jbn_com_old;
+		GodotReal4 jb_com_x = n_x * jbn_com_delta;
+		GodotReal4 jb_com_y = n_y * jbn_com_delta;
+
+		blv_A_x = blv_A_x - jb_com_x * inv_mass_A;
+		blv_A_y = blv_A_y - jb_com_y * inv_mass_A;
+		blv_B_x = blv_B_x + jb_com_x * inv_mass_B;
+		blv_B_y = blv_B_y + jb_com_y * inv_mass_B;
+
+		GodotReal4 jn = -(GodotReal4::load(c.bounce) + vn) * mass_normal;
+		GodotReal4 jn_old = GodotReal4::load(c.acc_normal_impulse);
+		GodotReal4 acc_normal = GodotReal4::max(jn_old + jn, zero);
+		acc_normal.store(c.acc_normal_impulse);
+
+		GodotReal4 jt_max = friction * acc_normal;
+		GodotReal4 jt = -vt * GodotReal4::load(c.mass_tangent);
+		GodotReal4 jt_old = GodotReal4::load(c.acc_tangent_impulse);
+		GodotReal4 acc_tangent = GodotReal4::clamp(jt_old + jt, -jt_max, jt_max);
+		acc_tangent.store(c.acc_tangent_impulse);
+
+		GodotReal4 jn_delta = acc_normal - jn_old;
+		GodotReal4 jt_delta = acc_tangent - jt_old;
+		GodotReal4 j_x = n_x * jn_delta + n_y * jt_delta;
+		GodotReal4 j_y = n_y * jn_delta - n_x * jt_delta;
+
+		lv_A_x = lv_A_x - j_x * inv_mass_A;
+		lv_A_y = lv_A_y - j_y * inv_mass_A;
+		av_A = av_A + inv_inertia_A * (rA_y * j_x - rA_x * j_y);
+		lv_B_x = lv_B_x + j_x * inv_mass_B;
+		lv_B_y = lv_B_y + j_y * inv_mass_B;
+		av_B = av_B + inv_inertia_B * (rB_x * j_y - rB_y * j_x);
+
+		(GodotReal4::load(c.acc_impulse_x) - j_x).store(c.acc_impulse_x);
+		(GodotReal4::load(c.acc_impulse_y) - j_y).store(c.acc_impulse_y);
+	}
+
+	lv_A_x.store(lane_data[0]);
+	lv_A_y.store(lane_data[1]);
+	av_A.store(lane_data[2]);
+	blv_A_x.store(lane_data[3]);
+	blv_A_y.store(lane_data[4]);
+	bav_A.store(lane_data[5]);
+	lv_B_x.store(lane_data[6]);
+	lv_B_y.store(lane_data[7]);
+	av_B.store(lane_data[8]);
+	blv_B_x.store(lane_data[9]);
+	blv_B_y.store(lane_data[10]);
+	bav_B.store(lane_data[11]);
+
+	// Static and kinematic bodies can be shared between lanes and groups, only write dynamic ones.
+	for (int lane = 0; lane < PACKED_WIDTH; lane++) {
+		const GodotBodyPair2D *pair = p_group.pairs[lane];
+		if (pair->collide_A) {
+			const uint32_t index_A = p_group.index_A[lane];
+			bodies.linear_velocity[index_A] = Vector2(lane_data[0][lane], lane_data[1][lane]);
+			bodies.angular_velocity[index_A] = lane_data[2][lane];
+			bodies.biased_linear_velocity[index_A] = Vector2(lane_data[3][lane], lane_data[4][lane]);
+			bodies.biased_angular_velocity[index_A] = lane_data[5][lane];
+		}
+		if (pair->collide_B) {
+			const uint32_t index_B = p_group.index_B[lane];
+			bodies.linear_velocity[index_B] = Vector2(lane_data[6][lane], lane_data[7][lane]);
+			bodies.angular_velocity[index_B] = lane_data[8][lane];
+			bodies.biased_linear_velocity[index_B] = Vector2(lane_data[9][lane], lane_data[10][lane]);
+			bodies.biased_angular_velocity[index_B] = lane_data[11][lane];
+		}
+	}
+}
+
+void GodotBodyPair2D::unpack(const PackedGroup &p_group) {
+	for (int lane = 0; lane < PACKED_WIDTH; lane++) {
+		GodotBodyPair2D *pair = p_group.pairs[lane];
+
+		for (int i = 0; i < pair->contact_count; i++) {
+			Contact &c = pair->contacts[i];
+			if (!c.active) {
+				continue;
+			}
+
+			const PackedContacts &packed = p_group.contacts[i];
+			c.acc_normal_impulse = packed.acc_normal_impulse[lane];
+			c.acc_tangent_impulse = packed.acc_tangent_impulse[lane];
+			c.acc_bias_impulse = packed.acc_bias_impulse[lane];
+			c.acc_bias_impulse_center_of_mass = packed.acc_bias_impulse_center_of_mass[lane];
+			c.acc_impulse = Vector2(packed.acc_impulse_x[lane], packed.acc_impulse_y[lane]);
+		}
+	}
+}
+
+GodotConstraint2D::OrderKey GodotBodyPair2D::get_order_key() const {
+	OrderKey key;
+	uint64_t id_A = A->get_self().get_id();
+	uint64_t id_B = B->get_self().get_id();
+	if (id_A < id_B) {
+		key.objects[0] = id_A;
+		key.objects[1] = id_B;
+		key.sub_key = (uint64_t(shape_A) << 32) | uint32_t(shape_B);
+	} else {
+		key.objects[0] = id_B;
+		key.objects[1] = id_A;
+		key.sub_key = (uint64_t(shape_B) << 32) | uint32_t(shape_A);
+	}
+	return key;
+}
+
 GodotBodyPair2D::GodotBodyPair2D(GodotBody2D *p_A, int p_shape_A, GodotBody2D *p_B, int p_shape_B) :
 		GodotConstraint2D(_arr, 2) {
 	A = p_A;
@@ -600,9 +839,18 @@ GodotBodyPair2D::GodotBodyPair2D(GodotBody2D *p_A, int p_shape_A, GodotBody2D *p
 	space = A->get_space();
 	A->add_constraint(this, 0);
 	B->add_constraint(this, 1);
+
+	if (space->has_cached_contacts()) {
+		_restore_cached_contacts();
+	}
 }
 
 GodotBodyPair2D::~GodotBodyPair2D() {
+	// Only bodies that stop touching can touch again, not removed bodies or shapes.
+	if (contact_count > 0 && space->get_contact_cache_steps() > 0 && !space->is_broadphase_removing()) {
+		_store_cached_contacts();
+	}
+
 	A->remove_constraint(this, 0);
 	B->remove_constraint(this, 1);
 }
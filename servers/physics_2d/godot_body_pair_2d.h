@@ -79,23 +79,78 @@ class GodotBodyPair2D : public GodotConstraint2D {
 	Vector2 sep_axis;
 	Contact contacts[MAX_CONTACTS];
 	int contact_count = 0;
+	real_t friction = 0.0;
 	bool collided = false;
-	bool check_ccd = false;
 	bool oneway_disabled = false;
 	bool report_contacts_only = false;
 
-	bool _test_ccd(real_t p_step, GodotBody2D *p_A, int p_shape_A, const Transform2D &p_xform_A, GodotBody2D *p_B, int p_shape_B, const Transform2D &p_xform_B);
 	void _validate_contacts();
+	void _store_cached_contacts() const;
+	void _restore_cached_contacts();
 	static void _add_contact(const Vector2 &p_point_A, const Vector2 &p_point_B, void *p_self);
 	_FORCE_INLINE_ void _contact_added_callback(const Vector2 &p_point_A, const Vector2 &p_point_B);
 
 public:
+	enum {
+		PACKED_WIDTH = 4
+	};
+
+	// One contact slot of the pairs of a PackedGroup, in GodotReal4 friendly layout.
+	struct PackedContacts {
+		real_t normal_x[PACKED_WIDTH];
+		real_t normal_y[PACKED_WIDTH];
+		real_t rA_x[PACKED_WIDTH];
+		real_t rA_y[PACKED_WIDTH];
+		real_t rB_x[PACKED_WIDTH];
+		real_t rB_y[PACKED_WIDTH];
+		real_t mass_normal[PACKED_WIDTH];
+		real_t mass_tangent[PACKED_WIDTH];
+		real_t bias[PACKED_WIDTH];
+		real_t bounce[PACKED_WIDTH];
+		real_t acc_normal_impulse[PACKED_WIDTH];
+		real_t acc_tangent_impulse[PACKED_WIDTH];
+		real_t acc_bias_impulse[PACKED_WIDTH];
+		real_t acc_bias_impulse_center_of_mass[PACKED_WIDTH];
+		real_t acc_impulse_x[PACKED_WIDTH];
+		real_t acc_impulse_y[PACKED_WIDTH];
+	};
+
+	// Pairs that don't share any dynamic body, solved together with 4-wide math.
+	struct PackedGroup {
+		GodotBodyPair2D *pairs[PACKED_WIDTH] = {};
+		uint32_t index_A[PACKED_WIDTH] = {};
+		uint32_t index_B[PACKED_WIDTH] = {};
+		real_t inv_mass_A[PACKED_WIDTH];
+		real_t inv_mass_B[PACKED_WIDTH];
+		real_t inv_inertia_A[PACKED_WIDTH];
+		real_t inv_inertia_B[PACKED_WIDTH];
+		real_t inv_mass_sum_rcp[PACKED_WIDTH];
+		real_t friction[PACKED_WIDTH];
+		PackedContacts contacts[MAX_CONTACTS];
+		int contact_count = 0;
+	};
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	virtual bool can_solve_packed() const override { return collided && !oneway_disabled; }
+	virtual OrderKey get_order_key() const override;
+
+	virtual bool is_body_pair() const override { return true; }
+	virtual uint32_t get_snapshot_state_size() const override;
+	virtual void save_snapshot_state(uint8_t *r_state) const override;
+	virtual void restore_snapshot_state(const uint8_t *p_state) override;
+
+	static void pack(GodotBodyPair2D *const *p_pairs, PackedGroup &r_group);
+	static void solve_packed(PackedGroup &p_group, real_t p_step);
+	static void unpack(const PackedGroup &p_group);
+
 	GodotBodyPair2D(GodotBody2D *p_A, int p_shape_A, GodotBody2D *p_B, int p_shape_B);
 	~GodotBodyPair2D();
 };
 
+real_t combine_bounce(GodotBody2D *A, GodotBody2D *B);
+real_t combine_friction(GodotBody2D *A, GodotBody2D *B);
+
 #endif // GODOT_BODY_PAIR_2D_H
@@ -32,5 +32,11 @@
 
 GodotBroadPhase2D::CreateFunction GodotBroadPhase2D::create_func = nullptr;
 
+void GodotBroadPhase2D::move_batch(const ID *p_ids, const Rect2 *p_aabbs, uint32_t p_count) {
+	for (uint32_t i = 0; i < p_count; i++) {
+		move(p_ids[i], p_aabbs[i]);
+	}
+}
+
 GodotBroadPhase2D::~GodotBroadPhase2D() {
 }
@@ -50,6 +50,8 @@ public:
 	// 0 is an invalid ID
 	virtual ID create(GodotCollisionObject2D *p_object_, int p_subindex = 0, const Rect2 &p_aabb = Rect2(), bool p_static = false) = 0;
 	virtual void move(ID p_id, const Rect2 &p_aabb) = 0;
+	// Each ID must appear at most once per batch.
+	virtual void move_batch(const ID *p_ids, const Rect2 *p_aabbs, uint32_t p_count);
 	virtual void set_static(ID p_id, bool p_static) = 0;
 	virtual void remove(ID p_id) = 0;
 
@@ -43,6 +43,15 @@ void GodotBroadPhase2DBVH::move(ID p_id, const Rect2 &p_aabb) {
 	bvh.move(p_id - 1, p_aabb);
 }
 
+void GodotBroadPhase2DBVH::move_batch(const ID *p_ids, const Rect2 *p_aabbs, uint32_t p_count) {
+	move_batch_handles.resize(p_count);
+	for (uint32_t i = 0; i < p_count; i++) {
+		ERR_FAIL_COND(!p_ids[i]);
+		move_batch_handles[i].set(p_ids[i] - 1);
+	}
+	bvh.move_batch(move_batch_handles.ptr(), p_aabbs, p_count);
+}
+
 void GodotBroadPhase2DBVH::set_static(ID p_id, bool p_static) {
 	ERR_FAIL_COND(!p_id);
 	uint32_t tree_id = p_static ? TREE_STATIC : TREE_DYNAMIC;
@@ -67,6 +67,8 @@ class GodotBroadPhase2DBVH : public GodotBroadPhase2D {
 
 	BVH_Manager<GodotCollisionObject2D, 2, true, 128, UserPairTestFunction<GodotCollisionObject2D>, UserCullTestFunction<GodotCollisionObject2D>, Rect2, Vector2> bvh;
 
+	LocalVector<BVHHandle> move_batch_handles;
+
 	static void *_pair_callback(void *, uint32_t, GodotCollisionObject2D *, int, uint32_t, GodotCollisionObject2D *, int);
 	static void _unpair_callback(void *, uint32_t, GodotCollisionObject2D *, int, uint32_t, GodotCollisionObject2D *, int, void *);
 
@@ -79,6 +81,7 @@ public:
 	// 0 is an invalid ID
 	virtual ID create(GodotCollisionObject2D *p_object, int p_subindex = 0, const Rect2 &p_aabb = Rect2(), bool p_static = false) override;
 	virtual void move(ID p_id, const Rect2 &p_aabb) override;
+	virtual void move_batch(const ID *p_ids, const Rect2 *p_aabbs, uint32_t p_count) override;
 	virtual void set_static(ID p_id, bool p_static) override;
 	virtual void remove(ID p_id) override;
 
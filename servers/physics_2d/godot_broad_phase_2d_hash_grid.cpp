@@ -0,0 +1,495 @@
+/**************************************************************************/
+/*  godot_broad_phase_2d_hash_grid.cpp                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "godot_broad_phase_2d_hash_grid.h"
+#include "godot_collision_object_2d.h"
+
+#include "core/config/project_settings.h"
+
+// Keeps cell coordinates far from integer overflow for huge or infinite AABBs.
+#define CELL_COORD_LIMIT (1 << 28)
+// Segments crossing more cells than this are tested against all the elements instead.
+#define SEGMENT_MAX_CELLS 4096
+
+Rect2i GodotBroadPhase2DHashGrid::_get_cells(const Rect2 &p_aabb) const {
+	Vector2 from = (p_aabb.position * inv_cell_size).floor();
+	Vector2 to = ((p_aabb.position + p_aabb.size) * inv_cell_size).floor();
+
+	Point2i cell_from(CLAMP(from.x, -CELL_COORD_LIMIT, CELL_COORD_LIMIT), CLAMP(from.y, -CELL_COORD_LIMIT, CELL_COORD_LIMIT));
+	Point2i cell_to(CLAMP(to.x, -CELL_COORD_LIMIT, CELL_COORD_LIMIT), CLAMP(to.y, -CELL_COORD_LIMIT, CELL_COORD_LIMIT));
+
+	return Rect2i(cell_from, cell_to - cell_from + Vector2i(1, 1));
+}
+
+// Clamped ranges can span up to 2^29 cells per axis, so their area doesn't fit in an int.
+static _FORCE_INLINE_ int64_t _get_cell_count(const Rect2i &p_cells) {
+	return int64_t(p_cells.size.x) * p_cells.size.y;
+}
+
+void GodotBroadPhase2DHashGrid::_insert_cells(ID p_id, const Rect2i &p_cells, const Rect2i &p_skip_cells) {
+	Point2i end = p_cells.get_end();
+	for (int y = p_cells.position.y; y < end.y; y++) {
+		for (int x = p_cells.position.x; x < end.x; x++) {
+			Point2i cell(x, y);
+			if (p_skip_cells.has_point(cell)) {
+				continue;
+			}
+			cells[cell].push_back(p_id);
+		}
+	}
+}
+
+void GodotBroadPhase2DHashGrid::_remove_cells(ID p_id, const Rect2i &p_cells, const Rect2i &p_keep_cells) {
+	Point2i end = p_cells.get_end();
+	for (int y = p_cells.position.y; y < end.y; y++) {
+		for (int x = p_cells.position.x; x < end.x; x++) {
+			Point2i cell(x, y);
+			if (p_keep_cells.has_point(cell)) {
+				continue;
+			}
+
+			HashMap<Vector2i, LocalVector<ID>>::Iterator E = cells.find(cell);
+			ERR_CONTINUE(!E);
+
+			int64_t index = E->value.find(p_id);
+			ERR_CONTINUE(index < 0);
+			E->value.remove_at_unordered(index);
+
+			if (E->value.is_empty()) {
+				cells.remove(E);
+			}
+		}
+	}
+}
+
+void GodotBroadPhase2DHashGrid::_mark_changed(ID p_id) {
+	Element &e = elements[p_id - 1];
+	if (!e.changed) {
+		e.changed = true;
+		changed_elements.push_back(p_id);
+	}
+}
+
+bool GodotBroadPhase2DHashGrid::_can_pair(const Element &p_a, const Element &p_b) const {
+	// Same rules as the BVH: static objects don't pair with each other, nor shapes of the same object.
+	if (p_a.owner == p_b.owner || (p_a._static && p_b._static)) {
+		return false;
+	}
+	return p_a.owner->interacts_with(p_b.owner);
+}
+
+void GodotBroadPhase2DHashGrid::_pair(ID p_a, ID p_b) {
+	if (p_a > p_b) {
+		SWAP(p_a, p_b);
+	}
+
+	Element &a = elements[p_a - 1];
+	Element &b = elements[p_b - 1];
+	a.pairs.push_back(p_b);
+	b.pairs.push_back(p_a);
+
+	void *data = nullptr;
+	if (pair_callback) {
+		data = pair_callback(a.owner, a.subindex, b.owner, b.subindex, pair_userdata);
+	}
+	pair_data.insert(_get_pair_key(p_a, p_b), data);
+}
+
+void GodotBroadPhase2DHashGrid::_unpair(ID p_a, ID p_b) {
+	if (p_a > p_b) {
+		SWAP(p_a, p_b);
+	}
+
+	Element &a = elements[p_a - 1];
+	Element &b = elements[p_b - 1];
+
+	int64_t index = a.pairs.find(p_b);
+	if (index >= 0) {
+		a.pairs.remove_at_unordered(index);
+	}
+	index = b.pairs.find(p_a);
+	if (index >= 0) {
+		b.pairs.remove_at_unordered(index);
+	}
+
+	HashMap<uint64_t, void *>::Iterator E = pair_data.find(_get_pair_key(p_a, p_b));
+	ERR_FAIL_COND(!E);
+	void *data = E->value;
+	pair_data.remove(E);
+
+	if (unpair_callback) {
+		unpair_callback(a.owner, a.subindex, b.owner, b.subindex, data, unpair_userdata);
+	}
+}
+
+void GodotBroadPhase2DHashGrid::_pair_candidate(ID p_id, ID p_other) {
+	if (p_id == p_other) {
+		return;
+	}
+
+	const Element &e = elements[p_id - 1];
+	const Element &other = elements[p_other - 1];
+	if (!e.aabb.intersects(other.aabb) || !_can_pair(e, other)) {
+		return;
+	}
+
+	// Elements covering several cells are found more than once.
+	if (pair_data.has(_get_pair_key(p_id, p_other))) {
+		return;
+	}
+
+	_pair(p_id, p_other);
+}
+
+GodotBroadPhase2D::ID GodotBroadPhase2DHashGrid::create(GodotCollisionObject2D *p_object, int p_subindex, const Rect2 &p_aabb, bool p_static) {
+	ID id;
+	if (free_ids.size()) {
+		id = free_ids[free_ids.size() - 1];
+		free_ids.resize(free_ids.size() - 1);
+	} else {
+		elements.resize(elements.size() + 1);
+		id = elements.size();
+	}
+
+	Element &e = elements[id - 1];
+	e.owner = p_object;
+	e.subindex = p_subindex;
+	e._static = p_static;
+	e.aabb = p_aabb;
+	e.cells = _get_cells(p_aabb);
+	e.large = _get_cell_count(e.cells) > large_object_cells;
+
+	if (e.large) {
+		large_elements.push_back(id);
+	} else {
+		_insert_cells(id, e.cells, Rect2i());
+	}
+
+	_mark_changed(id);
+
+	return id;
+}
+
+void GodotBroadPhase2DHashGrid::move(ID p_id, const Rect2 &p_aabb) {
+	ERR_FAIL_COND(!p_id || p_id > elements.size());
+	Element &e = elements[p_id - 1];
+	ERR_FAIL_COND(!e.owner);
+
+	if (e.aabb == p_aabb) {
+		return;
+	}
+
+	e.aabb = p_aabb;
+
+	Rect2i new_cells = _get_cells(p_aabb);
+	bool large = _get_cell_count(new_cells) > large_object_cells;
+
+	if (large != e.large) {
+		if (e.large) {
+			large_elements.erase(p_id);
+			_insert_cells(p_id, new_cells, Rect2i());
+		} else {
+			_remove_cells(p_id, e.cells, Rect2i());
+			large_elements.push_back(p_id);
+		}
+		e.large = large;
+	} else if (!large && new_cells != e.cells) {
+		// Only the cells entered or left are touched.
+		_remove_cells(p_id, e.cells, new_cells);
+		_insert_cells(p_id, new_cells, e.cells);
+	}
+
+	e.cells = new_cells;
+
+	_mark_changed(p_id);
+}
+
+void GodotBroadPhase2DHashGrid::set_static(ID p_id, bool p_static) {
+	ERR_FAIL_COND(!p_id || p_id > elements.size());
+	Element &e = elements[p_id - 1];
+	ERR_FAIL_COND(!e.owner);
+
+	if (e._static == p_static) {
+		return;
+	}
+
+	e._static = p_static;
+	_mark_changed(p_id);
+}
+
+void GodotBroadPhase2DHashGrid::remove(ID p_id) {
+	ERR_FAIL_COND(!p_id || p_id > elements.size());
+	Element &e = elements[p_id - 1];
+	ERR_FAIL_COND(!e.owner);
+
+	while (e.pairs.size()) {
+		_unpair(p_id, e.pairs[e.pairs.size() - 1]);
+	}
+
+	if (e.large) {
+		large_elements.erase(p_id);
+	} else {
+		_remove_cells(p_id, e.cells, Rect2i());
+	}
+
+	// The changed flag is kept, so an ID reused before the next update isn't listed twice.
+	e.owner = nullptr;
+	e.subindex = 0;
+	e.cells = Rect2i();
+	free_ids.push_back(p_id);
+}
+
+GodotCollisionObject2D *GodotBroadPhase2DHashGrid::get_object(ID p_id) const {
+	ERR_FAIL_COND_V(!p_id || p_id > elements.size(), nullptr);
+	GodotCollisionObject2D *owner = elements[p_id - 1].owner;
+	ERR_FAIL_COND_V(!owner, nullptr);
+	return owner;
+}
+
+bool GodotBroadPhase2DHashGrid::is_static(ID p_id) const {
+	ERR_FAIL_COND_V(!p_id || p_id > elements.size(), false);
+	return elements[p_id - 1]._static;
+}
+
+int GodotBroadPhase2DHashGrid::get_subindex(ID p_id) const {
+	ERR_FAIL_COND_V(!p_id || p_id > elements.size(), 0);
+	return elements[p_id - 1].subindex;
+}
+
+int GodotBroadPhase2DHashGrid::cull_segment(const Vector2 &p_from, const Vector2 &p_to, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices) {
+	if (p_max_results <= 0) {
+		return 0;
+	}
+
+	int count = 0;
+
+	Point2i cell = _get_cells(Rect2(p_from, Vector2())).position;
+	Point2i end_cell = _get_cells(Rect2(p_to, Vector2())).position;
+	int64_t cell_count = int64_t(ABS(end_cell.x - cell.x)) + ABS(end_cell.y - cell.y) + 1;
+
+	if (cell_count > SEGMENT_MAX_CELLS) {
+		for (uint32_t i = 0; i < elements.size() && count < p_max_results; i++) {
+			const Element &e = elements[i];
+			if (e.owner && !e.large && e.aabb.intersects_segment(p_from, p_to)) {
+				_add_result(e, p_results, p_result_indices, count);
+			}
+		}
+	} else {
+		// Walk the cells crossed by the segment, in order.
+		Vector2 dir = p_to - p_from;
+		Point2i step(SIGN(dir.x), SIGN(dir.y));
+		Vector2 t_max(INFINITY, INFINITY);
+		Vector2 t_delta(INFINITY, INFINITY);
+		for (int axis = 0; axis < 2; axis++) {
+			if (step[axis] != 0) {
+				real_t boundary = (cell[axis] + (step[axis] > 0 ? 1 : 0)) * cell_size;
+				t_max[axis] = (boundary - p_from[axis]) / dir[axis];
+				t_delta[axis] = cell_size / Math::abs(dir[axis]);
+			}
+		}
+
+		// Elements covering several cells are only reported from the first one crossed.
+		query_pass++;
+		for (int64_t i = 0; i < cell_count && count < p_max_results; i++) {
+			HashMap<Vector2i, LocalVector<ID>>::ConstIterator E = cells.find(cell);
+			if (E) {
+				for (const ID &id : E->value) {
+					Element &e = elements[id - 1];
+					if (e.query_pass == query_pass) {
+						continue;
+					}
+					e.query_pass = query_pass;
+					if (!e.aabb.intersects_segment(p_from, p_to)) {
+						continue;
+					}
+					_add_result(e, p_results, p_result_indices, count);
+					if (count >= p_max_results) {
+						break;
+					}
+				}
+			}
+
+			if (cell == end_cell) {
+				break;
+			}
+
+			if (t_max.x < t_max.y) {
+				t_max.x += t_delta.x;
+				cell.x += step.x;
+			} else {
+				t_max.y += t_delta.y;
+				cell.y += step.y;
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < large_elements.size() && count < p_max_results; i++) {
+		const Element &e = elements[large_elements[i] - 1];
+		if (e.aabb.intersects_segment(p_from, p_to)) {
+			_add_result(e, p_results, p_result_indices, count);
+		}
+	}
+
+	return count;
+}
+
+int GodotBroadPhase2DHashGrid::cull_aabb(const Rect2 &p_aabb, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices) {
+	if (p_max_results <= 0) {
+		return 0;
+	}
+
+	int count = 0;
+
+	Rect2i range = _get_cells(p_aabb);
+
+	if (_get_cell_count(range) > (int64_t)cells.size()) {
+		// Cheaper to go through the occupied cells than the whole range.
+		for (const KeyValue<Vector2i, LocalVector<ID>> &E : cells) {
+			if (!range.has_point(E.key)) {
+				continue;
+			}
+			for (const ID &id : E.value) {
+				const Element &e = elements[id - 1];
+				// Elements covering several cells are only reported from the first cell they share with the range.
+				if (E.key != e.cells.position.max(range.position) || !e.aabb.intersects(p_aabb)) {
+					continue;
+				}
+				_add_result(e, p_results, p_result_indices, count);
+				if (count >= p_max_results) {
+					return count;
+				}
+			}
+		}
+	} else {
+		Point2i end = range.get_end();
+		for (int y = range.position.y; y < end.y; y++) {
+			for (int x = range.position.x; x < end.x; x++) {
+				Point2i cell(x, y);
+				HashMap<Vector2i, LocalVector<ID>>::ConstIterator E = cells.find(cell);
+				if (!E) {
+					continue;
+				}
+				for (const ID &id : E->value) {
+					const Element &e = elements[id - 1];
+					if (cell != e.cells.position.max(range.position) || !e.aabb.intersects(p_aabb)) {
+						continue;
+					}
+					_add_result(e, p_results, p_result_indices, count);
+					if (count >= p_max_results) {
+						return count;
+					}
+				}
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < large_elements.size() && count < p_max_results; i++) {
+		const Element &e = elements[large_elements[i] - 1];
+		if (e.aabb.intersects(p_aabb)) {
+			_add_result(e, p_results, p_result_indices, count);
+		}
+	}
+
+	return count;
+}
+
+void GodotBroadPhase2DHashGrid::set_pair_callback(PairCallback p_pair_callback, void *p_userdata) {
+	pair_callback = p_pair_callback;
+	pair_userdata = p_userdata;
+}
+
+void GodotBroadPhase2DHashGrid::set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) {
+	unpair_callback = p_unpair_callback;
+	unpair_userdata = p_userdata;
+}
+
+void GodotBroadPhase2DHashGrid::update() {
+	// All the pairs of the elements moved since the last update are checked in one pass.
+	for (uint32_t i = 0; i < changed_elements.size(); i++) {
+		ID id = changed_elements[i];
+		Element &e = elements[id - 1];
+		e.changed = false;
+		if (!e.owner) {
+			continue; // Removed.
+		}
+
+		for (uint32_t j = 0; j < e.pairs.size(); j++) {
+			ID other_id = e.pairs[j];
+			const Element &other = elements[other_id - 1];
+			if (!e.aabb.intersects(other.aabb) || !_can_pair(e, other)) {
+				_unpair(id, other_id);
+				j--;
+			}
+		}
+
+		if (e.large) {
+			for (uint32_t j = 0; j < elements.size(); j++) {
+				if (elements[j].owner) {
+					_pair_candidate(id, j + 1);
+				}
+			}
+			continue;
+		}
+
+		Point2i end = e.cells.get_end();
+		for (int y = e.cells.position.y; y < end.y; y++) {
+			for (int x = e.cells.position.x; x < end.x; x++) {
+				HashMap<Vector2i, LocalVector<ID>>::ConstIterator E = cells.find(Point2i(x, y));
+				if (!E) {
+					continue;
+				}
+				for (const ID &other_id : E->value) {
+					_pair_candidate(id, other_id);
+				}
+			}
+		}
+
+		for (const ID &other_id : large_elements) {
+			_pair_candidate(id, other_id);
+		}
+	}
+
+	changed_elements.clear();
+}
+
+GodotBroadPhase2D *GodotBroadPhase2DHashGrid::_create() {
+	real_t cell_size = GLOBAL_GET("physics/2d/broad_phase/cell_size");
+	int large_object_cells = GLOBAL_GET("physics/2d/broad_phase/large_object_cells");
+	return memnew(GodotBroadPhase2DHashGrid(cell_size, large_object_cells));
+}
+
+GodotBroadPhase2DHashGrid::GodotBroadPhase2DHashGrid(real_t p_cell_size, int p_large_object_cells) {
+	cell_size = MAX(p_cell_size, (real_t)1.0);
+	inv_cell_size = 1.0 / cell_size;
+	large_object_cells = MAX(p_large_object_cells, 1);
+}
+
+GodotBroadPhase2DHashGrid::~GodotBroadPhase2DHashGrid() {
+}
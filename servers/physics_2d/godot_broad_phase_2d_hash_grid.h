@@ -0,0 +1,118 @@
+/**************************************************************************/
+/*  godot_broad_phase_2d_hash_grid.h                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_BROAD_PHASE_2D_HASH_GRID_H
+#define GODOT_BROAD_PHASE_2D_HASH_GRID_H
+
+#include "godot_broad_phase_2d.h"
+
+#include "core/math/rect2i.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+// Hashed uniform grid, cheaper than the BVH to update when many similarly sized objects move every step.
+// Objects covering too many cells are kept in a separate list and tested against everything.
+class GodotBroadPhase2DHashGrid : public GodotBroadPhase2D {
+	struct Element {
+		GodotCollisionObject2D *owner = nullptr;
+		int subindex = 0;
+		bool _static = false;
+		bool large = false;
+		bool changed = false;
+		uint64_t query_pass = 0; // Last segment query that found this element.
+		Rect2 aabb;
+		Rect2i cells;
+		LocalVector<ID> pairs;
+	};
+
+	LocalVector<Element> elements; // Element of ID i is at index i - 1.
+	LocalVector<ID> free_ids;
+	LocalVector<ID> large_elements;
+	LocalVector<ID> changed_elements;
+	HashMap<Vector2i, LocalVector<ID>> cells;
+	HashMap<uint64_t, void *> pair_data;
+	uint64_t query_pass = 0;
+
+	real_t cell_size = 128.0;
+	real_t inv_cell_size = 1.0 / 128.0;
+	int large_object_cells = 512;
+
+	PairCallback pair_callback = nullptr;
+	void *pair_userdata = nullptr;
+	UnpairCallback unpair_callback = nullptr;
+	void *unpair_userdata = nullptr;
+
+	_FORCE_INLINE_ static uint64_t _get_pair_key(ID p_a, ID p_b) {
+		return p_a < p_b ? ((uint64_t(p_a) << 32) | p_b) : ((uint64_t(p_b) << 32) | p_a);
+	}
+
+	Rect2i _get_cells(const Rect2 &p_aabb) const;
+	void _insert_cells(ID p_id, const Rect2i &p_cells, const Rect2i &p_skip_cells);
+	void _remove_cells(ID p_id, const Rect2i &p_cells, const Rect2i &p_keep_cells);
+	void _mark_changed(ID p_id);
+
+	bool _can_pair(const Element &p_a, const Element &p_b) const;
+	void _pair(ID p_a, ID p_b);
+	void _unpair(ID p_a, ID p_b);
+	void _pair_candidate(ID p_id, ID p_other);
+
+	_FORCE_INLINE_ void _add_result(const Element &p_element, GodotCollisionObject2D **p_results, int *p_result_indices, int &r_count) const {
+		p_results[r_count] = p_element.owner;
+		if (p_result_indices) {
+			p_result_indices[r_count] = p_element.subindex;
+		}
+		r_count++;
+	}
+
+public:
+	// 0 is an invalid ID
+	virtual ID create(GodotCollisionObject2D *p_object, int p_subindex = 0, const Rect2 &p_aabb = Rect2(), bool p_static = false) override;
+	virtual void move(ID p_id, const Rect2 &p_aabb) override;
+	virtual void set_static(ID p_id, bool p_static) override;
+	virtual void remove(ID p_id) override;
+
+	virtual GodotCollisionObject2D *get_object(ID p_id) const override;
+	virtual bool is_static(ID p_id) const override;
+	virtual int get_subindex(ID p_id) const override;
+
+	virtual int cull_segment(const Vector2 &p_from, const Vector2 &p_to, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices = nullptr) override;
+	virtual int cull_aabb(const Rect2 &p_aabb, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices = nullptr) override;
+
+	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata) override;
+	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) override;
+
+	virtual void update() override;
+
+	static GodotBroadPhase2D *_create();
+	GodotBroadPhase2DHashGrid(real_t p_cell_size = 128.0, int p_large_object_cells = 512);
+	~GodotBroadPhase2DHashGrid();
+};
+
+#endif // GODOT_BROAD_PHASE_2D_HASH_GRID_H
@@ -87,7 +87,7 @@ void GodotCollisionObject2D::set_shape_disabled(int p_idx, bool p_disabled) {
 	}
 
 	if (p_disabled && shape.bpid != 0) {
-		space->get_broadphase()->remove(shape.bpid);
+		space->broadphase_remove(shape.bpid);
 		shape.bpid = 0;
 		if (!pending_shape_update_list.in_list()) {
 			GodotPhysicsServer2D::godot_singleton->pending_shape_update_list.add(&pending_shape_update_list);
@@ -117,7 +117,7 @@ void GodotCollisionObject2D::remove_shape(int p_index) {
 			continue;
 		}
 		//should never get here with a null owner
-		space->get_broadphase()->remove(shapes[i].bpid);
+		space->broadphase_remove(shapes[i].bpid);
 		shapes.write[i].bpid = 0;
 	}
 	shapes[p_index].shape->remove_owner(this);
@@ -151,7 +151,7 @@ void GodotCollisionObject2D::_unregister_shapes() {
 	for (int i = 0; i < shapes.size(); i++) {
 		Shape &s = shapes.write[i];
 		if (s.bpid > 0) {
-			space->get_broadphase()->remove(s.bpid);
+			space->broadphase_remove(s.bpid);
 			s.bpid = 0;
 		}
 	}
@@ -180,7 +180,7 @@ void GodotCollisionObject2D::_update_shapes() {
 			space->get_broadphase()->set_static(s.bpid, _static);
 		}
 
-		space->get_broadphase()->move(s.bpid, shape_aabb);
+		space->broadphase_move(s.bpid, shape_aabb);
 	}
 }
 
@@ -207,7 +207,7 @@ void GodotCollisionObject2D::_update_shapes_with_motion(const Vector2 &p_motion)
 			space->get_broadphase()->set_static(s.bpid, _static);
 		}
 
-		space->get_broadphase()->move(s.bpid, shape_aabb);
+		space->broadphase_move(s.bpid, shape_aabb);
 	}
 }
 
@@ -218,7 +218,7 @@ void GodotCollisionObject2D::_set_space(GodotSpace2D *p_space) {
 		for (int i = 0; i < shapes.size(); i++) {
 			Shape &s = shapes.write[i];
 			if (s.bpid) {
-				space->get_broadphase()->remove(s.bpid);
+				space->broadphase_remove(s.bpid);
 				s.bpid = 0;
 			}
 		}
@@ -267,3 +267,323 @@ bool GodotCollisionSolver2D::solve(const GodotShape2D *p_shape_A, const Transfor
 		return collision_solver(p_shape_A, p_transform_A, p_motion_A, p_shape_B, p_transform_B, p_motion_B, p_result_callback, p_userdata, false, r_sep_axis, margin_A, margin_B);
 	}
 }
+
+struct GJKVertex2D {
+	Vector2 a; // Support point on A.
+	Vector2 b; // Support point on B.
+	Vector2 w; // a - b, a point of the Minkowski difference.
+	real_t u = 1.0; // Barycentric weight of the closest point.
+};
+
+static _FORCE_INLINE_ Vector2 _get_world_support(const GodotShape2D *p_shape, const Transform2D &p_transform, const Vector2 &p_direction) {
+	return p_transform.xform(p_shape->get_support(p_transform.basis_xform_inv(p_direction).normalized()));
+}
+
+// Angle swept by interpolate_with() between both transforms.
+static _FORCE_INLINE_ real_t _get_rotation_distance(const Transform2D &p_from, const Transform2D &p_to) {
+	real_t from = p_from.get_rotation();
+	return Math::abs(Math::lerp_angle(from, p_to.get_rotation(), (real_t)1.0) - from);
+}
+
+// Reduces the simplex to the features closest to the origin, returns false when it contains the origin.
+static bool _solve_gjk_simplex(GJKVertex2D *r_simplex, int &r_count) {
+	if (r_count == 2) {
+		const Vector2 &w1 = r_simplex[0].w;
+		const Vector2 &w2 = r_simplex[1].w;
+		Vector2 e12 = w2 - w1;
+
+		real_t d12_2 = -w1.dot(e12);
+		if (d12_2 <= 0.0) {
+			r_simplex[0].u = 1.0;
+			r_count = 1;
+			return true;
+		}
+
+		real_t d12_1 = w2.dot(e12);
+		if (d12_1 <= 0.0) {
+			r_simplex[0] = r_simplex[1];
+			r_simplex[0].u = 1.0;
+			r_count = 1;
+			return true;
+		}
+
+		real_t inv_d12 = 1.0 / (d12_1 + d12_2);
+		r_simplex[0].u = d12_1 * inv_d12;
+		r_simplex[1].u = d12_2 * inv_d12;
+		return true;
+	}
+
+	if (r_count == 3) {
+		const Vector2 &w1 = r_simplex[0].w;
+		const Vector2 &w2 = r_simplex[1].w;
+		const Vector2 &w3 = r_simplex[2].w;
+
+		Vector2 e12 = w2 - w1;
+		real_t d12_1 = w2.dot(e12);
+		real_t d12_2 = -w1.dot(e12);
+
+		Vector2 e13 = w3 - w1;
+		real_t d13_1 = w3.dot(e13);
+		real_t d13_2 = -w1.dot(e13);
+
+		Vector2 e23 = w3 - w2;
+		real_t d23_1 = w3.dot(e23);
+		real_t d23_2 = -w2.dot(e23);
+
+		real_t n123 = e12.cross(e13);
+		real_t d123_1 = n123 * w2.cross(w3);
+		real_t d123_2 = n123 * w3.cross(w1);
+		real_t d123_3 = n123 * w1.cross(w2);
+
+		if (d12_2 <= 0.0 && d13_2 <= 0.0) {
+			r_simplex[0].u = 1.0;
+			r_count = 1;
+			return true;
+		}
+
+		if (d12_1 > 0.0 && d12_2 > 0.0 && d123_3 <= 0.0) {
+			real_t inv_d12 = 1.0 / (d12_1 + d12_2);
+			r_simplex[0].u = d12_1 * inv_d12;
+			r_simplex[1].u = d12_2 * inv_d12;
+			r_count = 2;
+			return true;
+		}
+
+		if (d13_1 > 0.0 && d13_2 > 0.0 && d123_2 <= 0.0) {
+			real_t inv_d13 = 1.0 / (d13_1 + d13_2);
+			r_simplex[0].u = d13_1 * inv_d13;
+			r_simplex[1] = r_simplex[2];
+			r_simplex[1].u = d13_2 * inv_d13;
+			r_count = 2;
+			return true;
+		}
+
+		if (d12_1 <= 0.0 && d23_2 <= 0.0) {
+			r_simplex[0] = r_simplex[1];
+			r_simplex[0].u = 1.0;
+			r_count = 1;
+			return true;
+		}
+
+		if (d13_1 <= 0.0 && d23_1 <= 0.0) {
+			r_simplex[0] = r_simplex[2];
+			r_simplex[0].u = 1.0;
+			r_count = 1;
+			return true;
+		}
+
+		if (d23_1 > 0.0 && d23_2 > 0.0 && d123_1 <= 0.0) {
+			real_t inv_d23 = 1.0 / (d23_1 + d23_2);
+			r_simplex[0] = r_simplex[2];
+			r_simplex[0].u = d23_2 * inv_d23;
+			r_simplex[1].u = d23_1 * inv_d23;
+			r_count = 2;
+			return true;
+		}
+
+		return false;
+	}
+
+	r_simplex[0].u = 1.0;
+	return true;
+}
+
+real_t GodotCollisionSolver2D::compute_distance(const GodotShape2D *p_shape_A, const Transform2D &p_transform_A, const GodotShape2D *p_shape_B, const Transform2D &p_transform_B, Vector2 &r_point_A, Vector2 &r_point_B) {
+	if (p_shape_A->get_type() == PhysicsServer2D::SHAPE_WORLD_BOUNDARY) {
+		return compute_distance(p_shape_B, p_transform_B, p_shape_A, p_transform_A, r_point_B, r_point_A);
+	}
+
+	if (p_shape_B->get_type() == PhysicsServer2D::SHAPE_WORLD_BOUNDARY) {
+		const GodotWorldBoundaryShape2D *world_boundary = static_cast<const GodotWorldBoundaryShape2D *>(p_shape_B);
+		Vector2 n = p_transform_B.basis_xform(world_boundary->get_normal()).normalized();
+		real_t d = n.dot(p_transform_B.xform(world_boundary->get_normal() * world_boundary->get_d()));
+
+		r_point_A = _get_world_support(p_shape_A, p_transform_A, -n);
+		real_t distance = n.dot(r_point_A) - d;
+		r_point_B = r_point_A - n * distance;
+		return MAX(distance, 0.0);
+	}
+
+	GJKVertex2D simplex[3];
+	int count = 1;
+
+	Vector2 direction = p_transform_B.get_origin() - p_transform_A.get_origin();
+	if (direction.length_squared() < CMP_EPSILON2) {
+		direction = Vector2(1, 0);
+	}
+
+	simplex[0].a = _get_world_support(p_shape_A, p_transform_A, direction);
+	simplex[0].b = _get_world_support(p_shape_B, p_transform_B, -direction);
+	simplex[0].w = simplex[0].a - simplex[0].b;
+
+	Vector2 closest = simplex[0].w;
+	bool overlap = false;
+
+	for (int iteration = 0; iteration < DISTANCE_MAX_ITERATIONS; iteration++) {
+		if (closest.length_squared() < CMP_EPSILON2) {
+			overlap = true;
+			break;
+		}
+
+		// Search towards the origin from the closest point found so far.
+		direction = -closest;
+		GJKVertex2D vertex;
+		vertex.a = _get_world_support(p_shape_A, p_transform_A, direction);
+		vertex.b = _get_world_support(p_shape_B, p_transform_B, -direction);
+		vertex.w = vertex.a - vertex.b;
+
+		// No progress towards the origin, the closest point is final.
+		real_t progress = closest.dot(closest) - closest.dot(vertex.w);
+		if (progress <= CMP_EPSILON * closest.dot(closest)) {
+			break;
+		}
+
+		bool duplicate = false;
+		for (int i = 0; i < count; i++) {
+			if (simplex[i].w.is_equal_approx(vertex.w)) {
+				duplicate = true;
+				break;
+			}
+		}
+		if (duplicate) {
+			break;
+		}
+
+		simplex[count++] = vertex;
+		if (!_solve_gjk_simplex(simplex, count)) {
+			overlap = true;
+			break;
+		}
+
+		closest = Vector2();
+		for (int i = 0; i < count; i++) {
+			closest += simplex[i].w * simplex[i].u;
+		}
+	}
+
+	r_point_A = Vector2();
+	r_point_B = Vector2();
+	for (int i = 0; i < count; i++) {
+		r_point_A += simplex[i].a * simplex[i].u;
+		r_point_B += simplex[i].b * simplex[i].u;
+	}
+
+	if (overlap) {
+		return 0.0;
+	}
+
+	return closest.length();
+}
+
+bool GodotCollisionSolver2D::solve_time_of_impact_convex(const GodotShape2D *p_shape_A, const ShapeMotion &p_motion_A, const GodotShape2D *p_shape_B, const ShapeMotion &p_motion_B, real_t p_separation, TimeOfImpact &r_result) {
+	// Linear motion of B relative to A, and how much both rotations can move a point of each shape.
+	Vector2 relative_motion = (p_motion_B.to.get_origin() - p_motion_B.from.get_origin()) - (p_motion_A.to.get_origin() - p_motion_A.from.get_origin());
+	real_t angular_bound = _get_rotation_distance(p_motion_A.from, p_motion_A.to) * p_motion_A.radius;
+	angular_bound += _get_rotation_distance(p_motion_B.from, p_motion_B.to) * p_motion_B.radius;
+
+	real_t tolerance = MAX(p_separation * 0.25, (real_t)CMP_EPSILON);
+	real_t time = 0.0;
+
+	for (int iteration = 0; iteration < TIME_OF_IMPACT_MAX_ITERATIONS; iteration++) {
+		Transform2D xform_A = p_motion_A.from.interpolate_with(p_motion_A.to, time) * p_motion_A.shape_transform;
+		Transform2D xform_B = p_motion_B.from.interpolate_with(p_motion_B.to, time) * p_motion_B.shape_transform;
+
+		Vector2 point_A, point_B;
+		real_t distance = compute_distance(p_shape_A, xform_A, p_shape_B, xform_B, point_A, point_B);
+
+		if (distance > CMP_EPSILON) {
+			r_result.normal = (point_B - point_A) / distance;
+		}
+		r_result.point_A = point_A;
+		r_result.point_B = point_B;
+
+		if (distance < p_separation + tolerance) {
+			if (time == 0.0) {
+				return false;
+			}
+			r_result.time = time;
+			return true;
+		}
+
+		// Fastest the distance can shrink along the normal, no point of either shape moves faster than this.
+		real_t approach_bound = -relative_motion.dot(r_result.normal) + angular_bound;
+		if (approach_bound <= CMP_EPSILON) {
+			return false;
+		}
+
+		time += (distance - p_separation) / approach_bound;
+		if (time >= 1.0) {
+			return false;
+		}
+	}
+
+	// Out of iterations, the current time is still before the impact.
+	r_result.time = time;
+	return true;
+}
+
+bool GodotCollisionSolver2D::time_of_impact_concave_callback(void *p_userdata, GodotShape2D *p_convex) {
+	TimeOfImpactConcaveData &data = *(static_cast<TimeOfImpactConcaveData *>(p_userdata));
+
+	TimeOfImpact result;
+	bool collided;
+	if (data.swap) {
+		collided = solve_time_of_impact_convex(p_convex, *data.motion_B, data.shape_A, *data.motion_A, data.separation, result);
+	} else {
+		collided = solve_time_of_impact_convex(data.shape_A, *data.motion_A, p_convex, *data.motion_B, data.separation, result);
+	}
+
+	if (collided && result.time < data.result.time) {
+		data.result = result;
+		data.collided = true;
+	}
+
+	return false;
+}
+
+bool GodotCollisionSolver2D::solve_time_of_impact(const GodotShape2D *p_shape_A, const ShapeMotion &p_motion_A, const GodotShape2D *p_shape_B, const ShapeMotion &p_motion_B, real_t p_separation, TimeOfImpact &r_result) {
+	PhysicsServer2D::ShapeType type_A = p_shape_A->get_type();
+	PhysicsServer2D::ShapeType type_B = p_shape_B->get_type();
+
+	if (type_A == PhysicsServer2D::SHAPE_SEPARATION_RAY || type_B == PhysicsServer2D::SHAPE_SEPARATION_RAY) {
+		return false;
+	}
+
+	bool static_A = p_shape_A->is_concave() || type_A == PhysicsServer2D::SHAPE_WORLD_BOUNDARY;
+	bool static_B = p_shape_B->is_concave() || type_B == PhysicsServer2D::SHAPE_WORLD_BOUNDARY;
+	if (static_A && static_B) {
+		return false;
+	}
+
+	if (!p_shape_A->is_concave() && !p_shape_B->is_concave()) {
+		return solve_time_of_impact_convex(p_shape_A, p_motion_A, p_shape_B, p_motion_B, p_separation, r_result);
+	}
+
+	// Concave shapes are tested one segment at a time, against the segments the convex shape sweeps over.
+	bool swap = p_shape_A->is_concave();
+	const GodotShape2D *convex = swap ? p_shape_B : p_shape_A;
+	const GodotConcaveShape2D *concave = static_cast<const GodotConcaveShape2D *>(swap ? p_shape_A : p_shape_B);
+	const ShapeMotion &convex_motion = swap ? p_motion_B : p_motion_A;
+	const ShapeMotion &concave_motion = swap ? p_motion_A : p_motion_B;
+
+	Rect2 swept_aabb(convex_motion.from.get_origin(), Vector2());
+	swept_aabb.expand_to(convex_motion.to.get_origin());
+	swept_aabb = swept_aabb.grow(convex_motion.radius + p_separation);
+
+	Rect2 local_aabb = (concave_motion.from * concave_motion.shape_transform).affine_inverse().xform(swept_aabb);
+	local_aabb = local_aabb.merge((concave_motion.to * concave_motion.shape_transform).affine_inverse().xform(swept_aabb));
+
+	TimeOfImpactConcaveData data;
+	data.shape_A = convex;
+	data.motion_A = &convex_motion;
+	data.motion_B = &concave_motion;
+	data.separation = p_separation;
+	data.swap = swap;
+
+	concave->cull(local_aabb, time_of_impact_concave_callback, &data);
+
+	if (data.collided) {
+		r_result = data.result;
+	}
+	return data.collided;
+}
@@ -37,7 +37,40 @@ class GodotCollisionSolver2D {
 public:
 	typedef void (*CallbackResult)(const Vector2 &p_point_A, const Vector2 &p_point_B, void *p_userdata);
 
+	// Motion of a body shape during a step, the body pose is interpolated between both transforms.
+	struct ShapeMotion {
+		Transform2D from;
+		Transform2D to;
+		Transform2D shape_transform;
+		real_t radius = 0.0; // Farthest point of the shape from the body origin, bounds the motion due to rotation.
+	};
+
+	struct TimeOfImpact {
+		real_t time = 1.0;
+		Vector2 point_A;
+		Vector2 point_B;
+		Vector2 normal; // From A to B.
+	};
+
 private:
+	enum {
+		DISTANCE_MAX_ITERATIONS = 32,
+		TIME_OF_IMPACT_MAX_ITERATIONS = 32
+	};
+
+	struct TimeOfImpactConcaveData {
+		const GodotShape2D *shape_A = nullptr;
+		const ShapeMotion *motion_A = nullptr;
+		const ShapeMotion *motion_B = nullptr;
+		real_t separation = 0.0;
+		bool swap = false;
+		bool collided = false;
+		TimeOfImpact result;
+	};
+
+	static bool time_of_impact_concave_callback(void *p_userdata, GodotShape2D *p_convex);
+	static bool solve_time_of_impact_convex(const GodotShape2D *p_shape_A, const ShapeMotion &p_motion_A, const GodotShape2D *p_shape_B, const ShapeMotion &p_motion_B, real_t p_separation, TimeOfImpact &r_result);
+
 	static bool solve_static_world_boundary(const GodotShape2D *p_shape_A, const Transform2D &p_transform_A, const GodotShape2D *p_shape_B, const Transform2D &p_transform_B, const Vector2 &p_motion_B, CallbackResult p_result_callback, void *p_userdata, bool p_swap_result, real_t p_margin = 0);
 	static bool concave_callback(void *p_userdata, GodotShape2D *p_convex);
 	static bool solve_concave(const GodotShape2D *p_shape_A, const Transform2D &p_transform_A, const Vector2 &p_motion_A, const GodotShape2D *p_shape_B, const Transform2D &p_transform_B, const Vector2 &p_motion_B, CallbackResult p_result_callback, void *p_userdata, bool p_swap_result, Vector2 *r_sep_axis = nullptr, real_t p_margin_A = 0, real_t p_margin_B = 0);
@@ -45,6 +78,13 @@ private:
 
 public:
 	static bool solve(const GodotShape2D *p_shape_A, const Transform2D &p_transform_A, const Vector2 &p_motion_A, const GodotShape2D *p_shape_B, const Transform2D &p_transform_B, const Vector2 &p_motion_B, CallbackResult p_result_callback, void *p_userdata, Vector2 *r_sep_axis = nullptr, real_t p_margin_A = 0, real_t p_margin_B = 0);
+
+	// GJK distance between two convex shapes (or a convex shape and a world boundary), returns 0 when they overlap.
+	static real_t compute_distance(const GodotShape2D *p_shape_A, const Transform2D &p_transform_A, const GodotShape2D *p_shape_B, const Transform2D &p_transform_B, Vector2 &r_point_A, Vector2 &r_point_B);
+
+	// Conservative advancement: finds the first time in [0, 1] where both shapes get within p_separation of each other.
+	// Shapes that are already that close at the start are left to the regular contact solver.
+	static bool solve_time_of_impact(const GodotShape2D *p_shape_A, const ShapeMotion &p_motion_A, const GodotShape2D *p_shape_B, const ShapeMotion &p_motion_B, real_t p_separation, TimeOfImpact &r_result);
 };
 
 #endif // GODOT_COLLISION_SOLVER_2D_H
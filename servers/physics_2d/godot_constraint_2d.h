@@ -32,13 +32,44 @@
 #define GODOT_CONSTRAINT_2D_H
 
 #include "godot_body_2d.h"
+#include "godot_solver_bodies_2d.h"
 
 class GodotConstraint2D {
+public:
+	enum {
+		MAX_BODIES = 2
+	};
+
+	// Orders constraints by the RIDs of the objects they connect, which follow their creation order.
+	// Deterministic spaces solve constraints in this order, whatever order they were paired in.
+	struct OrderKey {
+		uint64_t objects[MAX_BODIES] = {};
+		uint64_t sub_key = 0;
+
+		_FORCE_INLINE_ bool operator<(const OrderKey &p_other) const {
+			if (objects[0] != p_other.objects[0]) {
+				return objects[0] < p_other.objects[0];
+			}
+			if (objects[1] != p_other.objects[1]) {
+				return objects[1] < p_other.objects[1];
+			}
+			return sub_key < p_other.sub_key;
+		}
+
+		_FORCE_INLINE_ bool operator==(const OrderKey &p_other) const {
+			return objects[0] == p_other.objects[0] && objects[1] == p_other.objects[1] && sub_key == p_other.sub_key;
+		}
+	};
+
+private:
 	GodotBody2D **_body_ptr;
 	int _body_count;
 	uint64_t island_step = 0;
 	bool disabled_collisions_between_bodies = true;
 
+	GodotSolverBodies2D *solver_bodies = nullptr;
+	uint32_t solver_body_indices[MAX_BODIES] = {};
+
 	RID self;
 
 protected:
@@ -47,6 +78,10 @@ protected:
 		_body_count = p_body_count;
 	}
 
+	// Only valid in solve(), bodies are bound by the step after pre_solve().
+	_FORCE_INLINE_ GodotSolverBodies2D &get_solver_bodies() const { return *solver_bodies; }
+	_FORCE_INLINE_ uint32_t get_solver_body_index(int p_body) const { return solver_body_indices[p_body]; }
+
 public:
 	_FORCE_INLINE_ void set_self(const RID &p_self) { self = p_self; }
 	_FORCE_INLINE_ RID get_self() const { return self; }
@@ -57,6 +92,9 @@ public:
 	_FORCE_INLINE_ GodotBody2D **get_body_ptr() const { return _body_ptr; }
 	_FORCE_INLINE_ int get_body_count() const { return _body_count; }
 
+	_FORCE_INLINE_ void set_solver_bodies(GodotSolverBodies2D *p_solver_bodies) { solver_bodies = p_solver_bodies; }
+	_FORCE_INLINE_ void set_solver_body_index(int p_body, uint32_t p_index) { solver_body_indices[p_body] = p_index; }
+
 	_FORCE_INLINE_ void disable_collisions_between_bodies(const bool p_disabled) { disabled_collisions_between_bodies = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled_collisions_between_bodies() const { return disabled_collisions_between_bodies; }
 
@@ -64,6 +102,25 @@ public:
 	virtual bool pre_solve(real_t p_step) = 0;
 	virtual void solve(real_t p_step) = 0;
 
+	// Body pairs can also be solved four at a time, see GodotBodyPair2D::PackedGroup.
+	virtual bool can_solve_packed() const { return false; }
+
+	virtual OrderKey get_order_key() const {
+		OrderKey key;
+		for (int i = 0; i < MIN(_body_count, (int)MAX_BODIES); i++) {
+			key.objects[i] = _body_ptr[i]->get_self().get_id();
+		}
+		key.sub_key = self.get_id();
+		return key;
+	}
+
+	// Warm starting state kept in space snapshots, constraints that recompute everything each step have none.
+	// The constraint is identified by its order key, restore_snapshot_state() resets the state when given nullptr.
+	virtual bool is_body_pair() const { return false; }
+	virtual uint32_t get_snapshot_state_size() const { return 0; }
+	virtual void save_snapshot_state(uint8_t *r_state) const {}
+	virtual void restore_snapshot_state(const uint8_t *p_state) {}
+
 	virtual ~GodotConstraint2D() {}
 };
 
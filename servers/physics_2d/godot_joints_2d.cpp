@@ -82,18 +82,14 @@ static inline real_t k_scalar(GodotBody2D *a, GodotBody2D *b, const Vector2 &rA,
 }
 
 static inline Vector2
-relative_velocity(GodotBody2D *a, GodotBody2D *b, Vector2 rA, Vector2 rB) {
-	Vector2 sum = a->get_linear_velocity() - (rA - a->get_center_of_mass()).orthogonal() * a->get_angular_velocity();
-	if (b) {
-		return (b->get_linear_velocity() - (rB - b->get_center_of_mass()).orthogonal() * b->get_angular_velocity()) - sum;
-	} else {
-		return -sum;
-	}
+relative_velocity(const GodotSolverBodies2D &p_bodies, uint32_t p_a, uint32_t p_b, const Vector2 &rA, const Vector2 &rB) {
+	Vector2 sum = p_bodies.linear_velocity[p_a] - (rA - p_bodies.center_of_mass[p_a]).orthogonal() * p_bodies.angular_velocity[p_a];
+	return (p_bodies.linear_velocity[p_b] - (rB - p_bodies.center_of_mass[p_b]).orthogonal() * p_bodies.angular_velocity[p_b]) - sum;
 }
 
 static inline real_t
-normal_relative_velocity(GodotBody2D *a, GodotBody2D *b, Vector2 rA, Vector2 rB, Vector2 n) {
-	return relative_velocity(a, b, rA, rB).dot(n);
+normal_relative_velocity(const GodotSolverBodies2D &p_bodies, uint32_t p_a, uint32_t p_b, const Vector2 &rA, const Vector2 &rB, const Vector2 &n) {
+	return relative_velocity(p_bodies, p_a, p_b, rA, rB).dot(n);
 }
 
 bool GodotPinJoint2D::setup(real_t p_step) {
@@ -175,12 +171,16 @@ bool GodotPinJoint2D::pre_solve(real_t p_step) {
 }
 
 void GodotPinJoint2D::solve(real_t p_step) {
+	GodotSolverBodies2D &bodies = get_solver_bodies();
+	const uint32_t index_A = get_solver_body_index(0);
+	const uint32_t index_B = B ? get_solver_body_index(1) : 0;
+
 	// compute relative velocity
-	Vector2 vA = A->get_linear_velocity() - custom_cross(rA - A->get_center_of_mass(), A->get_angular_velocity());
+	Vector2 vA = bodies.linear_velocity[index_A] - custom_cross(rA - bodies.center_of_mass[index_A], bodies.angular_velocity[index_A]);
 
 	Vector2 rel_vel;
 	if (B) {
-		rel_vel = B->get_linear_velocity() - custom_cross(rB - B->get_center_of_mass(), B->get_angular_velocity()) - vA;
+		rel_vel = bodies.linear_velocity[index_B] - custom_cross(rB - bodies.center_of_mass[index_B], bodies.angular_velocity[index_B]) - vA;
 	} else {
 		rel_vel = -vA;
 	}
@@ -188,15 +188,27 @@ void GodotPinJoint2D::solve(real_t p_step) {
 	Vector2 impulse = M.basis_xform(bias - rel_vel - Vector2(softness, softness) * P);
 
 	if (dynamic_A) {
-		A->apply_impulse(-impulse, rA);
+		bodies.apply_impulse(index_A, -impulse, rA - bodies.center_of_mass[index_A]);
 	}
 	if (B && dynamic_B) {
-		B->apply_impulse(impulse, rB);
+		bodies.apply_impulse(index_B, impulse, rB - bodies.center_of_mass[index_B]);
 	}
 
 	P += impulse;
 }
 
+void GodotPinJoint2D::save_snapshot_state(uint8_t *r_state) const {
+	memcpy(r_state, &P, sizeof(P));
+}
+
+void GodotPinJoint2D::restore_snapshot_state(const uint8_t *p_state) {
+	if (p_state) {
+		memcpy(&P, p_state, sizeof(P));
+	} else {
+		P = Vector2();
+	}
+}
+
 void GodotPinJoint2D::set_param(PhysicsServer2D::PinJointParam p_param, real_t p_value) {
 	if (p_param == PhysicsServer2D::PIN_JOINT_SOFTNESS) {
 		softness = p_value;
@@ -346,8 +358,12 @@ bool GodotGrooveJoint2D::pre_solve(real_t p_step) {
 }
 
 void GodotGrooveJoint2D::solve(real_t p_step) {
+	GodotSolverBodies2D &bodies = get_solver_bodies();
+	const uint32_t index_A = get_solver_body_index(0);
+	const uint32_t index_B = get_solver_body_index(1);
+
 	// compute impulse
-	Vector2 vr = relative_velocity(A, B, rA, rB);
+	Vector2 vr = relative_velocity(bodies, index_A, index_B, rA, rB);
 
 	Vector2 j = mult_k(gbias - vr, k1, k2);
 	Vector2 jOld = jn_acc;
@@ -358,10 +374,22 @@ void GodotGrooveJoint2D::solve(real_t p_step) {
 	j = jn_acc - jOld;
 
 	if (dynamic_A) {
-		A->apply_impulse(-j, rA);
+		bodies.apply_impulse(index_A, -j, rA - bodies.center_of_mass[index_A]);
 	}
 	if (dynamic_B) {
-		B->apply_impulse(j, rB);
+		bodies.apply_impulse(index_B, j, rB - bodies.center_of_mass[index_B]);
+	}
+}
+
+void GodotGrooveJoint2D::save_snapshot_state(uint8_t *r_state) const {
+	memcpy(r_state, &jn_acc, sizeof(jn_acc));
+}
+
+void GodotGrooveJoint2D::restore_snapshot_state(const uint8_t *p_state) {
+	if (p_state) {
+		memcpy(&jn_acc, p_state, sizeof(jn_acc));
+	} else {
+		jn_acc = Vector2();
 	}
 }
 
@@ -429,8 +457,12 @@ bool GodotDampedSpringJoint2D::pre_solve(real_t p_step) {
 }
 
 void GodotDampedSpringJoint2D::solve(real_t p_step) {
+	GodotSolverBodies2D &bodies = get_solver_bodies();
+	const uint32_t index_A = get_solver_body_index(0);
+	const uint32_t index_B = get_solver_body_index(1);
+
 	// compute relative velocity
-	real_t vrn = normal_relative_velocity(A, B, rA, rB, n) - target_vrn;
+	real_t vrn = normal_relative_velocity(bodies, index_A, index_B, rA, rB, n) - target_vrn;
 
 	// compute velocity loss from drag
 	// not 100% certain this is derived correctly, though it makes sense
@@ -439,10 +471,10 @@ void GodotDampedSpringJoint2D::solve(real_t p_step) {
 	Vector2 j_new = n * v_damp * n_mass;
 
 	if (dynamic_A) {
-		A->apply_impulse(-j_new, rA);
+		bodies.apply_impulse(index_A, -j_new, rA - bodies.center_of_mass[index_A]);
 	}
 	if (dynamic_B) {
-		B->apply_impulse(j_new, rB);
+		bodies.apply_impulse(index_B, j_new, rB - bodies.center_of_mass[index_B]);
 	}
 }
 
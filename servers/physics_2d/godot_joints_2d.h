@@ -98,6 +98,10 @@ public:
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	virtual uint32_t get_snapshot_state_size() const override { return sizeof(P); }
+	virtual void save_snapshot_state(uint8_t *r_state) const override;
+	virtual void restore_snapshot_state(const uint8_t *p_state) override;
+
 	void set_param(PhysicsServer2D::PinJointParam p_param, real_t p_value);
 	real_t get_param(PhysicsServer2D::PinJointParam p_param) const;
 
@@ -135,6 +139,10 @@ public:
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	virtual uint32_t get_snapshot_state_size() const override { return sizeof(jn_acc); }
+	virtual void save_snapshot_state(uint8_t *r_state) const override;
+	virtual void restore_snapshot_state(const uint8_t *p_state) override;
+
 	GodotGrooveJoint2D(const Vector2 &p_a_groove1, const Vector2 &p_a_groove2, const Vector2 &p_b_anchor, GodotBody2D *p_body_a, GodotBody2D *p_body_b);
 };
 
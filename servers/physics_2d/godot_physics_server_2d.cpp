@@ -32,6 +32,7 @@
 
 #include "godot_body_direct_state_2d.h"
 #include "godot_broad_phase_2d_bvh.h"
+#include "godot_broad_phase_2d_hash_grid.h"
 #include "godot_collision_solver_2d.h"
 
 #include "core/config/project_settings.h"
@@ -284,6 +285,22 @@ PhysicsDirectSpaceState2D *GodotPhysicsServer2D::space_get_direct_state(RID p_sp
 	return space->get_direct_state();
 }
 
+void GodotPhysicsServer2D::space_save_snapshot(RID p_space, Vector<uint8_t> &r_snapshot) {
+	GodotSpace2D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_COND(!space);
+	ERR_FAIL_COND_MSG((using_threads && !doing_sync) || space->is_locked(), "Space state is inaccessible right now, wait for iteration or physics process notification.");
+
+	space->save_snapshot(r_snapshot);
+}
+
+Error GodotPhysicsServer2D::space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) {
+	GodotSpace2D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_COND_V(!space, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V_MSG((using_threads && !doing_sync) || space->is_locked(), ERR_BUSY, "Space state is inaccessible right now, wait for iteration or physics process notification.");
+
+	return space->restore_snapshot(p_snapshot);
+}
+
 RID GodotPhysicsServer2D::area_create() {
 	GodotArea2D *area = memnew(GodotArea2D);
 	RID rid = area_owner.make_rid(area);
@@ -1376,7 +1393,11 @@ GodotPhysicsServer2D *GodotPhysicsServer2D::godot_singleton = nullptr;
 
 GodotPhysicsServer2D::GodotPhysicsServer2D(bool p_using_threads) {
 	godot_singleton = this;
-	GodotBroadPhase2D::create_func = GodotBroadPhase2DBVH::_create;
+	if (int(GLOBAL_GET("physics/2d/broad_phase/type")) == BROAD_PHASE_HASH_GRID) {
+		GodotBroadPhase2D::create_func = GodotBroadPhase2DHashGrid::_create;
+	} else {
+		GodotBroadPhase2D::create_func = GodotBroadPhase2DBVH::_create;
+	}
 
 	using_threads = p_using_threads;
 }
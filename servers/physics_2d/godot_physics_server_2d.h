@@ -44,6 +44,14 @@ class GodotPhysicsServer2D : public PhysicsServer2D {
 
 	friend class GodotPhysicsDirectSpaceState2D;
 	friend class GodotPhysicsDirectBodyState2D;
+	friend class GodotSpace2D;
+
+	// Values of the physics/2d/broad_phase/type project setting.
+	enum BroadPhaseType {
+		BROAD_PHASE_BVH,
+		BROAD_PHASE_HASH_GRID,
+	};
+
 	bool active = true;
 	bool doing_sync = false;
 
@@ -119,6 +127,9 @@ public:
 	// this function only works on physics process, errors and returns null otherwise
 	virtual PhysicsDirectSpaceState2D *space_get_direct_state(RID p_space) override;
 
+	virtual void space_save_snapshot(RID p_space, Vector<uint8_t> &r_snapshot) override;
+	virtual Error space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) override;
+
 	/* AREA API */
 
 	virtual RID area_create() override;
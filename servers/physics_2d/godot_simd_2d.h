@@ -0,0 +1,178 @@
+/**************************************************************************/
+/*  godot_simd_2d.h                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_SIMD_2D_H
+#define GODOT_SIMD_2D_H
+
+#include "core/math/math_defs.h"
+#include "core/typedefs.h"
+
+// Four real_t values processed at once, used by the packed contact solver.
+// SSE2 and NEON are only used with single precision, other targets use plain arrays
+// the compiler is free to vectorize.
+
+#if !defined(REAL_T_IS_DOUBLE) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define GODOT_SIMD_2D_SSE2
+#include <emmintrin.h>
+#elif !defined(REAL_T_IS_DOUBLE) && (defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64))
+#define GODOT_SIMD_2D_NEON
+#include <arm_neon.h>
+#endif
+
+struct GodotReal4 {
+#if defined(GODOT_SIMD_2D_SSE2)
+	__m128 v;
+
+	_FORCE_INLINE_ GodotReal4() {}
+	_FORCE_INLINE_ GodotReal4(__m128 p_v) :
+			v(p_v) {}
+	_FORCE_INLINE_ GodotReal4(real_t p_value) :
+			v(_mm_set1_ps(p_value)) {}
+
+	static _FORCE_INLINE_ GodotReal4 load(const real_t *p_src) { return _mm_loadu_ps(p_src); }
+	_FORCE_INLINE_ void store(real_t *r_dst) const { _mm_storeu_ps(r_dst, v); }
+
+	_FORCE_INLINE_ GodotReal4 operator+(const GodotReal4 &p_other) const { return _mm_add_ps(v, p_other.v); }
+	_FORCE_INLINE_ GodotReal4 operator-(const GodotReal4 &p_other) const { return _mm_sub_ps(v, p_other.v); }
+	_FORCE_INLINE_ GodotReal4 operator*(const GodotReal4 &p_other) const { return _mm_mul_ps(v, p_other.v); }
+	_FORCE_INLINE_ GodotReal4 operator-() const { return _mm_xor_ps(v, _mm_set1_ps(-0.0f)); }
+
+	static _FORCE_INLINE_ GodotReal4 min(const GodotReal4 &p_a, const GodotReal4 &p_b) { return _mm_min_ps(p_a.v, p_b.v); }
+	static _FORCE_INLINE_ GodotReal4 max(const GodotReal4 &p_a, const GodotReal4 &p_b) { return _mm_max_ps(p_a.v, p_b.v); }
+	static _FORCE_INLINE_ GodotReal4 abs(const GodotReal4 &p_a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), p_a.v); }
+
+	// Returns p_a where p_cond_a > p_cond_b, p_b otherwise.
+	static _FORCE_INLINE_ GodotReal4 select_greater(const GodotReal4 &p_cond_a, const GodotReal4 &p_cond_b, const GodotReal4 &p_a, const GodotReal4 &p_b) {
+		__m128 mask = _mm_cmpgt_ps(p_cond_a.v, p_cond_b.v);
+		return _mm_or_ps(_mm_and_ps(mask, p_a.v), _mm_andnot_ps(mask, p_b.v));
+	}
+#elif defined(GODOT_SIMD_2D_NEON)
+	float32x4_t v;
+
+	_FORCE_INLINE_ GodotReal4() {}
+	_FORCE_INLINE_ GodotReal4(float32x4_t p_v) :
+			v(p_v) {}
+	_FORCE_INLINE_ GodotReal4(real_t p_value) :
+			v(vdupq_n_f32(p_value)) {}
+
+	static _FORCE_INLINE_ GodotReal4 load(const real_t *p_src) { return vld1q_f32(p_src); }
+	_FORCE_INLINE_ void store(real_t *r_dst) const { vst1q_f32(r_dst, v); }
+
+	_FORCE_INLINE_ GodotReal4 operator+(const GodotReal4 &p_other) const { return vaddq_f32(v, p_other.v); }
+	_FORCE_INLINE_ GodotReal4 operator-(const GodotReal4 &p_other) const { return vsubq_f32(v, p_other.v); }
+	_FORCE_INLINE_ GodotReal4 operator*(const GodotReal4 &p_other) const { return vmulq_f32(v, p_other.v); }
+	_FORCE_INLINE_ GodotReal4 operator-() const { return vnegq_f32(v); }
+
+	static _FORCE_INLINE_ GodotReal4 min(const GodotReal4 &p_a, const GodotReal4 &p_b) { return vminq_f32(p_a.v, p_b.v); }
+	static _FORCE_INLINE_ GodotReal4 max(const GodotReal4 &p_a, const GodotReal4 &p_b) { return vmaxq_f32(p_a.v, p_b.v); }
+	static _FORCE_INLINE_ GodotReal4 abs(const GodotReal4 &p_a) { return vabsq_f32(p_a.v); }
+
+	// Returns p_a where p_cond_a > p_cond_b, p_b otherwise.
+	static _FORCE_INLINE_ GodotReal4 select_greater(const GodotReal4 &p_cond_a, const GodotReal4 &p_cond_b, const GodotReal4 &p_a, const GodotReal4 &p_b) {
+		return vbslq_f32(vcgtq_f32(p_cond_a.v, p_cond_b.v), p_a.v, p_b.v);
+	}
+#else
+	real_t v[4];
+
+	_FORCE_INLINE_ GodotReal4() {}
+	_FORCE_INLINE_ GodotReal4(real_t p_value) {
+		v[0] = v[1] = v[2] = v[3] = p_value;
+	}
+
+	static _FORCE_INLINE_ GodotReal4 load(const real_t *p_src) {
+		GodotReal4 r;
+		for (int i = 0; i < 4; i++) {
+			r.v[i] = p_src[i];
+		}
+		return r;
+	}
+	_FORCE_INLINE_ void store(real_t *r_dst) const {
+		for (int i = 0; i < 4; i++) {
+			r_dst[i] = v[i];
+		}
+	}
+
+#define GODOT_REAL4_OP(m_op)                                                      \
+	_FORCE_INLINE_ GodotReal4 operator m_op(const GodotReal4 &p_other) const { \
+		GodotReal4 r;                                                              \
+		for (int i = 0; i < 4; i++) {                                              \
+			r.v[i] = v[i] m_op p_other.v[i];                                       \
+		}                                                                          \
+		return r;                                                                  \
+	}
+	GODOT_REAL4_OP(+)
+	GODOT_REAL4_OP(-)
+	GODOT_REAL4_OP(*)
+#undef GODOT_REAL4_OP
+
+	_FORCE_INLINE_ GodotReal4 operator-() const {
+		GodotReal4 r;
+		for (int i = 0; i < 4; i++) {
+			r.v[i] = -v[i];
+		}
+		return r;
+	}
+
+	static _FORCE_INLINE_ GodotReal4 min(const GodotReal4 &p_a, const GodotReal4 &p_b) {
+		GodotReal4 r;
+		for (int i = 0; i < 4; i++) {
+			r.v[i] = MIN(p_a.v[i], p_b.v[i]);
+		}
+		return r;
+	}
+	static _FORCE_INLINE_ GodotReal4 max(const GodotReal4 &p_a, const GodotReal4 &p_b) {
+		GodotReal4 r;
+		for (int i = 0; i < 4; i++) {
+			r.v[i] = MAX(p_a.v[i], p_b.v[i]);
+		}
+		return r;
+	}
+	static _FORCE_INLINE_ GodotReal4 abs(const GodotReal4 &p_a) {
+		GodotReal4 r;
+		for (int i = 0; i < 4; i++) {
+			r.v[i] = ABS(p_a.v[i]);
+		}
+		return r;
+	}
+
+	// Returns p_a where p_cond_a > p_cond_b, p_b otherwise.
+	static _FORCE_INLINE_ GodotReal4 select_greater(const GodotReal4 &p_cond_a, const GodotReal4 &p_cond_b, const GodotReal4 &p_a, const GodotReal4 &p_b) {
+		GodotReal4 r;
+		for (int i = 0; i < 4; i++) {
+			r.v[i] = p_cond_a.v[i] > p_cond_b.v[i] ? p_a.v[i] : p_b.v[i];
+		}
+		return r;
+	}
+#endif
+
+	static _FORCE_INLINE_ GodotReal4 clamp(const GodotReal4 &p_value, const GodotReal4 &p_min, const GodotReal4 &p_max) { return min(max(p_value, p_min), p_max); }
+};
+
+#endif // GODOT_SIMD_2D_H
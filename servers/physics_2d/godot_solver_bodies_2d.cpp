@@ -0,0 +1,71 @@
+/**************************************************************************/
+/*  godot_solver_bodies_2d.cpp                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "godot_solver_bodies_2d.h"
+
+#include "godot_body_2d.h"
+
+void GodotSolverBodies2D::gather() {
+	uint32_t body_count = bodies.size();
+
+	linear_velocity.resize(body_count);
+	angular_velocity.resize(body_count);
+	biased_linear_velocity.resize(body_count);
+	biased_angular_velocity.resize(body_count);
+	inv_mass.resize(body_count);
+	inv_inertia.resize(body_count);
+	center_of_mass.resize(body_count);
+
+	for (uint32_t body_index = 0; body_index < body_count; ++body_index) {
+		const GodotBody2D *body = bodies[body_index];
+		linear_velocity[body_index] = body->get_linear_velocity();
+		angular_velocity[body_index] = body->get_angular_velocity();
+		biased_linear_velocity[body_index] = body->get_biased_linear_velocity();
+		biased_angular_velocity[body_index] = body->get_biased_angular_velocity();
+		inv_mass[body_index] = body->get_inv_mass();
+		inv_inertia[body_index] = body->get_inv_inertia();
+		center_of_mass[body_index] = body->get_center_of_mass();
+	}
+}
+
+void GodotSolverBodies2D::scatter() const {
+	uint32_t body_count = bodies.size();
+
+	for (uint32_t body_index = 0; body_index < body_count; ++body_index) {
+		GodotBody2D *body = bodies[body_index];
+		if (body->get_mode() <= PhysicsServer2D::BODY_MODE_KINEMATIC) {
+			continue; // Constraints never apply impulses to these.
+		}
+		body->set_linear_velocity(linear_velocity[body_index]);
+		body->set_angular_velocity(angular_velocity[body_index]);
+		body->set_biased_linear_velocity(biased_linear_velocity[body_index]);
+		body->set_biased_angular_velocity(biased_angular_velocity[body_index]);
+	}
+}
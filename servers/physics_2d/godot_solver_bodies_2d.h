@@ -0,0 +1,91 @@
+/**************************************************************************/
+/*  godot_solver_bodies_2d.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_SOLVER_BODIES_2D_H
+#define GODOT_SOLVER_BODIES_2D_H
+
+#include "core/math/vector2.h"
+#include "core/templates/local_vector.h"
+
+class GodotBody2D;
+
+// Velocity and mass data of every body touched by a constraint during a step, stored
+// as parallel arrays so the solver iterations don't have to go through GodotBody2D.
+// Positions are relative to the center of mass of each body.
+class GodotSolverBodies2D {
+public:
+	LocalVector<GodotBody2D *> bodies;
+
+	LocalVector<Vector2> linear_velocity;
+	LocalVector<real_t> angular_velocity;
+	LocalVector<Vector2> biased_linear_velocity;
+	LocalVector<real_t> biased_angular_velocity;
+
+	LocalVector<real_t> inv_mass;
+	LocalVector<real_t> inv_inertia;
+	LocalVector<Vector2> center_of_mass;
+
+	_FORCE_INLINE_ uint32_t size() const { return bodies.size(); }
+
+	_FORCE_INLINE_ Vector2 get_velocity_at(uint32_t p_index, const Vector2 &p_rel_pos) const {
+		return linear_velocity[p_index] + Vector2(-angular_velocity[p_index] * p_rel_pos.y, angular_velocity[p_index] * p_rel_pos.x);
+	}
+
+	_FORCE_INLINE_ Vector2 get_biased_velocity_at(uint32_t p_index, const Vector2 &p_rel_pos) const {
+		return biased_linear_velocity[p_index] + Vector2(-biased_angular_velocity[p_index] * p_rel_pos.y, biased_angular_velocity[p_index] * p_rel_pos.x);
+	}
+
+	_FORCE_INLINE_ void apply_impulse(uint32_t p_index, const Vector2 &p_impulse, const Vector2 &p_rel_pos) {
+		linear_velocity[p_index] += p_impulse * inv_mass[p_index];
+		angular_velocity[p_index] += inv_inertia[p_index] * p_rel_pos.cross(p_impulse);
+	}
+
+	_FORCE_INLINE_ void apply_bias_impulse(uint32_t p_index, const Vector2 &p_impulse, const Vector2 &p_rel_pos, real_t p_max_delta_av = -1.0) {
+		biased_linear_velocity[p_index] += p_impulse * inv_mass[p_index];
+		if (p_max_delta_av != 0.0) {
+			real_t delta_av = inv_inertia[p_index] * p_rel_pos.cross(p_impulse);
+			if (p_max_delta_av > 0 && delta_av > p_max_delta_av) {
+				delta_av = p_max_delta_av;
+			}
+			biased_angular_velocity[p_index] += delta_av;
+		}
+	}
+
+	void clear() {
+		bodies.clear();
+	}
+
+	// Copies the state of the bound bodies into the arrays.
+	void gather();
+	// Copies the velocities back into the dynamic bodies.
+	void scatter() const;
+};
+
+#endif // GODOT_SOLVER_BODIES_2D_H
@@ -33,6 +33,7 @@
 #include "godot_collision_solver_2d.h"
 #include "godot_physics_server_2d.h"
 
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 #include "core/templates/pair.h"
 
@@ -114,17 +115,13 @@ int GodotPhysicsDirectSpaceState2D::intersect_point(const PointParameters &p_par
 	return cc;
 }
 
-bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
-	ERR_FAIL_COND_V(space->locked, false);
-
+bool GodotPhysicsDirectSpaceState2D::_intersect_ray_candidates(const RayParameters &p_parameters, GodotCollisionObject2D *const *p_objects, const int *p_shapes, int p_amount, RayResult &r_result) const {
 	Vector2 begin, end;
 	Vector2 normal;
 	begin = p_parameters.from;
 	end = p_parameters.to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
-
 	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
 	bool collided = false;
@@ -133,18 +130,18 @@ bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parame
 	const GodotCollisionObject2D *res_obj = nullptr;
 	real_t min_d = 1e10;
 
-	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+	for (int i = 0; i < p_amount; i++) {
+		if (!_can_collide_with(p_objects[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(p_objects[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject2D *col_obj = space->intersection_query_results[i];
+		const GodotCollisionObject2D *col_obj = p_objects[i];
 
-		int shape_idx = space->intersection_query_subindex_results[i];
+		int shape_idx = p_shapes[i];
 		Transform2D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector2 local_from = inv_xform.xform(begin);
@@ -204,6 +201,14 @@ bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parame
 	return true;
 }
 
+bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
+	ERR_FAIL_COND_V(space->locked, false);
+
+	int amount = space->broadphase->cull_segment(p_parameters.from, p_parameters.to, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+
+	return _intersect_ray_candidates(p_parameters, space->intersection_query_results, space->intersection_query_subindex_results, amount, r_result);
+}
+
 int GodotPhysicsDirectSpaceState2D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
 	if (p_result_max <= 0) {
 		return 0;
@@ -253,39 +258,30 @@ int GodotPhysicsDirectSpaceState2D::intersect_shape(const ShapeParameters &p_par
 	return cc;
 }
 
-bool GodotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe) {
-	GodotShape2D *shape = GodotPhysicsServer2D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
-	ERR_FAIL_COND_V(!shape, false);
-
-	Rect2 aabb = p_parameters.transform.xform(shape->get_aabb());
-	aabb = aabb.merge(Rect2(aabb.position + p_parameters.motion, aabb.size)); //motion
-	aabb = aabb.grow(p_parameters.margin);
-
-	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
-
+void GodotPhysicsDirectSpaceState2D::_cast_motion_candidates(const ShapeParameters &p_parameters, GodotShape2D *p_shape, GodotCollisionObject2D *const *p_objects, const int *p_shapes, int p_amount, real_t &r_closest_safe, real_t &r_closest_unsafe) const {
 	real_t best_safe = 1;
 	real_t best_unsafe = 1;
 
-	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+	for (int i = 0; i < p_amount; i++) {
+		if (!_can_collide_with(p_objects[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(p_objects[i]->get_self())) {
 			continue; //ignore excluded
 		}
 
-		const GodotCollisionObject2D *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const GodotCollisionObject2D *col_obj = p_objects[i];
+		int shape_idx = p_shapes[i];
 
 		Transform2D col_obj_xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
 		//test initial overlap, does it collide if going all the way?
-		if (!GodotCollisionSolver2D::solve(shape, p_parameters.transform, p_parameters.motion, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
+		if (!GodotCollisionSolver2D::solve(p_shape, p_parameters.transform, p_parameters.motion, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
 			continue;
 		}
 
 		//test initial overlap, ignore objects it's inside of.
-		if (GodotCollisionSolver2D::solve(shape, p_parameters.transform, Vector2(), col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
+		if (GodotCollisionSolver2D::solve(p_shape, p_parameters.transform, Vector2(), col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
 			continue;
 		}
 
@@ -299,7 +295,7 @@ bool GodotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parame
 			real_t fraction = low + (hi - low) * fraction_coeff;
 
 			Vector2 sep = mnormal; //important optimization for this to work fast enough
-			bool collided = GodotCollisionSolver2D::solve(shape, p_parameters.transform, p_parameters.motion * fraction, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, &sep, p_parameters.margin);
+			bool collided = GodotCollisionSolver2D::solve(p_shape, p_parameters.transform, p_parameters.motion * fraction, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, &sep, p_parameters.margin);
 
 			if (collided) {
 				hi = fraction;
@@ -330,8 +326,21 @@ bool GodotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parame
 		}
 	}
 
-	p_closest_safe = best_safe;
-	p_closest_unsafe = best_unsafe;
+	r_closest_safe = best_safe;
+	r_closest_unsafe = best_unsafe;
+}
+
+bool GodotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe) {
+	GodotShape2D *shape = GodotPhysicsServer2D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_COND_V(!shape, false);
+
+	Rect2 aabb = p_parameters.transform.xform(shape->get_aabb());
+	aabb = aabb.merge(Rect2(aabb.position + p_parameters.motion, aabb.size)); //motion
+	aabb = aabb.grow(p_parameters.margin);
+
+	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+
+	_cast_motion_candidates(p_parameters, shape, space->intersection_query_results, space->intersection_query_subindex_results, amount, p_closest_safe, p_closest_unsafe);
 
 	return true;
 }
@@ -502,6 +511,110 @@ bool GodotPhysicsDirectSpaceState2D::rest_info(const ShapeParameters &p_paramete
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void GodotPhysicsDirectSpaceState2D::_batch_add_candidates(int p_amount) {
+	for (int i = 0; i < p_amount; i++) {
+		batch_objects.push_back(space->intersection_query_results[i]);
+		batch_shapes.push_back(space->intersection_query_subindex_results[i]);
+	}
+	batch_offsets.push_back(batch_objects.size());
+}
+
+void GodotPhysicsDirectSpaceState2D::_intersect_ray_batch_task(uint32_t p_index, RayBatch *p_batch) {
+	uint32_t from = batch_offsets[p_index];
+	uint32_t amount = batch_offsets[p_index + 1] - from;
+	p_batch->collided[p_index] = _intersect_ray_candidates(p_batch->parameters[p_index], batch_objects.ptr() + from, batch_shapes.ptr() + from, amount, p_batch->results[p_index]);
+}
+
+void GodotPhysicsDirectSpaceState2D::_cast_motion_batch_task(uint32_t p_index, MotionBatch *p_batch) {
+	if (!batch_query_shapes[p_index]) {
+		return;
+	}
+	uint32_t from = batch_offsets[p_index];
+	uint32_t amount = batch_offsets[p_index + 1] - from;
+	_cast_motion_candidates(p_batch->parameters[p_index], batch_query_shapes[p_index], batch_objects.ptr() + from, batch_shapes.ptr() + from, amount, p_batch->closest_safe[p_index], p_batch->closest_unsafe[p_index]);
+}
+
+void GodotPhysicsDirectSpaceState2D::intersect_ray_batch(const RayParameters *p_parameters, int p_count, RayResult *r_results, bool *r_collided, bool p_use_threads) {
+	ERR_FAIL_COND(space->locked);
+	if (p_count <= 0) {
+		return;
+	}
+
+	// The broadphase can't be culled from several threads at once, so every query is culled
+	// here first and only the narrow phase tests run in parallel.
+	batch_objects.clear();
+	batch_shapes.clear();
+	batch_offsets.clear();
+	batch_offsets.push_back(0);
+
+	for (int i = 0; i < p_count; i++) {
+		int amount = space->broadphase->cull_segment(p_parameters[i].from, p_parameters[i].to, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+		_batch_add_candidates(amount);
+	}
+
+	RayBatch batch;
+	batch.parameters = p_parameters;
+	batch.results = r_results;
+	batch.collided = r_collided;
+
+	if (p_use_threads && p_count >= BATCH_THREAD_MIN_QUERIES && WorkerThreadPool::get_singleton()->get_thread_count() > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotPhysicsDirectSpaceState2D::_intersect_ray_batch_task, &batch, p_count, -1, true, SNAME("Physics2DRayBatch"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (int i = 0; i < p_count; i++) {
+			_intersect_ray_batch_task(i, &batch);
+		}
+	}
+}
+
+void GodotPhysicsDirectSpaceState2D::cast_motion_batch(const ShapeParameters *p_parameters, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe, bool p_use_threads) {
+	ERR_FAIL_COND(space->locked);
+	if (p_count <= 0) {
+		return;
+	}
+
+	batch_objects.clear();
+	batch_shapes.clear();
+	batch_offsets.clear();
+	batch_offsets.push_back(0);
+	batch_query_shapes.resize(p_count);
+
+	for (int i = 0; i < p_count; i++) {
+		const ShapeParameters &parameters = p_parameters[i];
+		GodotShape2D *shape = GodotPhysicsServer2D::godot_singleton->shape_owner.get_or_null(parameters.shape_rid);
+		batch_query_shapes[i] = shape;
+		if (!shape) {
+			// Same result as a failed cast_motion(), the other queries still run.
+			r_closest_safe[i] = 1.0;
+			r_closest_unsafe[i] = 1.0;
+			_batch_add_candidates(0);
+			ERR_PRINT("Invalid shape RID in the motion cast batch.");
+			continue;
+		}
+
+		Rect2 aabb = parameters.transform.xform(shape->get_aabb());
+		aabb = aabb.merge(Rect2(aabb.position + parameters.motion, aabb.size)); //motion
+		aabb = aabb.grow(parameters.margin);
+
+		int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+		_batch_add_candidates(amount);
+	}
+
+	MotionBatch batch;
+	batch.parameters = p_parameters;
+	batch.closest_safe = r_closest_safe;
+	batch.closest_unsafe = r_closest_unsafe;
+
+	if (p_use_threads && p_count >= BATCH_THREAD_MIN_QUERIES && WorkerThreadPool::get_singleton()->get_thread_count() > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotPhysicsDirectSpaceState2D::_cast_motion_batch_task, &batch, p_count, -1, true, SNAME("Physics2DMotionBatch"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (int i = 0; i < p_count; i++) {
+			_cast_motion_batch_task(i, &batch);
+		}
+	}
+}
+
 int GodotSpace2D::_cull_aabb_for_body(GodotBody2D *p_body, const Rect2 &p_aabb) {
 	int amount = broadphase->cull_aabb(p_aabb, intersection_query_results, INTERSECTION_QUERY_MAX, intersection_query_subindex_results);
 
@@ -1034,6 +1147,11 @@ void *GodotSpace2D::_broadphase_pair(GodotCollisionObject2D *A, int p_subindex_A
 		}
 
 	} else {
+		if (self->solver_deterministic && B->get_self() < A->get_self()) {
+			// Keep the same body first whichever order the broadphase reports the pair in.
+			SWAP(A, B);
+			SWAP(p_subindex_A, p_subindex_B);
+		}
 		GodotBodyPair2D *b = memnew(GodotBodyPair2D(static_cast<GodotBody2D *>(A), p_subindex_A, static_cast<GodotBody2D *>(B), p_subindex_B));
 		return b;
 	}
@@ -1074,6 +1192,21 @@ GodotBroadPhase2D *GodotSpace2D::get_broadphase() {
 	return broadphase;
 }
 
+void GodotSpace2D::begin_broadphase_move_batch() {
+	broadphase_move_batching = true;
+}
+
+void GodotSpace2D::end_broadphase_move_batch() {
+	broadphase_move_batching = false;
+	if (broadphase_move_ids.is_empty()) {
+		return;
+	}
+
+	broadphase->move_batch(broadphase_move_ids.ptr(), broadphase_move_aabbs.ptr(), broadphase_move_ids.size());
+	broadphase_move_ids.clear();
+	broadphase_move_aabbs.clear();
+}
+
 void GodotSpace2D::add_object(GodotCollisionObject2D *p_object) {
 	ERR_FAIL_COND(objects.has(p_object));
 	objects.insert(p_object);
@@ -1096,6 +1229,14 @@ void GodotSpace2D::body_remove_from_state_query_list(SelfList<GodotBody2D> *p_bo
 	state_query_list.remove(p_body);
 }
 
+void GodotSpace2D::body_add_to_ccd_list(SelfList<GodotBody2D> *p_body) {
+	ccd_list.add(p_body);
+}
+
+void GodotSpace2D::body_remove_from_ccd_list(SelfList<GodotBody2D> *p_body) {
+	ccd_list.remove(p_body);
+}
+
 void GodotSpace2D::area_add_to_monitor_query_list(SelfList<GodotArea2D> *p_area) {
 	monitor_query_list.add(p_area);
 }
@@ -1133,16 +1274,382 @@ void GodotSpace2D::call_queries() {
 void GodotSpace2D::setup() {
 	contact_debug_count = 0;
 
+	contact_cache_step++;
+	_contact_cache_expire();
+
 	while (mass_properties_update_list.first()) {
 		mass_properties_update_list.first()->self()->update_mass_properties();
 		mass_properties_update_list.remove(mass_properties_update_list.first());
 	}
 }
 
+void GodotSpace2D::_contact_cache_clear() {
+	contact_cache.clear();
+	contact_cache_expiry.clear();
+	contact_cache_expiry_first = 0;
+}
+
+void GodotSpace2D::_contact_cache_expire() {
+	// Forget the manifolds of pairs that didn't come back in time.
+	while (contact_cache_expiry_first < contact_cache_expiry.size()) {
+		const ContactCacheExpiry &expiry = contact_cache_expiry[contact_cache_expiry_first];
+		if (expiry.step + contact_cache_steps >= contact_cache_step) {
+			break;
+		}
+		HashMap<ContactCacheKey, CachedContactManifold, ContactCacheKeyHasher>::Iterator E = contact_cache.find(expiry.key);
+		if (E && E->value.step == expiry.step) {
+			contact_cache.remove(E);
+		}
+		contact_cache_expiry_first++;
+	}
+
+	if (contact_cache_expiry_first == contact_cache_expiry.size()) {
+		contact_cache_expiry.clear();
+		contact_cache_expiry_first = 0;
+	} else if (contact_cache_expiry_first * 2 >= contact_cache_expiry.size()) {
+		uint32_t remaining = contact_cache_expiry.size() - contact_cache_expiry_first;
+		for (uint32_t i = 0; i < remaining; i++) {
+			contact_cache_expiry[i] = contact_cache_expiry[contact_cache_expiry_first + i];
+		}
+		contact_cache_expiry.resize(remaining);
+		contact_cache_expiry_first = 0;
+	}
+}
+
+void GodotSpace2D::_contact_cache_sort_expiry() {
+	// Restored manifolds don't come in step order.
+	contact_cache_expiry.clear();
+	contact_cache_expiry_first = 0;
+	for (const KeyValue<ContactCacheKey, CachedContactManifold> &E : contact_cache) {
+		ContactCacheExpiry expiry;
+		expiry.key = E.key;
+		expiry.step = E.value.step;
+		contact_cache_expiry.push_back(expiry);
+	}
+	contact_cache_expiry.sort();
+}
+
+void GodotSpace2D::contact_cache_store(const GodotBody2D *p_body_A, int p_shape_A, const GodotBody2D *p_body_B, int p_shape_B, const CachedContactManifold &p_manifold) {
+	if (contact_cache_steps == 0 || p_manifold.contact_count == 0) {
+		return;
+	}
+
+	ContactCacheKey key;
+	CachedContactManifold manifold = p_manifold;
+	manifold.step = contact_cache_step;
+
+	// Keys are ordered by RID, the pair can be created the other way around next time.
+	if (p_body_B->get_self() < p_body_A->get_self()) {
+		key.body_A = p_body_B->get_self();
+		key.shape_A = p_shape_B;
+		key.body_B = p_body_A->get_self();
+		key.shape_B = p_shape_A;
+		for (int i = 0; i < manifold.contact_count; i++) {
+			SWAP(manifold.contacts[i].local_A, manifold.contacts[i].local_B);
+			manifold.contacts[i].normal = -manifold.contacts[i].normal;
+		}
+	} else {
+		key.body_A = p_body_A->get_self();
+		key.shape_A = p_shape_A;
+		key.body_B = p_body_B->get_self();
+		key.shape_B = p_shape_B;
+	}
+
+	contact_cache.insert(key, manifold);
+
+	ContactCacheExpiry expiry;
+	expiry.key = key;
+	expiry.step = manifold.step;
+	contact_cache_expiry.push_back(expiry);
+}
+
+bool GodotSpace2D::contact_cache_take(const GodotBody2D *p_body_A, int p_shape_A, const GodotBody2D *p_body_B, int p_shape_B, CachedContactManifold &r_manifold) {
+	if (contact_cache.is_empty()) {
+		return false;
+	}
+
+	bool swapped = p_body_B->get_self() < p_body_A->get_self();
+
+	ContactCacheKey key;
+	key.body_A = swapped ? p_body_B->get_self() : p_body_A->get_self();
+	key.shape_A = swapped ? p_shape_B : p_shape_A;
+	key.body_B = swapped ? p_body_A->get_self() : p_body_B->get_self();
+	key.shape_B = swapped ? p_shape_A : p_shape_B;
+
+	HashMap<ContactCacheKey, CachedContactManifold, ContactCacheKeyHasher>::Iterator E = contact_cache.find(key);
+	if (!E) {
+		return false;
+	}
+
+	bool valid = E->value.step + contact_cache_steps >= contact_cache_step;
+	r_manifold = E->value;
+	contact_cache.remove(E);
+
+	if (!valid) {
+		return false;
+	}
+
+	if (swapped) {
+		for (int i = 0; i < r_manifold.contact_count; i++) {
+			SWAP(r_manifold.contacts[i].local_A, r_manifold.contacts[i].local_B);
+			r_manifold.contacts[i].normal = -r_manifold.contacts[i].normal;
+		}
+	}
+
+	return true;
+}
+
 void GodotSpace2D::update() {
 	broadphase->update();
 }
 
+real_t GodotSpace2D::_get_ccd_shape_radius(const GodotBody2D *p_body, int p_shape) {
+	Rect2 aabb = p_body->get_shape_transform(p_shape).xform(p_body->get_shape(p_shape)->get_aabb());
+	real_t radius_squared = aabb.position.length_squared();
+	radius_squared = MAX(radius_squared, Vector2(aabb.position.x + aabb.size.x, aabb.position.y).length_squared());
+	radius_squared = MAX(radius_squared, Vector2(aabb.position.x, aabb.position.y + aabb.size.y).length_squared());
+	radius_squared = MAX(radius_squared, (aabb.position + aabb.size).length_squared());
+	return Math::sqrt(radius_squared);
+}
+
+bool GodotSpace2D::_is_ccd_motion_fast(const GodotBody2D *p_body, const Transform2D &p_from, const Transform2D &p_to) const {
+	real_t min_size = 0.0;
+	real_t radius = 0.0;
+	bool has_shapes = false;
+
+	for (int i = 0; i < p_body->get_shape_count(); i++) {
+		if (p_body->is_shape_disabled(i)) {
+			continue;
+		}
+		Size2 size = p_body->get_shape_transform(i).xform(p_body->get_shape(i)->get_aabb()).size;
+		min_size = has_shapes ? MIN(min_size, MIN(size.x, size.y)) : MIN(size.x, size.y);
+		radius = MAX(radius, _get_ccd_shape_radius(p_body, i));
+		has_shapes = true;
+	}
+
+	if (!has_shapes) {
+		return false;
+	}
+
+	real_t rotation = p_from.get_rotation();
+	real_t motion = p_from.get_origin().distance_to(p_to.get_origin());
+	motion += Math::abs(Math::lerp_angle(rotation, p_to.get_rotation(), (real_t)1.0) - rotation) * radius;
+
+	// Slower bodies can't go through anything in a single step, the contact solver pushes them back out.
+	return motion > min_size * 0.3;
+}
+
+void GodotSpace2D::_cull_ccd_candidates(CCDBody &r_ccd_body) {
+	real_t radius = 0.0;
+	for (int i = 0; i < r_ccd_body.body->get_shape_count(); i++) {
+		if (!r_ccd_body.body->is_shape_disabled(i)) {
+			radius = MAX(radius, _get_ccd_shape_radius(r_ccd_body.body, i));
+		}
+	}
+
+	Rect2 swept_aabb(r_ccd_body.from.get_origin(), Vector2());
+	swept_aabb.expand_to(r_ccd_body.to.get_origin());
+	swept_aabb = swept_aabb.grow(radius + contact_max_allowed_penetration);
+
+	int amount = _cull_aabb_for_body(r_ccd_body.body, swept_aabb);
+
+	r_ccd_body.candidate_offset = ccd_candidates.size();
+	r_ccd_body.candidate_count = amount;
+	for (int i = 0; i < amount; i++) {
+		CCDCandidate candidate;
+		candidate.body = static_cast<GodotBody2D *>(intersection_query_results[i]);
+		candidate.shape = intersection_query_subindex_results[i];
+		ccd_candidates.push_back(candidate);
+	}
+}
+
+void GodotSpace2D::_find_first_impact(uint32_t p_index, void *p_userdata) {
+	CCDBody &ccd_body = ccd_bodies[p_index];
+	ccd_body.collided = false;
+	ccd_body.impact.time = 1.0;
+
+	const GodotBody2D *body = ccd_body.body;
+	Vector2 motion = ccd_body.to.get_origin() - ccd_body.from.get_origin();
+
+	for (int i = 0; i < body->get_shape_count(); i++) {
+		if (body->is_shape_disabled(i)) {
+			continue;
+		}
+		const GodotShape2D *shape = body->get_shape(i);
+
+		GodotCollisionSolver2D::ShapeMotion motion_A;
+		motion_A.from = ccd_body.from;
+		motion_A.to = ccd_body.to;
+		motion_A.shape_transform = body->get_shape_transform(i);
+		motion_A.radius = _get_ccd_shape_radius(body, i);
+
+		for (uint32_t j = 0; j < ccd_body.candidate_count; j++) {
+			const CCDCandidate &candidate = ccd_candidates[ccd_body.candidate_offset + j];
+			const GodotBody2D *collider = candidate.body;
+
+			// Other bodies are taken where they ended the step.
+			GodotCollisionSolver2D::ShapeMotion motion_B;
+			motion_B.from = collider->get_transform();
+			motion_B.to = collider->get_transform();
+			motion_B.shape_transform = collider->get_shape_transform(candidate.shape);
+
+			// One-way shapes only stop bodies moving along their direction.
+			if (shape->allows_one_way_collision() && collider->is_shape_set_as_one_way_collision(candidate.shape)) {
+				Vector2 direction = (motion_B.to * motion_B.shape_transform).columns[1].normalized();
+				if (direction.dot(motion) < CMP_EPSILON) {
+					continue;
+				}
+			}
+
+			GodotCollisionSolver2D::TimeOfImpact impact;
+			if (!GodotCollisionSolver2D::solve_time_of_impact(shape, motion_A, collider->get_shape(candidate.shape), motion_B, contact_max_allowed_penetration, impact)) {
+				continue;
+			}
+
+			if (impact.time < ccd_body.impact.time) {
+				ccd_body.collided = true;
+				ccd_body.shape = i;
+				ccd_body.collider = candidate;
+				ccd_body.impact = impact;
+			}
+		}
+	}
+}
+
+void GodotSpace2D::_apply_ccd_impulse(const CCDBody &p_ccd_body, const Transform2D &p_transform) {
+	GodotBody2D *A = p_ccd_body.body;
+	GodotBody2D *B = p_ccd_body.collider.body;
+	bool dynamic_B = B->get_mode() > PhysicsServer2D::BODY_MODE_KINEMATIC;
+
+	const Vector2 &normal = p_ccd_body.impact.normal;
+	Vector2 offset_A = p_ccd_body.impact.point_A - p_transform.get_origin();
+	Vector2 offset_B = p_ccd_body.impact.point_B - B->get_transform().get_origin();
+	Vector2 rA = offset_A - A->get_center_of_mass();
+	Vector2 rB = offset_B - B->get_center_of_mass();
+
+	Vector2 relative_velocity = A->get_velocity_in_local_point(rA) - B->get_velocity_in_local_point(rB);
+	real_t normal_velocity = relative_velocity.dot(normal);
+	if (normal_velocity <= 0.0) {
+		return; // Already moving apart.
+	}
+
+	real_t rnA = rA.cross(normal);
+	real_t k_normal = A->get_inv_mass() + A->get_inv_inertia() * rnA * rnA;
+	if (dynamic_B) {
+		real_t rnB = rB.cross(normal);
+		k_normal += B->get_inv_mass() + B->get_inv_inertia() * rnB * rnB;
+	}
+	if (k_normal <= CMP_EPSILON) {
+		return;
+	}
+
+	real_t normal_impulse = (1.0 + combine_bounce(A, B)) * normal_velocity / k_normal;
+	Vector2 impulse = normal * normal_impulse;
+
+	Vector2 tangent_velocity = relative_velocity - normal * normal_velocity;
+	real_t tangent_speed = tangent_velocity.length();
+	if (tangent_speed > CMP_EPSILON) {
+		Vector2 tangent = tangent_velocity / tangent_speed;
+		real_t rtA = rA.cross(tangent);
+		real_t k_tangent = A->get_inv_mass() + A->get_inv_inertia() * rtA * rtA;
+		if (dynamic_B) {
+			real_t rtB = rB.cross(tangent);
+			k_tangent += B->get_inv_mass() + B->get_inv_inertia() * rtB * rtB;
+		}
+		real_t tangent_impulse = MIN(tangent_speed / k_tangent, combine_friction(A, B) * normal_impulse);
+		impulse += tangent * tangent_impulse;
+	}
+
+	A->apply_impulse(-impulse, offset_A);
+	if (dynamic_B) {
+		B->apply_impulse(impulse, offset_B);
+		B->wakeup();
+	}
+}
+
+void GodotSpace2D::solve_continuous_collisions(real_t p_step) {
+	ccd_bodies.clear();
+	ccd_candidates.clear();
+
+	while (ccd_list.first()) {
+		GodotBody2D *body = ccd_list.first()->self();
+		ccd_list.remove(ccd_list.first());
+
+		if (!_is_ccd_motion_fast(body, body->get_ccd_from_transform(), body->get_transform())) {
+			continue;
+		}
+
+		CCDBody ccd_body;
+		ccd_body.body = body;
+		ccd_body.from = body->get_ccd_from_transform();
+		ccd_body.to = body->get_transform();
+		ccd_bodies.push_back(ccd_body);
+	}
+
+	if (ccd_bodies.is_empty()) {
+		return;
+	}
+
+	if (solver_deterministic) {
+		ccd_bodies.sort_custom<CCDBodyComparator>();
+	}
+
+	// Broadphase culls share their result buffers, so only the time of impact searches run on threads.
+	for (CCDBody &ccd_body : ccd_bodies) {
+		_cull_ccd_candidates(ccd_body);
+	}
+
+	uint32_t ccd_body_count = ccd_bodies.size();
+	if (ccd_body_count >= CCD_THREAD_MIN_BODIES && WorkerThreadPool::get_singleton()->get_thread_count() > 1) {
+		int task_count = solver_max_threads > 0 ? solver_max_threads : -1;
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotSpace2D::_find_first_impact, nullptr, ccd_body_count, task_count, true, SNAME("Physics2DContinuousCollisions"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < ccd_body_count; i++) {
+			_find_first_impact(i);
+		}
+	}
+
+	// Impacts change the velocity of the bodies that are hit, so they're resolved one body at a time.
+	// Only the bodies that hit something are sub-stepped, up to ccd_max_substeps impacts per step.
+	for (uint32_t i = 0; i < ccd_body_count; i++) {
+		CCDBody &ccd_body = ccd_bodies[i];
+		if (!ccd_body.collided) {
+			continue;
+		}
+
+		GodotBody2D *body = ccd_body.body;
+		real_t remaining = p_step;
+		Transform2D final_transform;
+
+		for (int substep = 0; ccd_body.collided; substep++) {
+			Transform2D impact_transform = ccd_body.from.interpolate_with(ccd_body.to, ccd_body.impact.time);
+			_apply_ccd_impulse(ccd_body, impact_transform);
+			remaining *= 1.0 - ccd_body.impact.time;
+			final_transform = impact_transform;
+
+			if (substep + 1 >= ccd_max_substeps) {
+				break;
+			}
+
+			// Move the rest of the step with the new velocity, like integrate_velocities() does.
+			real_t angle_delta = body->get_angular_velocity() * remaining;
+			Vector2 center_of_mass = impact_transform.basis_xform(body->get_center_of_mass_local());
+			Vector2 position = impact_transform.get_origin() + body->get_linear_velocity() * remaining;
+			position += center_of_mass - center_of_mass.rotated(angle_delta);
+
+			ccd_body.from = impact_transform;
+			ccd_body.to = Transform2D(impact_transform.get_rotation() + angle_delta, position);
+			final_transform = ccd_body.to;
+
+			_cull_ccd_candidates(ccd_body);
+			_find_first_impact(i);
+		}
+
+		body->set_ccd_transform(final_transform);
+	}
+}
+
 void GodotSpace2D::set_param(PhysicsServer2D::SpaceParameter p_param, real_t p_value) {
 	switch (p_param) {
 		case PhysicsServer2D::SPACE_PARAM_CONTACT_RECYCLE_RADIUS:
@@ -1172,6 +1679,27 @@ void GodotSpace2D::set_param(PhysicsServer2D::SpaceParameter p_param, real_t p_v
 		case PhysicsServer2D::SPACE_PARAM_SOLVER_ITERATIONS:
 			solver_iterations = p_value;
 			break;
+		case PhysicsServer2D::SPACE_PARAM_SOLVER_GRAPH_COLORING:
+			solver_graph_coloring = p_value != 0.0;
+			break;
+		case PhysicsServer2D::SPACE_PARAM_SOLVER_MAX_THREADS:
+			solver_max_threads = MAX((int)p_value, 0);
+			break;
+		case PhysicsServer2D::SPACE_PARAM_CONTACT_CACHE_STEPS:
+			contact_cache_steps = MAX((int)p_value, 0);
+			if (contact_cache_steps == 0) {
+				_contact_cache_clear();
+			}
+			break;
+		case PhysicsServer2D::SPACE_PARAM_SOLVER_DETERMINISTIC:
+			solver_deterministic = p_value != 0.0;
+			break;
+		case PhysicsServer2D::SPACE_PARAM_CCD_MAX_SUBSTEPS:
+			ccd_max_substeps = MAX((int)p_value, 1);
+			break;
+		case PhysicsServer2D::SPACE_PARAM_SOLVER_PACKED_CONTACTS:
+			solver_packed_contacts = p_value != 0.0;
+			break;
 	}
 }
 
@@ -1195,6 +1723,18 @@ real_t GodotSpace2D::get_param(PhysicsServer2D::SpaceParameter p_param) const {
 			return constraint_bias;
 		case PhysicsServer2D::SPACE_PARAM_SOLVER_ITERATIONS:
 			return solver_iterations;
+		case PhysicsServer2D::SPACE_PARAM_SOLVER_GRAPH_COLORING:
+			return solver_graph_coloring ? 1.0 : 0.0;
+		case PhysicsServer2D::SPACE_PARAM_SOLVER_MAX_THREADS:
+			return solver_max_threads;
+		case PhysicsServer2D::SPACE_PARAM_CONTACT_CACHE_STEPS:
+			return contact_cache_steps;
+		case PhysicsServer2D::SPACE_PARAM_SOLVER_DETERMINISTIC:
+			return solver_deterministic ? 1.0 : 0.0;
+		case PhysicsServer2D::SPACE_PARAM_CCD_MAX_SUBSTEPS:
+			return ccd_max_substeps;
+		case PhysicsServer2D::SPACE_PARAM_SOLVER_PACKED_CONTACTS:
+			return solver_packed_contacts ? 1.0 : 0.0;
 	}
 	return 0;
 }
@@ -1211,6 +1751,231 @@ bool GodotSpace2D::is_locked() const {
 	return locked;
 }
 
+void GodotSpace2D::save_snapshot(Vector<uint8_t> &r_snapshot) {
+	SnapshotHeader header;
+	uint32_t size = sizeof(SnapshotHeader);
+
+	for (const GodotCollisionObject2D *object : objects) {
+		if (object->get_type() != GodotCollisionObject2D::TYPE_BODY) {
+			continue;
+		}
+		header.body_count++;
+		size += sizeof(SnapshotBody);
+
+		// Constraints are saved with their first body so each is written once.
+		const GodotBody2D *body = static_cast<const GodotBody2D *>(object);
+		for (const Pair<GodotConstraint2D *, int> &E : body->get_constraint_list()) {
+			uint32_t state_size = E.first->get_snapshot_state_size();
+			if (E.second == 0 && state_size > 0) {
+				header.constraint_count++;
+				size += sizeof(SnapshotConstraint) + state_size;
+			}
+		}
+	}
+
+	header.constraint_count += contact_cache.size();
+	size += contact_cache.size() * (sizeof(SnapshotConstraint) + sizeof(CachedContactManifold));
+
+	// Records are zeroed before being filled, so the same state always gives the same bytes, padding included.
+	r_snapshot.resize(size);
+	uint8_t *w = r_snapshot.ptrw();
+	memcpy(w, &header, sizeof(SnapshotHeader));
+	w += sizeof(SnapshotHeader);
+
+	for (const GodotCollisionObject2D *object : objects) {
+		if (object->get_type() != GodotCollisionObject2D::TYPE_BODY) {
+			continue;
+		}
+		const GodotBody2D *body = static_cast<const GodotBody2D *>(object);
+
+		SnapshotBody record;
+		memset((void *)&record, 0, sizeof(SnapshotBody));
+		record.rid = body->get_self().get_id();
+		body->get_snapshot_state(record.state);
+		memcpy(w, &record, sizeof(SnapshotBody));
+		w += sizeof(SnapshotBody);
+	}
+
+	// Constraints are saved in key order, the order of the body lists depends on when the pairs were created.
+	LocalVector<const GodotConstraint2D *> saved_constraints;
+	for (const GodotCollisionObject2D *object : objects) {
+		if (object->get_type() != GodotCollisionObject2D::TYPE_BODY) {
+			continue;
+		}
+		const GodotBody2D *body = static_cast<const GodotBody2D *>(object);
+
+		for (const Pair<GodotConstraint2D *, int> &E : body->get_constraint_list()) {
+			if (E.second == 0 && E.first->get_snapshot_state_size() > 0) {
+				saved_constraints.push_back(E.first);
+			}
+		}
+	}
+	saved_constraints.sort_custom<ConstraintOrderSort>();
+
+	for (const GodotConstraint2D *constraint : saved_constraints) {
+		SnapshotConstraint record;
+		memset((void *)&record, 0, sizeof(SnapshotConstraint));
+		record.key = constraint->get_order_key();
+		record.state_size = constraint->get_snapshot_state_size();
+		record.flags = constraint->is_body_pair() ? SNAPSHOT_CONSTRAINT_BODY_PAIR : 0;
+		memcpy(w, &record, sizeof(SnapshotConstraint));
+		w += sizeof(SnapshotConstraint);
+		constraint->save_snapshot_state(w);
+		w += record.state_size;
+	}
+
+	// The cache is saved in key order, its own order depends on when the pairs were stored.
+	LocalVector<SnapshotConstraint> cached_records;
+	cached_records.resize(contact_cache.size());
+	uint32_t cached_index = 0;
+	for (const KeyValue<ContactCacheKey, CachedContactManifold> &E : contact_cache) {
+		SnapshotConstraint &record = cached_records[cached_index++];
+		memset((void *)&record, 0, sizeof(SnapshotConstraint));
+		record.key.objects[0] = E.key.body_A.get_id();
+		record.key.objects[1] = E.key.body_B.get_id();
+		record.key.sub_key = (uint64_t(E.key.shape_A) << 32) | uint32_t(E.key.shape_B);
+		record.state_size = sizeof(CachedContactManifold);
+		record.flags = SNAPSHOT_CONSTRAINT_BODY_PAIR | SNAPSHOT_CONSTRAINT_CACHED;
+		record.age = contact_cache_step - E.value.step;
+	}
+	cached_records.sort_custom<SnapshotConstraintSort>();
+
+	for (const SnapshotConstraint &record : cached_records) {
+		ContactCacheKey key;
+		key.body_A = RID::from_uint64(record.key.objects[0]);
+		key.body_B = RID::from_uint64(record.key.objects[1]);
+		key.shape_A = int(record.key.sub_key >> 32);
+		key.shape_B = int(record.key.sub_key & 0xFFFFFFFF);
+		const CachedContactManifold &cached = contact_cache[key];
+
+		// The absolute step isn't saved, the age of the record replaces it.
+		CachedContactManifold manifold;
+		memset((void *)&manifold, 0, sizeof(CachedContactManifold));
+		for (int i = 0; i < cached.contact_count; i++) {
+			manifold.contacts[i] = cached.contacts[i];
+		}
+		manifold.contact_count = cached.contact_count;
+
+		memcpy(w, &record, sizeof(SnapshotConstraint));
+		w += sizeof(SnapshotConstraint);
+		memcpy(w, &manifold, sizeof(CachedContactManifold));
+		w += sizeof(CachedContactManifold);
+	}
+}
+
+Error GodotSpace2D::restore_snapshot(const Vector<uint8_t> &p_snapshot) {
+	const uint8_t *r = p_snapshot.ptr();
+	const uint8_t *end = r + p_snapshot.size();
+
+	ERR_FAIL_COND_V_MSG(p_snapshot.size() < (int)sizeof(SnapshotHeader), ERR_INVALID_DATA, "Invalid physics space snapshot.");
+	SnapshotHeader header;
+	memcpy(&header, r, sizeof(SnapshotHeader));
+	r += sizeof(SnapshotHeader);
+	ERR_FAIL_COND_V_MSG(header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION, ERR_INVALID_DATA, "Invalid physics space snapshot.");
+	ERR_FAIL_COND_V_MSG(header.real_size != sizeof(real_t), ERR_INVALID_DATA, "Physics space snapshot was saved by a build with a different floating-point precision.");
+
+	// Validate everything before touching the space, a bad buffer must not leave it half restored.
+	ERR_FAIL_COND_V_MSG(uint64_t(end - r) < uint64_t(header.body_count) * sizeof(SnapshotBody), ERR_INVALID_DATA, "Invalid physics space snapshot.");
+	const uint8_t *constraints = r + header.body_count * sizeof(SnapshotBody);
+	const uint8_t *c = constraints;
+	for (uint32_t i = 0; i < header.constraint_count; i++) {
+		ERR_FAIL_COND_V_MSG(end - c < (int64_t)sizeof(SnapshotConstraint), ERR_INVALID_DATA, "Invalid physics space snapshot.");
+		SnapshotConstraint record;
+		memcpy(&record, c, sizeof(SnapshotConstraint));
+		c += sizeof(SnapshotConstraint);
+		ERR_FAIL_COND_V_MSG(uint64_t(end - c) < record.state_size, ERR_INVALID_DATA, "Invalid physics space snapshot.");
+		ERR_FAIL_COND_V_MSG((record.flags & SNAPSHOT_CONSTRAINT_BODY_PAIR) && record.state_size != sizeof(CachedContactManifold), ERR_INVALID_DATA, "Invalid physics space snapshot.");
+		c += record.state_size;
+	}
+
+	// Bodies that were removed since the snapshot are skipped, bodies added since then keep their state.
+	for (uint32_t i = 0; i < header.body_count; i++) {
+		SnapshotBody record;
+		memcpy(&record, r, sizeof(SnapshotBody));
+		r += sizeof(SnapshotBody);
+
+		GodotBody2D *body = GodotPhysicsServer2D::godot_singleton->body_owner.get_or_null(RID::from_uint64(record.rid));
+		if (!body || body->get_space() != this) {
+			continue;
+		}
+		body->set_snapshot_state(record.state);
+	}
+
+	_contact_cache_clear();
+	snapshot_constraints.clear();
+	for (uint32_t i = 0; i < header.constraint_count; i++) {
+		SnapshotConstraint record;
+		memcpy(&record, r, sizeof(SnapshotConstraint));
+		if (record.flags & SNAPSHOT_CONSTRAINT_CACHED) {
+			ContactCacheKey key;
+			key.body_A = RID::from_uint64(record.key.objects[0]);
+			key.body_B = RID::from_uint64(record.key.objects[1]);
+			key.shape_A = int(record.key.sub_key >> 32);
+			key.shape_B = int(record.key.sub_key & 0xFFFFFFFF);
+			CachedContactManifold manifold;
+			memcpy(&manifold, r + sizeof(SnapshotConstraint), sizeof(CachedContactManifold));
+			manifold.step = record.age > contact_cache_step ? 0 : contact_cache_step - record.age;
+			contact_cache.insert(key, manifold);
+		} else {
+			snapshot_constraints.insert(record.key, r - constraints);
+		}
+		r += sizeof(SnapshotConstraint) + record.state_size;
+	}
+
+	for (const GodotCollisionObject2D *object : objects) {
+		if (object->get_type() != GodotCollisionObject2D::TYPE_BODY) {
+			continue;
+		}
+		const GodotBody2D *body = static_cast<const GodotBody2D *>(object);
+
+		for (const Pair<GodotConstraint2D *, int> &E : body->get_constraint_list()) {
+			uint32_t state_size = E.first->get_snapshot_state_size();
+			if (E.second != 0 || state_size == 0) {
+				continue;
+			}
+
+			HashMap<GodotConstraint2D::OrderKey, uint32_t, OrderKeyHasher>::Iterator F = snapshot_constraints.find(E.first->get_order_key());
+			if (!F) {
+				E.first->restore_snapshot_state(nullptr);
+				continue;
+			}
+
+			SnapshotConstraint record;
+			memcpy(&record, constraints + F->value, sizeof(SnapshotConstraint));
+			E.first->restore_snapshot_state(record.state_size == state_size ? constraints + F->value + sizeof(SnapshotConstraint) : nullptr);
+			snapshot_constraints.remove(F);
+		}
+	}
+
+	// Pairs that were colliding in the snapshot but aren't paired right now are created by the next broadphase update,
+	// they pick their contacts up from the cache.
+	for (const KeyValue<GodotConstraint2D::OrderKey, uint32_t> &E : snapshot_constraints) {
+		SnapshotConstraint record;
+		memcpy(&record, constraints + E.value, sizeof(SnapshotConstraint));
+		if (!(record.flags & SNAPSHOT_CONSTRAINT_BODY_PAIR)) {
+			continue;
+		}
+
+		ContactCacheKey key;
+		key.body_A = RID::from_uint64(record.key.objects[0]);
+		key.body_B = RID::from_uint64(record.key.objects[1]);
+		key.shape_A = int(record.key.sub_key >> 32);
+		key.shape_B = int(record.key.sub_key & 0xFFFFFFFF);
+		CachedContactManifold manifold;
+		memcpy(&manifold, constraints + E.value + sizeof(SnapshotConstraint), sizeof(CachedContactManifold));
+		if (manifold.contact_count == 0) {
+			continue;
+		}
+		// One step ahead so the manifold survives the next setup() even when the cache is disabled.
+		manifold.step = contact_cache_step + 1;
+		contact_cache.insert(key, manifold);
+	}
+	snapshot_constraints.clear();
+	_contact_cache_sort_expiry();
+
+	return OK;
+}
+
 GodotPhysicsDirectSpaceState2D *GodotSpace2D::get_direct_state() {
 	return direct_access;
 }
@@ -1225,6 +1990,12 @@ GodotSpace2D::GodotSpace2D() {
 	contact_max_allowed_penetration = GLOBAL_GET("physics/2d/solver/contact_max_allowed_penetration");
 	contact_bias = GLOBAL_GET("physics/2d/solver/default_contact_bias");
 	constraint_bias = GLOBAL_GET("physics/2d/solver/default_constraint_bias");
+	solver_graph_coloring = GLOBAL_GET("physics/2d/solver/graph_coloring");
+	solver_max_threads = GLOBAL_GET("physics/2d/solver/max_threads");
+	contact_cache_steps = GLOBAL_GET("physics/2d/solver/contact_cache_steps");
+	solver_deterministic = GLOBAL_GET("physics/2d/solver/deterministic");
+	ccd_max_substeps = GLOBAL_GET("physics/2d/solver/ccd_max_substeps");
+	solver_packed_contacts = GLOBAL_GET("physics/2d/solver/packed_contacts");
 
 	broadphase = GodotBroadPhase2D::create_func();
 	broadphase->set_pair_callback(_broadphase_pair, this);
@@ -37,6 +37,7 @@
 #include "godot_body_pair_2d.h"
 #include "godot_broad_phase_2d.h"
 #include "godot_collision_object_2d.h"
+#include "godot_collision_solver_2d.h"
 
 #include "core/config/project_settings.h"
 #include "core/templates/hash_map.h"
@@ -45,6 +46,35 @@
 class GodotPhysicsDirectSpaceState2D : public PhysicsDirectSpaceState2D {
 	GDCLASS(GodotPhysicsDirectSpaceState2D, PhysicsDirectSpaceState2D);
 
+	enum {
+		BATCH_THREAD_MIN_QUERIES = 64
+	};
+
+	struct RayBatch {
+		const RayParameters *parameters = nullptr;
+		RayResult *results = nullptr;
+		bool *collided = nullptr;
+	};
+
+	struct MotionBatch {
+		const ShapeParameters *parameters = nullptr;
+		real_t *closest_safe = nullptr;
+		real_t *closest_unsafe = nullptr;
+	};
+
+	// Broadphase results of a whole batch, the candidates of query i are in [batch_offsets[i], batch_offsets[i + 1]).
+	LocalVector<GodotCollisionObject2D *> batch_objects;
+	LocalVector<int> batch_shapes;
+	LocalVector<uint32_t> batch_offsets;
+	LocalVector<GodotShape2D *> batch_query_shapes;
+
+	bool _intersect_ray_candidates(const RayParameters &p_parameters, GodotCollisionObject2D *const *p_objects, const int *p_shapes, int p_amount, RayResult &r_result) const;
+	void _cast_motion_candidates(const ShapeParameters &p_parameters, GodotShape2D *p_shape, GodotCollisionObject2D *const *p_objects, const int *p_shapes, int p_amount, real_t &r_closest_safe, real_t &r_closest_unsafe) const;
+
+	void _batch_add_candidates(int p_amount);
+	void _intersect_ray_batch_task(uint32_t p_index, RayBatch *p_batch);
+	void _cast_motion_batch_task(uint32_t p_index, MotionBatch *p_batch);
+
 public:
 	GodotSpace2D *space = nullptr;
 
@@ -54,12 +84,35 @@ public:
 	virtual bool cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe) override;
 	virtual bool collide_shape(const ShapeParameters &p_parameters, Vector2 *r_results, int p_result_max, int &r_result_count) override;
 	virtual bool rest_info(const ShapeParameters &p_parameters, ShapeRestInfo *r_info) override;
+	virtual void intersect_ray_batch(const RayParameters *p_parameters, int p_count, RayResult *r_results, bool *r_collided, bool p_use_threads = true) override;
+	virtual void cast_motion_batch(const ShapeParameters *p_parameters, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe, bool p_use_threads = true) override;
 
 	GodotPhysicsDirectSpaceState2D() {}
 };
 
 class GodotSpace2D {
 public:
+	enum {
+		CONTACT_CACHE_MAX_CONTACTS = 2
+	};
+
+	// Contacts of a body pair kept after the broadphase unpairs it, to warm start the pair if it comes back.
+	struct CachedContact {
+		Vector2 local_A;
+		Vector2 local_B;
+		Vector2 normal;
+		real_t acc_normal_impulse = 0.0;
+		real_t acc_tangent_impulse = 0.0;
+		real_t acc_bias_impulse = 0.0;
+		real_t acc_bias_impulse_center_of_mass = 0.0;
+	};
+
+	struct CachedContactManifold {
+		CachedContact contacts[CONTACT_CACHE_MAX_CONTACTS];
+		int contact_count = 0;
+		uint64_t step = 0;
+	};
+
 	enum ElapsedTime {
 		ELAPSED_TIME_INTEGRATE_FORCES,
 		ELAPSED_TIME_GENERATE_ISLANDS,
@@ -83,17 +136,154 @@ private:
 	RID self;
 
 	GodotBroadPhase2D *broadphase = nullptr;
+	bool broadphase_move_batching = false;
+	LocalVector<GodotBroadPhase2D::ID> broadphase_move_ids;
+	LocalVector<Rect2> broadphase_move_aabbs;
+	bool broadphase_removing = false;
 	SelfList<GodotBody2D>::List active_list;
 	SelfList<GodotBody2D>::List mass_properties_update_list;
 	SelfList<GodotBody2D>::List state_query_list;
 	SelfList<GodotArea2D>::List monitor_query_list;
 	SelfList<GodotArea2D>::List area_moved_list;
+	SelfList<GodotBody2D>::List ccd_list;
+
+	enum {
+		CCD_THREAD_MIN_BODIES = 64
+	};
+
+	struct CCDCandidate {
+		GodotBody2D *body = nullptr;
+		int shape = 0;
+	};
+
+	// A body that moved fast enough to tunnel, and the first impact found along its motion.
+	struct CCDBody {
+		GodotBody2D *body = nullptr;
+		Transform2D from;
+		Transform2D to;
+		uint32_t candidate_offset = 0;
+		uint32_t candidate_count = 0;
+		bool collided = false;
+		int shape = 0;
+		CCDCandidate collider;
+		GodotCollisionSolver2D::TimeOfImpact impact;
+	};
+
+	struct CCDBodyComparator {
+		_FORCE_INLINE_ bool operator()(const CCDBody &p_a, const CCDBody &p_b) const {
+			return p_a.body->get_self() < p_b.body->get_self();
+		}
+	};
+
+	LocalVector<CCDBody> ccd_bodies;
+	LocalVector<CCDCandidate> ccd_candidates;
+
+	static real_t _get_ccd_shape_radius(const GodotBody2D *p_body, int p_shape);
+	bool _is_ccd_motion_fast(const GodotBody2D *p_body, const Transform2D &p_from, const Transform2D &p_to) const;
+	void _cull_ccd_candidates(CCDBody &r_ccd_body);
+	void _find_first_impact(uint32_t p_index, void *p_userdata = nullptr);
+	void _apply_ccd_impulse(const CCDBody &p_ccd_body, const Transform2D &p_transform);
 
 	static void *_broadphase_pair(GodotCollisionObject2D *A, int p_subindex_A, GodotCollisionObject2D *B, int p_subindex_B, void *p_self);
 	static void _broadphase_unpair(GodotCollisionObject2D *A, int p_subindex_A, GodotCollisionObject2D *B, int p_subindex_B, void *p_data, void *p_self);
 
 	HashSet<GodotCollisionObject2D *> objects;
 
+	struct ContactCacheKey {
+		RID body_A;
+		RID body_B;
+		int shape_A = 0;
+		int shape_B = 0;
+
+		bool operator==(const ContactCacheKey &p_key) const {
+			return body_A == p_key.body_A && body_B == p_key.body_B && shape_A == p_key.shape_A && shape_B == p_key.shape_B;
+		}
+	};
+
+	struct ContactCacheKeyHasher {
+		static _FORCE_INLINE_ uint32_t hash(const ContactCacheKey &p_key) {
+			uint32_t h = hash_murmur3_one_64(p_key.body_A.get_id());
+			h = hash_murmur3_one_64(p_key.body_B.get_id(), h);
+			h = hash_murmur3_one_32(p_key.shape_A, h);
+			h = hash_murmur3_one_32(p_key.shape_B, h);
+			return hash_fmix32(h);
+		}
+	};
+
+	struct ContactCacheExpiry {
+		ContactCacheKey key;
+		uint64_t step = 0;
+
+		bool operator<(const ContactCacheExpiry &p_expiry) const {
+			return step < p_expiry.step;
+		}
+	};
+
+	HashMap<ContactCacheKey, CachedContactManifold, ContactCacheKeyHasher> contact_cache;
+	uint64_t contact_cache_step = 0;
+	// Stored manifolds by step, so setup() only looks at the ones expiring. Entries of manifolds taken or stored
+	// again since then are skipped.
+	LocalVector<ContactCacheExpiry> contact_cache_expiry;
+	uint32_t contact_cache_expiry_first = 0;
+
+	void _contact_cache_clear();
+	void _contact_cache_expire();
+	void _contact_cache_sort_expiry();
+
+	enum {
+		SNAPSHOT_MAGIC = 0x53503253, // "S2PS"
+		SNAPSHOT_VERSION = 1
+	};
+
+	enum SnapshotConstraintFlags {
+		SNAPSHOT_CONSTRAINT_BODY_PAIR = 1,
+		SNAPSHOT_CONSTRAINT_CACHED = 2
+	};
+
+	struct SnapshotHeader {
+		uint32_t magic = SNAPSHOT_MAGIC;
+		uint16_t version = SNAPSHOT_VERSION;
+		uint16_t real_size = sizeof(real_t);
+		uint32_t body_count = 0;
+		uint32_t constraint_count = 0;
+	};
+
+	struct SnapshotBody {
+		uint64_t rid = 0;
+		GodotBody2D::SnapshotState state;
+	};
+
+	// Followed by state_size bytes of constraint state, age is only used by manifolds of the contact cache.
+	struct SnapshotConstraint {
+		GodotConstraint2D::OrderKey key;
+		uint32_t state_size = 0;
+		uint32_t flags = 0;
+		uint64_t age = 0;
+	};
+
+	struct ConstraintOrderSort {
+		_FORCE_INLINE_ bool operator()(const GodotConstraint2D *p_a, const GodotConstraint2D *p_b) const {
+			return p_a->get_order_key() < p_b->get_order_key();
+		}
+	};
+
+	struct SnapshotConstraintSort {
+		_FORCE_INLINE_ bool operator()(const SnapshotConstraint &p_a, const SnapshotConstraint &p_b) const {
+			return p_a.key < p_b.key;
+		}
+	};
+
+	struct OrderKeyHasher {
+		static _FORCE_INLINE_ uint32_t hash(const GodotConstraint2D::OrderKey &p_key) {
+			uint32_t h = hash_murmur3_one_64(p_key.objects[0]);
+			h = hash_murmur3_one_64(p_key.objects[1], h);
+			h = hash_murmur3_one_64(p_key.sub_key, h);
+			return hash_fmix32(h);
+		}
+	};
+
+	HashMap<GodotConstraint2D::OrderKey, uint32_t, OrderKeyHasher> snapshot_constraints;
+
 	GodotArea2D *area = nullptr;
 
 	int solver_iterations = 0;
@@ -103,6 +293,12 @@ private:
 	real_t contact_max_allowed_penetration = 0.0;
 	real_t contact_bias = 0.0;
 	real_t constraint_bias = 0.0;
+	bool solver_graph_coloring = false;
+	int solver_max_threads = 0;
+	int contact_cache_steps = 0;
+	bool solver_deterministic = false;
+	int ccd_max_substeps = 0;
+	bool solver_packed_contacts = false;
 
 	enum {
 		INTERSECTION_QUERY_MAX = 2048
@@ -149,11 +345,34 @@ public:
 	void body_add_to_state_query_list(SelfList<GodotBody2D> *p_body);
 	void body_remove_from_state_query_list(SelfList<GodotBody2D> *p_body);
 
+	void body_add_to_ccd_list(SelfList<GodotBody2D> *p_body);
+	void body_remove_from_ccd_list(SelfList<GodotBody2D> *p_body);
+
 	void area_add_to_monitor_query_list(SelfList<GodotArea2D> *p_area);
 	void area_remove_from_monitor_query_list(SelfList<GodotArea2D> *p_area);
 
 	GodotBroadPhase2D *get_broadphase();
 
+	// Moves done between these calls are sent to the broadphase as a single batch.
+	void begin_broadphase_move_batch();
+	void end_broadphase_move_batch();
+	_FORCE_INLINE_ void broadphase_move(GodotBroadPhase2D::ID p_id, const Rect2 &p_aabb) {
+		if (broadphase_move_batching) {
+			broadphase_move_ids.push_back(p_id);
+			broadphase_move_aabbs.push_back(p_aabb);
+		} else {
+			broadphase->move(p_id, p_aabb);
+		}
+	}
+
+	// Pairs destroyed by a removal are not separating, their shape or body is gone.
+	_FORCE_INLINE_ void broadphase_remove(GodotBroadPhase2D::ID p_id) {
+		broadphase_removing = true;
+		broadphase->remove(p_id);
+		broadphase_removing = false;
+	}
+	_FORCE_INLINE_ bool is_broadphase_removing() const { return broadphase_removing; }
+
 	void add_object(GodotCollisionObject2D *p_object);
 	void remove_object(GodotCollisionObject2D *p_object);
 	const HashSet<GodotCollisionObject2D *> &get_objects() const;
@@ -164,12 +383,29 @@ public:
 	_FORCE_INLINE_ real_t get_contact_max_allowed_penetration() const { return contact_max_allowed_penetration; }
 	_FORCE_INLINE_ real_t get_contact_bias() const { return contact_bias; }
 	_FORCE_INLINE_ real_t get_constraint_bias() const { return constraint_bias; }
+	_FORCE_INLINE_ bool is_solver_graph_coloring_enabled() const { return solver_graph_coloring; }
+	_FORCE_INLINE_ int get_solver_max_threads() const { return solver_max_threads; }
+	_FORCE_INLINE_ int get_contact_cache_steps() const { return contact_cache_steps; }
+	_FORCE_INLINE_ bool is_solver_deterministic() const { return solver_deterministic; }
+	_FORCE_INLINE_ int get_ccd_max_substeps() const { return ccd_max_substeps; }
+	_FORCE_INLINE_ bool is_solver_packed_contacts_enabled() const { return solver_packed_contacts; }
 	_FORCE_INLINE_ real_t get_body_linear_velocity_sleep_threshold() const { return body_linear_velocity_sleep_threshold; }
 	_FORCE_INLINE_ real_t get_body_angular_velocity_sleep_threshold() const { return body_angular_velocity_sleep_threshold; }
 	_FORCE_INLINE_ real_t get_body_time_to_sleep() const { return body_time_to_sleep; }
 
+	void contact_cache_store(const GodotBody2D *p_body_A, int p_shape_A, const GodotBody2D *p_body_B, int p_shape_B, const CachedContactManifold &p_manifold);
+	bool contact_cache_take(const GodotBody2D *p_body_A, int p_shape_A, const GodotBody2D *p_body_B, int p_shape_B, CachedContactManifold &r_manifold);
+	_FORCE_INLINE_ bool has_cached_contacts() const { return !contact_cache.is_empty(); }
+
+	// Snapshots hold body state, contact manifolds and joint impulses. Area overlaps aren't saved.
+	// Buffers are only valid for the same build (real_t size), r_snapshot is resized in place so it can be reused.
+	void save_snapshot(Vector<uint8_t> &r_snapshot);
+	Error restore_snapshot(const Vector<uint8_t> &p_snapshot);
+
 	void update();
 	void setup();
+	// Moves bodies with continuous collision detection back to their first impact, and sub-steps the rest of their motion.
+	void solve_continuous_collisions(real_t p_step);
 	void call_queries();
 
 	bool is_locked() const;
@@ -39,6 +39,13 @@
 #define ISLAND_SIZE_RESERVE 512
 #define CONSTRAINT_COUNT_RESERVE 1024
 
+// Islands with fewer constraints are cheaper to solve on a single thread.
+#define GRAPH_COLORING_MIN_CONSTRAINTS 256
+// Colors are tracked with a 64-bit mask per body, extra constraints go to a serial batch.
+#define GRAPH_COLORING_MAX_COLORS 64
+// Smaller batches are solved on the calling thread to avoid the task dispatch cost.
+#define GRAPH_COLORING_MIN_BATCH_SIZE 32
+
 void GodotStep2D::_populate_island(GodotBody2D *p_body, LocalVector<GodotBody2D *> &p_body_island, LocalVector<GodotConstraint2D *> &p_constraint_island) {
 	p_body->set_island_step(_step);
 
@@ -90,6 +97,135 @@ void GodotStep2D::_pre_solve_island(LocalVector<GodotConstraint2D *> &p_constrai
 	p_constraint_island.resize(valid_constraint_count);
 }
 
+void GodotStep2D::_bind_solver_bodies(const LocalVector<GodotConstraint2D *> &p_constraint_island) {
+	for (GodotConstraint2D *constraint : p_constraint_island) {
+		GodotBody2D **bodies = constraint->get_body_ptr();
+		int body_count = constraint->get_body_count();
+		ERR_CONTINUE(body_count > GodotConstraint2D::MAX_BODIES);
+
+		for (int i = 0; i < body_count; i++) {
+			GodotBody2D *body = bodies[i];
+			if (body->get_solver_step() != _step) {
+				body->set_solver_step(_step);
+				body->set_solver_index(solver_bodies.size());
+				solver_bodies.bodies.push_back(body);
+			}
+			constraint->set_solver_body_index(i, body->get_solver_index());
+		}
+		constraint->set_solver_bodies(&solver_bodies);
+	}
+}
+
+void GodotStep2D::_color_island(LocalVector<GodotConstraint2D *> &p_constraint_island, bool p_packed, ColoredIsland &r_colored_island) {
+	uint32_t constraint_count = p_constraint_island.size();
+	constraint_colors.resize(constraint_count);
+
+	// Greedy coloring in island order, the serial batch uses the last slot.
+	uint32_t color_sizes[GRAPH_COLORING_MAX_COLORS + 1] = {};
+	uint32_t color_packed_sizes[GRAPH_COLORING_MAX_COLORS] = {};
+	uint32_t color_count = 0;
+
+	for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
+		GodotConstraint2D *constraint = p_constraint_island[constraint_index];
+		GodotBody2D **bodies = constraint->get_body_ptr();
+		int body_count = constraint->get_body_count();
+
+		// Static and kinematic bodies are only read during solving, they can be shared between colors.
+		uint64_t used_colors = 0;
+		for (int i = 0; i < body_count; i++) {
+			if (bodies[i]->get_mode() > PhysicsServer2D::BODY_MODE_KINEMATIC) {
+				used_colors |= bodies[i]->get_solver_color_mask();
+			}
+		}
+
+		uint32_t color = 0;
+		while (color < GRAPH_COLORING_MAX_COLORS && (used_colors & (uint64_t(1) << color))) {
+			color++;
+		}
+
+		if (color < GRAPH_COLORING_MAX_COLORS) {
+			for (int i = 0; i < body_count; i++) {
+				if (bodies[i]->get_mode() > PhysicsServer2D::BODY_MODE_KINEMATIC) {
+					bodies[i]->set_solver_color_mask(bodies[i]->get_solver_color_mask() | (uint64_t(1) << color));
+				}
+			}
+			color_count = MAX(color_count, color + 1);
+		}
+
+		constraint_colors[constraint_index] = color;
+		color_sizes[color]++;
+		if (p_packed && color < GRAPH_COLORING_MAX_COLORS && constraint->can_solve_packed()) {
+			color_packed_sizes[color]++;
+		}
+	}
+
+	// Counting sort by color, keeping the island order inside each batch.
+	r_colored_island.batch_offsets.clear();
+	uint32_t offset = 0;
+	for (uint32_t color = 0; color < color_count; ++color) {
+		r_colored_island.batch_offsets.push_back(offset);
+		offset += color_sizes[color];
+	}
+	r_colored_island.parallel_batch_count = color_count;
+	if (color_sizes[GRAPH_COLORING_MAX_COLORS] > 0) {
+		r_colored_island.batch_offsets.push_back(offset);
+		offset += color_sizes[GRAPH_COLORING_MAX_COLORS];
+	}
+	r_colored_island.batch_offsets.push_back(offset);
+
+	// Packable body pairs go first in each parallel batch, the other constraints follow.
+	uint32_t write_offsets[GRAPH_COLORING_MAX_COLORS + 1];
+	uint32_t packed_write_offsets[GRAPH_COLORING_MAX_COLORS];
+	for (uint32_t color = 0; color < color_count; ++color) {
+		packed_write_offsets[color] = r_colored_island.batch_offsets[color];
+		write_offsets[color] = r_colored_island.batch_offsets[color] + color_packed_sizes[color];
+	}
+	write_offsets[GRAPH_COLORING_MAX_COLORS] = offset - color_sizes[GRAPH_COLORING_MAX_COLORS];
+
+	r_colored_island.constraints.resize(constraint_count);
+	for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
+		GodotConstraint2D *constraint = p_constraint_island[constraint_index];
+		uint32_t color = constraint_colors[constraint_index];
+		if (p_packed && color < GRAPH_COLORING_MAX_COLORS && constraint->can_solve_packed()) {
+			r_colored_island.constraints[packed_write_offsets[color]++] = constraint;
+		} else {
+			r_colored_island.constraints[write_offsets[color]++] = constraint;
+		}
+
+		// Reset the masks for the next island.
+		GodotBody2D **bodies = constraint->get_body_ptr();
+		for (int i = 0; i < constraint->get_body_count(); i++) {
+			bodies[i]->set_solver_color_mask(0);
+		}
+	}
+
+	// Full groups of four pairs are packed, the remainder is solved with the scalar path.
+	r_colored_island.packed_group_offsets.clear();
+	uint32_t packed_group_count = 0;
+	for (uint32_t color = 0; color < color_count; ++color) {
+		r_colored_island.packed_group_offsets.push_back(packed_group_count);
+		packed_group_count += color_packed_sizes[color] / GodotBodyPair2D::PACKED_WIDTH;
+	}
+	r_colored_island.packed_group_offsets.push_back(packed_group_count);
+
+	r_colored_island.packed_groups.resize(packed_group_count);
+	for (uint32_t color = 0; color < color_count; ++color) {
+		GodotConstraint2D *const *constraints = r_colored_island.constraints.ptr() + r_colored_island.batch_offsets[color];
+		for (uint32_t group_index = r_colored_island.packed_group_offsets[color]; group_index < r_colored_island.packed_group_offsets[color + 1]; ++group_index) {
+			// Only packable constraints are sorted here, and they're all body pairs.
+			GodotBodyPair2D *pairs[GodotBodyPair2D::PACKED_WIDTH];
+			for (int lane = 0; lane < GodotBodyPair2D::PACKED_WIDTH; lane++) {
+				pairs[lane] = static_cast<GodotBodyPair2D *>(constraints[lane]);
+			}
+			GodotBodyPair2D::pack(pairs, r_colored_island.packed_groups[group_index]);
+			constraints += GodotBodyPair2D::PACKED_WIDTH;
+		}
+	}
+
+	// The constraints are now owned by the colored island, the regular island solve skips them.
+	p_constraint_island.clear();
+}
+
 void GodotStep2D::_solve_island(uint32_t p_island_index, void *p_userdata) const {
 	const LocalVector<GodotConstraint2D *> &constraint_island = constraint_islands[p_island_index];
 
@@ -101,6 +237,52 @@ void GodotStep2D::_solve_island(uint32_t p_island_index, void *p_userdata) const
 	}
 }
 
+void GodotStep2D::_solve_colored_island(ColoredIsland &p_colored_island) {
+	GodotConstraint2D **constraints = p_colored_island.constraints.ptr();
+	uint32_t batch_count = p_colored_island.batch_offsets.size() - 1;
+
+	for (int i = 0; i < iterations; i++) {
+		for (uint32_t batch_index = 0; batch_index < batch_count; ++batch_index) {
+			uint32_t batch_begin = p_colored_island.batch_offsets[batch_index];
+			uint32_t batch_size = p_colored_island.batch_offsets[batch_index + 1] - batch_begin;
+
+			ColorBatch batch;
+			batch.constraints = constraints + batch_begin;
+			if (batch_index < p_colored_island.parallel_batch_count) {
+				uint32_t group_begin = p_colored_island.packed_group_offsets[batch_index];
+				batch.packed_groups = p_colored_island.packed_groups.ptr() + group_begin;
+				batch.packed_group_count = p_colored_island.packed_group_offsets[batch_index + 1] - group_begin;
+			}
+
+			// Each packed group replaces four constraints.
+			uint32_t element_count = batch_size - batch.packed_group_count * (GodotBodyPair2D::PACKED_WIDTH - 1);
+
+			if (batch_index >= p_colored_island.parallel_batch_count || batch_size < GRAPH_COLORING_MIN_BATCH_SIZE) {
+				for (uint32_t element_index = 0; element_index < element_count; ++element_index) {
+					_solve_color_batch(element_index, &batch);
+				}
+			} else {
+				WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep2D::_solve_color_batch, &batch, element_count, task_count, true, SNAME("Physics2DConstraintSolveColorBatch"));
+				WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+			}
+		}
+	}
+
+	uint32_t packed_group_count = p_colored_island.packed_groups.size();
+	for (uint32_t group_index = 0; group_index < packed_group_count; ++group_index) {
+		GodotBodyPair2D::unpack(p_colored_island.packed_groups[group_index]);
+	}
+}
+
+void GodotStep2D::_solve_color_batch(uint32_t p_index, ColorBatch *p_batch) const {
+	if (p_index < p_batch->packed_group_count) {
+		GodotBodyPair2D::solve_packed(p_batch->packed_groups[p_index], delta);
+	} else {
+		uint32_t constraint_index = p_index + p_batch->packed_group_count * (GodotBodyPair2D::PACKED_WIDTH - 1);
+		p_batch->constraints[constraint_index]->solve(delta);
+	}
+}
+
 void GodotStep2D::_check_suspend(LocalVector<GodotBody2D *> &p_body_island) const {
 	bool can_sleep = true;
 
@@ -125,6 +307,17 @@ void GodotStep2D::_check_suspend(LocalVector<GodotBody2D *> &p_body_island) cons
 	}
 }
 
+void GodotStep2D::_sort_islands(uint32_t p_island_count) {
+	for (uint32_t island_index = 0; island_index < p_island_count; ++island_index) {
+		constraint_islands[island_index].sort_custom<ConstraintOrderComparator>();
+	}
+
+	// Area pairs of different islands can report to the same area, so the islands are processed in a fixed order too.
+	SortArray<uint32_t, IslandOrderComparator> sorter;
+	sorter.compare.islands = constraint_islands.ptr();
+	sorter.sort(island_order.ptr(), p_island_count);
+}
+
 void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 	p_space->lock(); // can't access space during this
 
@@ -134,6 +327,7 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 
 	iterations = p_space->get_solver_iterations();
 	delta = p_delta;
+	task_count = p_space->get_solver_max_threads() > 0 ? p_space->get_solver_max_threads() : -1;
 
 	const SelfList<GodotBody2D>::List *body_list = &p_space->get_active_body_list();
 
@@ -144,6 +338,9 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 
 	int active_count = 0;
 
+	// Each body moves its shapes at most once, they're sent to the broadphase together.
+	p_space->begin_broadphase_move_batch();
+
 	const SelfList<GodotBody2D> *b = body_list->first();
 	while (b) {
 		b->self()->integrate_forces(p_delta);
@@ -151,6 +348,8 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 		active_count++;
 	}
 
+	p_space->end_broadphase_move_batch();
+
 	p_space->set_active_objects(active_count);
 
 	// Update the broadphase to register collision pairs.
@@ -231,6 +430,17 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 
 	p_space->set_island_count((int)island_count);
 
+	island_order.resize(island_count);
+	for (uint32_t island_index = 0; island_index < island_count; ++island_index) {
+		island_order[island_index] = island_index;
+	}
+
+	// Islands and constraints follow the order bodies were activated and paired in, which depends on the
+	// history of the space. Deterministic spaces sort them so only the current state matters.
+	if (p_space->is_solver_deterministic()) {
+		_sort_islands(island_count);
+	}
+
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
 		p_space->set_elapsed_time(GodotSpace2D::ELAPSED_TIME_GENERATE_ISLANDS, profile_endtime - profile_begtime);
@@ -240,7 +450,7 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 	/* SETUP CONSTRAINTS / PROCESS COLLISIONS */
 
 	uint32_t total_constraint_count = all_constraints.size();
-	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep2D::_setup_constraint, nullptr, total_constraint_count, -1, true, SNAME("Physics2DConstraintSetup"));
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep2D::_setup_constraint, nullptr, total_constraint_count, task_count, true, SNAME("Physics2DConstraintSetup"));
 	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 
 	{ //profile
@@ -252,17 +462,76 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 	/* PRE-SOLVE CONSTRAINT ISLANDS */
 
 	// Warning: This doesn't run on threads, because it involves thread-unsafe processing.
-	for (uint32_t island_index = 0; island_index < island_count; ++island_index) {
+	for (uint32_t island_index : island_order) {
 		_pre_solve_island(constraint_islands[island_index]);
+		_bind_solver_bodies(constraint_islands[island_index]);
+	}
+
+	// Pack the state of the bound bodies after pre-solve impulses have been applied.
+	solver_bodies.gather();
+
+	/* COLOR LARGE CONSTRAINT ISLANDS */
+
+	uint32_t colored_island_count = 0;
+
+	// Packed contacts can't share bodies either, so they need the islands to be colored.
+	bool packed_contacts = p_space->is_solver_packed_contacts_enabled();
+
+	if (packed_contacts || p_space->is_solver_graph_coloring_enabled()) {
+		uint32_t small_constraint_count = 0;
+
+		for (uint32_t island_index = 0; island_index < island_count; ++island_index) {
+			LocalVector<GodotConstraint2D *> &constraint_island = constraint_islands[island_index];
+			if (constraint_island.size() < GRAPH_COLORING_MIN_CONSTRAINTS) {
+				small_constraint_count += constraint_island.size();
+				continue;
+			}
+
+			++colored_island_count;
+			if (colored_islands.size() < colored_island_count) {
+				colored_islands.resize(colored_island_count);
+			}
+			_color_island(constraint_island, packed_contacts, colored_islands[colored_island_count - 1]);
+		}
+
+		// Separate islands don't share any dynamic body, so many small islands (like bullets hitting walls)
+		// are colored together, and their contacts packed, as if they were a single large island.
+		if (packed_contacts && small_constraint_count >= GRAPH_COLORING_MIN_CONSTRAINTS) {
+			small_island_constraints.clear();
+			small_island_constraints.reserve(small_constraint_count);
+			for (uint32_t island_index : island_order) {
+				LocalVector<GodotConstraint2D *> &constraint_island = constraint_islands[island_index];
+				if (constraint_island.size() < GRAPH_COLORING_MIN_CONSTRAINTS) {
+					for (GodotConstraint2D *constraint : constraint_island) {
+						small_island_constraints.push_back(constraint);
+					}
+					constraint_island.clear();
+				}
+			}
+
+			++colored_island_count;
+			if (colored_islands.size() < colored_island_count) {
+				colored_islands.resize(colored_island_count);
+			}
+			_color_island(small_island_constraints, packed_contacts, colored_islands[colored_island_count - 1]);
+		}
 	}
 
 	/* SOLVE CONSTRAINT ISLANDS */
 
 	// Warning: _solve_island modifies the constraint islands for optimization purpose,
 	// their content is not reliable after these calls and shouldn't be used anymore.
-	group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep2D::_solve_island, nullptr, island_count, -1, true, SNAME("Physics2DConstraintSolveIslands"));
+	group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep2D::_solve_island, nullptr, island_count, task_count, true, SNAME("Physics2DConstraintSolveIslands"));
 	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 
+	// Colored islands dispatch their own batches, so they're solved from this thread.
+	for (uint32_t island_index = 0; island_index < colored_island_count; ++island_index) {
+		_solve_colored_island(colored_islands[island_index]);
+	}
+
+	solver_bodies.scatter();
+	solver_bodies.clear();
+
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
 		p_space->set_elapsed_time(GodotSpace2D::ELAPSED_TIME_SOLVE_CONSTRAINTS, profile_endtime - profile_begtime);
@@ -271,6 +540,8 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 
 	/* INTEGRATE VELOCITIES */
 
+	p_space->begin_broadphase_move_batch();
+
 	b = body_list->first();
 	while (b) {
 		const SelfList<GodotBody2D> *n = b->next();
@@ -278,6 +549,12 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 		b = n; // in case it shuts itself down
 	}
 
+	p_space->end_broadphase_move_batch();
+
+	/* CONTINUOUS COLLISION DETECTION */
+
+	p_space->solve_continuous_collisions(p_delta);
+
 	/* SLEEP / WAKE UP ISLANDS */
 
 	for (uint32_t island_index = 0; island_index < body_island_count; ++island_index) {
@@ -300,6 +577,8 @@ GodotStep2D::GodotStep2D() {
 	body_islands.reserve(BODY_ISLAND_COUNT_RESERVE);
 	constraint_islands.reserve(ISLAND_COUNT_RESERVE);
 	all_constraints.reserve(CONSTRAINT_COUNT_RESERVE);
+	constraint_colors.reserve(CONSTRAINT_COUNT_RESERVE);
+	island_order.reserve(ISLAND_COUNT_RESERVE);
 }
 
 GodotStep2D::~GodotStep2D() {
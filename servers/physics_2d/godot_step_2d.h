@@ -31,25 +31,71 @@
 #ifndef GODOT_STEP_2D_H
 #define GODOT_STEP_2D_H
 
+#include "godot_body_pair_2d.h"
+#include "godot_solver_bodies_2d.h"
 #include "godot_space_2d.h"
 
 #include "core/templates/local_vector.h"
 
 class GodotStep2D {
+	// Large islands split into batches of constraints that don't share any dynamic body,
+	// so each batch can be solved in parallel with the same result as a serial solve.
+	struct ColoredIsland {
+		LocalVector<GodotConstraint2D *> constraints; // Sorted by color.
+		LocalVector<uint32_t> batch_offsets; // Batch i spans [batch_offsets[i], batch_offsets[i + 1]).
+		uint32_t parallel_batch_count = 0; // Remaining batches share bodies and must be solved serially.
+
+		// Body pairs at the start of each parallel batch are solved four at a time.
+		LocalVector<GodotBodyPair2D::PackedGroup> packed_groups;
+		LocalVector<uint32_t> packed_group_offsets; // Batch i packs [packed_group_offsets[i], packed_group_offsets[i + 1]).
+	};
+
+	struct ColorBatch {
+		GodotConstraint2D **constraints = nullptr;
+		GodotBodyPair2D::PackedGroup *packed_groups = nullptr;
+		uint32_t packed_group_count = 0;
+	};
+
+	struct ConstraintOrderComparator {
+		_FORCE_INLINE_ bool operator()(const GodotConstraint2D *p_a, const GodotConstraint2D *p_b) const {
+			return p_a->get_order_key() < p_b->get_order_key();
+		}
+	};
+
+	// Islands are sorted by their first constraint, once their constraints are sorted.
+	struct IslandOrderComparator {
+		const LocalVector<GodotConstraint2D *> *islands = nullptr;
+
+		_FORCE_INLINE_ bool operator()(uint32_t p_a, uint32_t p_b) const {
+			return islands[p_a][0]->get_order_key() < islands[p_b][0]->get_order_key();
+		}
+	};
+
 	uint64_t _step = 1;
 
 	int iterations = 0;
 	real_t delta = 0.0;
+	int task_count = -1;
 
 	LocalVector<LocalVector<GodotBody2D *>> body_islands;
 	LocalVector<LocalVector<GodotConstraint2D *>> constraint_islands;
 	LocalVector<GodotConstraint2D *> all_constraints;
+	LocalVector<ColoredIsland> colored_islands;
+	LocalVector<GodotConstraint2D *> small_island_constraints;
+	LocalVector<uint32_t> island_order;
+	LocalVector<uint32_t> constraint_colors;
+	GodotSolverBodies2D solver_bodies;
 
 	void _populate_island(GodotBody2D *p_body, LocalVector<GodotBody2D *> &p_body_island, LocalVector<GodotConstraint2D *> &p_constraint_island);
 	void _setup_constraint(uint32_t p_constraint_index, void *p_userdata = nullptr);
 	void _pre_solve_island(LocalVector<GodotConstraint2D *> &p_constraint_island) const;
+	void _bind_solver_bodies(const LocalVector<GodotConstraint2D *> &p_constraint_island);
+	void _color_island(LocalVector<GodotConstraint2D *> &p_constraint_island, bool p_packed, ColoredIsland &r_colored_island);
 	void _solve_island(uint32_t p_island_index, void *p_userdata = nullptr) const;
+	void _solve_colored_island(ColoredIsland &p_colored_island);
+	void _solve_color_batch(uint32_t p_index, ColorBatch *p_batch) const;
 	void _check_suspend(LocalVector<GodotBody2D *> &p_body_island) const;
+	void _sort_islands(uint32_t p_island_count);
 
 public:
 	void step(GodotSpace2D *p_space, real_t p_delta);
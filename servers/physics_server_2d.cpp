@@ -449,6 +449,114 @@ Dictionary PhysicsDirectSpaceState2D::_get_rest_info(const Ref<PhysicsShapeQuery
 	return r;
 }
 
+Dictionary PhysicsDirectSpaceState2D::_intersect_ray_batch(const Ref<PhysicsRayQueryParameters2D> &p_ray_query, const PackedVector2Array &p_segments, bool p_use_threads) {
+	ERR_FAIL_COND_V(!p_ray_query.is_valid(), Dictionary());
+	ERR_FAIL_COND_V_MSG(p_segments.size() % 2 != 0, Dictionary(), "Segments must be given as pairs of start and end points.");
+
+	int count = p_segments.size() / 2;
+	const Vector2 *segments = p_segments.ptr();
+
+	LocalVector<RayParameters> parameters;
+	parameters.resize(count);
+	for (int i = 0; i < count; i++) {
+		parameters[i] = p_ray_query->get_parameters();
+		parameters[i].from = segments[i * 2 + 0];
+		parameters[i].to = segments[i * 2 + 1];
+	}
+
+	LocalVector<RayResult> results;
+	LocalVector<bool> collided;
+	results.resize(count);
+	collided.resize(count);
+	intersect_ray_batch(parameters.ptr(), count, results.ptr(), collided.ptr(), p_use_threads);
+
+	PackedVector2Array positions;
+	PackedVector2Array normals;
+	PackedInt64Array collider_ids;
+	Array rids;
+	PackedInt32Array shapes;
+	positions.resize(count);
+	normals.resize(count);
+	collider_ids.resize(count);
+	rids.resize(count);
+	shapes.resize(count);
+
+	Vector2 *positions_ptr = positions.ptrw();
+	Vector2 *normals_ptr = normals.ptrw();
+	int64_t *collider_ids_ptr = collider_ids.ptrw();
+	int32_t *shapes_ptr = shapes.ptrw();
+
+	for (int i = 0; i < count; i++) {
+		if (collided[i]) {
+			positions_ptr[i] = results[i].position;
+			normals_ptr[i] = results[i].normal;
+			collider_ids_ptr[i] = results[i].collider_id;
+			rids[i] = results[i].rid;
+			shapes_ptr[i] = results[i].shape;
+		} else {
+			positions_ptr[i] = Vector2();
+			normals_ptr[i] = Vector2();
+			collider_ids_ptr[i] = 0;
+			rids[i] = RID();
+			shapes_ptr[i] = -1;
+		}
+	}
+
+	Dictionary d;
+	d["position"] = positions;
+	d["normal"] = normals;
+	d["collider_id"] = collider_ids;
+	d["rid"] = rids;
+	d["shape"] = shapes;
+
+	return d;
+}
+
+Vector<real_t> PhysicsDirectSpaceState2D::_cast_motion_batch(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query, const PackedVector2Array &p_origins, const PackedVector2Array &p_motions, bool p_use_threads) {
+	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Vector<real_t>());
+	ERR_FAIL_COND_V_MSG(p_origins.size() != p_motions.size(), Vector<real_t>(), "Each origin must have a matching motion.");
+
+	int count = p_origins.size();
+
+	LocalVector<ShapeParameters> parameters;
+	parameters.resize(count);
+	for (int i = 0; i < count; i++) {
+		parameters[i] = p_shape_query->get_parameters();
+		parameters[i].transform.set_origin(p_origins[i]);
+		parameters[i].motion = p_motions[i];
+	}
+
+	LocalVector<real_t> closest_safe;
+	LocalVector<real_t> closest_unsafe;
+	closest_safe.resize(count);
+	closest_unsafe.resize(count);
+	cast_motion_batch(parameters.ptr(), count, closest_safe.ptr(), closest_unsafe.ptr(), p_use_threads);
+
+	Vector<real_t> ret;
+	ret.resize(count * 2);
+	real_t *ret_ptr = ret.ptrw();
+	for (int i = 0; i < count; i++) {
+		ret_ptr[i * 2 + 0] = closest_safe[i];
+		ret_ptr[i * 2 + 1] = closest_unsafe[i];
+	}
+	return ret;
+}
+
+void PhysicsDirectSpaceState2D::intersect_ray_batch(const RayParameters *p_parameters, int p_count, RayResult *r_results, bool *r_collided, bool p_use_threads) {
+	for (int i = 0; i < p_count; i++) {
+		r_collided[i] = intersect_ray(p_parameters[i], r_results[i]);
+	}
+}
+
+void PhysicsDirectSpaceState2D::cast_motion_batch(const ShapeParameters *p_parameters, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe, bool p_use_threads) {
+	for (int i = 0; i < p_count; i++) {
+		if (!cast_motion(p_parameters[i], r_closest_safe[i], r_closest_unsafe[i])) {
+			r_closest_safe[i] = 1.0;
+			r_closest_unsafe[i] = 1.0;
+		}
+	}
+}
+
 PhysicsDirectSpaceState2D::PhysicsDirectSpaceState2D() {
 }
 
@@ -459,6 +567,8 @@ void PhysicsDirectSpaceState2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("cast_motion", "parameters"), &PhysicsDirectSpaceState2D::_cast_motion);
 	ClassDB::bind_method(D_METHOD("collide_shape", "parameters", "max_results"), &PhysicsDirectSpaceState2D::_collide_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("get_rest_info", "parameters"), &PhysicsDirectSpaceState2D::_get_rest_info);
+	ClassDB::bind_method(D_METHOD("intersect_ray_batch", "parameters", "segments", "use_threads"), &PhysicsDirectSpaceState2D::_intersect_ray_batch, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("cast_motion_batch", "parameters", "origins", "motions", "use_threads"), &PhysicsDirectSpaceState2D::_cast_motion_batch, DEFVAL(true));
 }
 
 ///////////////////////////////
@@ -615,6 +725,20 @@ bool PhysicsServer2D::_body_test_motion(RID p_body, const Ref<PhysicsTestMotionP
 	return body_test_motion(p_body, p_parameters->get_parameters(), result_ptr);
 }
 
+void PhysicsServer2D::space_save_snapshot(RID p_space, Vector<uint8_t> &r_snapshot) {
+	ERR_FAIL_MSG("Space snapshots are not supported by this physics server.");
+}
+
+Error PhysicsServer2D::space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) {
+	ERR_FAIL_V_MSG(ERR_UNAVAILABLE, "Space snapshots are not supported by this physics server.");
+}
+
+Vector<uint8_t> PhysicsServer2D::_space_save_snapshot(RID p_space) {
+	Vector<uint8_t> snapshot;
+	space_save_snapshot(p_space, snapshot);
+	return snapshot;
+}
+
 void PhysicsServer2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("world_boundary_shape_create"), &PhysicsServer2D::world_boundary_shape_create);
 	ClassDB::bind_method(D_METHOD("separation_ray_shape_create"), &PhysicsServer2D::separation_ray_shape_create);
@@ -636,6 +760,8 @@ void PhysicsServer2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("space_set_param", "space", "param", "value"), &PhysicsServer2D::space_set_param);
 	ClassDB::bind_method(D_METHOD("space_get_param", "space", "param"), &PhysicsServer2D::space_get_param);
 	ClassDB::bind_method(D_METHOD("space_get_direct_state", "space"), &PhysicsServer2D::space_get_direct_state);
+	ClassDB::bind_method(D_METHOD("space_save_snapshot", "space"), &PhysicsServer2D::_space_save_snapshot);
+	ClassDB::bind_method(D_METHOD("space_restore_snapshot", "space", "snapshot"), &PhysicsServer2D::space_restore_snapshot);
 
 	ClassDB::bind_method(D_METHOD("area_create"), &PhysicsServer2D::area_create);
 	ClassDB::bind_method(D_METHOD("area_set_space", "area", "space"), &PhysicsServer2D::area_set_space);
@@ -797,6 +923,12 @@ void PhysicsServer2D::_bind_methods() {
 	BIND_ENUM_CONSTANT(SPACE_PARAM_BODY_TIME_TO_SLEEP);
 	BIND_ENUM_CONSTANT(SPACE_PARAM_CONSTRAINT_DEFAULT_BIAS);
 	BIND_ENUM_CONSTANT(SPACE_PARAM_SOLVER_ITERATIONS);
+	BIND_ENUM_CONSTANT(SPACE_PARAM_SOLVER_GRAPH_COLORING);
+	BIND_ENUM_CONSTANT(SPACE_PARAM_SOLVER_MAX_THREADS);
+	BIND_ENUM_CONSTANT(SPACE_PARAM_CONTACT_CACHE_STEPS);
+	BIND_ENUM_CONSTANT(SPACE_PARAM_SOLVER_DETERMINISTIC);
+	BIND_ENUM_CONSTANT(SPACE_PARAM_CCD_MAX_SUBSTEPS);
+	BIND_ENUM_CONSTANT(SPACE_PARAM_SOLVER_PACKED_CONTACTS);
 
 	BIND_ENUM_CONSTANT(SHAPE_WORLD_BOUNDARY);
 	BIND_ENUM_CONSTANT(SHAPE_SEPARATION_RAY);
@@ -891,12 +1023,21 @@ PhysicsServer2D::PhysicsServer2D() {
 	GLOBAL_DEF("physics/2d/sleep_threshold_linear", 2.0);
 	GLOBAL_DEF("physics/2d/sleep_threshold_angular", Math::deg_to_rad(8.0));
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/2d/time_before_sleep", PROPERTY_HINT_RANGE, "0,5,0.01,or_greater"), 0.5);
+	GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "physics/2d/broad_phase/type", PROPERTY_HINT_ENUM, "BVH,Hash Grid"), 0);
+	GLOBAL_DEF_RST(PropertyInfo(Variant::FLOAT, "physics/2d/broad_phase/cell_size", PROPERTY_HINT_RANGE, "1,1024,1,or_greater,suffix:px"), 128.0);
+	GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "physics/2d/broad_phase/large_object_cells", PROPERTY_HINT_RANGE, "1,4096,1,or_greater"), 512);
 	GLOBAL_DEF(PropertyInfo(Variant::INT, "physics/2d/solver/solver_iterations", PROPERTY_HINT_RANGE, "1,32,1,or_greater"), 16);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/2d/solver/contact_recycle_radius", PROPERTY_HINT_RANGE, "0,10,0.01,or_greater"), 1.0);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/2d/solver/contact_max_separation", PROPERTY_HINT_RANGE, "0,10,0.01,or_greater"), 1.5);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/2d/solver/contact_max_allowed_penetration", PROPERTY_HINT_RANGE, "0.01,10,0.01,or_greater"), 0.3);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/2d/solver/default_contact_bias", PROPERTY_HINT_RANGE, "0,1,0.01"), 0.8);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/2d/solver/default_constraint_bias", PROPERTY_HINT_RANGE, "0,1,0.01"), 0.2);
+	GLOBAL_DEF("physics/2d/solver/graph_coloring", false);
+	GLOBAL_DEF(PropertyInfo(Variant::INT, "physics/2d/solver/max_threads", PROPERTY_HINT_RANGE, "0,64,1,or_greater"), 0);
+	GLOBAL_DEF(PropertyInfo(Variant::INT, "physics/2d/solver/contact_cache_steps", PROPERTY_HINT_RANGE, "0,60,1,or_greater"), 0);
+	GLOBAL_DEF("physics/2d/solver/deterministic", false);
+	GLOBAL_DEF(PropertyInfo(Variant::INT, "physics/2d/solver/ccd_max_substeps", PROPERTY_HINT_RANGE, "1,16,1,or_greater"), 4);
+	GLOBAL_DEF("physics/2d/solver/packed_contacts", false);
 }
 
 PhysicsServer2D::~PhysicsServer2D() {
@@ -123,6 +123,8 @@ class PhysicsDirectSpaceState2D : public Object {
 	Vector<real_t> _cast_motion(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query);
 	TypedArray<Vector2> _collide_shape(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query, int p_max_results = 32);
 	Dictionary _get_rest_info(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query);
+	Dictionary _intersect_ray_batch(const Ref<PhysicsRayQueryParameters2D> &p_ray_query, const PackedVector2Array &p_segments, bool p_use_threads = true);
+	Vector<real_t> _cast_motion_batch(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query, const PackedVector2Array &p_origins, const PackedVector2Array &p_motions, bool p_use_threads = true);
 
 protected:
 	static void _bind_methods();
@@ -150,6 +152,8 @@ public:
 	};
 
 	virtual bool intersect_ray(const RayParameters &p_parameters, RayResult &r_result) = 0;
+	// Runs many ray queries at once, r_results and r_collided must have room for p_count elements.
+	virtual void intersect_ray_batch(const RayParameters *p_parameters, int p_count, RayResult *r_results, bool *r_collided, bool p_use_threads = true);
 
 	struct ShapeResult {
 		RID rid;
@@ -197,6 +201,8 @@ public:
 	virtual bool cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe) = 0;
 	virtual bool collide_shape(const ShapeParameters &p_parameters, Vector2 *r_results, int p_result_max, int &r_result_count) = 0;
 	virtual bool rest_info(const ShapeParameters &p_parameters, ShapeRestInfo *r_info) = 0;
+	// Runs many motion casts at once, queries that hit nothing report a safe and unsafe fraction of 1.
+	virtual void cast_motion_batch(const ShapeParameters *p_parameters, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe, bool p_use_threads = true);
 
 	PhysicsDirectSpaceState2D();
 };
@@ -210,6 +216,7 @@ class PhysicsServer2D : public Object {
 	static PhysicsServer2D *singleton;
 
 	virtual bool _body_test_motion(RID p_body, const Ref<PhysicsTestMotionParameters2D> &p_parameters, const Ref<PhysicsTestMotionResult2D> &p_result = Ref<PhysicsTestMotionResult2D>());
+	Vector<uint8_t> _space_save_snapshot(RID p_space);
 
 protected:
 	static void _bind_methods();
@@ -264,6 +271,12 @@ public:
 		SPACE_PARAM_BODY_TIME_TO_SLEEP,
 		SPACE_PARAM_CONSTRAINT_DEFAULT_BIAS,
 		SPACE_PARAM_SOLVER_ITERATIONS,
+		SPACE_PARAM_SOLVER_GRAPH_COLORING,
+		SPACE_PARAM_SOLVER_MAX_THREADS,
+		SPACE_PARAM_CONTACT_CACHE_STEPS,
+		SPACE_PARAM_SOLVER_DETERMINISTIC,
+		SPACE_PARAM_CCD_MAX_SUBSTEPS,
+		SPACE_PARAM_SOLVER_PACKED_CONTACTS,
 	};
 
 	virtual void space_set_param(RID p_space, SpaceParameter p_param, real_t p_value) = 0;
@@ -276,6 +289,10 @@ public:
 	virtual Vector<Vector2> space_get_contacts(RID p_space) const = 0;
 	virtual int space_get_contact_count(RID p_space) const = 0;
 
+	// Saves the simulation state of a space (bodies, contacts, sleep state and joints) to a buffer that can be reused between snapshots.
+	virtual void space_save_snapshot(RID p_space, Vector<uint8_t> &r_snapshot);
+	virtual Error space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot);
+
 	//missing space parameters
 
 	/* AREA API */
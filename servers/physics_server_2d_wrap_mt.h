@@ -125,6 +125,16 @@ public:
 		return physics_server_2d->space_get_contact_count(p_space);
 	}
 
+	virtual void space_save_snapshot(RID p_space, Vector<uint8_t> &r_snapshot) override {
+		ERR_FAIL_COND(main_thread != Thread::get_caller_id());
+		physics_server_2d->space_save_snapshot(p_space, r_snapshot);
+	}
+
+	virtual Error space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) override {
+		ERR_FAIL_COND_V(main_thread != Thread::get_caller_id(), ERR_BUSY);
+		return physics_server_2d->space_restore_snapshot(p_space, p_snapshot);
+	}
+
 	/* AREA API */
 
 	//FUNC0RID(area);
@@ -31,22 +31,55 @@
 #include "renderer_canvas_cull.h"
 
 #include "core/math/geometry_2d.h"
+#include "core/object/worker_thread_pool.h"
 #include "renderer_viewport.h"
 #include "rendering_server_default.h"
 #include "rendering_server_globals.h"
 #include "servers/rendering/storage/texture_storage.h"
 
-void RendererCanvasCull::_render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, RenderingServer::CanvasItemTextureFilter p_default_filter, RenderingServer::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel, uint32_t canvas_cull_mask) {
+void RendererCanvasCull::_render_canvas_item_tree(RID p_to_render_target, Canvas *p_canvas, Canvas::ChildItem *p_child_items, int p_child_item_count, Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, RenderingServer::CanvasItemTextureFilter p_default_filter, RenderingServer::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel, uint32_t canvas_cull_mask) {
 	RENDER_TIMESTAMP("Cull CanvasItem Tree");
 
 	memset(z_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
 	memset(z_last_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
 
-	for (int i = 0; i < p_child_item_count; i++) {
-		_cull_canvas_item(p_child_items[i].item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr, true, canvas_cull_mask);
+	if (p_transform != cull_canvas_transform) {
+		cull_canvas_transform = p_transform;
+		cull_canvas_version++;
+	}
+
+	static_cull_active = false;
+	if (!p_canvas->static_index.is_empty() && p_transform.determinant() != 0) {
+		// Items are culled against the clip rect size, see _attach_canvas_item_for_draw().
+		Rect2 view_rect = p_transform.affine_inverse().xform(Rect2(Vector2(), p_clip_rect.size)).grow(STATIC_INDEX_MARGIN);
+
+		StaticIndexQuery query;
+		query.pass = ++static_cull_pass;
+		p_canvas->static_index.aabb_query(AABB(Vector3(view_rect.position.x, view_rect.position.y, 0), Vector3(view_rect.size.x, view_rect.size.y, 0)), query);
+		static_cull_active = true;
+	}
+
+	if (_can_cull_threaded(p_child_item_count)) {
+		cull_top_level_items.resize(p_child_item_count);
+		for (int i = 0; i < p_child_item_count; i++) {
+			cull_top_level_items[i] = p_child_items[i].item;
+		}
+
+		CullChildrenTask task;
+		task.child_items = cull_top_level_items.ptr();
+		task.child_item_count = p_child_item_count;
+		task.mode = CULL_CHILDREN_ALL;
+		task.clip_rect = p_clip_rect;
+		task.modulate = Color(1, 1, 1, 1);
+		task.canvas_cull_mask = canvas_cull_mask;
+		_cull_canvas_item_children_threaded(task, z_list, z_last_list);
+	} else {
+		for (int i = 0; i < p_child_item_count; i++) {
+			_cull_canvas_item(p_child_items[i].item, Transform2D(), 0, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr, true, canvas_cull_mask);
+		}
 	}
 	if (p_canvas_item) {
-		_cull_canvas_item(p_canvas_item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr, true, canvas_cull_mask);
+		_cull_canvas_item(p_canvas_item, Transform2D(), 0, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr, true, canvas_cull_mask);
 	}
 
 	RendererCanvasRender::Item *list = nullptr;
@@ -82,6 +115,10 @@ void _collect_ysort_children(RendererCanvasCull::Item *p_canvas_item, Transform2
 		if (child_items[i]->visible) {
 			if (r_items) {
 				r_items[r_index] = child_items[i];
+				if (child_items[i]->ysort_xform != p_transform) {
+					// Culled relative to the y-sort owner, so this is part of its parent transform.
+					child_items[i]->cull_cache.dirty = true;
+				}
 				child_items[i]->ysort_xform = p_transform;
 				child_items[i]->ysort_pos = p_transform.xform(child_items[i]->xform.columns[2]);
 				child_items[i]->material_owner = child_items[i]->use_parent_material ? p_material_owner : nullptr;
@@ -185,7 +222,11 @@ void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *
 		//something to draw?
 
 		if (ci->update_when_visible) {
-			RenderingServerDefault::redraw_request();
+			if (cull_threaded) {
+				cull_redraw_requested.set();
+			} else {
+				RenderingServerDefault::redraw_request();
+			}
 		}
 
 		if (ci->commands != nullptr || ci->copy_back_buffer) {
@@ -213,7 +254,12 @@ void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *
 
 		if (ci->visibility_notifier) {
 			if (!ci->visibility_notifier->visible_element.in_list()) {
-				visibility_notifier_list.add(&ci->visibility_notifier->visible_element);
+				if (cull_threaded) {
+					MutexLock lock(cull_mutex);
+					visibility_notifier_list.add(&ci->visibility_notifier->visible_element);
+				} else {
+					visibility_notifier_list.add(&ci->visibility_notifier->visible_element);
+				}
 				ci->visibility_notifier->just_visible = true;
 			}
 
@@ -222,7 +268,7 @@ void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *
 	}
 }
 
-void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, Item *p_canvas_clip, Item *p_material_owner, bool allow_y_sort, uint32_t canvas_cull_mask) {
+void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, uint64_t p_xform_version, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, Item *p_canvas_clip, Item *p_material_owner, bool allow_y_sort, uint32_t canvas_cull_mask) {
 	Item *ci = p_canvas_item;
 
 	if (!ci->visible) {
@@ -233,12 +279,23 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 		return;
 	}
 
+	if (_is_static_culled(ci)) {
+		return;
+	}
+
 	if (ci->children_order_dirty) {
 		ci->child_items.sort_custom<ItemIndexSort>();
 		ci->children_order_dirty = false;
 	}
 
-	Rect2 rect = ci->get_rect();
+	Rect2 rect;
+	if (cull_threaded && !ci->custom_rect && (ci->rect_dirty || ci->update_when_visible || ci->skeleton.is_valid())) {
+		// Updating the rect may query mesh and particle storage, which is not thread safe.
+		MutexLock lock(cull_mutex);
+		rect = ci->get_rect();
+	} else {
+		rect = ci->get_rect();
+	}
 
 	if (ci->visibility_notifier) {
 		if (ci->visibility_notifier->area.size != Vector2()) {
@@ -246,13 +303,33 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 		}
 	}
 
-	Transform2D xform = ci->xform;
-	if (snapping_2d_transforms_to_pixel) {
-		xform.columns[2] = xform.columns[2].floor();
+	Item::CullCache &cache = ci->cull_cache;
+	if (cache.dirty || cache.parent_version != p_xform_version || cache.snapped != snapping_2d_transforms_to_pixel) {
+		Transform2D local_xform = ci->xform;
+		if (snapping_2d_transforms_to_pixel) {
+			local_xform.columns[2] = local_xform.columns[2].floor();
+		}
+
+		cache.parent_version = p_xform_version;
+		cache.version = cull_xform_version.increment();
+		cache.canvas_xform = p_transform * local_xform;
+		cache.snapped = snapping_2d_transforms_to_pixel;
+		cache.dirty = false;
+	}
+
+	if (cache.final_version != cache.version || cache.final_canvas_version != cull_canvas_version || cache.local_rect != rect) {
+		cache.final_version = cache.version;
+		cache.final_canvas_version = cull_canvas_version;
+		cache.local_rect = rect;
+		cache.xform = cull_canvas_transform * cache.canvas_xform;
+		cache.global_rect = cache.xform.xform(rect);
 	}
-	xform = p_transform * xform;
 
-	Rect2 global_rect = xform.xform(rect);
+	Transform2D xform = cache.xform;
+	Transform2D canvas_xform = cache.canvas_xform;
+	uint64_t xform_version = cache.version;
+
+	Rect2 global_rect = cache.global_rect;
 	global_rect.position += p_clip_rect.position;
 
 	if (ci->use_parent_material && p_material_owner) {
@@ -301,6 +378,7 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 			if (ci->ysort_children_count == -1) {
 				ci->ysort_children_count = 0;
 				_collect_ysort_children(ci, Transform2D(), p_material_owner, Color(1, 1, 1, 1), nullptr, ci->ysort_children_count, p_z);
+				ci->ysort_order.clear();
 			}
 
 			child_item_count = ci->ysort_children_count + 1;
@@ -313,11 +391,28 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 			ci->ysort_xform = ci->xform.affine_inverse();
 			ci->ysort_modulate = Color(1, 1, 1, 1);
 
-			SortArray<Item *, ItemPtrSort> sorter;
-			sorter.sort(child_items, child_item_count);
-
-			for (i = 0; i < child_item_count; i++) {
-				_cull_canvas_item(child_items[i], xform * child_items[i]->ysort_xform, p_clip_rect, modulate * child_items[i]->ysort_modulate, child_items[i]->ysort_parent_abs_z_index, r_z_list, r_z_last_list, (Item *)ci->final_clip_owner, (Item *)child_items[i]->material_owner, false, canvas_cull_mask);
+			_sort_ysort_children(ci, child_items, child_item_count);
+
+			// A clipping owner rewrites its own clip rect when culled, while its children read it.
+			if (!ci->clip && _can_cull_threaded(child_item_count)) {
+				CullChildrenTask task;
+				task.child_items = child_items;
+				task.child_item_count = child_item_count;
+				task.mode = CULL_CHILDREN_Y_SORTED;
+				task.transform = canvas_xform;
+				task.xform_version = xform_version;
+				task.ysort_owner = ci;
+				task.clip_rect = p_clip_rect;
+				task.modulate = modulate;
+				task.canvas_clip = (Item *)ci->final_clip_owner;
+				task.canvas_cull_mask = canvas_cull_mask;
+				_cull_canvas_item_children_threaded(task, r_z_list, r_z_last_list);
+			} else {
+				for (i = 0; i < child_item_count; i++) {
+					// The owner culls itself again in its y-sorted place, with the transform it was just culled with.
+					uint64_t child_xform_version = child_items[i] == ci ? cache.parent_version : xform_version;
+					_cull_canvas_item(child_items[i], canvas_xform * child_items[i]->ysort_xform, child_xform_version, p_clip_rect, modulate * child_items[i]->ysort_modulate, child_items[i]->ysort_parent_abs_z_index, r_z_list, r_z_last_list, (Item *)ci->final_clip_owner, (Item *)child_items[i]->material_owner, false, canvas_cull_mask);
+				}
 			}
 		} else {
 			RendererCanvasRender::Item *canvas_group_from = nullptr;
@@ -341,14 +436,223 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 			if (!child_items[i]->behind && !use_canvas_group) {
 				continue;
 			}
-			_cull_canvas_item(child_items[i], xform, p_clip_rect, modulate, p_z, r_z_list, r_z_last_list, (Item *)ci->final_clip_owner, p_material_owner, true, canvas_cull_mask);
+			_cull_canvas_item(child_items[i], canvas_xform, xform_version, p_clip_rect, modulate, p_z, r_z_list, r_z_last_list, (Item *)ci->final_clip_owner, p_material_owner, true, canvas_cull_mask);
 		}
 		_attach_canvas_item_for_draw(ci, p_canvas_clip, r_z_list, r_z_last_list, xform, p_clip_rect, global_rect, modulate, p_z, p_material_owner, use_canvas_group, canvas_group_from, xform);
-		for (int i = 0; i < child_item_count; i++) {
-			if (child_items[i]->behind || use_canvas_group) {
+		if (!use_canvas_group && _can_cull_threaded(child_item_count)) {
+			CullChildrenTask task;
+			task.child_items = child_items;
+			task.child_item_count = child_item_count;
+			task.mode = CULL_CHILDREN_IN_FRONT;
+			task.transform = canvas_xform;
+			task.xform_version = xform_version;
+			task.clip_rect = p_clip_rect;
+			task.modulate = modulate;
+			task.z = p_z;
+			task.canvas_clip = (Item *)ci->final_clip_owner;
+			task.material_owner = p_material_owner;
+			task.canvas_cull_mask = canvas_cull_mask;
+			_cull_canvas_item_children_threaded(task, r_z_list, r_z_last_list);
+		} else {
+			for (int i = 0; i < child_item_count; i++) {
+				if (child_items[i]->behind || use_canvas_group) {
+					continue;
+				}
+				_cull_canvas_item(child_items[i], canvas_xform, xform_version, p_clip_rect, modulate, p_z, r_z_list, r_z_last_list, (Item *)ci->final_clip_owner, p_material_owner, true, canvas_cull_mask);
+			}
+		}
+	}
+}
+
+void RendererCanvasCull::_sort_ysort_children(Item *p_owner, Item **r_items, int p_count) {
+	LocalVector<Item *> &order = p_owner->ysort_order;
+
+	// The cached order is cleared whenever the set of flattened children changes.
+	bool sorted = false;
+	if (order.size() == uint32_t(p_count)) {
+		memcpy(r_items, order.ptr(), p_count * sizeof(Item *));
+
+		ItemPtrSort compare;
+		uint64_t max_shifts = uint64_t(p_count) * YSORT_INCREMENTAL_MAX_SHIFTS_PER_ITEM;
+		uint64_t shifts = 0;
+		sorted = true;
+		for (int i = 1; i < p_count && sorted; i++) {
+			Item *item = r_items[i];
+			int j = i;
+			while (j > 0 && compare(item, r_items[j - 1])) {
+				r_items[j] = r_items[j - 1];
+				j--;
+				if (++shifts > max_shifts) {
+					sorted = false;
+					break;
+				}
+			}
+			r_items[j] = item;
+		}
+	}
+
+	if (!sorted) {
+		SortArray<Item *, ItemPtrSort> sorter;
+		sorter.sort(r_items, p_count);
+	}
+
+	order.resize(p_count);
+	memcpy(order.ptr(), r_items, p_count * sizeof(Item *));
+}
+
+bool RendererCanvasCull::_can_cull_threaded(int p_item_count) const {
+	// Only the outermost large sibling list is split, tasks never spawn further tasks.
+	return !cull_threaded && p_item_count >= CULL_THREADED_MIN_ITEMS && WorkerThreadPool::get_singleton()->get_thread_count() > 1;
+}
+
+void RendererCanvasCull::_cull_canvas_item_children_chunk(uint32_t p_chunk, CullChildrenTask *p_task) {
+	RendererCanvasRender::Item **chunk_z_list = cull_chunk_z_lists.ptr() + p_chunk * z_range * 2;
+	RendererCanvasRender::Item **chunk_z_last_list = chunk_z_list + z_range;
+
+	memset(chunk_z_list, 0, z_range * 2 * sizeof(RendererCanvasRender::Item *));
+
+	uint32_t from = uint64_t(p_task->child_item_count) * p_chunk / p_task->chunk_count;
+	uint32_t to = uint64_t(p_task->child_item_count) * (p_chunk + 1) / p_task->chunk_count;
+
+	for (uint32_t i = from; i < to; i++) {
+		Item *child = p_task->child_items[i];
+
+		switch (p_task->mode) {
+			case CULL_CHILDREN_ALL: {
+				_cull_canvas_item(child, p_task->transform, p_task->xform_version, p_task->clip_rect, p_task->modulate, p_task->z, chunk_z_list, chunk_z_last_list, p_task->canvas_clip, p_task->material_owner, true, p_task->canvas_cull_mask);
+			} break;
+			case CULL_CHILDREN_IN_FRONT: {
+				if (child->behind) {
+					continue;
+				}
+				_cull_canvas_item(child, p_task->transform, p_task->xform_version, p_task->clip_rect, p_task->modulate, p_task->z, chunk_z_list, chunk_z_last_list, p_task->canvas_clip, p_task->material_owner, true, p_task->canvas_cull_mask);
+			} break;
+			case CULL_CHILDREN_Y_SORTED: {
+				uint64_t xform_version = child == p_task->ysort_owner ? child->cull_cache.parent_version : p_task->xform_version;
+				_cull_canvas_item(child, p_task->transform * child->ysort_xform, xform_version, p_task->clip_rect, p_task->modulate * child->ysort_modulate, child->ysort_parent_abs_z_index, chunk_z_list, chunk_z_last_list, p_task->canvas_clip, (Item *)child->material_owner, false, p_task->canvas_cull_mask);
+			} break;
+		}
+	}
+}
+
+void RendererCanvasCull::_cull_canvas_item_children_threaded(CullChildrenTask &p_task, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list) {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	p_task.chunk_count = CLAMP(p_task.child_item_count / CULL_THREADED_MIN_ITEMS_PER_TASK, 1u, uint32_t(pool->get_thread_count()));
+
+	cull_chunk_z_lists.resize(p_task.chunk_count * z_range * 2);
+
+	cull_threaded = true;
+	WorkerThreadPool::GroupID group_task = pool->add_template_group_task(this, &RendererCanvasCull::_cull_canvas_item_children_chunk, &p_task, p_task.chunk_count, -1, true, SNAME("CanvasCull"));
+	pool->wait_for_group_task_completion(group_task);
+	cull_threaded = false;
+
+	if (cull_redraw_requested.is_set()) {
+		cull_redraw_requested.clear();
+		RenderingServerDefault::redraw_request();
+	}
+
+	// Append each chunk's lists in order, as a serial cull would have.
+	for (uint32_t i = 0; i < p_task.chunk_count; i++) {
+		RendererCanvasRender::Item **chunk_z_list = cull_chunk_z_lists.ptr() + i * z_range * 2;
+		RendererCanvasRender::Item **chunk_z_last_list = chunk_z_list + z_range;
+
+		for (int j = 0; j < z_range; j++) {
+			if (!chunk_z_list[j]) {
 				continue;
 			}
-			_cull_canvas_item(child_items[i], xform, p_clip_rect, modulate, p_z, r_z_list, r_z_last_list, (Item *)ci->final_clip_owner, p_material_owner, true, canvas_cull_mask);
+			if (r_z_last_list[j]) {
+				r_z_last_list[j]->next = chunk_z_list[j];
+			} else {
+				r_z_list[j] = chunk_z_list[j];
+			}
+			r_z_last_list[j] = chunk_z_last_list[j];
+		}
+	}
+}
+
+bool RendererCanvasCull::_is_static_culled(const Item *p_item) const {
+	if (!static_cull_active || !p_item->static_index_id.is_valid() || p_item->static_visible_pass == static_cull_pass) {
+		return false;
+	}
+	// Only leaves with a plain rect can be skipped, anything else may draw outside of it.
+	return p_item->child_items.is_empty() && !p_item->vp_render && !p_item->copy_back_buffer && !p_item->canvas_group && p_item->skeleton.is_null();
+}
+
+void RendererCanvasCull::_propagate_static_count(RID p_parent, int p_delta) {
+	while (canvas_item_owner.owns(p_parent)) {
+		Item *parent = canvas_item_owner.get_or_null(p_parent);
+		parent->static_count += p_delta;
+		p_parent = parent->parent;
+	}
+}
+
+void RendererCanvasCull::_mark_static_dirty(Item *p_item) {
+	if (!p_item->static_dirty_element.in_list()) {
+		static_dirty_list.add(&p_item->static_dirty_element);
+	}
+}
+
+void RendererCanvasCull::_mark_static_subtree_dirty(Item *p_item) {
+	if (p_item->static_count == 0) {
+		return;
+	}
+
+	if (p_item->is_static) {
+		_mark_static_dirty(p_item);
+	}
+
+	for (int i = 0; i < p_item->child_items.size(); i++) {
+		_mark_static_subtree_dirty(p_item->child_items[i]);
+	}
+}
+
+void RendererCanvasCull::_remove_static_from_index(Item *p_item) {
+	if (p_item->static_index_id.is_valid()) {
+		// The index went away with its canvas if it was freed.
+		Canvas *canvas = canvas_owner.get_or_null(p_item->static_canvas);
+		if (canvas) {
+			canvas->static_index.remove(p_item->static_index_id);
+		}
+	}
+
+	p_item->static_index_id = DynamicBVH::ID();
+	p_item->static_canvas = RID();
+}
+
+void RendererCanvasCull::_update_static_index() {
+	while (static_dirty_list.first()) {
+		Item *ci = static_dirty_list.first()->self();
+		static_dirty_list.remove(&ci->static_dirty_element);
+
+		// Walk up to the canvas, accumulating the canvas space transform.
+		Transform2D xform = ci->xform;
+		RID parent = ci->parent;
+		while (canvas_item_owner.owns(parent)) {
+			Item *parent_item = canvas_item_owner.get_or_null(parent);
+			xform = parent_item->xform * xform;
+			parent = parent_item->parent;
+		}
+
+		Canvas *canvas = canvas_owner.get_or_null(parent);
+		if (!ci->is_static || !canvas || ci->static_canvas != parent) {
+			_remove_static_from_index(ci);
+		}
+		if (!ci->is_static || !canvas) {
+			continue;
+		}
+
+		Rect2 rect = ci->get_rect();
+		if (ci->visibility_notifier && ci->visibility_notifier->area.size != Vector2()) {
+			rect = rect.merge(ci->visibility_notifier->area);
+		}
+		rect = xform.xform(rect);
+
+		AABB aabb(Vector3(rect.position.x, rect.position.y, 0), Vector3(rect.size.x, rect.size.y, 0));
+		if (ci->static_index_id.is_valid()) {
+			canvas->static_index.update(ci->static_index_id, aabb);
+		} else {
+			ci->static_index_id = canvas->static_index.insert(aabb, ci);
+			ci->static_canvas = parent;
 		}
 	}
 }
@@ -359,6 +663,8 @@ void RendererCanvasCull::render_canvas(RID p_render_target, Canvas *p_canvas, co
 	sdf_used = false;
 	snapping_2d_transforms_to_pixel = p_snap_2d_transforms_to_pixel;
 
+	_update_static_index();
+
 	if (p_canvas->children_order_dirty) {
 		p_canvas->child_items.sort();
 		p_canvas->children_order_dirty = false;
@@ -376,26 +682,26 @@ void RendererCanvasCull::render_canvas(RID p_render_target, Canvas *p_canvas, co
 	}
 
 	if (!has_mirror) {
-		_render_canvas_item_tree(p_render_target, ci, l, nullptr, p_transform, p_clip_rect, p_canvas->modulate, p_lights, p_directional_lights, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel, canvas_cull_mask);
+		_render_canvas_item_tree(p_render_target, p_canvas, ci, l, nullptr, p_transform, p_clip_rect, p_canvas->modulate, p_lights, p_directional_lights, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel, canvas_cull_mask);
 
 	} else {
 		//used for parallaxlayer mirroring
 		for (int i = 0; i < l; i++) {
 			const Canvas::ChildItem &ci2 = p_canvas->child_items[i];
-			_render_canvas_item_tree(p_render_target, nullptr, 0, ci2.item, p_transform, p_clip_rect, p_canvas->modulate, p_lights, p_directional_lights, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel, canvas_cull_mask);
+			_render_canvas_item_tree(p_render_target, p_canvas, nullptr, 0, ci2.item, p_transform, p_clip_rect, p_canvas->modulate, p_lights, p_directional_lights, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel, canvas_cull_mask);
 
 			//mirroring (useful for scrolling backgrounds)
 			if (ci2.mirror.x != 0) {
 				Transform2D xform2 = p_transform * Transform2D(0, Vector2(ci2.mirror.x, 0));
-				_render_canvas_item_tree(p_render_target, nullptr, 0, ci2.item, xform2, p_clip_rect, p_canvas->modulate, p_lights, p_directional_lights, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel, canvas_cull_mask);
+				_render_canvas_item_tree(p_render_target, p_canvas, nullptr, 0, ci2.item, xform2, p_clip_rect, p_canvas->modulate, p_lights, p_directional_lights, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel, canvas_cull_mask);
 			}
 			if (ci2.mirror.y != 0) {
 				Transform2D xform2 = p_transform * Transform2D(0, Vector2(0, ci2.mirror.y));
-				_render_canvas_item_tree(p_render_target, nullptr, 0, ci2.item, xform2, p_clip_rect, p_canvas->modulate, p_lights, p_directional_lights, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel, canvas_cull_mask);
+				_render_canvas_item_tree(p_render_target, p_canvas, nullptr, 0, ci2.item, xform2, p_clip_rect, p_canvas->modulate, p_lights, p_directional_lights, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel, canvas_cull_mask);
 			}
 			if (ci2.mirror.y != 0 && ci2.mirror.x != 0) {
 				Transform2D xform2 = p_transform * Transform2D(0, ci2.mirror);
-				_render_canvas_item_tree(p_render_target, nullptr, 0, ci2.item, xform2, p_clip_rect, p_canvas->modulate, p_lights, p_directional_lights, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel, canvas_cull_mask);
+				_render_canvas_item_tree(p_render_target, p_canvas, nullptr, 0, ci2.item, xform2, p_clip_rect, p_canvas->modulate, p_lights, p_directional_lights, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel, canvas_cull_mask);
 			}
 		}
 	}
@@ -455,6 +761,8 @@ void RendererCanvasCull::canvas_item_set_parent(RID p_item, RID p_parent) {
 	ERR_FAIL_COND(!canvas_item);
 
 	if (canvas_item->parent.is_valid()) {
+		_propagate_static_count(canvas_item->parent, -int(canvas_item->static_count));
+
 		if (canvas_owner.owns(canvas_item->parent)) {
 			Canvas *canvas = canvas_owner.get_or_null(canvas_item->parent);
 			canvas->erase_item(canvas_item);
@@ -492,6 +800,9 @@ void RendererCanvasCull::canvas_item_set_parent(RID p_item, RID p_parent) {
 	}
 
 	canvas_item->parent = p_parent;
+
+	_propagate_static_count(p_parent, canvas_item->static_count);
+	_mark_static_subtree_dirty(canvas_item);
 }
 
 void RendererCanvasCull::canvas_item_set_visible(RID p_item, bool p_visible) {
@@ -515,6 +826,9 @@ void RendererCanvasCull::canvas_item_set_transform(RID p_item, const Transform2D
 	ERR_FAIL_COND(!canvas_item);
 
 	canvas_item->xform = p_transform;
+	canvas_item->cull_cache.dirty = true;
+
+	_mark_static_subtree_dirty(canvas_item);
 }
 
 void RendererCanvasCull::canvas_item_set_visibility_layer(RID p_item, uint32_t p_visibility_layer) {
@@ -551,6 +865,10 @@ void RendererCanvasCull::canvas_item_set_custom_rect(RID p_item, bool p_custom_r
 
 	canvas_item->custom_rect = p_custom_rect;
 	canvas_item->rect = p_rect;
+
+	if (canvas_item->is_static) {
+		_mark_static_dirty(canvas_item);
+	}
 }
 
 void RendererCanvasCull::canvas_item_set_modulate(RID p_item, const Color &p_color) {
@@ -581,6 +899,26 @@ void RendererCanvasCull::canvas_item_set_update_when_visible(RID p_item, bool p_
 	canvas_item->update_when_visible = p_update;
 }
 
+void RendererCanvasCull::canvas_item_set_static(RID p_item, bool p_static) {
+	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
+	ERR_FAIL_COND(!canvas_item);
+
+	if (canvas_item->is_static == p_static) {
+		return;
+	}
+
+	canvas_item->is_static = p_static;
+	int delta = p_static ? 1 : -1;
+	canvas_item->static_count += delta;
+	_propagate_static_count(canvas_item->parent, delta);
+
+	if (p_static) {
+		_mark_static_dirty(canvas_item);
+	} else {
+		_remove_static_from_index(canvas_item);
+	}
+}
+
 void RendererCanvasCull::canvas_item_add_line(RID p_item, const Point2 &p_from, const Point2 &p_to, const Color &p_color, float p_width, bool p_antialiased) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_COND(!canvas_item);
@@ -1460,6 +1798,142 @@ void RendererCanvasCull::canvas_item_add_multimesh(RID p_item, RID p_mesh, RID p
 	mm->texture = p_texture;
 }
 
+RID RendererCanvasCull::_get_sprite_batch_quad() {
+	if (sprite_batch_quad.is_null()) {
+		Vector<Vector2> points = { Vector2(0, 0), Vector2(1, 0), Vector2(1, 1), Vector2(0, 1) };
+		Vector<int> indices = { 0, 1, 2, 0, 2, 3 };
+
+		Array arrays;
+		arrays.resize(RS::ARRAY_MAX);
+		arrays[RS::ARRAY_VERTEX] = points;
+		arrays[RS::ARRAY_TEX_UV] = points;
+		arrays[RS::ARRAY_INDEX] = indices;
+
+		RS::SurfaceData surface;
+		Error err = RS::get_singleton()->mesh_create_surface_data_from_arrays(&surface, RS::PRIMITIVE_TRIANGLES, arrays);
+		ERR_FAIL_COND_V(err != OK, RID());
+
+		sprite_batch_quad = RSG::mesh_storage->mesh_allocate();
+		RSG::mesh_storage->mesh_initialize(sprite_batch_quad);
+		RSG::mesh_storage->mesh_add_surface(sprite_batch_quad, surface);
+	}
+	return sprite_batch_quad;
+}
+
+void RendererCanvasCull::canvas_item_add_sprite_batch(RID p_item, RID p_texture, const Vector<float> &p_transforms, const Vector<float> &p_regions, const Vector<Color> &p_colors, bool p_centered) {
+	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
+	ERR_FAIL_COND(!canvas_item);
+	ERR_FAIL_COND_MSG(p_transforms.size() % 6 != 0, "Sprite batch transforms must contain 6 floats per instance.");
+
+	int instance_count = p_transforms.size() / 6;
+	if (instance_count == 0) {
+		return;
+	}
+
+	int region_count = p_regions.size() / 4;
+	ERR_FAIL_COND_MSG(p_regions.size() % 4 != 0 || (region_count > 1 && region_count != instance_count), "Sprite batch regions must be empty, a single Rect2 or one Rect2 per instance.");
+	int color_count = p_colors.size();
+	ERR_FAIL_COND_MSG(color_count > 1 && color_count != instance_count, "Sprite batch colors must be empty, a single Color or one Color per instance.");
+
+	RID quad = _get_sprite_batch_quad();
+	ERR_FAIL_COND(quad.is_null());
+
+	// Regions default to the whole texture, which is the diffuse one for canvas textures.
+	Size2 texture_size;
+	RID diffuse = p_texture.is_valid() ? RSG::texture_storage->canvas_texture_get_diffuse(p_texture) : RID();
+	if (diffuse.is_valid()) {
+		texture_size = RSG::texture_storage->texture_size_with_proxy(diffuse);
+	}
+
+	// Reuse the multimesh this batch had in the previous redraw. Its data is reallocated to grow, or to
+	// shrink when the batch stayed well below the capacity for a while.
+	if (canvas_item->sprite_batch_multimeshes_used == canvas_item->sprite_batch_multimeshes.size()) {
+		Item::SpriteBatchMultiMesh sprite_batch_multimesh;
+		sprite_batch_multimesh.multimesh = RSG::mesh_storage->multimesh_allocate();
+		RSG::mesh_storage->multimesh_initialize(sprite_batch_multimesh.multimesh);
+		RSG::mesh_storage->multimesh_set_mesh(sprite_batch_multimesh.multimesh, quad);
+		canvas_item->sprite_batch_multimeshes.push_back(sprite_batch_multimesh);
+	}
+	Item::SpriteBatchMultiMesh &sprite_batch_multimesh = canvas_item->sprite_batch_multimeshes[canvas_item->sprite_batch_multimeshes_used++];
+	RID multimesh = sprite_batch_multimesh.multimesh;
+	if (instance_count * 4 <= sprite_batch_multimesh.capacity) {
+		sprite_batch_multimesh.low_usage_redraws++;
+	} else {
+		sprite_batch_multimesh.low_usage_redraws = 0;
+	}
+	if (sprite_batch_multimesh.capacity < instance_count || sprite_batch_multimesh.low_usage_redraws >= SPRITE_BATCH_SHRINK_REDRAWS) {
+		sprite_batch_multimesh.capacity = next_power_of_2(instance_count);
+		sprite_batch_multimesh.low_usage_redraws = 0;
+		RSG::mesh_storage->multimesh_allocate_data(multimesh, sprite_batch_multimesh.capacity, RS::MULTIMESH_TRANSFORM_2D, true, true);
+	}
+
+	// 2D transform (8 floats), color (4) and region (4) per instance, the layout
+	// multimesh_set_buffer() expects for MULTIMESH_TRANSFORM_2D with colors and custom data.
+	const int stride = 16;
+	Vector<float> buffer;
+	buffer.resize(sprite_batch_multimesh.capacity * stride);
+	float *w = buffer.ptrw();
+	const float *transforms = p_transforms.ptr();
+	const float *regions = p_regions.ptr();
+	const Color *colors = p_colors.ptr();
+
+	for (int i = 0; i < instance_count; i++) {
+		const float *t = transforms + i * 6;
+		Transform2D xform(t[0], t[1], t[2], t[3], t[4], t[5]);
+
+		Rect2 region;
+		if (region_count > 0) {
+			const float *r = regions + (region_count == 1 ? 0 : i * 4);
+			region = Rect2(r[0], r[1], r[2], r[3]);
+		}
+		if (region.size == Size2()) {
+			region = Rect2(Point2(), texture_size);
+		}
+
+		// Scale the unit quad to the region, so the multimesh covers it in pixels.
+		Transform2D quad_xform(region.size.x, 0, 0, region.size.y, 0, 0);
+		if (p_centered) {
+			quad_xform.columns[2] = -region.size / 2;
+		}
+		xform = xform * quad_xform;
+
+		float *dataptr = w + i * stride;
+		dataptr[0] = xform.columns[0][0];
+		dataptr[1] = xform.columns[1][0];
+		dataptr[2] = 0;
+		dataptr[3] = xform.columns[2][0];
+		dataptr[4] = xform.columns[0][1];
+		dataptr[5] = xform.columns[1][1];
+		dataptr[6] = 0;
+		dataptr[7] = xform.columns[2][1];
+
+		Color color = color_count == 0 ? Color(1, 1, 1) : colors[color_count == 1 ? 0 : i];
+		dataptr[8] = color.r;
+		dataptr[9] = color.g;
+		dataptr[10] = color.b;
+		dataptr[11] = color.a;
+
+		dataptr[12] = region.position.x;
+		dataptr[13] = region.position.y;
+		dataptr[14] = region.size.x;
+		dataptr[15] = region.size.y;
+	}
+
+	// Unused instances aren't drawn, they repeat the last one so they don't grow the multimesh AABB.
+	for (int i = instance_count; i < sprite_batch_multimesh.capacity; i++) {
+		memcpy(w + i * stride, w + (instance_count - 1) * stride, stride * sizeof(float));
+	}
+
+	RSG::mesh_storage->multimesh_set_buffer(multimesh, buffer);
+	RSG::mesh_storage->multimesh_set_visible_instances(multimesh, instance_count);
+
+	Item::CommandMultiMesh *mm = canvas_item->alloc_command<Item::CommandMultiMesh>();
+	ERR_FAIL_COND(!mm);
+	mm->multimesh = multimesh;
+	mm->texture = p_texture;
+	mm->sprite_batch = true;
+}
+
 void RendererCanvasCull::canvas_item_add_clip_ignore(RID p_item, bool p_ignore) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_COND(!canvas_item);
@@ -1557,6 +2031,15 @@ void RendererCanvasCull::canvas_item_clear(RID p_item) {
 	ERR_FAIL_COND(!canvas_item);
 
 	canvas_item->clear();
+
+	if (!canvas_item->sprite_batch_multimeshes.is_empty() && !canvas_item->sprite_batch_trim_element.in_list()) {
+		sprite_batch_trim_list.add(&canvas_item->sprite_batch_trim_element);
+	}
+
+	// Commands are added after clearing, the rect is read when the index is updated.
+	if (canvas_item->is_static) {
+		_mark_static_dirty(canvas_item);
+	}
 }
 
 void RendererCanvasCull::canvas_item_set_draw_index(RID p_item, int p_index) {
@@ -1610,6 +2093,10 @@ void RendererCanvasCull::canvas_item_set_visibility_notifier(RID p_item, bool p_
 			canvas_item->visibility_notifier = nullptr;
 		}
 	}
+
+	if (canvas_item->is_static) {
+		_mark_static_dirty(canvas_item);
+	}
 }
 
 void RendererCanvasCull::canvas_item_set_canvas_group_mode(RID p_item, RS::CanvasGroupMode p_mode, float p_clear_margin, bool p_fit_empty, float p_fit_margin, bool p_blur_mipmaps) {
@@ -2048,6 +2535,7 @@ bool RendererCanvasCull::free(RID p_rid) {
 
 		for (int i = 0; i < canvas->child_items.size(); i++) {
 			canvas->child_items[i].item->parent = RID();
+			_mark_static_subtree_dirty(canvas->child_items[i].item);
 		}
 
 		for (RendererCanvasRender::Light *E : canvas->lights) {
@@ -2065,6 +2553,8 @@ bool RendererCanvasCull::free(RID p_rid) {
 		ERR_FAIL_COND_V(!canvas_item, true);
 
 		if (canvas_item->parent.is_valid()) {
+			_propagate_static_count(canvas_item->parent, -int(canvas_item->static_count));
+
 			if (canvas_owner.owns(canvas_item->parent)) {
 				Canvas *canvas = canvas_owner.get_or_null(canvas_item->parent);
 				canvas->erase_item(canvas_item);
@@ -2078,8 +2568,11 @@ bool RendererCanvasCull::free(RID p_rid) {
 			}
 		}
 
+		_remove_static_from_index(canvas_item);
+
 		for (int i = 0; i < canvas_item->child_items.size(); i++) {
 			canvas_item->child_items[i]->parent = RID();
+			_mark_static_subtree_dirty(canvas_item->child_items[i]);
 		}
 
 		if (canvas_item->visibility_notifier != nullptr) {
@@ -2150,6 +2643,26 @@ bool RendererCanvasCull::free(RID p_rid) {
 	return true;
 }
 
+void RendererCanvasCull::update_sprite_batches() {
+	// The redraws are complete by now, free the multimeshes past the last one they used.
+	while (sprite_batch_trim_list.first()) {
+		Item *ci = sprite_batch_trim_list.first()->self();
+		sprite_batch_trim_list.remove(&ci->sprite_batch_trim_element);
+
+		for (uint32_t i = ci->sprite_batch_multimeshes_used; i < ci->sprite_batch_multimeshes.size(); i++) {
+			RSG::mesh_storage->multimesh_free(ci->sprite_batch_multimeshes[i].multimesh);
+		}
+		ci->sprite_batch_multimeshes.resize(ci->sprite_batch_multimeshes_used);
+	}
+}
+
+void RendererCanvasCull::finalize() {
+	if (sprite_batch_quad.is_valid()) {
+		RSG::mesh_storage->mesh_free(sprite_batch_quad);
+		sprite_batch_quad = RID();
+	}
+}
+
 RendererCanvasCull::RendererCanvasCull() {
 	z_list = (RendererCanvasRender::Item **)memalloc(z_range * sizeof(RendererCanvasRender::Item *));
 	z_last_list = (RendererCanvasRender::Item **)memalloc(z_range * sizeof(RendererCanvasRender::Item *));
@@ -2158,6 +2671,12 @@ RendererCanvasCull::RendererCanvasCull() {
 }
 
 RendererCanvasCull::~RendererCanvasCull() {
+	while (static_dirty_list.first()) {
+		static_dirty_list.remove(static_dirty_list.first());
+	}
+	while (sprite_batch_trim_list.first()) {
+		sprite_batch_trim_list.remove(sprite_batch_trim_list.first());
+	}
 	memfree(z_list);
 	memfree(z_last_list);
 }
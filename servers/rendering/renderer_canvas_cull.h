@@ -31,7 +31,11 @@
 #ifndef RENDERER_CANVAS_CULL_H
 #define RENDERER_CANVAS_CULL_H
 
+#include "core/math/dynamic_bvh.h"
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/paged_allocator.h"
+#include "core/templates/safe_refcount.h"
 #include "renderer_compositor.h"
 #include "renderer_viewport.h"
 
@@ -54,6 +58,7 @@ public:
 		Vector2 ysort_pos;
 		int ysort_index;
 		int ysort_parent_abs_z_index; // Absolute Z index of parent. Only populated and used when y-sorting.
+		LocalVector<Item *> ysort_order; // Sorted children of a y-sort owner in the last cull, reused as the starting order of the next one.
 		uint32_t visibility_layer = 0xffffffff;
 
 		Vector<Item *> child_items;
@@ -72,7 +77,39 @@ public:
 
 		VisibilityNotifierData *visibility_notifier = nullptr;
 
-		Item() {
+		// Transforms and rect computed by the last cull. The canvas space transform is reused while
+		// the item's own transform is clean and its parent's hasn't been recomputed, which each
+		// recomputation tells apart with a new version. The final transform and rect also depend on
+		// the canvas transform, so scrolling a camera only redoes the last step.
+		struct CullCache {
+			uint64_t parent_version = 0;
+			uint64_t version = 0; // Unique among all items, 0 is canvas space.
+			Transform2D canvas_xform;
+			bool snapped = false;
+			bool dirty = true;
+
+			uint64_t final_version = 0;
+			uint64_t final_canvas_version = 0;
+			Rect2 local_rect;
+			Transform2D xform;
+			Rect2 global_rect;
+		} cull_cache;
+
+		// Static items are kept in a spatial index of their canvas, so culling can skip the ones
+		// outside the viewport without visiting them. Their canvas space rect is refreshed when
+		// they or any ancestor move, are reparented or are redrawn.
+		bool is_static = false;
+		uint32_t static_count = 0; // Static items in this subtree, including this one.
+		RID static_canvas;
+		DynamicBVH::ID static_index_id;
+		uint64_t static_visible_pass = 0;
+		SelfList<Item> static_dirty_element;
+
+		SelfList<Item> sprite_batch_trim_element;
+
+		Item() :
+				static_dirty_element(this),
+				sprite_batch_trim_element(this) {
 			children_order_dirty = true;
 			E = nullptr;
 			z_index = 0;
@@ -144,6 +181,8 @@ public:
 		RID parent;
 		float parent_scale;
 
+		DynamicBVH static_index;
+
 		int find_item(Item *p_item) {
 			for (int i = 0; i < child_items.size(); i++) {
 				if (child_items[i].item == p_item) {
@@ -180,14 +219,115 @@ public:
 	_FORCE_INLINE_ void _attach_canvas_item_for_draw(Item *ci, Item *p_canvas_clip, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, const Transform2D &xform, const Rect2 &p_clip_rect, Rect2 global_rect, const Color &modulate, int p_z, RendererCanvasCull::Item *p_material_owner, bool p_use_canvas_group, RendererCanvasRender::Item *canvas_group_from, const Transform2D &p_xform);
 
 private:
-	void _render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, RS::CanvasItemTextureFilter p_default_filter, RS::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel, uint32_t canvas_cull_mask);
-	void _cull_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, Item *p_canvas_clip, Item *p_material_owner, bool allow_y_sort, uint32_t canvas_cull_mask);
+	void _render_canvas_item_tree(RID p_to_render_target, Canvas *p_canvas, Canvas::ChildItem *p_child_items, int p_child_item_count, Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, RS::CanvasItemTextureFilter p_default_filter, RS::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel, uint32_t canvas_cull_mask);
+	void _cull_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, uint64_t p_xform_version, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, Item *p_canvas_clip, Item *p_material_owner, bool allow_y_sort, uint32_t canvas_cull_mask);
 
 	static constexpr int z_range = RS::CANVAS_ITEM_Z_MAX - RS::CANVAS_ITEM_Z_MIN + 1;
 
 	RendererCanvasRender::Item **z_list;
 	RendererCanvasRender::Item **z_last_list;
 
+	/* Y-SORT */
+
+	// Y positions change little from one frame to the next, so last frame's order is nearly
+	// sorted and an insertion sort finishes in close to linear time. When too many items have
+	// to be shifted, it gives up and the regular sort takes over.
+	enum {
+		YSORT_INCREMENTAL_MAX_SHIFTS_PER_ITEM = 4,
+	};
+
+	void _sort_ysort_children(Item *p_owner, Item **r_items, int p_count);
+
+	/* THREADED CULLING */
+
+	// Siblings are split in contiguous chunks, each culled into its own z lists. Appending the
+	// chunk lists back in order gives exactly the same draw order as a serial cull.
+	enum {
+		CULL_THREADED_MIN_ITEMS = 1024,
+		CULL_THREADED_MIN_ITEMS_PER_TASK = 256,
+	};
+
+	enum CullChildrenMode {
+		CULL_CHILDREN_ALL,
+		CULL_CHILDREN_IN_FRONT,
+		CULL_CHILDREN_Y_SORTED,
+	};
+
+	struct CullChildrenTask {
+		Item **child_items = nullptr;
+		uint32_t child_item_count = 0;
+		uint32_t chunk_count = 0;
+		CullChildrenMode mode = CULL_CHILDREN_ALL;
+		Transform2D transform;
+		uint64_t xform_version = 0;
+		Item *ysort_owner = nullptr;
+		Rect2 clip_rect;
+		Color modulate;
+		int z = 0;
+		Item *canvas_clip = nullptr;
+		Item *material_owner = nullptr;
+		uint32_t canvas_cull_mask = 0;
+	};
+
+	// Items are culled in canvas space, the canvas transform is only applied to their final transforms.
+	Transform2D cull_canvas_transform;
+	uint64_t cull_canvas_version = 1;
+	SafeNumeric<uint64_t> cull_xform_version;
+
+	bool cull_threaded = false;
+	BinaryMutex cull_mutex;
+	SafeFlag cull_redraw_requested;
+	LocalVector<RendererCanvasRender::Item *> cull_chunk_z_lists;
+	LocalVector<Item *> cull_top_level_items;
+
+	_FORCE_INLINE_ bool _can_cull_threaded(int p_item_count) const;
+	void _cull_canvas_item_children_chunk(uint32_t p_chunk, CullChildrenTask *p_task);
+	void _cull_canvas_item_children_threaded(CullChildrenTask &p_task, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list);
+
+	/* STATIC ITEM INDEX */
+
+	// Each pass queries the canvas index with the viewport rect and stamps the static items it
+	// finds. Unstamped static leaves are skipped, which can only drop items that would have been
+	// culled anyway, so z and tree (or y-sort) order of the drawn items are unchanged.
+	struct StaticIndexQuery {
+		uint64_t pass = 0;
+
+		_FORCE_INLINE_ bool operator()(void *p_data) {
+			((Item *)p_data)->static_visible_pass = pass;
+			return false;
+		}
+	};
+
+	// Grows the query, so pixel snapping of transforms can't push an item out of the index rect.
+	static constexpr real_t STATIC_INDEX_MARGIN = 2.0;
+
+	SelfList<Item>::List static_dirty_list;
+	uint64_t static_cull_pass = 0;
+	bool static_cull_active = false;
+
+	_FORCE_INLINE_ bool _is_static_culled(const Item *p_item) const;
+	void _propagate_static_count(RID p_parent, int p_delta);
+	void _mark_static_dirty(Item *p_item);
+	void _mark_static_subtree_dirty(Item *p_item);
+	void _remove_static_from_index(Item *p_item);
+	void _update_static_index();
+
+	/* SPRITE BATCH */
+
+	// Unit quad shared by all sprite batches; each instance transform scales it to its region.
+	RID sprite_batch_quad;
+
+	// A multimesh is reallocated to fit once its batch used at most a quarter of it for this many
+	// redraws in a row.
+	enum {
+		SPRITE_BATCH_SHRINK_REDRAWS = 30,
+	};
+
+	// Items cleared since the last frame. Multimeshes their redraw left unused are freed.
+	SelfList<Item>::List sprite_batch_trim_list;
+
+	RID _get_sprite_batch_quad();
+
 public:
 	void render_canvas(RID p_render_target, Canvas *p_canvas, const Transform2D &p_transform, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, const Rect2 &p_clip_rect, RS::CanvasItemTextureFilter p_default_filter, RS::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_transforms_to_pixel, bool p_snap_2d_vertices_to_pixel, uint32_t canvas_cull_mask);
 
@@ -222,6 +362,7 @@ public:
 	void canvas_item_set_draw_behind_parent(RID p_item, bool p_enable);
 
 	void canvas_item_set_update_when_visible(RID p_item, bool p_update);
+	void canvas_item_set_static(RID p_item, bool p_static);
 
 	void canvas_item_add_line(RID p_item, const Point2 &p_from, const Point2 &p_to, const Color &p_color, float p_width = -1.0, bool p_antialiased = false);
 	void canvas_item_add_polyline(RID p_item, const Vector<Point2> &p_points, const Vector<Color> &p_colors, float p_width = -1.0, bool p_antialiased = false);
@@ -238,6 +379,7 @@ public:
 	void canvas_item_add_triangle_array(RID p_item, const Vector<int> &p_indices, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs = Vector<Point2>(), const Vector<int> &p_bones = Vector<int>(), const Vector<float> &p_weights = Vector<float>(), RID p_texture = RID(), int p_count = -1);
 	void canvas_item_add_mesh(RID p_item, const RID &p_mesh, const Transform2D &p_transform = Transform2D(), const Color &p_modulate = Color(1, 1, 1), RID p_texture = RID());
 	void canvas_item_add_multimesh(RID p_item, RID p_mesh, RID p_texture = RID());
+	void canvas_item_add_sprite_batch(RID p_item, RID p_texture, const Vector<float> &p_transforms, const Vector<float> &p_regions = Vector<float>(), const Vector<Color> &p_colors = Vector<Color>(), bool p_centered = true);
 	void canvas_item_add_particles(RID p_item, RID p_particles, RID p_texture);
 	void canvas_item_add_set_transform(RID p_item, const Transform2D &p_transform);
 	void canvas_item_add_clip_ignore(RID p_item, bool p_ignore);
@@ -318,8 +460,11 @@ public:
 	void canvas_item_set_default_texture_repeat(RID p_item, RS::CanvasItemTextureRepeat p_repeat);
 
 	void update_visibility_notifiers();
+	void update_sprite_batches();
 
 	bool free(RID p_rid);
+	void finalize();
+
 	RendererCanvasCull();
 	~RendererCanvasCull();
 };
@@ -134,3 +134,11 @@ RendererCanvasRender::Item::CommandMesh::~CommandMesh() {
 		RSG::mesh_storage->mesh_instance_free(mesh_instance);
 	}
 }
+
+void RendererCanvasRender::Item::free_sprite_batch_multimeshes() {
+	for (const SpriteBatchMultiMesh &E : sprite_batch_multimeshes) {
+		RSG::mesh_storage->multimesh_free(E.multimesh);
+	}
+	sprite_batch_multimeshes.clear();
+	sprite_batch_multimeshes_used = 0;
+}
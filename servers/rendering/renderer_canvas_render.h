@@ -266,6 +266,10 @@ public:
 
 			RID texture;
 
+			// Sprite batches use a multimesh owned by the item and store each
+			// instance's source region (in pixels) in its custom data.
+			bool sprite_batch = false;
+
 			CommandMultiMesh() { type = TYPE_MULTIMESH; }
 		};
 
@@ -340,6 +344,17 @@ public:
 		};
 		CopyBackBuffer *copy_back_buffer = nullptr;
 
+		// Multimeshes of the sprite batch commands, reused in order when the item is redrawn.
+		struct SpriteBatchMultiMesh {
+			RID multimesh;
+			int capacity = 0;
+			int low_usage_redraws = 0; // Redraws in a row that used at most a quarter of the capacity.
+		};
+		LocalVector<SpriteBatchMultiMesh> sprite_batch_multimeshes;
+		uint32_t sprite_batch_multimeshes_used = 0;
+
+		void free_sprite_batch_multimeshes();
+
 		Color final_modulate;
 		Transform2D final_transform;
 		Rect2 final_clip_rect;
@@ -436,6 +451,7 @@ public:
 			final_clip_owner = nullptr;
 			material_owner = nullptr;
 			light_masked = false;
+			sprite_batch_multimeshes_used = 0;
 		}
 
 		RS::CanvasItemTextureFilter texture_filter;
@@ -467,6 +483,7 @@ public:
 		}
 		virtual ~Item() {
 			clear();
+			free_sprite_batch_multimeshes();
 			for (int i = 0; i < blocks.size(); i++) {
 				memfree(blocks[i].memory);
 			}
@@ -478,6 +495,15 @@ public:
 
 	virtual void canvas_render_items(RID p_to_render_target, Item *p_item_list, const Color &p_modulate, Light *p_light_list, Light *p_directional_list, const Transform2D &p_canvas_transform, RS::CanvasItemTextureFilter p_default_filter, RS::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel, bool &r_sdf_used) = 0;
 
+	// Filled by the renderer while drawing, reset by the viewport renderer at the start of each frame.
+	struct RenderInfo {
+		uint32_t items_in_frame = 0;
+		uint32_t batches_in_frame = 0;
+		uint32_t shadow_updates_skipped_in_frame = 0;
+	};
+
+	RenderInfo render_info;
+
 	struct LightOccluderInstance {
 		bool enabled;
 		RID canvas;
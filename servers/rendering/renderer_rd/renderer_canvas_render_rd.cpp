@@ -99,6 +99,143 @@ void RendererCanvasRenderRD::_update_transform_to_mat4(const Transform3D &p_tran
 	p_mat4[15] = 1;
 }
 
+void RendererCanvasRenderRD::PolygonArena::_release(const Allocation &p_allocation) {
+	RBMap<uint32_t, uint32_t> &free_ranges = pages[p_allocation.page].free_ranges;
+
+	RBMap<uint32_t, uint32_t>::Element *previous = free_ranges.find_closest(p_allocation.offset);
+	RBMap<uint32_t, uint32_t>::Element *next = previous ? previous->next() : free_ranges.front();
+
+	if (previous && previous->key() + previous->get() == p_allocation.offset) {
+		previous->get() += p_allocation.size;
+		if (next && previous->key() + previous->get() == next->key()) {
+			previous->get() += next->get();
+			free_ranges.erase(next);
+		}
+	} else if (next && p_allocation.offset + p_allocation.size == next->key()) {
+		uint32_t size = p_allocation.size + next->get();
+		free_ranges.erase(next);
+		free_ranges.insert(p_allocation.offset, size);
+	} else {
+		free_ranges.insert(p_allocation.offset, p_allocation.size);
+	}
+}
+
+uint32_t RendererCanvasRenderRD::PolygonArena::get_aligned_size(uint32_t p_size) {
+	return (p_size + POLYGON_ARENA_ALIGNMENT - 1) & ~uint32_t(POLYGON_ARENA_ALIGNMENT - 1);
+}
+
+bool RendererCanvasRenderRD::PolygonArena::allocate(uint32_t p_size, Allocation &r_allocation) {
+	p_size = get_aligned_size(p_size);
+
+	// First fit.
+	for (uint32_t i = 0; i < pages.size(); i++) {
+		RBMap<uint32_t, uint32_t> &free_ranges = pages[i].free_ranges;
+		for (RBMap<uint32_t, uint32_t>::Element *E = free_ranges.front(); E; E = E->next()) {
+			if (E->get() < p_size) {
+				continue;
+			}
+
+			r_allocation.page = i;
+			r_allocation.offset = E->key();
+			r_allocation.size = p_size;
+
+			uint32_t remaining = E->get() - p_size;
+			free_ranges.erase(E);
+			if (remaining > 0) {
+				free_ranges.insert(r_allocation.offset + p_size, remaining);
+			}
+			return true;
+		}
+	}
+
+	return false;
+}
+
+uint32_t RendererCanvasRenderRD::PolygonArena::add_page(RID p_buffer, uint32_t p_size) {
+	uint32_t page_index = 0;
+	while (page_index < pages.size() && pages[page_index].buffer.is_valid()) {
+		page_index++;
+	}
+	if (page_index == pages.size()) {
+		pages.push_back(Page());
+	}
+
+	Page &page = pages[page_index];
+	page.buffer = p_buffer;
+	page.size = p_size;
+	page.free_ranges.clear();
+	page.free_ranges.insert(0, p_size);
+	return page_index;
+}
+
+void RendererCanvasRenderRD::PolygonArena::free(const Allocation &p_allocation, uint64_t p_frame) {
+	if (pending_frames.is_empty() || pending_frames.back()->get().frame != p_frame) {
+		pending_frames.push_back(PendingFrame());
+		pending_frames.back()->get().frame = p_frame;
+	}
+	pending_frames.back()->get().allocations.push_back(p_allocation);
+}
+
+void RendererCanvasRenderRD::PolygonArena::reclaim(uint64_t p_frame, uint64_t p_frame_delay, LocalVector<RID> &r_empty_buffers) {
+	bool released = false;
+	while (!pending_frames.is_empty() && pending_frames.front()->get().frame + p_frame_delay <= p_frame) {
+		for (const Allocation &allocation : pending_frames.front()->get().allocations) {
+			_release(allocation);
+		}
+		pending_frames.pop_front();
+		released = true;
+	}
+
+	if (!released) {
+		return;
+	}
+
+	// One empty page is kept, so items cleared and redrawn every frame don't create a buffer every time.
+	bool empty_page_kept = false;
+	for (Page &page : pages) {
+		if (page.buffer.is_null() || page.free_ranges.size() != 1 || page.free_ranges.front()->get() != page.size) {
+			continue;
+		}
+		if (!empty_page_kept && page.size == POLYGON_ARENA_PAGE_SIZE) {
+			empty_page_kept = true;
+			continue;
+		}
+		r_empty_buffers.push_back(page.buffer);
+		page.buffer = RID();
+		page.size = 0;
+		page.free_ranges.clear();
+	}
+}
+
+void RendererCanvasRenderRD::PolygonArena::clear(LocalVector<RID> &r_buffers) {
+	for (const Page &page : pages) {
+		if (page.buffer.is_valid()) {
+			r_buffers.push_back(page.buffer);
+		}
+	}
+	pages.clear();
+	pending_frames.clear();
+}
+
+bool RendererCanvasRenderRD::_polygon_arena_allocate(PolygonArena &p_arena, uint32_t p_size, PolygonArena::Allocation &r_allocation) {
+	if (p_arena.allocate(p_size, r_allocation)) {
+		return true;
+	}
+
+	// Polygons larger than a page get a page of their own size.
+	uint32_t size = MAX(uint32_t(POLYGON_ARENA_PAGE_SIZE), PolygonArena::get_aligned_size(p_size));
+	RID buffer;
+	if (p_arena.index_buffers) {
+		buffer = RD::get_singleton()->index_buffer_create(size / sizeof(int32_t), RD::INDEX_BUFFER_FORMAT_UINT32);
+	} else {
+		buffer = RD::get_singleton()->vertex_buffer_create(size);
+	}
+	ERR_FAIL_COND_V(buffer.is_null(), false);
+
+	p_arena.add_page(buffer, size);
+	return p_arena.allocate(p_size, r_allocation);
+}
+
 RendererCanvasRender::PolygonID RendererCanvasRenderRD::request_polygon(const Vector<int> &p_indices, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, const Vector<int> &p_bones, const Vector<float> &p_weights) {
 	// Care must be taken to generate array formats
 	// in ways where they could be reused, so we will
@@ -296,26 +433,37 @@ RendererCanvasRender::PolygonID RendererCanvasRenderRD::request_polygon(const Ve
 	RD::VertexFormatID vertex_id = RD::get_singleton()->vertex_format_create(descriptions);
 	ERR_FAIL_COND_V(vertex_id == RD::INVALID_ID, 0);
 
+	uint64_t frame = RSG::rasterizer->get_frame_number();
+
 	PolygonBuffers pb;
-	pb.vertex_buffer = RD::get_singleton()->vertex_buffer_create(polygon_buffer.size(), polygon_buffer);
+	ERR_FAIL_COND_V(!_polygon_arena_allocate(polygon_buffers.vertex_arena, polygon_buffer.size(), pb.vertices), 0);
+	RID vertex_buffer = polygon_buffers.vertex_arena.pages[pb.vertices.page].buffer;
+	RD::get_singleton()->buffer_update(vertex_buffer, pb.vertices.offset, polygon_buffer.size(), polygon_buffer.ptr());
+
+	Vector<uint64_t> offsets;
+	offsets.resize(descriptions.size());
 	for (int i = 0; i < descriptions.size(); i++) {
 		if (buffers[i] == RID()) { //if put in vertex, use as vertex
-			buffers.write[i] = pb.vertex_buffer;
+			buffers.write[i] = vertex_buffer;
+			offsets.write[i] = pb.vertices.offset;
+		} else {
+			offsets.write[i] = 0;
 		}
 	}
 
-	pb.vertex_array = RD::get_singleton()->vertex_array_create(p_points.size(), vertex_id, buffers);
+	pb.vertex_array = RD::get_singleton()->vertex_array_create(p_points.size(), vertex_id, buffers, offsets);
 
 	if (p_indices.size()) {
 		//create indices, as indices were requested
-		Vector<uint8_t> index_buffer;
-		index_buffer.resize(p_indices.size() * sizeof(int32_t));
-		{
-			uint8_t *w = index_buffer.ptrw();
-			memcpy(w, p_indices.ptr(), sizeof(int32_t) * p_indices.size());
+		uint32_t index_size = p_indices.size() * sizeof(int32_t);
+		if (!_polygon_arena_allocate(polygon_buffers.index_arena, index_size, pb.index_data)) {
+			polygon_buffers.vertex_arena.free(pb.vertices, frame);
+			RD::get_singleton()->free(pb.vertex_array);
+			ERR_FAIL_V(0);
 		}
-		pb.index_buffer = RD::get_singleton()->index_buffer_create(p_indices.size(), RD::INDEX_BUFFER_FORMAT_UINT32, index_buffer);
-		pb.indices = RD::get_singleton()->index_array_create(pb.index_buffer, 0, p_indices.size());
+		RID index_buffer = polygon_buffers.index_arena.pages[pb.index_data.page].buffer;
+		RD::get_singleton()->buffer_update(index_buffer, pb.index_data.offset, index_size, p_indices.ptr());
+		pb.indices = RD::get_singleton()->index_array_create(index_buffer, pb.index_data.offset / sizeof(int32_t), p_indices.size());
 	}
 
 	pb.vertex_format_id = vertex_id;
@@ -333,15 +481,14 @@ void RendererCanvasRenderRD::free_polygon(PolygonID p_polygon) {
 
 	PolygonBuffers &pb = *pb_ptr;
 
+	uint64_t frame = RSG::rasterizer->get_frame_number();
 	if (pb.indices.is_valid()) {
 		RD::get_singleton()->free(pb.indices);
-	}
-	if (pb.index_buffer.is_valid()) {
-		RD::get_singleton()->free(pb.index_buffer);
+		polygon_buffers.index_arena.free(pb.index_data, frame);
 	}
 
 	RD::get_singleton()->free(pb.vertex_array);
-	RD::get_singleton()->free(pb.vertex_buffer);
+	polygon_buffers.vertex_arena.free(pb.vertices, frame);
 
 	polygon_buffers.polygons.erase(p_polygon);
 }
@@ -398,7 +545,116 @@ void RendererCanvasRenderRD::_bind_canvas_texture(RD::DrawListID p_draw_list, RI
 	r_last_texture = p_texture;
 }
 
-void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_render_target, const Item *p_item, RD::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, Light *p_lights, PipelineVariants *p_pipeline_variants, bool &r_sdf_used) {
+bool RendererCanvasRenderRD::_is_rect_batchable(const Item::CommandRect *p_rect) {
+	// MSDF and LCD rects need their own push constant data and blend constants, UV clipping reads the source rect in the fragment shader.
+	return !(p_rect->flags & (CANVAS_RECT_MSDF | CANVAS_RECT_LCD | CANVAS_RECT_CLIP_UV));
+}
+
+void RendererCanvasRenderRD::rect_batch_fill_instances(const Item *const *p_items, int p_item_count, const Transform2D &p_canvas_transform_inverse, double p_time, uint32_t p_capacity, LocalVector<BatchInstanceData> &r_instances) {
+	// Walks the commands in the same order as _render_item(), skipping the same animation slices.
+	r_instances.clear();
+
+	for (int i = 0; i < p_item_count; i++) {
+		const Item *ci = p_items[i];
+
+		Transform2D base_transform = p_canvas_transform_inverse * ci->final_transform;
+		Transform2D draw_transform;
+		Color base_color = ci->final_modulate;
+		bool skipping = false;
+
+		const Item::Command *c = ci->commands;
+		while (c) {
+			if (c->type == Item::Command::TYPE_ANIMATION_SLICE) {
+				const Item::CommandAnimationSlice *as = static_cast<const Item::CommandAnimationSlice *>(c);
+				double local_time = Math::fposmod(p_time - as->offset, as->animation_length);
+				skipping = !(local_time >= as->slice_begin && local_time < as->slice_end);
+			} else if (!skipping && c->type == Item::Command::TYPE_TRANSFORM) {
+				draw_transform = static_cast<const Item::CommandTransform *>(c)->xform;
+			} else if (!skipping && c->type == Item::Command::TYPE_RECT) {
+				const Item::CommandRect *rect = static_cast<const Item::CommandRect *>(c);
+
+				if (_is_rect_batchable(rect)) {
+					if (r_instances.size() == p_capacity) {
+						return;
+					}
+
+					Rect2 src_rect(0, 0, 1, 1);
+					Rect2 dst_rect = rect->rect.abs();
+					uint32_t instance_flags = 0;
+
+					if (rect->texture != RID()) {
+						if (rect->flags & CANVAS_RECT_REGION) {
+							// The texture size is only known once it is bound, the shader converts to UV.
+							src_rect = rect->source;
+							instance_flags |= BATCH_INSTANCE_FLAGS_REGION_IN_PIXELS;
+						}
+						if (rect->flags & CANVAS_RECT_FLIP_H) {
+							src_rect.size.x *= -1;
+						}
+						if (rect->flags & CANVAS_RECT_FLIP_V) {
+							src_rect.size.y *= -1;
+						}
+					}
+
+					BatchInstanceData instance;
+					_update_transform_2d_to_mat2x3(base_transform * draw_transform, instance.world);
+					instance.flags = instance_flags;
+					instance.pad = 0;
+
+					instance.modulation[0] = rect->modulate.r * base_color.r;
+					instance.modulation[1] = rect->modulate.g * base_color.g;
+					instance.modulation[2] = rect->modulate.b * base_color.b;
+					instance.modulation[3] = rect->modulate.a * base_color.a;
+
+					instance.dst_rect[0] = dst_rect.position.x;
+					instance.dst_rect[1] = dst_rect.position.y;
+					instance.dst_rect[2] = dst_rect.size.width;
+					instance.dst_rect[3] = dst_rect.size.height;
+
+					instance.src_rect[0] = src_rect.position.x;
+					instance.src_rect[1] = src_rect.position.y;
+					instance.src_rect[2] = src_rect.size.width;
+					instance.src_rect[3] = src_rect.size.height;
+
+					r_instances.push_back(instance);
+				}
+			}
+
+			c = c->next;
+		}
+	}
+}
+
+uint32_t RendererCanvasRenderRD::rect_batch_get_slot(const Item::CommandRect *p_rect, uint32_t &r_cursor, uint32_t p_instance_count) {
+	if (!_is_rect_batchable(p_rect)) {
+		return UINT32_MAX;
+	}
+
+	// Overflowing rects still take a cursor position, so the ones after them don't shift.
+	uint32_t slot = r_cursor++;
+	return slot < p_instance_count ? slot : UINT32_MAX;
+}
+
+bool RendererCanvasRenderRD::rect_batch_can_join(const RectBatch &p_batch, const RectBatch &p_rect) {
+	return p_batch.count > 0 && p_batch.start + p_batch.count == p_rect.start &&
+			p_batch.material == p_rect.material && p_batch.clip == p_rect.clip &&
+			p_batch.pipeline == p_rect.pipeline && p_batch.texture == p_rect.texture &&
+			p_batch.filter == p_rect.filter && p_batch.repeat == p_rect.repeat && p_batch.flags == p_rect.flags &&
+			memcmp(p_batch.lights, p_rect.lights, sizeof(p_batch.lights)) == 0 &&
+			memcmp(p_batch.basis, p_rect.basis, sizeof(p_batch.basis)) == 0;
+}
+
+void RendererCanvasRenderRD::_flush_rect_batch(RD::DrawListID p_draw_list) {
+	if (rect_batch.count == 0) {
+		return;
+	}
+
+	RD::get_singleton()->draw_list_draw(p_draw_list, true, rect_batch.count);
+	render_info.batches_in_frame++;
+	rect_batch.count = 0;
+}
+
+void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_render_target, const Item *p_item, RD::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, Light *p_lights, PipelineVariants *p_pipeline_variants, RID p_material, bool &r_sdf_used) {
 	//create an empty push constant
 	RendererRD::TextureStorage *texture_storage = RendererRD::TextureStorage::get_singleton();
 	RendererRD::MeshStorage *mesh_storage = RendererRD::MeshStorage::get_singleton();
@@ -432,8 +688,8 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 	push_constant.color_texture_pixel_size[0] = 0;
 	push_constant.color_texture_pixel_size[1] = 0;
 
-	push_constant.pad[0] = 0;
-	push_constant.pad[1] = 0;
+	push_constant.batch_offset = 0;
+	push_constant.pad = 0;
 
 	push_constant.lights[0] = 0;
 	push_constant.lights[1] = 0;
@@ -445,7 +701,12 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 	uint16_t light_count = 0;
 	PipelineLightMode light_mode;
 
-	{
+	if (state.light_tiles_active) {
+		// The shader finds the lights in its screen tile and filters them by mask and z itself.
+		push_constant.lights[0] = p_item->light_mask;
+		push_constant.lights[1] = uint32_t(p_item->z_final);
+		base_flags |= FLAGS_USE_LIGHT_TILES;
+	} else {
 		Light *light = p_lights;
 
 		while (light) {
@@ -465,7 +726,7 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 		base_flags |= light_count << FLAGS_LIGHT_COUNT_SHIFT;
 	}
 
-	light_mode = (light_count > 0 || using_directional_lights) ? PIPELINE_LIGHT_MODE_ENABLED : PIPELINE_LIGHT_MODE_DISABLED;
+	light_mode = (light_count > 0 || state.light_tiles_active || using_directional_lights) ? PIPELINE_LIGHT_MODE_ENABLED : PIPELINE_LIGHT_MODE_DISABLED;
 
 	PipelineVariants *pipeline_variants = p_pipeline_variants;
 
@@ -485,6 +746,11 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 
 		push_constant.flags = base_flags | (push_constant.flags & (FLAGS_DEFAULT_NORMAL_MAP_USED | FLAGS_DEFAULT_SPECULAR_MAP_USED)); //reset on each command for sanity, keep canvastexture binding config
 
+		if (c->type != Item::Command::TYPE_RECT && c->type != Item::Command::TYPE_TRANSFORM && c->type != Item::Command::TYPE_ANIMATION_SLICE) {
+			// Anything else changes draw state, so a pending batch must be drawn first.
+			_flush_rect_batch(p_draw_list);
+		}
+
 		switch (c->type) {
 			case Item::Command::TYPE_RECT: {
 				const Item::CommandRect *rect = static_cast<const Item::CommandRect *>(c);
@@ -493,6 +759,64 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 					current_repeat = RenderingServer::CanvasItemTextureRepeat::CANVAS_ITEM_TEXTURE_REPEAT_ENABLED;
 				}
 
+				uint32_t batch_slot = rect_batch_get_slot(rect, state.batch_instance_cursor, state.batch_instances.size());
+
+				if (batch_slot != UINT32_MAX) {
+					// Per-instance data was uploaded by rect_batch_fill_instances(), only state shared by the whole batch goes here.
+					uint32_t flags = (push_constant.flags & ~(FLAGS_DEFAULT_NORMAL_MAP_USED | FLAGS_DEFAULT_SPECULAR_MAP_USED)) | FLAGS_BATCHED_RECT;
+					if (rect->texture != RID()) {
+						if (rect->flags & CANVAS_RECT_FLIP_H) {
+							flags |= FLAGS_FLIP_H;
+						}
+						if (rect->flags & CANVAS_RECT_FLIP_V) {
+							flags |= FLAGS_FLIP_V;
+						}
+						if (rect->flags & CANVAS_RECT_TRANSPOSE) {
+							flags |= FLAGS_TRANSPOSE_RECT;
+						}
+					}
+
+					const float *world = state.batch_instances[batch_slot].world;
+
+					RectBatch batch;
+					batch.material = p_material;
+					batch.clip = current_clip;
+					batch.pipeline = pipeline_variants->variants[light_mode][PIPELINE_VARIANT_QUAD].get_render_pipeline(RD::INVALID_ID, p_framebuffer_format);
+					batch.texture = rect->texture != RID() ? rect->texture : default_canvas_texture;
+					batch.filter = current_filter;
+					batch.repeat = current_repeat;
+					batch.flags = flags;
+					memcpy(batch.lights, push_constant.lights, sizeof(batch.lights));
+					if (light_mode == PIPELINE_LIGHT_MODE_ENABLED) {
+						// Normal maps are rotated by the world basis in the push constant, so lit rects only batch with rects of the same basis.
+						memcpy(batch.basis, world, sizeof(batch.basis));
+					}
+					batch.start = batch_slot;
+					batch.count = 1;
+
+					if (rect_batch_can_join(rect_batch, batch)) {
+						rect_batch.count++;
+						break;
+					}
+
+					_flush_rect_batch(p_draw_list);
+
+					RD::get_singleton()->draw_list_bind_render_pipeline(p_draw_list, batch.pipeline);
+					_bind_canvas_texture(p_draw_list, rect->texture, current_filter, current_repeat, last_texture, push_constant, texpixel_size);
+
+					push_constant.flags = flags | (push_constant.flags & (FLAGS_DEFAULT_NORMAL_MAP_USED | FLAGS_DEFAULT_SPECULAR_MAP_USED));
+					push_constant.batch_offset = batch_slot;
+					memcpy(push_constant.world, world, sizeof(push_constant.world));
+
+					RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
+					RD::get_singleton()->draw_list_bind_index_array(p_draw_list, shader.quad_index_array);
+
+					rect_batch = batch;
+					break;
+				}
+
+				_flush_rect_batch(p_draw_list);
+
 				//bind pipeline
 				if (rect->flags & CANVAS_RECT_LCD) {
 					RID pipeline = pipeline_variants->variants[light_mode][PIPELINE_VARIANT_QUAD_LCD_BLEND].get_render_pipeline(RD::INVALID_ID, p_framebuffer_format);
@@ -584,6 +908,7 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 				RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 				RD::get_singleton()->draw_list_bind_index_array(p_draw_list, shader.quad_index_array);
 				RD::get_singleton()->draw_list_draw(p_draw_list, true);
+				render_info.batches_in_frame++;
 
 			} break;
 
@@ -648,6 +973,7 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 				RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 				RD::get_singleton()->draw_list_bind_index_array(p_draw_list, shader.quad_index_array);
 				RD::get_singleton()->draw_list_draw(p_draw_list, true);
+				render_info.batches_in_frame++;
 
 				// Restore if overridden.
 				push_constant.color_texture_pixel_size[0] = texpixel_size.x;
@@ -693,6 +1019,7 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 					RD::get_singleton()->draw_list_bind_index_array(p_draw_list, pb->indices);
 				}
 				RD::get_singleton()->draw_list_draw(p_draw_list, pb->indices.is_valid());
+				render_info.batches_in_frame++;
 
 			} break;
 			case Item::Command::TYPE_PRIMITIVE: {
@@ -723,6 +1050,7 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 				}
 				RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 				RD::get_singleton()->draw_list_draw(p_draw_list, true);
+				render_info.batches_in_frame++;
 
 				if (primitive->point_count == 4) {
 					for (uint32_t j = 1; j < 3; j++) {
@@ -738,6 +1066,7 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 
 					RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 					RD::get_singleton()->draw_list_draw(p_draw_list, true);
+					render_info.batches_in_frame++;
 				}
 
 			} break;
@@ -787,6 +1116,9 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 					if (mesh_storage->multimesh_uses_custom_data(multimesh)) {
 						push_constant.flags |= FLAGS_INSTANCING_HAS_CUSTOM_DATA;
 					}
+					if (mm->sprite_batch) {
+						push_constant.flags |= FLAGS_INSTANCING_CUSTOM_IS_REGION;
+					}
 				} else if (c->type == Item::Command::TYPE_PARTICLES) {
 					const Item::CommandParticles *pt = static_cast<const Item::CommandParticles *>(c);
 					ERR_BREAK(particles_storage->particles_get_mode(pt->particles) != RS::PARTICLES_MODE_2D);
@@ -890,6 +1222,7 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 					RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 
 					RD::get_singleton()->draw_list_draw(p_draw_list, index_array.is_valid(), instance_count);
+					render_info.batches_in_frame++;
 				}
 
 				for (int j = 0; j < 6; j++) {
@@ -1040,6 +1373,22 @@ RID RendererCanvasRenderRD::_create_base_uniform_set(RID p_to_render_target, boo
 		uniforms.push_back(u);
 	}
 
+	{
+		RD::Uniform u;
+		u.uniform_type = RD::UNIFORM_TYPE_STORAGE_BUFFER;
+		u.binding = 10;
+		u.append_id(state.batch_instance_buffer);
+		uniforms.push_back(u);
+	}
+
+	{
+		RD::Uniform u;
+		u.uniform_type = RD::UNIFORM_TYPE_STORAGE_BUFFER;
+		u.binding = 11;
+		u.append_id(state.light_tile_buffer);
+		uniforms.push_back(u);
+	}
+
 	RID uniform_set = RD::get_singleton()->uniform_set_create(uniforms, shader.default_version_rd_shader, BASE_UNIFORM_SET);
 	if (p_backbuffer) {
 		texture_storage->render_target_set_backbuffer_uniform_set(p_to_render_target, uniform_set);
@@ -1084,6 +1433,14 @@ void RendererCanvasRenderRD::_render_items(RID p_to_render_target, int p_item_co
 
 	RD::FramebufferFormatID fb_format = RD::get_singleton()->framebuffer_get_format(framebuffer);
 
+	// Buffers can't be updated while a draw list is open, so batched rect data is uploaded up front.
+	rect_batch_fill_instances(items, p_item_count, canvas_transform_inverse, RendererCompositorRD::get_singleton()->get_total_time(), state.batch_instance_capacity, state.batch_instances);
+	state.batch_instance_cursor = 0;
+	if (state.batch_instances.size()) {
+		RD::get_singleton()->buffer_update(state.batch_instance_buffer, 0, state.batch_instances.size() * sizeof(BatchInstanceData), state.batch_instances.ptr());
+	}
+	rect_batch.count = 0;
+
 	RD::DrawListID draw_list = RD::get_singleton()->draw_list_begin(framebuffer, clear ? RD::INITIAL_ACTION_CLEAR : RD::INITIAL_ACTION_KEEP, RD::FINAL_ACTION_READ, RD::INITIAL_ACTION_KEEP, RD::FINAL_ACTION_DISCARD, clear_colors);
 
 	RD::get_singleton()->draw_list_bind_uniform_set(draw_list, fb_uniform_set, BASE_UNIFORM_SET);
@@ -1097,6 +1454,7 @@ void RendererCanvasRenderRD::_render_items(RID p_to_render_target, int p_item_co
 		Item *ci = items[i];
 
 		if (current_clip != ci->final_clip_owner) {
+			_flush_rect_batch(draw_list);
 			current_clip = ci->final_clip_owner;
 
 			//setup clip
@@ -1125,6 +1483,8 @@ void RendererCanvasRenderRD::_render_items(RID p_to_render_target, int p_item_co
 		}
 
 		if (material != prev_material) {
+			_flush_rect_batch(draw_list);
+
 			CanvasMaterialData *material_data = nullptr;
 			if (material.is_valid()) {
 				material_data = static_cast<CanvasMaterialData *>(material_storage->material_get_data(material, RendererRD::MaterialStorage::SHADER_TYPE_2D));
@@ -1146,11 +1506,14 @@ void RendererCanvasRenderRD::_render_items(RID p_to_render_target, int p_item_co
 			}
 		}
 
-		_render_item(draw_list, p_to_render_target, ci, fb_format, canvas_transform_inverse, current_clip, p_lights, pipeline_variants, r_sdf_used);
+		_render_item(draw_list, p_to_render_target, ci, fb_format, canvas_transform_inverse, current_clip, p_lights, pipeline_variants, material, r_sdf_used);
+		render_info.items_in_frame++;
 
 		prev_material = material;
 	}
 
+	_flush_rect_batch(draw_list);
+
 	RD::get_singleton()->draw_list_end();
 }
 
@@ -1220,6 +1583,11 @@ void RendererCanvasRenderRD::canvas_render_items(RID p_to_render_target, Item *p
 				state.light_uniforms[index].flags |= LIGHT_FLAGS_HAS_SHADOW;
 			}
 
+			state.light_uniforms[index].item_mask = 0;
+			state.light_uniforms[index].z_min = 0;
+			state.light_uniforms[index].z_max = 0;
+			state.light_uniforms[index].pad = 0;
+
 			l->render_index_cache = index;
 
 			index++;
@@ -1296,6 +1664,11 @@ void RendererCanvasRenderRD::canvas_render_items(RID p_to_render_target, Item *p
 				state.light_uniforms[index].atlas_rect[3] = 0;
 			}
 
+			state.light_uniforms[index].item_mask = l->item_mask;
+			state.light_uniforms[index].z_min = l->z_min;
+			state.light_uniforms[index].z_max = l->z_max;
+			state.light_uniforms[index].pad = 0;
+
 			l->render_index_cache = index;
 
 			index++;
@@ -1309,6 +1682,11 @@ void RendererCanvasRenderRD::canvas_render_items(RID p_to_render_target, Item *p
 		RD::get_singleton()->buffer_update(state.lights_uniform_buffer, 0, sizeof(LightUniform) * light_count, &state.light_uniforms[0]);
 	}
 
+	state.light_tiles_active = false;
+	if (state.light_tiles_enabled && light_count > directional_light_count) {
+		_update_light_tiles(p_light_list, texture_storage->render_target_get_size(p_to_render_target));
+	}
+
 	{
 		//update canvas state uniform buffer
 		State::Buffer state_buffer;
@@ -1340,6 +1718,8 @@ void RendererCanvasRenderRD::canvas_render_items(RID p_to_render_target, Item *p
 		state_buffer.use_pixel_snap = p_snap_2d_vertices_to_pixel;
 
 		state_buffer.directional_light_count = directional_light_count;
+		state_buffer.light_tile_size = state.light_tile_size;
+		state_buffer.light_tile_columns = state.light_tile_columns;
 
 		Vector2 canvas_scale = p_canvas_transform.get_scale();
 
@@ -1608,8 +1988,133 @@ void RendererCanvasRenderRD::_update_shadow_atlas() {
 		}
 
 		state.shadow_fb = RD::get_singleton()->framebuffer_create(fb_textures);
+
+		// New texture, no shadow map can be reused.
+		state.shadow_row_owners.resize(state.max_lights_per_render);
+		for (RID &owner : state.shadow_row_owners) {
+			owner = RID();
+		}
 	}
 }
+
+bool RendererCanvasRenderRD::shadow_cache_update(ShadowCache &p_cache, bool p_row_owned, float p_near, float p_far, const LocalVector<ShadowCaster> &p_casters) {
+	bool valid = p_cache.valid && p_row_owned && p_cache.near == p_near && p_cache.far == p_far && p_cache.casters.size() == p_casters.size();
+
+	// Compared with what was last rendered rather than last frame, so slow movement adds up.
+	for (uint32_t i = 0; i < p_casters.size() && valid; i++) {
+		const ShadowCaster &cached = p_cache.casters[i];
+		valid = cached.occluder == p_casters[i].occluder && cached.version == p_casters[i].version && cached.xform.is_equal_approx(p_casters[i].xform);
+	}
+
+	if (valid) {
+		return true;
+	}
+
+	p_cache.valid = true;
+	p_cache.near = p_near;
+	p_cache.far = p_far;
+	p_cache.casters = p_casters;
+	return false;
+}
+
+bool RendererCanvasRenderRD::_light_shadow_cache_update(RID p_rid, CanvasLight *p_light, int p_shadow_index, const Transform2D &p_light_xform, int p_light_mask, float p_near, float p_far, LightOccluderInstance *p_occluders) {
+	if (p_shadow_index < 0 || p_shadow_index >= (int)state.shadow_row_owners.size()) {
+		p_light->shadow_cache.valid = false;
+		return false;
+	}
+
+	LocalVector<ShadowCaster> &casters = state.shadow_casters;
+	casters.clear();
+	for (LightOccluderInstance *instance = p_occluders; instance; instance = instance->next) {
+		OccluderPolygon *co = occluder_polygon_owner.get_or_null(instance->occluder);
+		if (!co || co->index_array.is_null() || !(p_light_mask & instance->light_mask)) {
+			continue;
+		}
+
+		ShadowCaster caster;
+		caster.occluder = instance->occluder;
+		caster.version = co->version;
+		caster.xform = p_light_xform * instance->xform_cache;
+		casters.push_back(caster);
+	}
+
+	// The row may have been overwritten by another light, possibly from another viewport.
+	if (shadow_cache_update(p_light->shadow_cache, state.shadow_row_owners[p_shadow_index] == p_rid, p_near, p_far, casters)) {
+		return true;
+	}
+
+	state.shadow_row_owners[p_shadow_index] = p_rid;
+	return false;
+}
+
+uint32_t RendererCanvasRenderRD::light_tiles_get_size(const Size2i &p_render_target_size, uint32_t &r_columns, uint32_t &r_rows) {
+	uint32_t tile_size = LIGHT_TILE_SIZE_MIN;
+	while (true) {
+		r_columns = (p_render_target_size.width + tile_size - 1) / tile_size;
+		r_rows = (p_render_target_size.height + tile_size - 1) / tile_size;
+		if (r_columns * r_rows <= LIGHT_TILE_MAX_COUNT) {
+			return tile_size;
+		}
+		tile_size *= 2;
+	}
+}
+
+void RendererCanvasRenderRD::light_tiles_add_light(uint32_t *p_tiles, uint32_t p_columns, uint32_t p_rows, uint32_t p_tile_size, const Rect2 &p_rect, uint32_t p_index) {
+	uint32_t from_x = uint32_t(p_rect.position.x) / p_tile_size;
+	uint32_t from_y = uint32_t(p_rect.position.y) / p_tile_size;
+	uint32_t to_x = MIN(p_columns - 1, uint32_t(p_rect.get_end().x) / p_tile_size);
+	uint32_t to_y = MIN(p_rows - 1, uint32_t(p_rect.get_end().y) / p_tile_size);
+
+	for (uint32_t y = from_y; y <= to_y; y++) {
+		for (uint32_t x = from_x; x <= to_x; x++) {
+			uint32_t *tile = p_tiles + (y * p_columns + x) * LIGHT_TILE_STRIDE;
+			uint32_t count = tile[0];
+			if (count == MAX_LIGHTS_PER_TILE) {
+				continue;
+			}
+			tile[1 + (count >> 2)] |= p_index << ((count & 3) * 8);
+			tile[0] = count + 1;
+		}
+	}
+}
+
+void RendererCanvasRenderRD::_update_light_tiles(Light *p_lights, const Size2i &p_render_target_size) {
+	uint32_t columns = 0;
+	uint32_t rows = 0;
+	uint32_t tile_size = light_tiles_get_size(p_render_target_size, columns, rows);
+
+	uint32_t tile_count = columns * rows;
+	if (tile_count == 0) {
+		return;
+	}
+
+	state.light_tile_data.resize(tile_count * LIGHT_TILE_STRIDE);
+	uint32_t *tiles = state.light_tile_data.ptr();
+	memset(tiles, 0, sizeof(uint32_t) * tile_count * LIGHT_TILE_STRIDE);
+
+	Rect2 screen_rect(Point2(), p_render_target_size);
+
+	for (Light *l = p_lights; l; l = l->next_ptr) {
+		if (l->render_index_cache < 0) {
+			continue;
+		}
+
+		// Same bounds as the per item test, in render target pixels.
+		Rect2 light_rect = l->xform_cache.xform(l->rect_cache).intersection(screen_rect);
+		if (!light_rect.has_area()) {
+			continue;
+		}
+
+		light_tiles_add_light(tiles, columns, rows, tile_size, light_rect, l->render_index_cache);
+	}
+
+	RD::get_singleton()->buffer_update(state.light_tile_buffer, 0, sizeof(uint32_t) * tile_count * LIGHT_TILE_STRIDE, tiles);
+
+	state.light_tile_size = tile_size;
+	state.light_tile_columns = columns;
+	state.light_tiles_active = true;
+}
+
 void RendererCanvasRenderRD::light_update_shadow(RID p_rid, int p_shadow_index, const Transform2D &p_light_xform, int p_light_mask, float p_near, float p_far, LightOccluderInstance *p_occluders) {
 	CanvasLight *cl = canvas_light_owner.get_or_null(p_rid);
 	ERR_FAIL_COND(!cl->shadow.enabled);
@@ -1618,6 +2123,12 @@ void RendererCanvasRenderRD::light_update_shadow(RID p_rid, int p_shadow_index,
 
 	cl->shadow.z_far = p_far;
 	cl->shadow.y_offset = float(p_shadow_index * 2 + 1) / float(state.max_lights_per_render * 2);
+
+	if (_light_shadow_cache_update(p_rid, cl, p_shadow_index, p_light_xform, p_light_mask, p_near, p_far, p_occluders)) {
+		render_info.shadow_updates_skipped_in_frame++;
+		return;
+	}
+
 	Vector<Color> cc;
 	cc.push_back(Color(p_far, p_far, p_far, 1.0));
 
@@ -1713,6 +2224,17 @@ void RendererCanvasRenderRD::light_update_directional_shadow(RID p_rid, int p_sh
 
 	to_light_xform.invert();
 
+	Transform2D to_shadow;
+	to_shadow.columns[0].x = 1.0 / -(half_size * 2.0);
+	to_shadow.columns[2].x = 0.5;
+
+	cl->shadow.directional_xform = to_shadow * to_light_xform;
+
+	if (_light_shadow_cache_update(p_rid, cl, p_shadow_index, to_light_xform, p_light_mask, half_size, distance, p_occluders)) {
+		render_info.shadow_updates_skipped_in_frame++;
+		return;
+	}
+
 	Vector<Color> cc;
 	cc.push_back(Color(1, 1, 1, 1));
 
@@ -1758,12 +2280,6 @@ void RendererCanvasRenderRD::light_update_directional_shadow(RID p_rid, int p_sh
 	}
 
 	RD::get_singleton()->draw_list_end();
-
-	Transform2D to_shadow;
-	to_shadow.columns[0].x = 1.0 / -(half_size * 2.0);
-	to_shadow.columns[2].x = 0.5;
-
-	cl->shadow.directional_xform = to_shadow * to_light_xform;
 }
 
 void RendererCanvasRenderRD::render_sdf(RID p_render_target, LightOccluderInstance *p_occluders) {
@@ -1843,6 +2359,8 @@ void RendererCanvasRenderRD::occluder_polygon_set_shape(RID p_occluder, const Ve
 	OccluderPolygon *oc = occluder_polygon_owner.get_or_null(p_occluder);
 	ERR_FAIL_COND(!oc);
 
+	oc->version++;
+
 	Vector<Vector2> lines;
 
 	if (p_points.size()) {
@@ -2014,6 +2532,7 @@ void RendererCanvasRenderRD::occluder_polygon_set_cull_mode(RID p_occluder, RS::
 	OccluderPolygon *oc = occluder_polygon_owner.get_or_null(p_occluder);
 	ERR_FAIL_COND(!oc);
 	oc->cull_mode = p_mode;
+	oc->version++;
 }
 
 void RendererCanvasRenderRD::CanvasShaderData::set_code(const String &p_code) {
@@ -2276,6 +2795,16 @@ void RendererCanvasRenderRD::set_time(double p_time) {
 }
 
 void RendererCanvasRenderRD::update() {
+	// Ranges freed a few frames ago are no longer read by the GPU. This runs every frame, so they
+	// are reused even while nothing is drawn, e.g. when all viewports are hidden.
+	uint64_t frame = RSG::rasterizer->get_frame_number();
+	uint64_t frame_delay = RD::get_singleton()->get_frame_delay();
+	LocalVector<RID> empty_buffers;
+	polygon_buffers.vertex_arena.reclaim(frame, frame_delay, empty_buffers);
+	polygon_buffers.index_arena.reclaim(frame, frame_delay, empty_buffers);
+	for (const RID &buffer : empty_buffers) {
+		RD::get_singleton()->free(buffer);
+	}
 }
 
 RendererCanvasRenderRD::RendererCanvasRenderRD() {
@@ -2440,7 +2969,8 @@ RendererCanvasRenderRD::RendererCanvasRenderRD() {
 		actions.renames["SCREEN_PIXEL_SIZE"] = "canvas_data.screen_pixel_size";
 		actions.renames["FRAGCOORD"] = "gl_FragCoord";
 		actions.renames["POINT_COORD"] = "gl_PointCoord";
-		actions.renames["INSTANCE_ID"] = "gl_InstanceIndex";
+		// Batched rects are drawn as instances, but each of them is a single draw for the shader.
+		actions.renames["INSTANCE_ID"] = "(bool(draw_data.flags & FLAGS_BATCHED_RECT) ? 0 : gl_InstanceIndex)";
 		actions.renames["VERTEX_ID"] = "gl_VertexIndex";
 
 		actions.renames["LIGHT_POSITION"] = "light_position";
@@ -2556,8 +3086,17 @@ RendererCanvasRenderRD::RendererCanvasRenderRD() {
 	{ //bindings
 
 		state.canvas_state_buffer = RD::get_singleton()->uniform_buffer_create(sizeof(State::Buffer));
+
+		state.batch_instance_capacity = MAX(128, int(GLOBAL_GET("rendering/2d/batching/item_buffer_size")));
+		state.batch_instances.reserve(state.batch_instance_capacity);
+		state.batch_instance_buffer = RD::get_singleton()->storage_buffer_create(sizeof(BatchInstanceData) * state.batch_instance_capacity);
 		state.lights_uniform_buffer = RD::get_singleton()->uniform_buffer_create(sizeof(LightUniform) * state.max_lights_per_render);
 
+		// Still bound when tiled light culling is disabled, so keep a single empty tile.
+		state.light_tiles_enabled = GLOBAL_GET("rendering/2d/lights/tiled_culling");
+		uint32_t light_tile_count = state.light_tiles_enabled ? LIGHT_TILE_MAX_COUNT : 1;
+		state.light_tile_buffer = RD::get_singleton()->storage_buffer_create(sizeof(uint32_t) * LIGHT_TILE_STRIDE * light_tile_count);
+
 		RD::SamplerState shadow_sampler_state;
 		shadow_sampler_state.mag_filter = RD::SAMPLER_FILTER_LINEAR;
 		shadow_sampler_state.min_filter = RD::SAMPLER_FILTER_LINEAR;
@@ -2570,6 +3109,7 @@ RendererCanvasRenderRD::RendererCanvasRenderRD() {
 	{
 		//polygon buffers
 		polygon_buffers.last_id = 1;
+		polygon_buffers.index_arena.index_buffers = true;
 	}
 
 	{ // default index buffer
@@ -2746,6 +3286,8 @@ RendererCanvasRenderRD::~RendererCanvasRenderRD() {
 
 		memdelete_arr(state.light_uniforms);
 		RD::get_singleton()->free(state.lights_uniform_buffer);
+		RD::get_singleton()->free(state.batch_instance_buffer);
+		RD::get_singleton()->free(state.light_tile_buffer);
 	}
 
 	//shadow rendering
@@ -2765,6 +3307,14 @@ RendererCanvasRenderRD::~RendererCanvasRenderRD() {
 		RD::get_singleton()->free(shader.quad_index_array);
 		RD::get_singleton()->free(shader.quad_index_buffer);
 		//primitives are erase by dependency
+
+		// Vertex and index arrays still using the pages are freed with them.
+		LocalVector<RID> page_buffers;
+		polygon_buffers.vertex_arena.clear(page_buffers);
+		polygon_buffers.index_arena.clear(page_buffers);
+		for (const RID &buffer : page_buffers) {
+			RD::get_singleton()->free(buffer);
+		}
 	}
 
 	if (state.shadow_fb.is_valid()) {
@@ -31,6 +31,9 @@
 #ifndef RENDERER_CANVAS_RENDER_RD_H
 #define RENDERER_CANVAS_RENDER_RD_H
 
+#include "core/templates/list.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/rb_map.h"
 #include "servers/rendering/renderer_canvas_render.h"
 #include "servers/rendering/renderer_compositor.h"
 #include "servers/rendering/renderer_rd/pipeline_cache_rd.h"
@@ -75,12 +78,16 @@ class RendererCanvasRenderRD : public RendererCanvasRender {
 
 		FLAGS_NINEPACH_DRAW_CENTER = (1 << 12),
 		FLAGS_USING_PARTICLES = (1 << 13),
+		FLAGS_BATCHED_RECT = (1 << 14),
 
 		FLAGS_USE_SKELETON = (1 << 15),
 		FLAGS_NINEPATCH_H_MODE_SHIFT = 16,
 		FLAGS_NINEPATCH_V_MODE_SHIFT = 18,
 		FLAGS_LIGHT_COUNT_SHIFT = 20,
 
+		FLAGS_INSTANCING_CUSTOM_IS_REGION = (1 << 24),
+		FLAGS_USE_LIGHT_TILES = (1 << 25),
+
 		FLAGS_DEFAULT_NORMAL_MAP_USED = (1 << 26),
 		FLAGS_DEFAULT_SPECULAR_MAP_USED = (1 << 27),
 
@@ -214,21 +221,70 @@ class RendererCanvasRenderRD : public RendererCanvasRender {
 		RS::CanvasItemTextureRepeat default_repeat;
 	} default_samplers;
 
+public:
 	/******************/
 	/**** POLYGONS ****/
 	/******************/
 
+	// Polygon vertices and indices are sub-allocated from a few large buffers, so items that are
+	// cleared and redrawn reuse memory instead of creating and freeing buffers every time.
+	// The arena only keeps track of the ranges, the renderer creates and frees the page buffers.
+	enum {
+		POLYGON_ARENA_PAGE_SIZE = 1024 * 1024,
+		POLYGON_ARENA_ALIGNMENT = 16,
+	};
+
+	struct PolygonArena {
+		struct Page {
+			RID buffer; // Null once an empty page is released, its slot is reused by the next page.
+			uint32_t size = 0;
+			RBMap<uint32_t, uint32_t> free_ranges; // Offset to size, touching ranges are merged.
+		};
+
+		struct Allocation {
+			uint32_t page = 0;
+			uint32_t offset = 0;
+			uint32_t size = 0;
+		};
+
+		// The GPU may still read a freed range for a few frames, it is only reused afterwards.
+		struct PendingFrame {
+			uint64_t frame = 0;
+			LocalVector<Allocation> allocations;
+		};
+
+		bool index_buffers = false;
+		LocalVector<Page> pages;
+		List<PendingFrame> pending_frames; // Oldest first.
+
+		void _release(const Allocation &p_allocation);
+
+		static uint32_t get_aligned_size(uint32_t p_size);
+
+		// Fails when no page has room, a page must be added first.
+		bool allocate(uint32_t p_size, Allocation &r_allocation);
+		uint32_t add_page(RID p_buffer, uint32_t p_size);
+		void free(const Allocation &p_allocation, uint64_t p_frame);
+		// Returns ranges freed p_frame_delay frames ago or earlier to their pages. Buffers of the
+		// pages left empty are appended to r_empty_buffers, except one that is kept.
+		void reclaim(uint64_t p_frame, uint64_t p_frame_delay, LocalVector<RID> &r_empty_buffers);
+		void clear(LocalVector<RID> &r_buffers);
+	};
+
+private:
 	struct PolygonBuffers {
 		RD::VertexFormatID vertex_format_id;
-		RID vertex_buffer;
 		RID vertex_array;
-		RID index_buffer;
 		RID indices;
+		PolygonArena::Allocation vertices;
+		PolygonArena::Allocation index_data; // Empty without indices.
 	};
 
 	struct {
 		HashMap<PolygonID, PolygonBuffers> polygons;
 		PolygonID last_id;
+		PolygonArena vertex_arena;
+		PolygonArena index_arena;
 	} polygon_buffers;
 
 	/********************/
@@ -243,10 +299,32 @@ class RendererCanvasRenderRD : public RendererCanvasRender {
 	/**** MATERIALS ****/
 	/*******************/
 
+public:
 	/******************/
 	/**** LIGHTING ****/
 	/******************/
 
+	struct ShadowCaster {
+		RID occluder;
+		uint64_t version = 0;
+		Transform2D xform; // Occluder to light space, as drawn into the shadow map.
+	};
+
+	// What a light's shadow map was last rendered from. Only occluder transforms relative to the
+	// light matter, so moving the camera alone doesn't invalidate point light shadows.
+	struct ShadowCache {
+		bool valid = false;
+		float near = 0.0;
+		float far = 0.0;
+		LocalVector<ShadowCaster> casters;
+	};
+
+	// CPU side of the shadow cache, see _light_shadow_cache_update(). Returns true when the shadow
+	// row still holds this light's map, rendered from the same casters and range. Otherwise the
+	// cache is set to p_casters and the row must be rendered again.
+	static bool shadow_cache_update(ShadowCache &p_cache, bool p_row_owned, float p_near, float p_far, const LocalVector<ShadowCaster> &p_casters);
+
+private:
 	struct CanvasLight {
 		RID texture;
 		struct {
@@ -255,6 +333,8 @@ class RendererCanvasRenderRD : public RendererCanvasRender {
 			float y_offset;
 			Transform2D directional_xform;
 		} shadow;
+
+		ShadowCache shadow_cache;
 	};
 
 	RID_Owner<CanvasLight> canvas_light_owner;
@@ -269,6 +349,7 @@ class RendererCanvasRenderRD : public RendererCanvasRender {
 
 	struct OccluderPolygon {
 		RS::CanvasOccluderPolygonCullMode cull_mode;
+		uint64_t version = 0; // Bumped when the shape or cull mode changes.
 		int line_point_count;
 		RID vertex_buffer;
 		RID vertex_array;
@@ -299,6 +380,11 @@ class RendererCanvasRenderRD : public RendererCanvasRender {
 		float shadow_y_ofs;
 
 		float atlas_rect[4];
+
+		uint32_t item_mask;
+		int32_t z_min;
+		int32_t z_max;
+		uint32_t pad;
 	};
 
 	RID_Owner<OccluderPolygon> occluder_polygon_owner;
@@ -324,6 +410,50 @@ class RendererCanvasRenderRD : public RendererCanvasRender {
 		RD::FramebufferFormatID sdf_framebuffer_format;
 	} shadow_render;
 
+public:
+	/********************/
+	/**** RECT BATCH ****/
+	/********************/
+
+	// Per-instance data of rects drawn through batches, filled for all items before the draw list
+	// starts, see rect_batch_fill_instances().
+	struct BatchInstanceData {
+		float world[6];
+		uint32_t flags;
+		uint32_t pad;
+		float modulation[4];
+		float dst_rect[4];
+		float src_rect[4];
+	};
+
+	enum {
+		BATCH_INSTANCE_FLAGS_REGION_IN_PIXELS = 1,
+	};
+
+	// Consecutive rects sharing material, clip, pipeline, texture, flags and lights are drawn
+	// together as a single instanced quad draw. Lit rects also need the same basis.
+	struct RectBatch {
+		RID material;
+		const Item *clip = nullptr;
+		RID pipeline;
+		RID texture;
+		RS::CanvasItemTextureFilter filter = RS::CANVAS_ITEM_TEXTURE_FILTER_DEFAULT;
+		RS::CanvasItemTextureRepeat repeat = RS::CANVAS_ITEM_TEXTURE_REPEAT_DEFAULT;
+		uint32_t flags = 0;
+		uint32_t lights[4] = {};
+		float basis[4] = {}; // Left at zero for unlit rects.
+		uint32_t start = 0;
+		uint32_t count = 0;
+	};
+
+	// CPU side of rect batching. Instances are written in the order _render_item() walks the
+	// commands, so each batchable rect finds its slot from a running cursor. Rects past
+	// p_capacity get no slot and are drawn one by one.
+	static void rect_batch_fill_instances(const Item *const *p_items, int p_item_count, const Transform2D &p_canvas_transform_inverse, double p_time, uint32_t p_capacity, LocalVector<BatchInstanceData> &r_instances);
+	static uint32_t rect_batch_get_slot(const Item::CommandRect *p_rect, uint32_t &r_cursor, uint32_t p_instance_count);
+	static bool rect_batch_can_join(const RectBatch &p_batch, const RectBatch &p_rect);
+
+private:
 	/***************/
 	/**** STATE ****/
 	/***************/
@@ -348,8 +478,8 @@ class RendererCanvasRenderRD : public RendererCanvasRender {
 
 			uint32_t directional_light_count;
 			float tex_to_sdf;
-			uint32_t pad1;
-			uint32_t pad2;
+			uint32_t light_tile_size;
+			uint32_t light_tile_columns;
 		};
 
 		LightUniform *light_uniforms = nullptr;
@@ -361,6 +491,8 @@ class RendererCanvasRenderRD : public RendererCanvasRender {
 		RID shadow_depth_texture;
 		RID shadow_fb;
 		int shadow_texture_size = 2048;
+		LocalVector<RID> shadow_row_owners; // Light whose shadow map is in each row of the shadow texture.
+		LocalVector<ShadowCaster> shadow_casters; // Reused by _light_shadow_cache_update().
 
 		RID default_transforms_uniform_set;
 
@@ -369,8 +501,25 @@ class RendererCanvasRenderRD : public RendererCanvasRender {
 
 		double time;
 
+		// Per-instance data of rects drawn through batches, see rect_batch_fill_instances().
+		RID batch_instance_buffer;
+		LocalVector<BatchInstanceData> batch_instances;
+		uint32_t batch_instance_capacity = 0;
+		uint32_t batch_instance_cursor = 0;
+
+		// Positional lights binned into screen tiles, see _update_light_tiles().
+		bool light_tiles_enabled = false;
+		bool light_tiles_active = false;
+		RID light_tile_buffer;
+		LocalVector<uint32_t> light_tile_data;
+		uint32_t light_tile_size = LIGHT_TILE_SIZE_MIN;
+		uint32_t light_tile_columns = 0;
+
 	} state;
 
+	// The batch currently being accumulated.
+	RectBatch rect_batch;
+
 	struct PushConstant {
 		float world[6];
 		uint32_t flags;
@@ -385,7 +534,8 @@ class RendererCanvasRenderRD : public RendererCanvasRender {
 				};
 				float dst_rect[4];
 				float src_rect[4];
-				float pad[2];
+				uint32_t batch_offset;
+				uint32_t pad;
 			};
 			//primitive
 			struct {
@@ -414,18 +564,37 @@ class RendererCanvasRenderRD : public RendererCanvasRender {
 	RID _create_base_uniform_set(RID p_to_render_target, bool p_backbuffer);
 
 	inline void _bind_canvas_texture(RD::DrawListID p_draw_list, RID p_texture, RS::CanvasItemTextureFilter p_base_filter, RS::CanvasItemTextureRepeat p_base_repeat, RID &r_last_texture, PushConstant &push_constant, Size2 &r_texpixel_size); //recursive, so regular inline used instead.
-	void _render_item(RenderingDevice::DrawListID p_draw_list, RID p_render_target, const Item *p_item, RenderingDevice::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, Light *p_lights, PipelineVariants *p_pipeline_variants, bool &r_sdf_used);
+	_FORCE_INLINE_ static bool _is_rect_batchable(const Item::CommandRect *p_rect);
+	void _flush_rect_batch(RenderingDevice::DrawListID p_draw_list);
+	void _render_item(RenderingDevice::DrawListID p_draw_list, RID p_render_target, const Item *p_item, RenderingDevice::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, Light *p_lights, PipelineVariants *p_pipeline_variants, RID p_material, bool &r_sdf_used);
 	void _render_items(RID p_to_render_target, int p_item_count, const Transform2D &p_canvas_transform_inverse, Light *p_lights, bool &r_sdf_used, bool p_to_backbuffer = false);
 
 	_FORCE_INLINE_ void _update_transform_2d_to_mat2x4(const Transform2D &p_transform, float *p_mat2x4);
-	_FORCE_INLINE_ void _update_transform_2d_to_mat2x3(const Transform2D &p_transform, float *p_mat2x3);
+	_FORCE_INLINE_ static void _update_transform_2d_to_mat2x3(const Transform2D &p_transform, float *p_mat2x3);
 
 	_FORCE_INLINE_ void _update_transform_2d_to_mat4(const Transform2D &p_transform, float *p_mat4);
 	_FORCE_INLINE_ void _update_transform_to_mat4(const Transform3D &p_transform, float *p_mat4);
 
+	bool _polygon_arena_allocate(PolygonArena &p_arena, uint32_t p_size, PolygonArena::Allocation &r_allocation);
+
 	void _update_shadow_atlas();
+	void _update_light_tiles(Light *p_lights, const Size2i &p_render_target_size);
+	bool _light_shadow_cache_update(RID p_rid, CanvasLight *p_light, int p_shadow_index, const Transform2D &p_light_xform, int p_light_mask, float p_near, float p_far, LightOccluderInstance *p_occluders);
 
 public:
+	// Tiled light culling, must match the shader. Tiles start at LIGHT_TILE_SIZE_MIN pixels and
+	// grow (in powers of 2) until the render target fits in LIGHT_TILE_MAX_COUNT tiles.
+	enum {
+		MAX_LIGHTS_PER_TILE = 32,
+		LIGHT_TILE_STRIDE = 1 + MAX_LIGHTS_PER_TILE / 4,
+		LIGHT_TILE_SIZE_MIN = 32,
+		LIGHT_TILE_MAX_COUNT = 8192,
+	};
+
+	// CPU side of the tiled light culling, _update_light_tiles() uploads the result.
+	static uint32_t light_tiles_get_size(const Size2i &p_render_target_size, uint32_t &r_columns, uint32_t &r_rows);
+	static void light_tiles_add_light(uint32_t *p_tiles, uint32_t p_columns, uint32_t p_rows, uint32_t p_tile_size, const Rect2 &p_rect, uint32_t p_index);
+
 	PolygonID request_polygon(const Vector<int> &p_indices, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs = Vector<Point2>(), const Vector<int> &p_bones = Vector<int>(), const Vector<float> &p_weights = Vector<float>());
 	void free_polygon(PolygonID p_polygon);
 
@@ -38,6 +38,7 @@ layout(set = 1, binding = 0, std140) uniform MaterialUniforms{
 
 void main() {
 	vec4 instance_custom = vec4(0.0);
+	mat4 model_matrix = mat4(vec4(draw_data.world_x, 0.0, 0.0), vec4(draw_data.world_y, 0.0, 0.0), vec4(0.0, 0.0, 1.0, 0.0), vec4(draw_data.world_ofs, 0.0, 1.0));
 #ifdef USE_PRIMITIVE
 
 	//weird bug,
@@ -75,15 +76,27 @@ void main() {
 	vec2 vertex_base_arr[4] = vec2[](vec2(0.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 1.0), vec2(1.0, 0.0));
 	vec2 vertex_base = vertex_base_arr[gl_VertexIndex];
 
-	vec2 uv = draw_data.src_rect.xy + abs(draw_data.src_rect.zw) * ((draw_data.flags & FLAGS_TRANSPOSE_RECT) != 0 ? vertex_base.yx : vertex_base.xy);
+	vec4 src_rect = draw_data.src_rect;
+	vec4 dst_rect = draw_data.dst_rect;
 	vec4 color = draw_data.modulation;
-	vec2 vertex = draw_data.dst_rect.xy + abs(draw_data.dst_rect.zw) * mix(vertex_base, vec2(1.0, 1.0) - vertex_base, lessThan(draw_data.src_rect.zw, vec2(0.0, 0.0)));
+
+	if (bool(draw_data.flags & FLAGS_BATCHED_RECT)) {
+		BatchInstance instance = batch_instances.data[draw_data.batch_offset + gl_InstanceIndex];
+		src_rect = instance.src_rect;
+		if (bool(instance.flags & BATCH_INSTANCE_FLAGS_REGION_IN_PIXELS)) {
+			src_rect *= draw_data.color_texture_pixel_size.xyxy;
+		}
+		dst_rect = instance.dst_rect;
+		color = instance.modulation;
+		model_matrix = mat4(vec4(instance.world_x, 0.0, 0.0), vec4(instance.world_y, 0.0, 0.0), vec4(0.0, 0.0, 1.0, 0.0), vec4(instance.world_ofs, 0.0, 1.0));
+	}
+
+	vec2 uv = src_rect.xy + abs(src_rect.zw) * ((draw_data.flags & FLAGS_TRANSPOSE_RECT) != 0 ? vertex_base.yx : vertex_base.xy);
+	vec2 vertex = dst_rect.xy + abs(dst_rect.zw) * mix(vertex_base, vec2(1.0, 1.0) - vertex_base, lessThan(src_rect.zw, vec2(0.0, 0.0)));
 	uvec4 bones = uvec4(0, 0, 0, 0);
 
 #endif
 
-	mat4 model_matrix = mat4(vec4(draw_data.world_x, 0.0, 0.0), vec4(draw_data.world_y, 0.0, 0.0), vec4(0.0, 0.0, 1.0, 0.0), vec4(draw_data.world_ofs, 0.0, 1.0));
-
 #define FLAGS_INSTANCING_MASK 0x7F
 #define FLAGS_INSTANCING_HAS_COLORS (1 << 7)
 #define FLAGS_INSTANCING_HAS_CUSTOM_DATA (1 << 8)
@@ -155,6 +168,11 @@ void main() {
 				instance_custom = transforms.data[offset];
 			}
 
+			if (bool(draw_data.flags & FLAGS_INSTANCING_CUSTOM_IS_REGION)) {
+				// Sprite batch, custom data is the source region in pixels.
+				uv = (instance_custom.xy + uv * instance_custom.zw) * draw_data.color_texture_pixel_size;
+			}
+
 			matrix = transpose(matrix);
 			model_matrix = model_matrix * matrix;
 		}
@@ -490,6 +508,14 @@ void main() {
 	}
 
 	uint light_count = (draw_data.flags >> FLAGS_LIGHT_COUNT_SHIFT) & 0xF; //max 16 lights
+	bool use_light_tiles = bool(draw_data.flags & FLAGS_USE_LIGHT_TILES);
+	uint light_tile_base = 0;
+	if (use_light_tiles) {
+		// The item's light mask and z index are passed instead of a light list.
+		uvec2 tile = uvec2(gl_FragCoord.xy) / canvas_data.light_tile_size;
+		light_tile_base = (tile.y * canvas_data.light_tile_columns + tile.x) * LIGHT_TILE_STRIDE;
+		light_count = min(light_tiles.data[light_tile_base], MAX_LIGHTS_PER_TILE);
+	}
 	bool using_light = light_count > 0 || canvas_data.directional_light_count > 0;
 
 	vec3 normal;
@@ -618,13 +644,25 @@ void main() {
 
 	// Positional Lights
 
-	for (uint i = 0; i < MAX_LIGHTS_PER_ITEM; i++) {
+	for (uint i = 0; i < MAX_LIGHTS_PER_TILE; i++) {
 		if (i >= light_count) {
 			break;
 		}
-		uint light_base = draw_data.lights[i >> 2];
-		light_base >>= (i & 3) * 8;
-		light_base &= 0xFF;
+		uint light_base;
+		if (use_light_tiles) {
+			light_base = light_tiles.data[light_tile_base + 1 + (i >> 2)];
+			light_base >>= (i & 3) * 8;
+			light_base &= 0xFF;
+
+			int z = int(draw_data.lights[1]);
+			if (!bool(light_array.data[light_base].item_mask & draw_data.lights[0]) || z < light_array.data[light_base].z_min || z > light_array.data[light_base].z_max) {
+				continue;
+			}
+		} else {
+			light_base = draw_data.lights[i >> 2];
+			light_base >>= (i & 3) * 8;
+			light_base &= 0xFF;
+		}
 
 		vec2 tex_uv = (vec4(vertex, 0.0, 1.0) * mat4(light_array.data[light_base].texture_matrix[0], light_array.data[light_base].texture_matrix[1], vec4(0.0, 0.0, 1.0, 0.0), vec4(0.0, 0.0, 0.0, 1.0))).xy; //multiply inverse given its transposed. Optimizer removes useless operations.
 		vec2 tex_uv_atlas = tex_uv * light_array.data[light_base].atlas_rect.zw + light_array.data[light_base].atlas_rect.xy;
@@ -1,6 +1,11 @@
 
 #define MAX_LIGHTS_PER_ITEM 16
 
+// With tiled light culling, lights are binned per screen tile: a count followed by
+// the light indices packed 4 per uint.
+#define MAX_LIGHTS_PER_TILE 32
+#define LIGHT_TILE_STRIDE (1 + MAX_LIGHTS_PER_TILE / 4)
+
 #define M_PI 3.14159265359
 
 #define SDF_MAX_LENGTH 16384.0
@@ -15,12 +20,16 @@
 #define FLAGS_USING_LIGHT_MASK (1 << 11)
 #define FLAGS_NINEPACH_DRAW_CENTER (1 << 12)
 #define FLAGS_USING_PARTICLES (1 << 13)
+#define FLAGS_BATCHED_RECT (1 << 14)
 
 #define FLAGS_NINEPATCH_H_MODE_SHIFT 16
 #define FLAGS_NINEPATCH_V_MODE_SHIFT 18
 
 #define FLAGS_LIGHT_COUNT_SHIFT 20
 
+#define FLAGS_INSTANCING_CUSTOM_IS_REGION (1 << 24)
+#define FLAGS_USE_LIGHT_TILES (1 << 25)
+
 #define FLAGS_DEFAULT_NORMAL_MAP_USED (1 << 26)
 #define FLAGS_DEFAULT_SPECULAR_MAP_USED (1 << 27)
 
@@ -60,7 +69,8 @@ layout(push_constant, std430) uniform DrawData {
 	vec4 ninepatch_margins;
 	vec4 dst_rect; //for built-in rect and UV
 	vec4 src_rect;
-	vec2 pad;
+	uint batch_offset;
+	uint pad;
 
 #endif
 	vec2 color_texture_pixel_size;
@@ -93,8 +103,8 @@ layout(set = 0, binding = 1, std140) uniform CanvasData {
 
 	uint directional_light_count;
 	float tex_to_sdf;
-	uint pad1;
-	uint pad2;
+	uint light_tile_size;
+	uint light_tile_columns;
 }
 canvas_data;
 
@@ -125,6 +135,11 @@ struct Light {
 	float shadow_y_ofs;
 
 	vec4 atlas_rect;
+
+	uint item_mask; // Checked by the shader when using light tiles.
+	int z_min;
+	int z_max;
+	uint pad;
 };
 
 layout(set = 0, binding = 2, std140) uniform LightData {
@@ -147,6 +162,30 @@ layout(set = 0, binding = 9, std430) restrict readonly buffer GlobalShaderUnifor
 }
 global_shader_uniforms;
 
+#define BATCH_INSTANCE_FLAGS_REGION_IN_PIXELS 1
+
+// Rects drawn as a batch read their per-instance data from here, starting at draw_data.batch_offset.
+struct BatchInstance {
+	vec2 world_x;
+	vec2 world_y;
+	vec2 world_ofs;
+	uint flags;
+	uint pad;
+	vec4 modulation;
+	vec4 dst_rect;
+	vec4 src_rect;
+};
+
+layout(set = 0, binding = 10, std430) restrict readonly buffer BatchInstanceData {
+	BatchInstance data[];
+}
+batch_instances;
+
+layout(set = 0, binding = 11, std430) restrict readonly buffer LightTileData {
+	uint data[];
+}
+light_tiles;
+
 /* SET1: Is reserved for the material */
 
 //
@@ -616,6 +616,14 @@ void TextureStorage::canvas_texture_set_texture_repeat(RID p_canvas_texture, RS:
 	ct->clear_sets();
 }
 
+RID TextureStorage::canvas_texture_get_diffuse(RID p_texture) {
+	CanvasTexture *ct = canvas_texture_owner.get_or_null(p_texture);
+	if (!ct) {
+		return p_texture;
+	}
+	return ct->diffuse;
+}
+
 bool TextureStorage::canvas_texture_get_uniform_set(RID p_texture, RS::CanvasItemTextureFilter p_base_filter, RS::CanvasItemTextureRepeat p_base_repeat, RID p_base_shader, int p_base_set, RID &r_uniform_set, Size2i &r_size, Color &r_specular_shininess, bool &r_use_normal, bool &r_use_specular) {
 	MaterialStorage *material_storage = MaterialStorage::get_singleton();
 
@@ -472,6 +472,8 @@ void RendererViewport::draw_viewports() {
 	int objects_drawn = 0;
 	int draw_calls_used = 0;
 
+	RSG::canvas_render->render_info = RendererCanvasRender::RenderInfo();
+
 	for (int i = 0; i < sorted_active_viewports.size(); i++) {
 		Viewport *vp = sorted_active_viewports[i];
 
@@ -530,6 +532,9 @@ void RendererViewport::draw_viewports() {
 	total_objects_drawn = objects_drawn;
 	total_vertices_drawn = vertices_drawn;
 	total_draw_calls_used = draw_calls_used;
+	total_canvas_items_drawn = RSG::canvas_render->render_info.items_in_frame;
+	total_canvas_batches_drawn = RSG::canvas_render->render_info.batches_in_frame;
+	total_canvas_shadow_updates_skipped = RSG::canvas_render->render_info.shadow_updates_skipped_in_frame;
 
 	RENDER_TIMESTAMP("< Render Viewports");
 	//this needs to be called to make screen swapping more efficient
@@ -930,6 +935,16 @@ int RendererViewport::get_total_primitives_drawn() const {
 int RendererViewport::get_total_draw_calls_used() const {
 	return total_draw_calls_used;
 }
+int RendererViewport::get_total_canvas_items_drawn() const {
+	return total_canvas_items_drawn;
+}
+int RendererViewport::get_total_canvas_batches_drawn() const {
+	return total_canvas_batches_drawn;
+}
+
+int RendererViewport::get_total_canvas_shadow_updates_skipped() const {
+	return total_canvas_shadow_updates_skipped;
+}
 
 RendererViewport::RendererViewport() {
 }
@@ -175,6 +175,9 @@ public:
 	int total_objects_drawn = 0;
 	int total_vertices_drawn = 0;
 	int total_draw_calls_used = 0;
+	int total_canvas_items_drawn = 0;
+	int total_canvas_batches_drawn = 0;
+	int total_canvas_shadow_updates_skipped = 0;
 
 private:
 	Vector<Viewport *> _sort_active_viewports();
@@ -249,6 +252,9 @@ public:
 	int get_total_objects_drawn() const;
 	int get_total_primitives_drawn() const;
 	int get_total_draw_calls_used() const;
+	int get_total_canvas_items_drawn() const;
+	int get_total_canvas_batches_drawn() const;
+	int get_total_canvas_shadow_updates_skipped() const;
 
 	// Workaround for setting this on thread.
 	void call_set_vsync_mode(DisplayServer::VSyncMode p_mode, DisplayServer::WindowID p_window);
@@ -86,6 +86,7 @@ void RenderingServerDefault::_draw(bool p_swap_buffers, double frame_step) {
 
 	RSG::particles_storage->update_particles(); //need to be done after instances are updated (colliders and particle transforms), and colliders are rendered
 
+	RSG::canvas->update_sprite_batches();
 	RSG::viewport->draw_viewports();
 	RSG::canvas_render->update();
 
@@ -202,6 +203,7 @@ void RenderingServerDefault::_init() {
 }
 
 void RenderingServerDefault::_finish() {
+	RSG::canvas->finalize();
 	RSG::rasterizer->finalize();
 }
 
@@ -236,6 +238,13 @@ void RenderingServerDefault::finish() {
 /* STATUS INFORMATION */
 
 uint64_t RenderingServerDefault::get_rendering_info(RenderingInfo p_info) {
+	if (p_info == RS::RENDERING_INFO_TOTAL_CANVAS_ITEMS_IN_FRAME) {
+		return RSG::viewport->get_total_canvas_items_drawn();
+	} else if (p_info == RS::RENDERING_INFO_TOTAL_CANVAS_BATCHES_IN_FRAME) {
+		return RSG::viewport->get_total_canvas_batches_drawn();
+	} else if (p_info == RS::RENDERING_INFO_TOTAL_CANVAS_SHADOW_UPDATES_SKIPPED_IN_FRAME) {
+		return RSG::viewport->get_total_canvas_shadow_updates_skipped();
+	}
 	return RSG::utilities->get_rendering_info(p_info);
 }
 
@@ -360,6 +369,12 @@ void RenderingServerDefault::sync() {
 	}
 }
 
+void RenderingServerDefault::set_command_queued_semaphore(Semaphore *p_semaphore) {
+	// The rendering thread flushes the queue on its own.
+	ERR_FAIL_COND(create_thread);
+	command_queue.set_push_semaphore(p_semaphore);
+}
+
 void RenderingServerDefault::draw(bool p_swap_buffers, double frame_step) {
 	if (create_thread) {
 		command_queue.push(this, &RenderingServerDefault::_thread_draw, p_swap_buffers, frame_step);
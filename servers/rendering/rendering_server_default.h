@@ -657,6 +657,7 @@ public:
 	FUNC2(canvas_item_set_visibility_layer, RID, uint32_t)
 
 	FUNC2(canvas_item_set_update_when_visible, RID, bool)
+	FUNC2(canvas_item_set_static, RID, bool)
 
 	FUNC2(canvas_item_set_transform, RID, const Transform2D &)
 	FUNC2(canvas_item_set_clip, RID, bool)
@@ -682,6 +683,7 @@ public:
 	FUNC9(canvas_item_add_triangle_array, RID, const Vector<int> &, const Vector<Point2> &, const Vector<Color> &, const Vector<Point2> &, const Vector<int> &, const Vector<float> &, RID, int)
 	FUNC5(canvas_item_add_mesh, RID, const RID &, const Transform2D &, const Color &, RID)
 	FUNC3(canvas_item_add_multimesh, RID, RID, RID)
+	FUNC6(canvas_item_add_sprite_batch, RID, RID, const Vector<float> &, const Vector<float> &, const Vector<Color> &, bool)
 	FUNC3(canvas_item_add_particles, RID, RID, RID)
 	FUNC2(canvas_item_add_set_transform, RID, const Transform2D &)
 	FUNC2(canvas_item_add_clip_ignore, RID, bool)
@@ -786,6 +788,7 @@ public:
 
 	virtual void draw(bool p_swap_buffers, double frame_step) override;
 	virtual void sync() override;
+	virtual void set_command_queued_semaphore(Semaphore *p_semaphore) override;
 	virtual bool has_changed() const override;
 	virtual void init() override;
 	virtual void finish() override;
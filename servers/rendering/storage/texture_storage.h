@@ -57,6 +57,8 @@ public:
 
 	virtual void canvas_texture_set_texture_filter(RID p_item, RS::CanvasItemTextureFilter p_filter) = 0;
 	virtual void canvas_texture_set_texture_repeat(RID p_item, RS::CanvasItemTextureRepeat p_repeat) = 0;
+	// Regular textures are returned as is.
+	virtual RID canvas_texture_get_diffuse(RID p_texture) = 0;
 
 	/* Texture API */
 	virtual bool can_create_resources_async() const = 0;
@@ -35,6 +35,7 @@
 #include "core/math/geometry_3d.h"
 #include "core/math/transform_2d.h"
 #include "core/object/class_db.h"
+#include "core/os/semaphore.h"
 #include "core/templates/rid.h"
 #include "core/variant/typed_array.h"
 #include "core/variant/variant.h"
@@ -1134,6 +1135,7 @@ public:
 	virtual void canvas_item_set_light_mask(RID p_item, int p_mask) = 0;
 
 	virtual void canvas_item_set_update_when_visible(RID p_item, bool p_update) = 0;
+	virtual void canvas_item_set_static(RID p_item, bool p_static) = 0;
 
 	virtual void canvas_item_set_transform(RID p_item, const Transform2D &p_transform) = 0;
 	virtual void canvas_item_set_clip(RID p_item, bool p_clip) = 0;
@@ -1166,6 +1168,7 @@ public:
 	virtual void canvas_item_add_triangle_array(RID p_item, const Vector<int> &p_indices, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs = Vector<Point2>(), const Vector<int> &p_bones = Vector<int>(), const Vector<float> &p_weights = Vector<float>(), RID p_texture = RID(), int p_count = -1) = 0;
 	virtual void canvas_item_add_mesh(RID p_item, const RID &p_mesh, const Transform2D &p_transform = Transform2D(), const Color &p_modulate = Color(1, 1, 1), RID p_texture = RID()) = 0;
 	virtual void canvas_item_add_multimesh(RID p_item, RID p_mesh, RID p_texture = RID()) = 0;
+	virtual void canvas_item_add_sprite_batch(RID p_item, RID p_texture, const Vector<float> &p_transforms, const Vector<float> &p_regions = Vector<float>(), const Vector<Color> &p_colors = Vector<Color>(), bool p_centered = true) = 0;
 	virtual void canvas_item_add_particles(RID p_item, RID p_particles, RID p_texture) = 0;
 	virtual void canvas_item_add_set_transform(RID p_item, const Transform2D &p_transform) = 0;
 	virtual void canvas_item_add_clip_ignore(RID p_item, bool p_ignore) = 0;
@@ -1327,6 +1330,9 @@ public:
 
 	virtual void draw(bool p_swap_buffers = true, double frame_step = 0.0) = 0;
 	virtual void sync() = 0;
+	// Without a rendering thread, calls made from other threads wait until the main thread syncs. The semaphore is
+	// posted each time one is queued, so the main thread can wait for them instead of polling. Pass nullptr to stop.
+	virtual void set_command_queued_semaphore(Semaphore *p_semaphore) = 0;
 	virtual bool has_changed() const = 0;
 	virtual void init();
 	virtual void finish() = 0;
@@ -1340,6 +1346,9 @@ public:
 		RENDERING_INFO_TEXTURE_MEM_USED,
 		RENDERING_INFO_BUFFER_MEM_USED,
 		RENDERING_INFO_VIDEO_MEM_USED,
+		RENDERING_INFO_TOTAL_CANVAS_ITEMS_IN_FRAME,
+		RENDERING_INFO_TOTAL_CANVAS_BATCHES_IN_FRAME,
+		RENDERING_INFO_TOTAL_CANVAS_SHADOW_UPDATES_SKIPPED_IN_FRAME,
 		RENDERING_INFO_MAX
 	};
 
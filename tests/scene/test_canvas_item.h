@@ -0,0 +1,113 @@
+/**************************************************************************/
+/*  test_canvas_item.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_CANVAS_ITEM_H
+#define TEST_CANVAS_ITEM_H
+
+#include "core/object/message_queue.h"
+#include "scene/2d/line_2d.h"
+#include "scene/main/window.h"
+#include "servers/rendering/renderer_canvas_cull.h"
+#include "servers/rendering/rendering_server_globals.h"
+
+#include "tests/test_macros.h"
+
+namespace TestCanvasItem {
+
+static bool has_draw_commands(const CanvasItem *p_item) {
+	return RSG::canvas->canvas_item_owner.get_or_null(p_item->get_canvas_item())->commands != nullptr;
+}
+
+TEST_CASE("[SceneTree][CanvasItem] Thread safe items are redrawn with the others") {
+	Window *root = SceneTree::get_singleton()->get_root();
+
+	// Enough items to be redrawn on the worker thread pool, mixed with regular ones.
+	LocalVector<Line2D *> lines;
+	for (int i = 0; i < 32; i++) {
+		Line2D *line = memnew(Line2D);
+		line->add_point(Vector2());
+		line->add_point(Vector2(i, 10));
+		line->set_thread_safe_draw(i % 4 != 0);
+		root->add_child(line);
+		lines.push_back(line);
+	}
+
+	// Entering the tree queues a redraw of every item.
+	MessageQueue::get_singleton()->flush();
+	RS::get_singleton()->sync();
+
+	bool all_drawn = true;
+	for (const Line2D *line : lines) {
+		all_drawn = all_drawn && has_draw_commands(line);
+	}
+	CHECK(all_drawn);
+
+	// Clearing the points empties the drawing.
+	for (Line2D *line : lines) {
+		line->clear_points();
+	}
+	MessageQueue::get_singleton()->flush();
+	RS::get_singleton()->sync();
+
+	bool all_cleared = true;
+	for (const Line2D *line : lines) {
+		all_cleared = all_cleared && !has_draw_commands(line);
+	}
+	CHECK(all_cleared);
+
+	// Hidden items are cleared instead of drawn.
+	for (uint32_t i = 0; i < lines.size(); i++) {
+		lines[i]->add_point(Vector2());
+		lines[i]->add_point(Vector2(i, 10));
+		lines[i]->set_visible(i % 2 == 0);
+	}
+	MessageQueue::get_singleton()->flush();
+	RS::get_singleton()->sync();
+
+	bool only_visible_drawn = true;
+	for (const Line2D *line : lines) {
+		only_visible_drawn = only_visible_drawn && has_draw_commands(line) == line->is_visible();
+	}
+	CHECK(only_visible_drawn);
+
+	// Items freed before their redraw runs are skipped.
+	lines[1]->queue_redraw();
+	memdelete(lines[1]);
+	lines.remove_at(1);
+	MessageQueue::get_singleton()->flush();
+
+	for (Line2D *line : lines) {
+		memdelete(line);
+	}
+}
+
+} // namespace TestCanvasItem
+
+#endif // TEST_CANVAS_ITEM_H
@@ -0,0 +1,209 @@
+/**************************************************************************/
+/*  test_sprite_batch_2d.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SPRITE_BATCH_2D_H
+#define TEST_SPRITE_BATCH_2D_H
+
+#include "core/object/message_queue.h"
+#include "scene/2d/sprite_batch_2d.h"
+#include "scene/main/window.h"
+#include "servers/rendering/renderer_canvas_cull.h"
+#include "servers/rendering/rendering_server_globals.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSpriteBatch2D {
+
+TEST_CASE("[SceneTree][SpriteBatch2D] Instance setters and getters") {
+	SpriteBatch2D *batch = memnew(SpriteBatch2D);
+	CHECK(batch->get_instance_count() == 0);
+
+	Transform2D xform(0.5, Vector2(10, 20));
+	CHECK(batch->add_instance(xform, Rect2(16, 0, 16, 16), Color(1, 0, 0)) == 0);
+	CHECK(batch->add_instance(Transform2D()) == 1);
+	CHECK(batch->get_instance_count() == 2);
+
+	CHECK(batch->get_instance_transform(0).is_equal_approx(xform));
+	CHECK(batch->get_instance_region(0) == Rect2(16, 0, 16, 16));
+	CHECK(batch->get_instance_color(0) == Color(1, 0, 0));
+	CHECK(batch->get_instance_region(1) == Rect2());
+	CHECK(batch->get_instance_color(1) == Color(1, 1, 1));
+
+	batch->set_instance_transform(1, xform);
+	batch->set_instance_color(1, Color(0, 1, 0));
+	CHECK(batch->get_instance_transform(1).is_equal_approx(xform));
+	CHECK(batch->get_instance_color(1) == Color(0, 1, 0));
+
+	SUBCASE("Setting packed transforms resizes the instances") {
+		Vector<float> transforms = batch->get_transforms();
+		CHECK(transforms.size() == 12);
+		for (int i = 0; i < 6; i++) {
+			transforms.push_back(i == 0 || i == 3 ? 1 : 0);
+		}
+		batch->set_transforms(transforms);
+		CHECK(batch->get_instance_count() == 3);
+		CHECK(batch->get_regions().size() == 12);
+		CHECK(batch->get_colors().size() == 3);
+		CHECK(batch->get_instance_color(0) == Color(1, 0, 0));
+		CHECK(batch->get_instance_color(2) == Color(1, 1, 1));
+		CHECK(batch->get_instance_transform(2) == Transform2D());
+	}
+
+	SUBCASE("Clearing removes all instances") {
+		batch->clear_instances();
+		CHECK(batch->get_instance_count() == 0);
+		CHECK(batch->get_regions().is_empty());
+		CHECK(batch->get_colors().is_empty());
+	}
+
+	memdelete(batch);
+}
+
+TEST_CASE("[SceneTree][SpriteBatch2D] All instances are drawn with one command") {
+	Ref<Image> image = Image::create_empty(32, 16, false, Image::FORMAT_RGBA8);
+	Ref<ImageTexture> texture = ImageTexture::create_from_image(image);
+
+	SpriteBatch2D *batch = memnew(SpriteBatch2D);
+	batch->set_texture(texture);
+	for (int i = 0; i < 100; i++) {
+		batch->add_instance(Transform2D(0, Vector2(i * 4, i)), Rect2(16 * (i % 2), 0, 16, 16));
+	}
+	SceneTree::get_singleton()->get_root()->add_child(batch);
+
+	MessageQueue::get_singleton()->flush();
+	RS::get_singleton()->sync();
+
+	const RendererCanvasRender::Item::Command *command = RSG::canvas->canvas_item_owner.get_or_null(batch->get_canvas_item())->commands;
+	REQUIRE(command != nullptr);
+	CHECK(command->type == RendererCanvasRender::Item::Command::TYPE_MULTIMESH);
+	CHECK(static_cast<const RendererCanvasRender::Item::CommandMultiMesh *>(command)->sprite_batch);
+	CHECK(command->next == nullptr);
+
+	batch->clear_instances();
+	MessageQueue::get_singleton()->flush();
+	RS::get_singleton()->sync();
+	CHECK(RSG::canvas->canvas_item_owner.get_or_null(batch->get_canvas_item())->commands == nullptr);
+
+	memdelete(batch);
+}
+
+TEST_CASE("[SceneTree][SpriteBatch2D] Redraws reuse the multimesh") {
+	Ref<Image> image = Image::create_empty(32, 16, false, Image::FORMAT_RGBA8);
+	Ref<ImageTexture> texture = ImageTexture::create_from_image(image);
+
+	SpriteBatch2D *batch = memnew(SpriteBatch2D);
+	batch->set_texture(texture);
+	for (int i = 0; i < 100; i++) {
+		batch->add_instance(Transform2D(0, Vector2(i * 4, i)));
+	}
+	SceneTree::get_singleton()->get_root()->add_child(batch);
+
+	MessageQueue::get_singleton()->flush();
+	RS::get_singleton()->sync();
+
+	const RendererCanvasRender::Item *item = RSG::canvas->canvas_item_owner.get_or_null(batch->get_canvas_item());
+	REQUIRE(item->sprite_batch_multimeshes.size() == 1);
+	CHECK(item->sprite_batch_multimeshes_used == 1);
+	CHECK(item->sprite_batch_multimeshes[0].capacity == 128);
+
+	// Fewer instances keep the allocated data.
+	batch->set_transforms(batch->get_transforms().slice(0, 10 * 6));
+	MessageQueue::get_singleton()->flush();
+	RS::get_singleton()->sync();
+	REQUIRE(item->sprite_batch_multimeshes.size() == 1);
+	CHECK(item->sprite_batch_multimeshes[0].capacity == 128);
+
+	// More instances than the capacity grow it.
+	for (int i = 0; i < 190; i++) {
+		batch->add_instance(Transform2D(0, Vector2(i, i * 4)));
+	}
+	MessageQueue::get_singleton()->flush();
+	RS::get_singleton()->sync();
+	REQUIRE(item->sprite_batch_multimeshes.size() == 1);
+	CHECK(item->sprite_batch_multimeshes_used == 1);
+	CHECK(item->sprite_batch_multimeshes[0].capacity == 256);
+
+	// Staying well below the capacity for a number of redraws shrinks it.
+	batch->set_transforms(batch->get_transforms().slice(0, 10 * 6));
+	int redraws = 1;
+	MessageQueue::get_singleton()->flush();
+	RS::get_singleton()->sync();
+	CHECK(item->sprite_batch_multimeshes[0].capacity == 256);
+	while (item->sprite_batch_multimeshes[0].capacity == 256 && redraws < 100) {
+		batch->set_instance_color(0, Color(1, 1, 1, redraws % 2));
+		MessageQueue::get_singleton()->flush();
+		RS::get_singleton()->sync();
+		redraws++;
+	}
+	REQUIRE(item->sprite_batch_multimeshes.size() == 1);
+	CHECK(item->sprite_batch_multimeshes[0].capacity == 16);
+	CHECK(redraws > 10);
+
+	memdelete(batch);
+}
+
+TEST_CASE("[SceneTree][SpriteBatch2D] Multimeshes left unused by a redraw are freed") {
+	RID canvas = RS::get_singleton()->canvas_create();
+	RID ci = RS::get_singleton()->canvas_item_create();
+	RS::get_singleton()->canvas_item_set_parent(ci, canvas);
+
+	Vector<float> transforms;
+	transforms.resize(6);
+	Transform2D xform;
+	for (int i = 0; i < 6; i++) {
+		transforms.write[i] = xform.columns[i / 2][i % 2];
+	}
+
+	RS::get_singleton()->canvas_item_add_sprite_batch(ci, RID(), transforms);
+	RS::get_singleton()->canvas_item_add_sprite_batch(ci, RID(), transforms);
+	RS::get_singleton()->sync();
+
+	const RendererCanvasRender::Item *item = RSG::canvas->canvas_item_owner.get_or_null(ci);
+	CHECK(item->sprite_batch_multimeshes.size() == 2);
+
+	RS::get_singleton()->canvas_item_clear(ci);
+	RS::get_singleton()->canvas_item_add_sprite_batch(ci, RID(), transforms);
+	RS::get_singleton()->sync();
+	RSG::canvas->update_sprite_batches();
+	CHECK(item->sprite_batch_multimeshes.size() == 1);
+	CHECK(item->sprite_batch_multimeshes_used == 1);
+
+	RS::get_singleton()->canvas_item_clear(ci);
+	RS::get_singleton()->sync();
+	RSG::canvas->update_sprite_batches();
+	CHECK(item->sprite_batch_multimeshes.is_empty());
+
+	RS::get_singleton()->free(ci);
+	RS::get_singleton()->free(canvas);
+}
+
+} // namespace TestSpriteBatch2D
+
+#endif // TEST_SPRITE_BATCH_2D_H
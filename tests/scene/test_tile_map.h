@@ -0,0 +1,617 @@
+/**************************************************************************/
+/*  test_tile_map.h                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_TILE_MAP_H
+#define TEST_TILE_MAP_H
+
+#include "core/io/dir_access.h"
+#include "core/io/marshalls.h"
+#include "core/io/resource_loader.h"
+#include "core/io/resource_saver.h"
+#include "core/object/message_queue.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
+#include "scene/2d/tile_map.h"
+#include "scene/2d/tile_map_chunk_stream.h"
+#include "scene/main/window.h"
+#include "scene/resources/packed_scene.h"
+#include "scene/resources/world_2d.h"
+#include "servers/physics_server_2d.h"
+#include "servers/rendering/renderer_canvas_cull.h"
+#include "servers/rendering/rendering_server_globals.h"
+
+#include "tests/test_macros.h"
+
+namespace TestTileMap {
+
+static Ref<TileSet> create_tile_set(int &r_source_id) {
+	Ref<Image> image = Image::create_empty(32, 16, false, Image::FORMAT_RGBA8);
+
+	Ref<TileSetAtlasSource> atlas_source;
+	atlas_source.instantiate();
+	atlas_source->set_texture(ImageTexture::create_from_image(image));
+	atlas_source->set_texture_region_size(Vector2i(16, 16));
+	atlas_source->create_tile(Vector2i(0, 0));
+	atlas_source->create_tile(Vector2i(1, 0));
+
+	Ref<TileSet> tile_set;
+	tile_set.instantiate();
+	tile_set->set_tile_size(Vector2i(16, 16));
+	r_source_id = tile_set->add_source(atlas_source);
+	return tile_set;
+}
+
+static int count_drawn_tiles(TileMap *p_tile_map, int p_layer) {
+	int count = 0;
+	for (const KeyValue<Vector2i, TileMapQuadrant> &E : *p_tile_map->get_quadrant_map(p_layer)) {
+		for (const RID &ci : E.value.canvas_items) {
+			const RendererCanvasRender::Item::Command *command = RSG::canvas->canvas_item_owner.get_or_null(ci)->commands;
+			while (command) {
+				if (command->type == RendererCanvasRender::Item::Command::TYPE_RECT) {
+					count++;
+				}
+				command = command->next;
+			}
+		}
+	}
+	return count;
+}
+
+TEST_CASE("[SceneTree][TileMap] Dirty quadrants are rebuilt with all their cells") {
+	int source_id = 0;
+	Ref<TileSet> tile_set = create_tile_set(source_id);
+
+	TileMap *tile_map = memnew(TileMap);
+	tile_map->set_tileset(tile_set);
+	tile_map->set_quadrant_size(16);
+	SceneTree::get_singleton()->get_root()->add_child(tile_map);
+
+	SUBCASE("Few quadrants are updated serially") {
+		for (int y = 0; y < 4; y++) {
+			for (int x = 0; x < 4; x++) {
+				tile_map->set_cell(0, Vector2i(x, y), source_id, Vector2i((x + y) % 2, 0));
+			}
+		}
+		MessageQueue::get_singleton()->flush();
+		RS::get_singleton()->sync();
+
+		CHECK(tile_map->get_quadrant_map(0)->size() == 1);
+		CHECK(count_drawn_tiles(tile_map, 0) == 16);
+		CHECK(tile_map->get_last_update_threaded_quadrants() == 0);
+	}
+
+	SUBCASE("Many quadrants are updated on the worker threads") {
+		for (int y = 0; y < 64; y++) {
+			for (int x = 0; x < 64; x++) {
+				tile_map->set_cell(0, Vector2i(x, y), source_id, Vector2i((x + y) % 2, 0));
+			}
+		}
+		MessageQueue::get_singleton()->flush();
+		RS::get_singleton()->sync();
+
+		CHECK(tile_map->get_quadrant_map(0)->size() == 16);
+		CHECK(count_drawn_tiles(tile_map, 0) == 64 * 64);
+		if (WorkerThreadPool::get_singleton()->get_thread_count() > 1) {
+			CHECK_MESSAGE(tile_map->get_last_update_threaded_quadrants() == 16, "The cells of every dirty quadrant should be resolved on the worker threads.");
+		}
+
+		// Erasing cells only redraws the quadrants they belong to.
+		for (int x = 0; x < 64; x++) {
+			tile_map->erase_cell(0, Vector2i(x, 0));
+		}
+		MessageQueue::get_singleton()->flush();
+		RS::get_singleton()->sync();
+
+		CHECK(count_drawn_tiles(tile_map, 0) == 64 * 63);
+	}
+
+	SUBCASE("Large updates are done in a single frame by default") {
+		CHECK(tile_map->get_update_cells_per_frame() == 0);
+		tile_map->fill_rect(0, Rect2i(0, 0, 256, 256), source_id, Vector2i(0, 0));
+		MessageQueue::get_singleton()->flush();
+		RS::get_singleton()->sync();
+
+		CHECK(count_drawn_tiles(tile_map, 0) == 256 * 256);
+	}
+
+	SUBCASE("Large updates are spread over several frames with a limit") {
+		// 256 quadrants of 256 cells, four times the cells updated per frame.
+		tile_map->set_update_cells_per_frame(16384);
+		tile_map->fill_rect(0, Rect2i(0, 0, 256, 256), source_id, Vector2i(0, 0));
+		MessageQueue::get_singleton()->flush();
+		RS::get_singleton()->sync();
+
+		CHECK(tile_map->get_quadrant_map(0)->size() == 256);
+		CHECK(count_drawn_tiles(tile_map, 0) == 256 * 64);
+
+		for (int frame = 0; frame < 3; frame++) {
+			SceneTree::get_singleton()->emit_signal(SNAME("process_frame"));
+		}
+		RS::get_singleton()->sync();
+		CHECK(count_drawn_tiles(tile_map, 0) == 256 * 256);
+
+		// Nothing is left to update.
+		SceneTree::get_singleton()->emit_signal(SNAME("process_frame"));
+		int dirty_count = 0;
+		for (const KeyValue<Vector2i, TileMapQuadrant> &E : *tile_map->get_quadrant_map(0)) {
+			dirty_count += E.value.dirty_list_element.in_list() ? 1 : 0;
+		}
+		CHECK(dirty_count == 0);
+	}
+
+	memdelete(tile_map);
+}
+
+// Returns the body at a cell of the TileMap, or an invalid RID if no collision shape covers the point.
+static RID intersect_tile_map_point(TileMap *p_tile_map, const Vector2i &p_coords, const Vector2 &p_offset = Vector2()) {
+	PhysicsDirectSpaceState2D *space_state = PhysicsServer2D::get_singleton()->space_get_direct_state(p_tile_map->get_world_2d()->get_space());
+	REQUIRE(space_state != nullptr);
+
+	PhysicsDirectSpaceState2D::PointParameters parameters;
+	parameters.position = p_tile_map->to_global(p_tile_map->map_to_local(p_coords) + p_offset);
+	PhysicsDirectSpaceState2D::ShapeResult result;
+	if (space_state->intersect_point(parameters, &result, 1) == 0) {
+		return RID();
+	}
+	CHECK(result.collider_id == p_tile_map->get_instance_id());
+	return result.rid;
+}
+
+TEST_CASE("[SceneTree][TileMap] Collision shapes are merged per quadrant") {
+	int source_id = 0;
+	Ref<TileSet> tile_set = create_tile_set(source_id);
+	tile_set->add_physics_layer();
+
+	// A full square tile and a bottom half tile.
+	Ref<TileSetAtlasSource> atlas_source = tile_set->get_source(source_id);
+	TileData *square = atlas_source->get_tile_data(Vector2i(0, 0), 0);
+	square->add_collision_polygon(0);
+	square->set_collision_polygon_points(0, 0, { Vector2(-8, -8), Vector2(8, -8), Vector2(8, 8), Vector2(-8, 8) });
+	TileData *half = atlas_source->get_tile_data(Vector2i(1, 0), 0);
+	half->add_collision_polygon(0);
+	half->set_collision_polygon_points(0, 0, { Vector2(-8, 0), Vector2(8, 0), Vector2(8, 8), Vector2(-8, 8) });
+
+	TileMap *tile_map = memnew(TileMap);
+	tile_map->set_tileset(tile_set);
+	tile_map->set_quadrant_size(16);
+	SceneTree::get_singleton()->get_root()->add_child(tile_map);
+
+	// Two rows of squares, with a row of half tiles on the right side.
+	for (int x = 0; x < 8; x++) {
+		tile_map->set_cell(0, Vector2i(x, 0), source_id, Vector2i(0, 0));
+		tile_map->set_cell(0, Vector2i(x, 1), source_id, Vector2i(0, 0));
+		tile_map->set_cell(0, Vector2i(x + 8, 1), source_id, Vector2i(1, 0));
+	}
+
+	MessageQueue::get_singleton()->flush();
+	const TileMapQuadrant &quadrant = tile_map->get_quadrant_map(0)->begin()->value;
+	CHECK(quadrant.bodies.size() == 24);
+
+	// Bodies are created in the order of the quadrant cells, not in drawing order.
+	bool bodies_sorted = true;
+	Vector2i previous_coords(INT32_MIN, INT32_MIN);
+	for (const RID &quadrant_body : quadrant.bodies) {
+		Vector2i coords = tile_map->get_coords_for_body_rid(quadrant_body);
+		bodies_sorted = bodies_sorted && previous_coords < coords;
+		previous_coords = coords;
+	}
+	CHECK_MESSAGE(bodies_sorted, "Bodies should be created in coordinates order.");
+
+	tile_map->set_collision_merged(true);
+	MessageQueue::get_singleton()->flush();
+	const TileMapQuadrant &merged_quadrant = tile_map->get_quadrant_map(0)->begin()->value;
+	REQUIRE(merged_quadrant.bodies.size() == 1);
+
+	// The squares make one rectangle, the half tiles are unioned into another one.
+	RID body = merged_quadrant.bodies.front()->get();
+	int shape_count = PhysicsServer2D::get_singleton()->body_get_shape_count(body);
+	CHECK(shape_count == (int)merged_quadrant.merged_collision_shapes.size());
+	CHECK(shape_count == 2);
+	CHECK(tile_map->get_coords_for_body_rid(body) == Vector2i());
+
+	// Register the shapes in the space, then check that the merged shapes cover the same area as the tiles.
+	PhysicsServer2D::get_singleton()->flush_queries();
+	PhysicsServer2D::get_singleton()->step(1.0 / 60.0);
+
+	CHECK(intersect_tile_map_point(tile_map, Vector2i(0, 0)) == body);
+	CHECK(intersect_tile_map_point(tile_map, Vector2i(7, 1), Vector2(7, 7)) == body);
+	CHECK(intersect_tile_map_point(tile_map, Vector2i(12, 1), Vector2(0, 4)) == body);
+	CHECK(intersect_tile_map_point(tile_map, Vector2i(15, 1), Vector2(7, 1)) == body);
+	// The top of the half tiles and the empty cells are not covered.
+	CHECK(intersect_tile_map_point(tile_map, Vector2i(12, 1), Vector2(0, -4)) == RID());
+	CHECK(intersect_tile_map_point(tile_map, Vector2i(12, 0)) == RID());
+	CHECK(intersect_tile_map_point(tile_map, Vector2i(3, 2)) == RID());
+
+	memdelete(tile_map);
+}
+
+TEST_CASE("[SceneTree][TileMap] Chunks are streamed from a chunks file") {
+	int source_id = 0;
+	Ref<TileSet> tile_set = create_tile_set(source_id);
+
+	TileMap *tile_map = memnew(TileMap);
+	tile_map->set_tileset(tile_set);
+	SceneTree::get_singleton()->get_root()->add_child(tile_map);
+
+	// Cells in four chunks of 8x8 cells, around the origin.
+	for (int y = -8; y < 8; y++) {
+		for (int x = -8; x < 8; x++) {
+			tile_map->set_cell(0, Vector2i(x, y), source_id, Vector2i((x + y) & 1, 0));
+		}
+	}
+
+	const String path = OS::get_singleton()->get_cache_path().path_join("test_tile_map.tmchunks");
+	REQUIRE(tile_map->save_chunks(path, 8) == OK);
+
+	// The same cells painted in another order are saved to the same file.
+	TileMap *reversed = memnew(TileMap);
+	reversed->set_tileset(tile_set);
+	for (int y = 7; y >= -8; y--) {
+		for (int x = 7; x >= -8; x--) {
+			reversed->set_cell(0, Vector2i(x, y), source_id, Vector2i((x + y) & 1, 0));
+		}
+	}
+	const String reversed_path = OS::get_singleton()->get_cache_path().path_join("test_tile_map_reversed.tmchunks");
+	REQUIRE(reversed->save_chunks(reversed_path, 8) == OK);
+	CHECK(FileAccess::get_file_as_bytes(reversed_path) == FileAccess::get_file_as_bytes(path));
+	DirAccess::remove_absolute(reversed_path);
+	memdelete(reversed);
+
+	tile_map->clear();
+
+	SIGNAL_WATCH(tile_map, "chunk_loaded");
+	SIGNAL_WATCH(tile_map, "chunk_unloaded");
+
+	tile_map->set_chunk_stream_path(path);
+	CHECK(tile_map->get_chunk_size() == 8);
+	CHECK(tile_map->get_used_cells(0).is_empty());
+
+	SUBCASE("Loading a chunk sets its cells") {
+		CHECK(tile_map->load_chunk(0, Vector2i(-1, 0)));
+		CHECK(tile_map->is_chunk_loaded(0, Vector2i(-1, 0)));
+		CHECK(tile_map->get_used_cells(0).size() == 64);
+		CHECK(tile_map->get_cell_source_id(0, Vector2i(-8, 0)) == source_id);
+		CHECK(tile_map->get_cell_atlas_coords(0, Vector2i(-7, 0)) == Vector2i(1, 0));
+		CHECK(tile_map->get_cell_source_id(0, Vector2i(0, 0)) == TileSet::INVALID_SOURCE);
+
+		Array chunk_args;
+		chunk_args.push_back(0);
+		chunk_args.push_back(Vector2i(-1, 0));
+		Array args;
+		args.push_back(chunk_args);
+		SIGNAL_CHECK("chunk_loaded", args);
+
+		// Chunks that are not in the file can't be loaded.
+		CHECK_FALSE(tile_map->load_chunk(0, Vector2i(5, 5)));
+		SIGNAL_CHECK_FALSE("chunk_loaded");
+
+		tile_map->unload_chunk(0, Vector2i(-1, 0));
+		CHECK_FALSE(tile_map->is_chunk_loaded(0, Vector2i(-1, 0)));
+		CHECK(tile_map->get_used_cells(0).is_empty());
+		SIGNAL_CHECK("chunk_unloaded", args);
+	}
+
+	SUBCASE("Chunks are loaded and unloaded around a position") {
+		tile_map->update_chunks(tile_map->map_to_local(Vector2i(-12, 4)), 1);
+		CHECK(tile_map->get_loaded_chunks(0).size() == 2);
+		CHECK(tile_map->is_chunk_loaded(0, Vector2i(-1, -1)));
+		CHECK(tile_map->is_chunk_loaded(0, Vector2i(-1, 0)));
+		CHECK_FALSE(tile_map->is_chunk_loaded(0, Vector2i(0, 0)));
+
+		tile_map->update_chunks(tile_map->map_to_local(Vector2i(4, 4)), 1);
+		CHECK(tile_map->get_loaded_chunks(0).size() == 4);
+		CHECK(tile_map->get_used_cells(0).size() == 256);
+
+		tile_map->update_chunks(tile_map->map_to_local(Vector2i(100, 100)), 1);
+		CHECK(tile_map->get_loaded_chunks(0).is_empty());
+		CHECK(tile_map->get_used_cells(0).is_empty());
+	}
+
+	SUBCASE("Corrupted chunks files are rejected") {
+		Vector<uint8_t> valid = FileAccess::get_file_as_bytes(path);
+		REQUIRE(valid.size() > 16 + TileMapChunkStream::INDEX_ENTRY_SIZE);
+		const String corrupted_path = OS::get_singleton()->get_cache_path().path_join("test_tile_map_corrupted.tmchunks");
+
+		auto write_corrupted = [&](int p_offset, uint32_t p_value) {
+			Vector<uint8_t> data = valid.duplicate();
+			encode_uint32(p_value, data.ptrw() + p_offset);
+			Ref<FileAccess> f = FileAccess::open(corrupted_path, FileAccess::WRITE);
+			f->store_buffer(data);
+		};
+
+		TileMapChunkStream stream;
+		ERR_PRINT_OFF;
+
+		// Chunk size.
+		write_corrupted(8, TileMapChunkStream::MAX_CHUNK_SIZE + 1);
+		CHECK(stream.open(corrupted_path) == ERR_FILE_CORRUPT);
+		CHECK_FALSE(stream.is_open());
+		write_corrupted(8, 0x10000);
+		CHECK(stream.open(corrupted_path) == ERR_FILE_CORRUPT);
+
+		// Chunk count, more entries than the file can hold.
+		write_corrupted(12, 0xFFFFFFFF);
+		CHECK(stream.open(corrupted_path) == ERR_FILE_CORRUPT);
+		CHECK_FALSE(stream.is_open());
+
+		// Data offset of the first entry, past the end of the file.
+		write_corrupted(16 + 3 * 4, 0x7FFFFFFF);
+		REQUIRE(stream.open(corrupted_path) == OK);
+		Vector3i key = Vector3i(decode_uint32(valid.ptr() + 20), decode_uint32(valid.ptr() + 24), decode_uint32(valid.ptr() + 16));
+		Vector<TileMapCell> cells;
+		CHECK(stream.read_chunk(key.z, Vector2i(key.x, key.y), cells) == ERR_FILE_CORRUPT);
+		stream.close();
+
+		ERR_PRINT_ON;
+		DirAccess::remove_absolute(corrupted_path);
+	}
+
+	SIGNAL_UNWATCH(tile_map, "chunk_loaded");
+	SIGNAL_UNWATCH(tile_map, "chunk_unloaded");
+
+	memdelete(tile_map);
+	DirAccess::remove_absolute(path);
+}
+
+TEST_CASE("[SceneTree][TileMap] Layer tile data is saved as compressed chunks") {
+	int source_id = 0;
+	Ref<TileSet> tile_set = create_tile_set(source_id);
+
+	TileMap *tile_map = memnew(TileMap);
+	tile_map->set_tileset(tile_set);
+	for (int y = -40; y < 40; y += 3) {
+		for (int x = -40; x < 40; x++) {
+			tile_map->set_cell(0, Vector2i(x, y), source_id, Vector2i(x & 1, 0), y & 1);
+		}
+	}
+
+	Variant data = tile_map->get("layer_0/tile_data");
+	REQUIRE(data.get_type() == Variant::PACKED_BYTE_ARRAY);
+	CHECK(tile_map->get("format") == Variant(4));
+
+	TileMap *loaded = memnew(TileMap);
+	loaded->set_tileset(tile_set);
+	loaded->set("format", tile_map->get("format"));
+	loaded->set("layer_0/tile_data", data);
+
+	TypedArray<Vector2i> used_cells = tile_map->get_used_cells(0);
+	CHECK(loaded->get_used_cells(0).size() == used_cells.size());
+	for (int i = 0; i < used_cells.size(); i++) {
+		Vector2i coords = used_cells[i];
+		CHECK(loaded->get_cell_source_id(0, coords) == source_id);
+		CHECK(loaded->get_cell_atlas_coords(0, coords) == tile_map->get_cell_atlas_coords(0, coords));
+		CHECK(loaded->get_cell_alternative_tile(0, coords) == tile_map->get_cell_alternative_tile(0, coords));
+	}
+	CHECK(loaded->get_used_rect() == tile_map->get_used_rect());
+
+	SUBCASE("The same cells give the same data whatever the painting order") {
+		TileMap *reversed = memnew(TileMap);
+		reversed->set_tileset(tile_set);
+		for (int i = used_cells.size() - 1; i >= 0; i--) {
+			Vector2i coords = used_cells[i];
+			reversed->set_cell(0, coords, source_id, tile_map->get_cell_atlas_coords(0, coords), tile_map->get_cell_alternative_tile(0, coords));
+		}
+		CHECK(reversed->get("layer_0/tile_data") == data);
+		memdelete(reversed);
+	}
+
+	SUBCASE("Uncompressed data from older scenes is still loaded") {
+		Vector<int> legacy;
+		legacy.resize(3);
+		uint8_t *ptr = (uint8_t *)legacy.ptrw();
+		encode_uint16(-3, &ptr[0]);
+		encode_uint16(7, &ptr[2]);
+		encode_uint16(source_id, &ptr[4]);
+		encode_uint16(1, &ptr[6]);
+		encode_uint16(0, &ptr[8]);
+		encode_uint16(0, &ptr[10]);
+
+		loaded->set("format", 3);
+		loaded->set("layer_0/tile_data", legacy);
+		CHECK(loaded->get_used_cells(0).size() == 1);
+		CHECK(loaded->get_cell_atlas_coords(0, Vector2i(-3, 7)) == Vector2i(1, 0));
+	}
+
+	SUBCASE("Corrupted data is rejected") {
+		PackedByteArray corrupted = data;
+		ERR_PRINT_OFF;
+
+		// Chunk size.
+		encode_uint32(0x10000, corrupted.ptrw());
+		loaded->set("layer_0/tile_data", corrupted);
+		CHECK(loaded->get_used_cells(0).is_empty());
+
+		// Chunk count, more chunks than the data can hold.
+		corrupted = data;
+		encode_uint32(0xFFFFFFFF, corrupted.ptrw() + 4);
+		loaded->set("layer_0/tile_data", corrupted);
+		CHECK(loaded->get_used_cells(0).is_empty());
+
+		ERR_PRINT_ON;
+	}
+
+	memdelete(loaded);
+	memdelete(tile_map);
+}
+
+TEST_CASE("[SceneTree][TileMap] Bulk cells edition") {
+	int source_id = 0;
+	Ref<TileSet> tile_set = create_tile_set(source_id);
+
+	TileMap *tile_map = memnew(TileMap);
+	tile_map->set_tileset(tile_set);
+	tile_map->set_quadrant_size(16);
+
+	tile_map->fill_rect(0, Rect2i(-8, -8, 32, 16), source_id, Vector2i(1, 0));
+	CHECK(tile_map->get_used_cells(0).size() == 32 * 16);
+	CHECK(tile_map->get_used_rect() == Rect2i(-8, -8, 32, 16));
+	CHECK(tile_map->get_quadrant_map(0)->size() == 6);
+	CHECK(tile_map->get_cell_atlas_coords(0, Vector2i(23, 7)) == Vector2i(1, 0));
+
+	SUBCASE("Cells read from a rect can be set back") {
+		PackedInt32Array cells = tile_map->get_cells_rect(0, Rect2i(20, 6, 6, 3));
+		REQUIRE(cells.size() == 6 * 3 * 4);
+		CHECK(cells[0] == source_id);
+		CHECK(cells[1] == 1);
+		CHECK(cells[4 * 4] == TileSet::INVALID_SOURCE);
+
+		tile_map->set_cells_rect(0, Rect2i(100, 100, 6, 3), cells);
+		CHECK(tile_map->get_cells_rect(0, Rect2i(100, 100, 6, 3)) == cells);
+		CHECK(tile_map->get_used_cells(0).size() == 32 * 16 + 4 * 2);
+	}
+
+	SUBCASE("Rects with too many cells are rejected") {
+		ERR_PRINT_OFF;
+		CHECK(tile_map->get_cells_rect(0, Rect2i(0, 0, 32768, 32768)).is_empty());
+		tile_map->set_cells_rect(0, Rect2i(0, 0, 32768, 32768), PackedInt32Array());
+		ERR_PRINT_ON;
+		CHECK(tile_map->get_used_cells(0).size() == 32 * 16);
+	}
+
+	SUBCASE("Cells are set from packed coordinates") {
+		PackedInt32Array coords = { 0, 0, 50, 50, 1, 1 };
+		PackedInt32Array cells = { source_id, 0, 0, 0, source_id, 0, 0, 0, -1, -1, -1, -1 };
+		tile_map->set_cells(0, coords, cells);
+		CHECK(tile_map->get_cell_atlas_coords(0, Vector2i(0, 0)) == Vector2i(0, 0));
+		CHECK(tile_map->get_cell_source_id(0, Vector2i(50, 50)) == source_id);
+		CHECK(tile_map->get_cell_source_id(0, Vector2i(1, 1)) == TileSet::INVALID_SOURCE);
+		CHECK(tile_map->get_used_cells(0).size() == 32 * 16 + 1 - 1);
+	}
+
+	SUBCASE("Filling with an empty cell erases cells and empty quadrants") {
+		tile_map->fill_rect(0, Rect2i(-8, -8, 8, 16));
+		CHECK(tile_map->get_used_cells(0).size() == 24 * 16);
+		CHECK(tile_map->get_quadrant_map(0)->size() == 4);
+		tile_map->fill_rect(0, tile_map->get_used_rect());
+		CHECK(tile_map->get_used_cells(0).is_empty());
+		CHECK(tile_map->get_quadrant_map(0)->is_empty());
+	}
+
+	memdelete(tile_map);
+}
+
+TEST_CASE_PENDING("[SceneTree][TileMap][Benchmark] Set 1M cells") {
+	int source_id = 0;
+	Ref<TileSet> tile_set = create_tile_set(source_id);
+
+	const int size = 1000;
+	TileMap *tile_map = memnew(TileMap);
+	tile_map->set_tileset(tile_set);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			tile_map->set_cell(0, Vector2i(x, y), source_id, Vector2i((x + y) & 1, 0));
+		}
+	}
+	MESSAGE(vformat("Set 1M cells with set_cell() in %.3f ms.", (OS::get_singleton()->get_ticks_usec() - begin) / 1000.0));
+
+	PackedInt32Array cells = tile_map->get_cells_rect(0, Rect2i(0, 0, size, size));
+	tile_map->clear();
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	tile_map->set_cells_rect(0, Rect2i(0, 0, size, size), cells);
+	MESSAGE(vformat("Set 1M cells with set_cells_rect() in %.3f ms.", (OS::get_singleton()->get_ticks_usec() - begin) / 1000.0));
+	CHECK(tile_map->get_used_cells(0).size() == size * size);
+
+	memdelete(tile_map);
+}
+
+TEST_CASE_PENDING("[SceneTree][TileMap][Benchmark] Load a 1M cells map") {
+	int source_id = 0;
+	Ref<TileSet> tile_set = create_tile_set(source_id);
+
+	const int size = 1000;
+	TileMap *tile_map = memnew(TileMap);
+	tile_map->set_tileset(tile_set);
+	Vector<int> legacy;
+	legacy.resize(size * size * 3);
+	uint8_t *ptr = (uint8_t *)legacy.ptrw();
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			// Patches of tiles, like a generated terrain would have.
+			Vector2i atlas_coords((x / 7 + y / 5) & 1, 0);
+			tile_map->set_cell(0, Vector2i(x, y), source_id, atlas_coords);
+
+			encode_uint16(x, &ptr[0]);
+			encode_uint16(y, &ptr[2]);
+			encode_uint16(source_id, &ptr[4]);
+			encode_uint16(atlas_coords.x, &ptr[6]);
+			encode_uint16(atlas_coords.y, &ptr[8]);
+			encode_uint16(0, &ptr[10]);
+			ptr += 12;
+		}
+	}
+
+	Vector<uint8_t> compressed = tile_map->get("layer_0/tile_data");
+	MESSAGE(vformat("Layer data: %d bytes compressed, %d bytes uncompressed.", compressed.size(), legacy.size() * 4));
+
+	TileMap *loaded = memnew(TileMap);
+	loaded->set_tileset(tile_set);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	loaded->set("format", 3);
+	loaded->set("layer_0/tile_data", legacy);
+	MESSAGE(vformat("Set uncompressed layer data in %.3f ms.", (OS::get_singleton()->get_ticks_usec() - begin) / 1000.0));
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	loaded->set("format", 4);
+	loaded->set("layer_0/tile_data", compressed);
+	MESSAGE(vformat("Set compressed layer data in %.3f ms.", (OS::get_singleton()->get_ticks_usec() - begin) / 1000.0));
+	CHECK(loaded->get_used_cells(0).size() == size * size);
+	memdelete(loaded);
+
+	Ref<PackedScene> scene;
+	scene.instantiate();
+	scene->pack(tile_map);
+	memdelete(tile_map);
+
+	for (const String &extension : { String("tscn"), String("scn") }) {
+		const String path = OS::get_singleton()->get_cache_path().path_join("test_tile_map_benchmark." + extension);
+		REQUIRE(ResourceSaver::save(scene, path) == OK);
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		Ref<PackedScene> loaded_scene = ResourceLoader::load(path, "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+		REQUIRE(loaded_scene.is_valid());
+		TileMap *instance = Object::cast_to<TileMap>(loaded_scene->instantiate());
+		double elapsed = (OS::get_singleton()->get_ticks_usec() - begin) / 1000.0;
+
+		REQUIRE(instance != nullptr);
+		CHECK(instance->get_used_cells(0).size() == size * size);
+		MESSAGE(vformat("Loaded and instantiated the .%s scene (%d bytes) in %.3f ms.", extension, FileAccess::get_file_as_bytes(path).size(), elapsed));
+
+		memdelete(instance);
+		DirAccess::remove_absolute(path);
+	}
+}
+
+} // namespace TestTileMap
+
+#endif // TEST_TILE_MAP_H
@@ -0,0 +1,280 @@
+/**************************************************************************/
+/*  test_broad_phase_2d.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_BROAD_PHASE_2D_H
+#define TEST_BROAD_PHASE_2D_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "core/templates/hash_set.h"
+#include "servers/physics_2d/godot_body_2d.h"
+#include "servers/physics_2d/godot_broad_phase_2d_bvh.h"
+#include "servers/physics_2d/godot_broad_phase_2d_hash_grid.h"
+
+#include "tests/test_macros.h"
+
+namespace TestBroadPhase2D {
+
+// Objects use their index as subindex, so pairs can be identified without the owners.
+struct BroadPhaseScene {
+	GodotBroadPhase2D *broad_phase = nullptr;
+	LocalVector<GodotBody2D *> bodies;
+	LocalVector<GodotBroadPhase2D::ID> ids;
+	LocalVector<Rect2> aabbs;
+	LocalVector<bool> statics;
+	HashSet<uint64_t> pairs;
+
+	static uint64_t get_pair_key(int p_a, int p_b) {
+		return p_a < p_b ? ((uint64_t(p_a) << 32) | uint32_t(p_b)) : ((uint64_t(p_b) << 32) | uint32_t(p_a));
+	}
+
+	static void *pair_callback(GodotCollisionObject2D *p_a, int p_subindex_a, GodotCollisionObject2D *p_b, int p_subindex_b, void *p_self) {
+		static_cast<BroadPhaseScene *>(p_self)->pairs.insert(get_pair_key(p_subindex_a, p_subindex_b));
+		return nullptr;
+	}
+
+	static void unpair_callback(GodotCollisionObject2D *p_a, int p_subindex_a, GodotCollisionObject2D *p_b, int p_subindex_b, void *p_data, void *p_self) {
+		static_cast<BroadPhaseScene *>(p_self)->pairs.erase(get_pair_key(p_subindex_a, p_subindex_b));
+	}
+
+	void init(GodotBroadPhase2D *p_broad_phase) {
+		broad_phase = p_broad_phase;
+		broad_phase->set_pair_callback(pair_callback, this);
+		broad_phase->set_unpair_callback(unpair_callback, this);
+	}
+
+	void add(const Rect2 &p_aabb, bool p_static) {
+		GodotBody2D *body = memnew(GodotBody2D);
+		int index = bodies.size();
+		bodies.push_back(body);
+		ids.push_back(broad_phase->create(body, index, p_aabb, p_static));
+		aabbs.push_back(p_aabb);
+		statics.push_back(p_static);
+	}
+
+	void move(int p_index, const Rect2 &p_aabb) {
+		aabbs[p_index] = p_aabb;
+		broad_phase->move(ids[p_index], p_aabb);
+	}
+
+	~BroadPhaseScene() {
+		for (uint32_t i = 0; i < ids.size(); i++) {
+			broad_phase->remove(ids[i]);
+		}
+		for (GodotBody2D *body : bodies) {
+			memdelete(body);
+		}
+		memdelete(broad_phase);
+	}
+};
+
+// Small, medium and a few huge objects spread over a large area.
+static void add_mixed_objects(BroadPhaseScene &r_scene, RandomPCG &r_rng, int p_count, real_t p_world_size) {
+	for (int i = 0; i < p_count; i++) {
+		real_t size;
+		if (i % 100 == 0) {
+			size = r_rng.random(1000.0f, 3000.0f);
+		} else if (i % 10 == 0) {
+			size = r_rng.random(50.0f, 200.0f);
+		} else {
+			size = r_rng.random(4.0f, 16.0f);
+		}
+		Vector2 position(r_rng.random(-p_world_size, p_world_size), r_rng.random(-p_world_size, p_world_size));
+		r_scene.add(Rect2(position, Vector2(size, size * 0.5)), i % 10 == 5);
+	}
+}
+
+static void check_pairs(const BroadPhaseScene &p_scene) {
+	int expected_count = 0;
+	int missing_count = 0;
+	for (uint32_t i = 0; i < p_scene.aabbs.size(); i++) {
+		for (uint32_t j = i + 1; j < p_scene.aabbs.size(); j++) {
+			if ((p_scene.statics[i] && p_scene.statics[j]) || !p_scene.aabbs[i].intersects(p_scene.aabbs[j])) {
+				continue;
+			}
+			expected_count++;
+			if (!p_scene.pairs.has(BroadPhaseScene::get_pair_key(i, j))) {
+				missing_count++;
+			}
+		}
+	}
+	CHECK_MESSAGE(missing_count == 0, "All the overlapping objects should be paired.");
+	CHECK_MESSAGE((int)p_scene.pairs.size() == expected_count, "Only the overlapping objects should be paired.");
+}
+
+static void check_culls(BroadPhaseScene &p_scene, RandomPCG &r_rng, real_t p_world_size) {
+	const int max_results = 4096;
+	LocalVector<GodotCollisionObject2D *> results;
+	LocalVector<int> indices;
+	results.resize(max_results);
+	indices.resize(max_results);
+
+	for (int query = 0; query < 20; query++) {
+		Vector2 from(r_rng.random(-p_world_size, p_world_size), r_rng.random(-p_world_size, p_world_size));
+		Vector2 to(r_rng.random(-p_world_size, p_world_size), r_rng.random(-p_world_size, p_world_size));
+		Rect2 rect = Rect2(from, Vector2()).expand(to);
+
+		int expected_aabb = 0;
+		int expected_segment = 0;
+		for (const Rect2 &aabb : p_scene.aabbs) {
+			expected_aabb += aabb.intersects(rect) ? 1 : 0;
+			expected_segment += aabb.intersects_segment(from, to) ? 1 : 0;
+		}
+
+		int aabb_count = p_scene.broad_phase->cull_aabb(rect, results.ptr(), max_results, indices.ptr());
+		CHECK_MESSAGE(aabb_count == expected_aabb, "AABB queries should report each overlapping object once.");
+		for (int i = 0; i < aabb_count; i++) {
+			CHECK(p_scene.aabbs[indices[i]].intersects(rect));
+		}
+
+		int segment_count = p_scene.broad_phase->cull_segment(from, to, results.ptr(), max_results, indices.ptr());
+		CHECK_MESSAGE(segment_count == expected_segment, "Segment queries should report each crossed object once.");
+	}
+}
+
+TEST_CASE("[PhysicsServer2D][BroadPhase] Hash grid pairs and queries") {
+	const real_t world_size = 2000.0;
+	RandomPCG rng(42);
+
+	BroadPhaseScene scene;
+	scene.init(memnew(GodotBroadPhase2DHashGrid(64.0, 256)));
+	add_mixed_objects(scene, rng, 1000, world_size);
+	scene.broad_phase->update();
+
+	SUBCASE("Created objects") {
+		check_pairs(scene);
+		check_culls(scene, rng, world_size);
+	}
+
+	SUBCASE("Moved and teleported objects") {
+		for (uint32_t i = 0; i < scene.aabbs.size(); i++) {
+			if (scene.statics[i]) {
+				continue;
+			}
+			Vector2 offset = i % 7 == 0 ? Vector2(rng.random(-world_size, world_size), 0) : Vector2(rng.random(-20.0f, 20.0f), rng.random(-20.0f, 20.0f));
+			scene.move(i, Rect2(scene.aabbs[i].position + offset, scene.aabbs[i].size));
+		}
+		scene.broad_phase->update();
+
+		check_pairs(scene);
+		check_culls(scene, rng, world_size);
+	}
+
+	SUBCASE("Removed objects") {
+		for (uint32_t i = 0; i < scene.ids.size(); i += 3) {
+			scene.broad_phase->remove(scene.ids[i]);
+		}
+		// Keep the remaining objects in the scene and move the removed ones out of the way of the checks.
+		for (uint32_t i = 0; i < scene.ids.size(); i += 3) {
+			scene.ids[i] = scene.broad_phase->create(scene.bodies[i], i, Rect2(Vector2(1e6, 1e6 + i * 100.0), Vector2(1, 1)), scene.statics[i]);
+			scene.aabbs[i] = Rect2(Vector2(1e6, 1e6 + i * 100.0), Vector2(1, 1));
+		}
+		scene.broad_phase->update();
+
+		check_pairs(scene);
+	}
+}
+
+TEST_CASE("[PhysicsServer2D][BroadPhase] Hash grid with huge objects and queries") {
+	BroadPhaseScene scene;
+	scene.init(memnew(GodotBroadPhase2DHashGrid(64.0, 256)));
+
+	// Spans far more cells than fit in an int once multiplied, like a world boundary.
+	scene.add(Rect2(Vector2(-1e9, -1e9), Vector2(2e9, 2e9)), true);
+	scene.add(Rect2(Vector2(10, 10), Vector2(8, 8)), false);
+	scene.add(Rect2(Vector2(5e8, -5e8), Vector2(8, 8)), false);
+	scene.broad_phase->update();
+
+	check_pairs(scene);
+
+	// Moving the huge object must keep it out of the cells.
+	scene.move(0, Rect2(Vector2(-2e9, -1e9), Vector2(3e9, 2e9)));
+	scene.broad_phase->update();
+	check_pairs(scene);
+
+	const int max_results = 16;
+	GodotCollisionObject2D *results[max_results];
+	int indices[max_results];
+	int count = scene.broad_phase->cull_aabb(Rect2(Vector2(-1e9, -1e9), Vector2(2e9, 2e9)), results, max_results, indices);
+	CHECK_MESSAGE(count == 3, "A query covering the whole world should report all the objects.");
+	count = scene.broad_phase->cull_aabb(Rect2(Vector2(-1e9, 100), Vector2(2e9, 8)), results, max_results, indices);
+	CHECK_MESSAGE(count == 1, "A thin query should only report the huge object.");
+}
+
+static real_t benchmark_broad_phase(GodotBroadPhase2D *p_broad_phase, int p_count, real_t p_world_size, bool p_mixed_sizes) {
+	const int warmup_steps = 5;
+	const int measured_steps = 60;
+
+	RandomPCG rng(7);
+	BroadPhaseScene scene;
+	scene.init(p_broad_phase);
+
+	LocalVector<Vector2> velocities;
+	for (int i = 0; i < p_count; i++) {
+		real_t size = 8.0;
+		if (p_mixed_sizes) {
+			size = i % 50 == 0 ? rng.random(256.0f, 2048.0f) : rng.random(4.0f, 64.0f);
+		}
+		Vector2 position(rng.random(-p_world_size, p_world_size), rng.random(-p_world_size, p_world_size));
+		scene.add(Rect2(position, Vector2(size, size)), p_mixed_sizes && i % 4 == 0);
+		velocities.push_back(Vector2(rng.random(-8.0f, 8.0f), rng.random(-8.0f, 8.0f)));
+	}
+	scene.broad_phase->update();
+
+	uint64_t begin = 0;
+	for (int step = 0; step < warmup_steps + measured_steps; step++) {
+		if (step == warmup_steps) {
+			begin = OS::get_singleton()->get_ticks_usec();
+		}
+		for (int i = 0; i < p_count; i++) {
+			if (!scene.statics[i]) {
+				scene.move(i, Rect2(scene.aabbs[i].position + velocities[i], scene.aabbs[i].size));
+			}
+		}
+		scene.broad_phase->update();
+	}
+
+	return (OS::get_singleton()->get_ticks_usec() - begin) / (measured_steps * 1000.0);
+}
+
+TEST_CASE_PENDING("[PhysicsServer2D][BroadPhase][Benchmark] BVH and hash grid step time") {
+	// Dense: 20,000 bullets of the same size. Sparse: 5,000 objects of mixed sizes, some static.
+	real_t dense_bvh = benchmark_broad_phase(GodotBroadPhase2DBVH::_create(), 20000, 2000.0, false);
+	real_t dense_grid = benchmark_broad_phase(memnew(GodotBroadPhase2DHashGrid), 20000, 2000.0, false);
+	real_t sparse_bvh = benchmark_broad_phase(GodotBroadPhase2DBVH::_create(), 5000, 20000.0, true);
+	real_t sparse_grid = benchmark_broad_phase(memnew(GodotBroadPhase2DHashGrid), 5000, 20000.0, true);
+
+	MESSAGE(vformat("Dense uniform: BVH %.3f ms, hash grid %.3f ms per step.", dense_bvh, dense_grid));
+	MESSAGE(vformat("Sparse mixed sizes: BVH %.3f ms, hash grid %.3f ms per step.", sparse_bvh, sparse_grid));
+}
+
+} // namespace TestBroadPhase2D
+
+#endif // TEST_BROAD_PHASE_2D_H
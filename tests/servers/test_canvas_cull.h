@@ -0,0 +1,357 @@
+/**************************************************************************/
+/*  test_canvas_cull.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_CANVAS_CULL_H
+#define TEST_CANVAS_CULL_H
+
+#include "core/os/os.h"
+#include "servers/rendering/renderer_canvas_cull.h"
+#include "servers/rendering/rendering_server_globals.h"
+
+#include "tests/test_macros.h"
+
+namespace TestCanvasCull {
+
+// Culls the canvas as a viewport would. The dummy renderer draws nothing, but culled items keep
+// their final transforms and stay linked in draw order through their next pointers.
+static void render_canvas(RID p_canvas, const Transform2D &p_canvas_transform = Transform2D()) {
+	RendererCanvasCull::Canvas *canvas = RSG::canvas->canvas_owner.get_or_null(p_canvas);
+	RSG::canvas->render_canvas(RID(), canvas, p_canvas_transform, nullptr, nullptr, Rect2(0, 0, 1024, 1024), RS::CANVAS_ITEM_TEXTURE_FILTER_LINEAR, RS::CANVAS_ITEM_TEXTURE_REPEAT_DISABLED, false, false, 0xFFFFFFFF);
+}
+
+static RID create_item(RID p_parent, const Vector2 &p_position) {
+	RID item = RS::get_singleton()->canvas_item_create();
+	RS::get_singleton()->canvas_item_set_parent(item, p_parent);
+	RS::get_singleton()->canvas_item_set_transform(item, Transform2D(0, p_position));
+	RS::get_singleton()->canvas_item_add_rect(item, Rect2(0, 0, 8, 8), Color(1, 1, 1));
+	return item;
+}
+
+static Vector2 get_final_origin(RID p_item) {
+	return RSG::canvas->canvas_item_owner.get_or_null(p_item)->final_transform.get_origin();
+}
+
+TEST_CASE("[SceneTree][CanvasCull] Cached global transforms follow parent and item changes") {
+	RID canvas = RS::get_singleton()->canvas_create();
+	RID parent = create_item(canvas, Vector2(100, 0));
+	RID child = create_item(parent, Vector2(10, 5));
+
+	render_canvas(canvas);
+	CHECK(get_final_origin(child).is_equal_approx(Vector2(110, 5)));
+
+	// Nothing changed, the cached transform is reused.
+	render_canvas(canvas);
+	CHECK(get_final_origin(child).is_equal_approx(Vector2(110, 5)));
+
+	RS::get_singleton()->canvas_item_set_transform(parent, Transform2D(0, Vector2(200, 0)));
+	render_canvas(canvas);
+	CHECK(get_final_origin(parent).is_equal_approx(Vector2(200, 0)));
+	CHECK(get_final_origin(child).is_equal_approx(Vector2(210, 5)));
+
+	RS::get_singleton()->canvas_item_set_transform(child, Transform2D(0, Vector2(20, 0)));
+	render_canvas(canvas);
+	CHECK(get_final_origin(child).is_equal_approx(Vector2(220, 0)));
+
+	// Scrolling the camera only changes the final transforms, the canvas space ones are kept.
+	uint64_t parent_version = RSG::canvas->canvas_item_owner.get_or_null(parent)->cull_cache.version;
+	uint64_t child_version = RSG::canvas->canvas_item_owner.get_or_null(child)->cull_cache.version;
+	render_canvas(canvas, Transform2D(0, Vector2(-50, 30)));
+	CHECK(get_final_origin(parent).is_equal_approx(Vector2(150, 30)));
+	CHECK(get_final_origin(child).is_equal_approx(Vector2(170, 30)));
+	CHECK(RSG::canvas->canvas_item_owner.get_or_null(parent)->cull_cache.version == parent_version);
+	CHECK(RSG::canvas->canvas_item_owner.get_or_null(child)->cull_cache.version == child_version);
+
+	// A parent moved while its child is hidden still moves the child once it is shown again.
+	RS::get_singleton()->canvas_item_set_visible(child, false);
+	render_canvas(canvas);
+	RS::get_singleton()->canvas_item_set_transform(parent, Transform2D(0, Vector2(300, 0)));
+	render_canvas(canvas);
+	RS::get_singleton()->canvas_item_set_visible(child, true);
+	render_canvas(canvas);
+	CHECK(get_final_origin(child).is_equal_approx(Vector2(320, 0)));
+
+	RS::get_singleton()->free(child);
+	RS::get_singleton()->free(parent);
+	RS::get_singleton()->free(canvas);
+}
+
+TEST_CASE("[SceneTree][CanvasCull] Large sibling lists keep z and tree order") {
+	RID canvas = RS::get_singleton()->canvas_create();
+	RID root = RS::get_singleton()->canvas_item_create();
+	RS::get_singleton()->canvas_item_set_parent(root, canvas);
+
+	// Enough children for the cull to be split across threads.
+	const int item_count = 4000;
+	LocalVector<RID> items;
+	for (int i = 0; i < item_count; i++) {
+		RID item = create_item(root, Vector2(i % 100, i / 100) * 10);
+		RS::get_singleton()->canvas_item_set_z_index(item, i % 3);
+		items.push_back(item);
+	}
+
+	render_canvas(canvas);
+
+	// Expect every z = 0 item in tree order, then z = 1, then z = 2.
+	RendererCanvasRender::Item *current = RSG::canvas->canvas_item_owner.get_or_null(items[0]);
+	int visited = 0;
+	bool ordered = true;
+	for (int z = 0; z < 3; z++) {
+		for (int i = z; i < item_count; i += 3) {
+			if (current != RSG::canvas->canvas_item_owner.get_or_null(items[i])) {
+				ordered = false;
+				break;
+			}
+			current = current->next;
+			visited++;
+		}
+	}
+	CHECK(ordered);
+	CHECK(visited == item_count);
+	CHECK(current == nullptr);
+
+	for (const RID &item : items) {
+		RS::get_singleton()->free(item);
+	}
+	RS::get_singleton()->free(root);
+	RS::get_singleton()->free(canvas);
+}
+
+TEST_CASE("[SceneTree][CanvasCull] Static items outside the view are skipped in draw order") {
+	RID canvas = RS::get_singleton()->canvas_create();
+	RID root = RS::get_singleton()->canvas_item_create();
+	RS::get_singleton()->canvas_item_set_parent(root, canvas);
+	RS::get_singleton()->canvas_item_set_sort_children_by_y(root, true);
+
+	// Even items are on screen, odd ones far to the right. Y decreases with the index, so
+	// y-sorting reverses tree order within each z index.
+	const int item_count = 20;
+	LocalVector<RID> items;
+	for (int i = 0; i < item_count; i++) {
+		RID item = create_item(root, Vector2(i % 2 == 0 ? i * 10 : 5000 + i, 100 - i));
+		RS::get_singleton()->canvas_item_set_z_index(item, i % 4 == 0 ? 0 : 1);
+		RS::get_singleton()->canvas_item_set_static(item, true);
+		items.push_back(item);
+	}
+
+	render_canvas(canvas);
+
+	const int expected_on_screen[] = { 16, 12, 8, 4, 0, 18, 14, 10, 6, 2 };
+	RendererCanvasRender::Item *current = RSG::canvas->canvas_item_owner.get_or_null(items[16]);
+	bool ordered = true;
+	for (int index : expected_on_screen) {
+		if (current != RSG::canvas->canvas_item_owner.get_or_null(items[index])) {
+			ordered = false;
+			break;
+		}
+		current = current->next;
+	}
+	CHECK(ordered);
+	CHECK(current == nullptr);
+
+	// Skipped items were never culled, so their cached transforms are still dirty.
+	bool skipped = true;
+	for (int i = 1; i < item_count; i += 2) {
+		skipped = skipped && RSG::canvas->canvas_item_owner.get_or_null(items[i])->cull_cache.dirty;
+	}
+	CHECK(skipped);
+
+	// Moving the parent moves the indexed rects of its static children.
+	RS::get_singleton()->canvas_item_set_transform(root, Transform2D(0, Vector2(-5000, 0)));
+	render_canvas(canvas);
+
+	current = RSG::canvas->canvas_item_owner.get_or_null(items[19]);
+	ordered = true;
+	for (int i = item_count - 1; i > 0; i -= 2) {
+		if (current != RSG::canvas->canvas_item_owner.get_or_null(items[i])) {
+			ordered = false;
+			break;
+		}
+		current = current->next;
+	}
+	CHECK(ordered);
+	CHECK(current == nullptr);
+	CHECK(get_final_origin(items[1]).is_equal_approx(Vector2(1, 99)));
+
+	for (const RID &item : items) {
+		RS::get_singleton()->free(item);
+	}
+	RS::get_singleton()->free(root);
+	RS::get_singleton()->free(canvas);
+}
+
+// Walks the draw list from the item with the lowest Y and checks every item is drawn once, by increasing Y.
+static bool is_drawn_in_y_order(const LocalVector<RID> &p_items, const LocalVector<real_t> &p_y) {
+	uint32_t first = 0;
+	for (uint32_t i = 1; i < p_items.size(); i++) {
+		if (p_y[i] < p_y[first]) {
+			first = i;
+		}
+	}
+
+	RendererCanvasRender::Item *current = RSG::canvas->canvas_item_owner.get_or_null(p_items[first]);
+	uint32_t visited = 0;
+	real_t last_y = -1; // Test items never have a negative Y.
+	while (current) {
+		real_t y = current->final_transform.get_origin().y;
+		if (y <= last_y) {
+			return false;
+		}
+		last_y = y;
+		visited++;
+		current = current->next;
+	}
+	return visited == p_items.size();
+}
+
+TEST_CASE("[SceneTree][CanvasCull] Y-sort stays ordered across small and large reorderings") {
+	RID canvas = RS::get_singleton()->canvas_create();
+	RID root = RS::get_singleton()->canvas_item_create();
+	RS::get_singleton()->canvas_item_set_parent(root, canvas);
+	RS::get_singleton()->canvas_item_set_sort_children_by_y(root, true);
+
+	// Distinct Y values in scrambled tree order.
+	const int item_count = 1000;
+	LocalVector<RID> items;
+	LocalVector<real_t> y;
+	for (int i = 0; i < item_count; i++) {
+		y.push_back((i * 7919) % item_count);
+		items.push_back(create_item(root, Vector2((i % 100) * 10, y[i])));
+	}
+
+	render_canvas(canvas);
+	CHECK(is_drawn_in_y_order(items, y));
+
+	// Every other item passes its neighbor, the order from the last frame is nearly sorted.
+	for (int i = 0; i < item_count; i += 2) {
+		y[i] += 1.5;
+		RS::get_singleton()->canvas_item_set_transform(items[i], Transform2D(0, Vector2((i % 100) * 10, y[i])));
+	}
+	render_canvas(canvas);
+	CHECK(is_drawn_in_y_order(items, y));
+
+	// Reversing everything is too far from the last order to sort incrementally.
+	for (int i = 0; i < item_count; i++) {
+		y[i] = item_count + 10 - y[i];
+		RS::get_singleton()->canvas_item_set_transform(items[i], Transform2D(0, Vector2((i % 100) * 10, y[i])));
+	}
+	render_canvas(canvas);
+	CHECK(is_drawn_in_y_order(items, y));
+
+	// Removing an item changes the set of sorted children.
+	RS::get_singleton()->free(items[0]);
+	items.remove_at_unordered(0);
+	y.remove_at_unordered(0);
+	render_canvas(canvas);
+	CHECK(is_drawn_in_y_order(items, y));
+
+	for (const RID &item : items) {
+		RS::get_singleton()->free(item);
+	}
+	RS::get_singleton()->free(root);
+	RS::get_singleton()->free(canvas);
+}
+
+TEST_CASE_PENDING("[SceneTree][CanvasCull][Benchmark] Cull 100k static and 1k moving items") {
+	RID canvas = RS::get_singleton()->canvas_create();
+	RID root = RS::get_singleton()->canvas_item_create();
+	RS::get_singleton()->canvas_item_set_parent(root, canvas);
+
+	LocalVector<RID> items;
+	for (int i = 0; i < 100000; i++) {
+		items.push_back(create_item(root, Vector2(i % 400, i / 400) * 4));
+	}
+
+	LocalVector<RID> moving;
+	for (int i = 0; i < 1000; i++) {
+		moving.push_back(create_item(root, Vector2(i, 0)));
+	}
+
+	render_canvas(canvas);
+
+	const int frames = 60;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int frame = 0; frame < frames; frame++) {
+		for (uint32_t i = 0; i < moving.size(); i++) {
+			RS::get_singleton()->canvas_item_set_transform(moving[i], Transform2D(0, Vector2(i, frame)));
+		}
+		// The camera follows the moving items, as in most games.
+		render_canvas(canvas, Transform2D(0, Vector2(-frame * 2, 0)));
+	}
+	double elapsed = (OS::get_singleton()->get_ticks_usec() - begin) / 1000.0;
+
+	MESSAGE(vformat("Culled 101,000 items (1,000 moving) with a scrolling camera in %.3f ms per frame.", elapsed / frames));
+
+	for (const RID &item : items) {
+		RS::get_singleton()->free(item);
+	}
+	for (const RID &item : moving) {
+		RS::get_singleton()->free(item);
+	}
+	RS::get_singleton()->free(root);
+	RS::get_singleton()->free(canvas);
+}
+
+TEST_CASE_PENDING("[SceneTree][CanvasCull][Benchmark] Y-sort 10k moving items") {
+	RID canvas = RS::get_singleton()->canvas_create();
+	RID root = RS::get_singleton()->canvas_item_create();
+	RS::get_singleton()->canvas_item_set_parent(root, canvas);
+	RS::get_singleton()->canvas_item_set_sort_children_by_y(root, true);
+
+	LocalVector<RID> items;
+	for (int i = 0; i < 10000; i++) {
+		items.push_back(create_item(root, Vector2(i % 100, i / 100) * 10));
+	}
+
+	render_canvas(canvas);
+
+	const int frames = 60;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int frame = 0; frame < frames; frame++) {
+		// Actors wander a few pixels per frame.
+		for (uint32_t i = 0; i < items.size(); i++) {
+			Vector2 position = Vector2(i % 100, i / 100) * 10 + Vector2(0, Math::sin(frame * 0.1 + i) * 20);
+			RS::get_singleton()->canvas_item_set_transform(items[i], Transform2D(0, position));
+		}
+		render_canvas(canvas);
+	}
+	double elapsed = (OS::get_singleton()->get_ticks_usec() - begin) / 1000.0;
+
+	MESSAGE(vformat("Culled 10,000 moving y-sorted items in %.3f ms per frame.", elapsed / frames));
+
+	for (const RID &item : items) {
+		RS::get_singleton()->free(item);
+	}
+	RS::get_singleton()->free(root);
+	RS::get_singleton()->free(canvas);
+}
+
+} // namespace TestCanvasCull
+
+#endif // TEST_CANVAS_CULL_H
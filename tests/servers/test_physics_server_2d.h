@@ -0,0 +1,689 @@
+/**************************************************************************/
+/*  test_physics_server_2d.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_PHYSICS_SERVER_2D_H
+#define TEST_PHYSICS_SERVER_2D_H
+
+#include "core/os/os.h"
+#include "servers/physics_server_2d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsServer2D {
+
+struct TestScene {
+	RID space;
+	RID ground_shape;
+	RID box_shape;
+	RID ground;
+	LocalVector<RID> bodies;
+};
+
+static RID create_space() {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	RID space = ps->space_create();
+	ps->area_set_param(space, PhysicsServer2D::AREA_PARAM_GRAVITY, 980.0);
+	ps->area_set_param(space, PhysicsServer2D::AREA_PARAM_GRAVITY_VECTOR, Vector2(0, 1));
+	ps->space_set_active(space, true);
+	return space;
+}
+
+// Builds a pyramid of boxes resting on a static ground, the whole pyramid is a single island.
+static void create_pyramid(TestScene &r_scene, int p_rows, real_t p_box_size = 16.0) {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	r_scene.space = create_space();
+
+	r_scene.ground_shape = ps->rectangle_shape_create();
+	ps->shape_set_data(r_scene.ground_shape, Vector2(p_rows * p_box_size, p_box_size * 0.5));
+	r_scene.ground = ps->body_create();
+	ps->body_set_mode(r_scene.ground, PhysicsServer2D::BODY_MODE_STATIC);
+	ps->body_add_shape(r_scene.ground, r_scene.ground_shape);
+	ps->body_set_state(r_scene.ground, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(0, p_box_size * 0.5)));
+	ps->body_set_space(r_scene.ground, r_scene.space);
+
+	r_scene.box_shape = ps->rectangle_shape_create();
+	ps->shape_set_data(r_scene.box_shape, Vector2(p_box_size * 0.5, p_box_size * 0.5));
+
+	for (int row = 0; row < p_rows; row++) {
+		int count = p_rows - row;
+		real_t y = -(row + 0.5) * p_box_size;
+		for (int i = 0; i < count; i++) {
+			real_t x = (i - (count - 1) * 0.5) * p_box_size;
+			RID body = ps->body_create();
+			ps->body_set_mode(body, PhysicsServer2D::BODY_MODE_RIGID);
+			ps->body_add_shape(body, r_scene.box_shape);
+			ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(x, y)));
+			ps->body_set_space(body, r_scene.space);
+			r_scene.bodies.push_back(body);
+		}
+	}
+}
+
+// Builds a grid of separate boxes falling on a static ground.
+static void create_box_grid(TestScene &r_scene, int p_columns, int p_rows, real_t p_box_size = 8.0, real_t p_spacing = 16.0) {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	r_scene.space = create_space();
+
+	r_scene.ground_shape = ps->rectangle_shape_create();
+	ps->shape_set_data(r_scene.ground_shape, Vector2(p_columns * p_spacing, p_box_size));
+	r_scene.ground = ps->body_create();
+	ps->body_set_mode(r_scene.ground, PhysicsServer2D::BODY_MODE_STATIC);
+	ps->body_add_shape(r_scene.ground, r_scene.ground_shape);
+	ps->body_set_state(r_scene.ground, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(0, p_box_size)));
+	ps->body_set_space(r_scene.ground, r_scene.space);
+
+	r_scene.box_shape = ps->rectangle_shape_create();
+	ps->shape_set_data(r_scene.box_shape, Vector2(p_box_size * 0.5, p_box_size * 0.5));
+
+	for (int row = 0; row < p_rows; row++) {
+		for (int column = 0; column < p_columns; column++) {
+			RID body = ps->body_create();
+			ps->body_set_mode(body, PhysicsServer2D::BODY_MODE_RIGID);
+			ps->body_add_shape(body, r_scene.box_shape);
+			Vector2 position((column - (p_columns - 1) * 0.5) * p_spacing, -(row + 1) * p_spacing);
+			ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, position));
+			ps->body_set_space(body, r_scene.space);
+			r_scene.bodies.push_back(body);
+		}
+	}
+}
+
+static void free_scene(TestScene &r_scene) {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	for (const RID &body : r_scene.bodies) {
+		ps->free(body);
+	}
+	r_scene.bodies.clear();
+	ps->free(r_scene.ground);
+	ps->free(r_scene.box_shape);
+	ps->free(r_scene.ground_shape);
+	ps->free(r_scene.space);
+}
+
+static void step_scene(int p_steps, real_t p_delta = 1.0 / 60.0) {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	for (int i = 0; i < p_steps; i++) {
+		ps->flush_queries();
+		ps->step(p_delta);
+	}
+}
+
+static Vector2 get_body_position(RID p_body) {
+	Transform2D xform = PhysicsServer2D::get_singleton()->body_get_state(p_body, PhysicsServer2D::BODY_STATE_TRANSFORM);
+	return xform.get_origin();
+}
+
+TEST_CASE("[SceneTree][PhysicsServer2D] Solver space parameters") {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	RID space = create_space();
+
+	CHECK(ps->space_get_param(space, PhysicsServer2D::SPACE_PARAM_SOLVER_GRAPH_COLORING) == 0.0);
+	ps->space_set_param(space, PhysicsServer2D::SPACE_PARAM_SOLVER_GRAPH_COLORING, 1.0);
+	CHECK(ps->space_get_param(space, PhysicsServer2D::SPACE_PARAM_SOLVER_GRAPH_COLORING) == 1.0);
+
+	CHECK(ps->space_get_param(space, PhysicsServer2D::SPACE_PARAM_SOLVER_PACKED_CONTACTS) == 0.0);
+	ps->space_set_param(space, PhysicsServer2D::SPACE_PARAM_SOLVER_PACKED_CONTACTS, 1.0);
+	CHECK(ps->space_get_param(space, PhysicsServer2D::SPACE_PARAM_SOLVER_PACKED_CONTACTS) == 1.0);
+
+	CHECK(ps->space_get_param(space, PhysicsServer2D::SPACE_PARAM_SOLVER_MAX_THREADS) == 0.0);
+	ps->space_set_param(space, PhysicsServer2D::SPACE_PARAM_SOLVER_MAX_THREADS, 4.0);
+	CHECK(ps->space_get_param(space, PhysicsServer2D::SPACE_PARAM_SOLVER_MAX_THREADS) == 4.0);
+	ps->space_set_param(space, PhysicsServer2D::SPACE_PARAM_SOLVER_MAX_THREADS, -1.0);
+	CHECK_MESSAGE(ps->space_get_param(space, PhysicsServer2D::SPACE_PARAM_SOLVER_MAX_THREADS) == 0.0, "Negative thread counts should fall back to all threads.");
+
+	CHECK(ps->space_get_param(space, PhysicsServer2D::SPACE_PARAM_CONTACT_CACHE_STEPS) == 0.0);
+	ps->space_set_param(space, PhysicsServer2D::SPACE_PARAM_CONTACT_CACHE_STEPS, 8.0);
+	CHECK(ps->space_get_param(space, PhysicsServer2D::SPACE_PARAM_CONTACT_CACHE_STEPS) == 8.0);
+
+	ps->free(space);
+}
+
+TEST_CASE("[SceneTree][PhysicsServer2D] Graph coloring keeps a large island stable") {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	const int rows = 30;
+
+	TestScene serial_scene;
+	create_pyramid(serial_scene, rows);
+	step_scene(30);
+	Vector2 serial_top = get_body_position(serial_scene.bodies[serial_scene.bodies.size() - 1]);
+	free_scene(serial_scene);
+
+	TestScene colored_scene;
+	create_pyramid(colored_scene, rows);
+	ps->space_set_param(colored_scene.space, PhysicsServer2D::SPACE_PARAM_SOLVER_GRAPH_COLORING, 1.0);
+	step_scene(30);
+	Vector2 colored_top = get_body_position(colored_scene.bodies[colored_scene.bodies.size() - 1]);
+	free_scene(colored_scene);
+
+	CHECK_MESSAGE(colored_top.is_finite(), "The colored solver should not produce invalid transforms.");
+	CHECK_MESSAGE(Math::abs(colored_top.x - serial_top.x) < 4.0, "The top of the pyramid should not drift sideways compared to the serial solver.");
+	CHECK_MESSAGE(Math::abs(colored_top.y - serial_top.y) < 4.0, "The top of the pyramid should settle like with the serial solver.");
+}
+
+static LocalVector<Vector2> simulate_packed_contacts(TestScene &r_scene, bool p_packed, int p_steps) {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	// Graph coloring is forced on, so both solvers process the constraints in the same order.
+	ps->space_set_param(r_scene.space, PhysicsServer2D::SPACE_PARAM_SOLVER_GRAPH_COLORING, 1.0);
+	ps->space_set_param(r_scene.space, PhysicsServer2D::SPACE_PARAM_SOLVER_PACKED_CONTACTS, p_packed ? 1.0 : 0.0);
+	step_scene(p_steps);
+
+	LocalVector<Vector2> positions;
+	for (const RID &body : r_scene.bodies) {
+		positions.push_back(get_body_position(body));
+	}
+	free_scene(r_scene);
+	return positions;
+}
+
+static real_t get_max_distance(const LocalVector<Vector2> &p_a, const LocalVector<Vector2> &p_b) {
+	real_t max_distance = 0.0;
+	for (uint32_t i = 0; i < p_a.size(); i++) {
+		max_distance = MAX(max_distance, p_a[i].distance_to(p_b[i]));
+	}
+	return max_distance;
+}
+
+TEST_CASE("[SceneTree][PhysicsServer2D] Packed contacts match scalar contacts") {
+	SUBCASE("Large island") {
+		TestScene scalar_scene;
+		create_pyramid(scalar_scene, 24);
+		LocalVector<Vector2> scalar_positions = simulate_packed_contacts(scalar_scene, false, 30);
+
+		TestScene packed_scene;
+		create_pyramid(packed_scene, 24);
+		LocalVector<Vector2> packed_positions = simulate_packed_contacts(packed_scene, true, 30);
+
+		REQUIRE(packed_positions.size() == scalar_positions.size());
+		CHECK_MESSAGE(get_max_distance(packed_positions, scalar_positions) < 0.01, "Packed contacts should move the bodies like scalar contacts.");
+	}
+
+	SUBCASE("Many small islands") {
+		// Each box only touches the ground, the islands are batched together to be packed.
+		TestScene scalar_scene;
+		create_box_grid(scalar_scene, 300, 1);
+		LocalVector<Vector2> scalar_positions = simulate_packed_contacts(scalar_scene, false, 60);
+
+		TestScene packed_scene;
+		create_box_grid(packed_scene, 300, 1);
+		LocalVector<Vector2> packed_positions = simulate_packed_contacts(packed_scene, true, 60);
+
+		REQUIRE(packed_positions.size() == scalar_positions.size());
+		CHECK_MESSAGE(get_max_distance(packed_positions, scalar_positions) < 0.01, "Packed contacts should move the bodies like scalar contacts.");
+		for (const Vector2 &position : packed_positions) {
+			CHECK_MESSAGE(position.y < 0.0, "The boxes should rest on the ground.");
+		}
+	}
+}
+
+// Lifts a box resting on the ground for one step, puts it back, and returns the impulse of its contacts
+// when it touches the ground again. These impulses are the ones the solver is warm started with.
+static real_t get_repaired_contact_impulse(int p_cache_steps) {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+
+	TestScene scene;
+	create_pyramid(scene, 1);
+	ps->space_set_param(scene.space, PhysicsServer2D::SPACE_PARAM_CONTACT_CACHE_STEPS, p_cache_steps);
+	RID box = scene.bodies[0];
+	ps->body_set_max_contacts_reported(box, 4);
+	step_scene(60);
+
+	Transform2D rest_xform = ps->body_get_state(box, PhysicsServer2D::BODY_STATE_TRANSFORM);
+
+	// Moving the box away unpairs it from the ground, its contacts go to the cache.
+	ps->body_set_state(box, PhysicsServer2D::BODY_STATE_TRANSFORM, rest_xform.translated(Vector2(0, -1000)));
+	step_scene(1);
+	CHECK(ps->body_get_direct_state(box)->get_contact_count() == 0);
+
+	ps->body_set_state(box, PhysicsServer2D::BODY_STATE_TRANSFORM, rest_xform);
+	ps->body_set_state(box, PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY, Vector2());
+	step_scene(1);
+
+	PhysicsDirectBodyState2D *state = ps->body_get_direct_state(box);
+	real_t impulse = 0.0;
+	for (int i = 0; i < state->get_contact_count(); i++) {
+		impulse += state->get_contact_impulse(i).length();
+	}
+	CHECK(state->get_contact_count() > 0);
+
+	step_scene(10);
+	Vector2 position = get_body_position(box);
+	CHECK_MESSAGE(position.is_finite(), "Contacts should not produce invalid transforms.");
+	CHECK_MESSAGE(position.distance_to(rest_xform.get_origin()) < 1.0, "The box should keep resting on the ground.");
+
+	free_scene(scene);
+	return impulse;
+}
+
+TEST_CASE("[SceneTree][PhysicsServer2D] Contact cache restores pairs that come back") {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+
+	SUBCASE("Restored contacts are warm started") {
+		CHECK_MESSAGE(get_repaired_contact_impulse(0) == doctest::Approx(0.0), "New contacts should start without impulses.");
+		// The box is held by about one step of gravity.
+		CHECK_MESSAGE(get_repaired_contact_impulse(4) > 980.0 / 60.0 * 0.5, "Restored contacts should start with their previous impulses.");
+	}
+
+	SUBCASE("Removed bodies are not cached") {
+		TestScene scene;
+		create_pyramid(scene, 1);
+		ps->space_set_param(scene.space, PhysicsServer2D::SPACE_PARAM_CONTACT_CACHE_STEPS, 4.0);
+		step_scene(60);
+
+		Vector<uint8_t> resting_snapshot;
+		ps->space_save_snapshot(scene.space, resting_snapshot);
+
+		// The pair of the box and the ground is destroyed with the box, without a cached manifold
+		// the snapshot only holds the ground, like after clearing the cache.
+		ps->free(scene.bodies[0]);
+		scene.bodies.clear();
+		Vector<uint8_t> snapshot;
+		ps->space_save_snapshot(scene.space, snapshot);
+		ps->space_set_param(scene.space, PhysicsServer2D::SPACE_PARAM_CONTACT_CACHE_STEPS, 0.0);
+		Vector<uint8_t> uncached_snapshot;
+		ps->space_save_snapshot(scene.space, uncached_snapshot);
+
+		CHECK(snapshot.size() < resting_snapshot.size());
+		CHECK(snapshot.size() == uncached_snapshot.size());
+
+		free_scene(scene);
+	}
+
+	SUBCASE("Pairs that don't come back in time are forgotten") {
+		TestScene scene;
+		create_pyramid(scene, 1);
+		ps->space_set_param(scene.space, PhysicsServer2D::SPACE_PARAM_CONTACT_CACHE_STEPS, 4.0);
+		RID box = scene.bodies[0];
+		step_scene(60);
+
+		Transform2D rest_xform = ps->body_get_state(box, PhysicsServer2D::BODY_STATE_TRANSFORM);
+		ps->body_set_state(box, PhysicsServer2D::BODY_STATE_TRANSFORM, rest_xform.translated(Vector2(0, -1000)));
+		step_scene(1);
+		Vector<uint8_t> cached_snapshot;
+		ps->space_save_snapshot(scene.space, cached_snapshot);
+
+		step_scene(5);
+		Vector<uint8_t> expired_snapshot;
+		ps->space_save_snapshot(scene.space, expired_snapshot);
+		ps->space_set_param(scene.space, PhysicsServer2D::SPACE_PARAM_CONTACT_CACHE_STEPS, 0.0);
+		Vector<uint8_t> uncached_snapshot;
+		ps->space_save_snapshot(scene.space, uncached_snapshot);
+
+		CHECK(expired_snapshot.size() < cached_snapshot.size());
+		CHECK(expired_snapshot.size() == uncached_snapshot.size());
+
+		free_scene(scene);
+	}
+}
+
+TEST_CASE("[SceneTree][PhysicsServer2D] Batched broadphase moves pair bodies with the ground") {
+	// Enough moving bodies for the broadphase to move and refit them on several threads.
+	TestScene scene;
+	create_box_grid(scene, 64, 16);
+	step_scene(90);
+
+	int fallen_through = 0;
+	for (const RID &body : scene.bodies) {
+		if (get_body_position(body).y > 0.0) {
+			fallen_through++;
+		}
+	}
+	free_scene(scene);
+
+	CHECK_MESSAGE(fallen_through == 0, "All the boxes should land on the ground.");
+}
+
+TEST_CASE("[SceneTree][PhysicsServer2D] Batched queries match single queries") {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	TestScene scene;
+	create_box_grid(scene, 32, 8);
+	step_scene(1);
+
+	PhysicsDirectSpaceState2D *space_state = ps->space_get_direct_state(scene.space);
+	REQUIRE(space_state != nullptr);
+
+	const int query_count = 256;
+	LocalVector<PhysicsDirectSpaceState2D::RayParameters> rays;
+	rays.resize(query_count);
+	for (int i = 0; i < query_count; i++) {
+		// Vertical rays through the columns, and diagonal rays crossing the whole grid.
+		real_t x = (i - query_count * 0.5) * 2.0;
+		rays[i].from = Vector2(x, -200);
+		rays[i].to = i % 2 ? Vector2(x, 50) : Vector2(-x, 50);
+	}
+
+	RID circle_shape = ps->circle_shape_create();
+	ps->shape_set_data(circle_shape, 3.0);
+	LocalVector<PhysicsDirectSpaceState2D::ShapeParameters> casts;
+	casts.resize(query_count);
+	for (int i = 0; i < query_count; i++) {
+		casts[i].shape_rid = circle_shape;
+		casts[i].transform = Transform2D(0, Vector2((i - query_count * 0.5) * 2.0, -200));
+		casts[i].motion = Vector2(i % 3 - 1, 1) * 250.0;
+	}
+
+	for (int use_threads = 0; use_threads < 2; use_threads++) {
+		LocalVector<PhysicsDirectSpaceState2D::RayResult> ray_results;
+		LocalVector<bool> collided;
+		ray_results.resize(query_count);
+		collided.resize(query_count);
+		space_state->intersect_ray_batch(rays.ptr(), query_count, ray_results.ptr(), collided.ptr(), use_threads);
+
+		int ray_mismatch_count = 0;
+		int hit_count = 0;
+		for (int i = 0; i < query_count; i++) {
+			PhysicsDirectSpaceState2D::RayResult result;
+			bool hit = space_state->intersect_ray(rays[i], result);
+			hit_count += hit ? 1 : 0;
+			if (hit != collided[i] || (hit && (result.rid != ray_results[i].rid || result.shape != ray_results[i].shape || !result.position.is_equal_approx(ray_results[i].position)))) {
+				ray_mismatch_count++;
+			}
+		}
+		CHECK_MESSAGE(hit_count > query_count / 2, "Most rays should hit a box or the ground.");
+		CHECK_MESSAGE(ray_mismatch_count == 0, "Batched rays should give the same results as single rays.");
+
+		LocalVector<real_t> closest_safe;
+		LocalVector<real_t> closest_unsafe;
+		closest_safe.resize(query_count);
+		closest_unsafe.resize(query_count);
+		space_state->cast_motion_batch(casts.ptr(), query_count, closest_safe.ptr(), closest_unsafe.ptr(), use_threads);
+
+		int cast_mismatch_count = 0;
+		for (int i = 0; i < query_count; i++) {
+			real_t safe = 0.0;
+			real_t unsafe = 0.0;
+			space_state->cast_motion(casts[i], safe, unsafe);
+			if (safe != closest_safe[i] || unsafe != closest_unsafe[i]) {
+				cast_mismatch_count++;
+			}
+		}
+		CHECK_MESSAGE(cast_mismatch_count == 0, "Batched motion casts should give the same results as single casts.");
+
+		// An invalid shape only fails its own query.
+		LocalVector<PhysicsDirectSpaceState2D::ShapeParameters> invalid_casts = casts;
+		invalid_casts[query_count / 2].shape_rid = RID();
+		LocalVector<real_t> invalid_safe;
+		LocalVector<real_t> invalid_unsafe;
+		invalid_safe.resize(query_count);
+		invalid_unsafe.resize(query_count);
+		ERR_PRINT_OFF;
+		space_state->cast_motion_batch(invalid_casts.ptr(), query_count, invalid_safe.ptr(), invalid_unsafe.ptr(), use_threads);
+		ERR_PRINT_ON;
+
+		CHECK(invalid_safe[query_count / 2] == 1.0);
+		CHECK(invalid_unsafe[query_count / 2] == 1.0);
+		int invalid_mismatch_count = 0;
+		for (int i = 0; i < query_count; i++) {
+			if (i != query_count / 2 && (invalid_safe[i] != closest_safe[i] || invalid_unsafe[i] != closest_unsafe[i])) {
+				invalid_mismatch_count++;
+			}
+		}
+		CHECK_MESSAGE(invalid_mismatch_count == 0, "The valid queries of a batch with an invalid shape should still be cast.");
+	}
+
+	ps->free(circle_shape);
+	free_scene(scene);
+}
+
+// Hashes the state of the bodies, two scenes only match if every value is bit identical.
+static uint32_t get_scene_state_hash(const TestScene &p_scene) {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	uint32_t hash = HASH_MURMUR3_SEED;
+	for (const RID &body : p_scene.bodies) {
+		Transform2D xform = ps->body_get_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM);
+		Vector2 linear_velocity = ps->body_get_state(body, PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY);
+		real_t angular_velocity = ps->body_get_state(body, PhysicsServer2D::BODY_STATE_ANGULAR_VELOCITY);
+		for (int i = 0; i < 3; i++) {
+			hash = hash_murmur3_one_real(xform.columns[i].x, hash);
+			hash = hash_murmur3_one_real(xform.columns[i].y, hash);
+		}
+		hash = hash_murmur3_one_real(linear_velocity.x, hash);
+		hash = hash_murmur3_one_real(linear_velocity.y, hash);
+		hash = hash_murmur3_one_real(angular_velocity, hash);
+	}
+	return hash_fmix32(hash);
+}
+
+static uint32_t simulate_deterministic_pyramid(int p_max_threads) {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	TestScene scene;
+	create_pyramid(scene, 24);
+	ps->space_set_param(scene.space, PhysicsServer2D::SPACE_PARAM_SOLVER_DETERMINISTIC, 1);
+	ps->space_set_param(scene.space, PhysicsServer2D::SPACE_PARAM_SOLVER_GRAPH_COLORING, 1);
+	ps->space_set_param(scene.space, PhysicsServer2D::SPACE_PARAM_SOLVER_MAX_THREADS, p_max_threads);
+
+	// Knock the pyramid over so bodies keep pairing and unpairing during the simulation.
+	for (uint32_t i = 0; i < scene.bodies.size(); i += 7) {
+		ps->body_set_state(scene.bodies[i], PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY, Vector2(200.0, -100.0));
+	}
+	step_scene(180);
+
+	uint32_t hash = get_scene_state_hash(scene);
+	free_scene(scene);
+	return hash;
+}
+
+TEST_CASE("[SceneTree][PhysicsServer2D] Deterministic spaces give the same result with any thread count") {
+	uint32_t single_thread_hash = simulate_deterministic_pyramid(1);
+	uint32_t two_threads_hash = simulate_deterministic_pyramid(2);
+	uint32_t all_threads_hash = simulate_deterministic_pyramid(0);
+
+	CHECK_MESSAGE(single_thread_hash == two_threads_hash, "The state should be bit identical with one and two solver threads.");
+	CHECK_MESSAGE(single_thread_hash == all_threads_hash, "The state should be bit identical with one solver thread and all the threads.");
+	CHECK_MESSAGE(single_thread_hash == simulate_deterministic_pyramid(0), "Running the same scene again should give the same state.");
+}
+
+TEST_CASE("[SceneTree][PhysicsServer2D] Restoring a snapshot replays the same simulation") {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	TestScene scene;
+	create_pyramid(scene, 12);
+	ps->space_set_param(scene.space, PhysicsServer2D::SPACE_PARAM_SOLVER_DETERMINISTIC, 1);
+
+	for (uint32_t i = 0; i < scene.bodies.size(); i += 5) {
+		ps->body_set_state(scene.bodies[i], PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY, Vector2(150.0, -80.0));
+	}
+	step_scene(30);
+
+	Vector<uint8_t> snapshot;
+	ps->space_save_snapshot(scene.space, snapshot);
+	REQUIRE_FALSE(snapshot.is_empty());
+	uint32_t snapshot_hash = get_scene_state_hash(scene);
+
+	step_scene(60);
+	uint32_t first_run_hash = get_scene_state_hash(scene);
+	Vector<uint8_t> first_run_snapshot;
+	ps->space_save_snapshot(scene.space, first_run_snapshot);
+
+	CHECK(ps->space_restore_snapshot(scene.space, snapshot) == OK);
+	CHECK_MESSAGE(get_scene_state_hash(scene) == snapshot_hash, "Restoring should bring the bodies back to the saved state.");
+
+	step_scene(60);
+	CHECK_MESSAGE(get_scene_state_hash(scene) == first_run_hash, "Stepping from a restored snapshot should give the same state as the first run.");
+	Vector<uint8_t> replay_snapshot;
+	ps->space_save_snapshot(scene.space, replay_snapshot);
+	CHECK_MESSAGE(replay_snapshot == first_run_snapshot, "The same state should be saved to the same bytes, so snapshots can be compared for desyncs.");
+
+	ERR_PRINT_OFF;
+	Vector<uint8_t> truncated = snapshot;
+	truncated.resize(snapshot.size() - 1);
+	CHECK(ps->space_restore_snapshot(scene.space, truncated) == ERR_INVALID_DATA);
+	CHECK(ps->space_restore_snapshot(scene.space, Vector<uint8_t>()) == ERR_INVALID_DATA);
+	ERR_PRINT_ON;
+	CHECK_MESSAGE(get_scene_state_hash(scene) == first_run_hash, "An invalid snapshot should leave the space untouched.");
+
+	free_scene(scene);
+}
+
+static RID create_projectile(RID p_space, RID p_shape, const Vector2 &p_position, const Vector2 &p_velocity, PhysicsServer2D::CCDMode p_ccd_mode) {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	RID body = ps->body_create();
+	ps->body_set_mode(body, PhysicsServer2D::BODY_MODE_RIGID);
+	ps->body_add_shape(body, p_shape);
+	ps->body_set_continuous_collision_detection_mode(body, p_ccd_mode);
+	ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, p_position));
+	ps->body_set_state(body, PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY, p_velocity);
+	ps->body_set_space(body, p_space);
+	return body;
+}
+
+TEST_CASE("[SceneTree][PhysicsServer2D] Continuous collision detection stops fast bodies at thin walls") {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	RID space = create_space();
+	const Vector2 velocity(20000.0, 0.0); // Over 300 pixels per step.
+
+	// A segment and a concave polygon, both without any thickness.
+	RID segment_shape = ps->segment_shape_create();
+	ps->shape_set_data(segment_shape, Rect2(Vector2(0, -400), Vector2(0, 0)));
+	RID segment_wall = ps->body_create();
+	ps->body_set_mode(segment_wall, PhysicsServer2D::BODY_MODE_STATIC);
+	ps->body_add_shape(segment_wall, segment_shape);
+	ps->body_set_state(segment_wall, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(500, 0)));
+	ps->body_set_space(segment_wall, space);
+
+	RID concave_shape = ps->concave_polygon_shape_create();
+	Vector<Vector2> segments = { Vector2(0, 0), Vector2(0, 400), Vector2(0, 400), Vector2(200, 400) };
+	ps->shape_set_data(concave_shape, segments);
+	RID concave_wall = ps->body_create();
+	ps->body_set_mode(concave_wall, PhysicsServer2D::BODY_MODE_STATIC);
+	ps->body_add_shape(concave_wall, concave_shape);
+	ps->body_set_state(concave_wall, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(500, 0)));
+	ps->body_set_space(concave_wall, space);
+
+	RID circle_shape = ps->circle_shape_create();
+	ps->shape_set_data(circle_shape, 4.0);
+	RID rectangle_shape = ps->rectangle_shape_create();
+	ps->shape_set_data(rectangle_shape, Vector2(4.0, 2.0));
+	RID capsule_shape = ps->capsule_shape_create();
+	ps->shape_set_data(capsule_shape, Vector2(3.0, 12.0));
+	RID polygon_shape = ps->convex_polygon_shape_create();
+	Vector<Vector2> triangle = { Vector2(-4, -4), Vector2(6, 0), Vector2(-4, 4) };
+	ps->shape_set_data(polygon_shape, triangle);
+
+	const RID shapes[] = { circle_shape, rectangle_shape, capsule_shape, polygon_shape };
+	LocalVector<RID> projectiles;
+	for (int i = 0; i < 4; i++) {
+		projectiles.push_back(create_projectile(space, shapes[i], Vector2(0, -300 + i * 50), velocity, PhysicsServer2D::CCD_MODE_CAST_RAY));
+		projectiles.push_back(create_projectile(space, shapes[i], Vector2(0, 100 + i * 50), velocity, PhysicsServer2D::CCD_MODE_CAST_SHAPE));
+	}
+	RID unchecked = create_projectile(space, circle_shape, Vector2(0, -350), velocity, PhysicsServer2D::CCD_MODE_DISABLED);
+
+	step_scene(10);
+
+	for (const RID &projectile : projectiles) {
+		CHECK_MESSAGE(get_body_position(projectile).x < 500.0, "Bodies with continuous collision detection shouldn't go through the walls.");
+	}
+	CHECK_MESSAGE(get_body_position(unchecked).x > 500.0, "A body without continuous collision detection moving this fast should go through the wall.");
+
+	for (const RID &projectile : projectiles) {
+		ps->free(projectile);
+	}
+	ps->free(unchecked);
+	ps->free(segment_wall);
+	ps->free(concave_wall);
+	for (const RID &shape : shapes) {
+		ps->free(shape);
+	}
+	ps->free(segment_shape);
+	ps->free(concave_shape);
+	ps->free(space);
+}
+
+TEST_CASE_PENDING("[SceneTree][PhysicsServer2D][Benchmark] Graph coloring step time for a 5,000 body pyramid") {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	const int rows = 100; // 5,050 bodies.
+	const int warmup_steps = 10;
+	const int measured_steps = 60;
+	const int thread_counts[] = { 1, 4, 16 };
+
+	for (int thread_count : thread_counts) {
+		TestScene scene;
+		create_pyramid(scene, rows);
+		ps->space_set_param(scene.space, PhysicsServer2D::SPACE_PARAM_SOLVER_GRAPH_COLORING, 1.0);
+		ps->space_set_param(scene.space, PhysicsServer2D::SPACE_PARAM_SOLVER_MAX_THREADS, thread_count);
+		step_scene(warmup_steps);
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		step_scene(measured_steps);
+		uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+		MESSAGE(vformat("%d threads: %.3f ms per step.", thread_count, elapsed / (measured_steps * 1000.0)));
+		free_scene(scene);
+	}
+}
+
+TEST_CASE_PENDING("[SceneTree][PhysicsServer2D][Benchmark] Continuous collision detection step time for 4,000 projectiles") {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	const int columns = 40;
+	const int rows = 100;
+	const int measured_steps = 60;
+	const PhysicsServer2D::CCDMode modes[] = { PhysicsServer2D::CCD_MODE_DISABLED, PhysicsServer2D::CCD_MODE_CAST_RAY };
+
+	for (PhysicsServer2D::CCDMode mode : modes) {
+		RID space = create_space();
+		ps->area_set_param(space, PhysicsServer2D::AREA_PARAM_GRAVITY, 0.0);
+
+		RID wall_shape = ps->world_boundary_shape_create();
+		Array wall_data;
+		wall_data.push_back(Vector2(-1, 0));
+		wall_data.push_back(0.0);
+		ps->shape_set_data(wall_shape, wall_data);
+		RID wall = ps->body_create();
+		ps->body_set_mode(wall, PhysicsServer2D::BODY_MODE_STATIC);
+		ps->body_add_shape(wall, wall_shape);
+		ps->body_set_state(wall, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(4000, 0)));
+		ps->body_set_space(wall, space);
+
+		RID shape = ps->circle_shape_create();
+		ps->shape_set_data(shape, 2.0);
+		LocalVector<RID> projectiles;
+		for (int row = 0; row < rows; row++) {
+			for (int column = 0; column < columns; column++) {
+				projectiles.push_back(create_projectile(space, shape, Vector2(column * 16.0, row * 16.0), Vector2(3000.0, 0.0), mode));
+			}
+		}
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		step_scene(measured_steps);
+		uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+		MESSAGE(vformat("CCD mode %d: %.3f ms per step.", mode, elapsed / (measured_steps * 1000.0)));
+
+		for (const RID &projectile : projectiles) {
+			ps->free(projectile);
+		}
+		ps->free(wall);
+		ps->free(shape);
+		ps->free(wall_shape);
+		ps->free(space);
+	}
+}
+
+} // namespace TestPhysicsServer2D
+
+#endif // TEST_PHYSICS_SERVER_2D_H
@@ -0,0 +1,407 @@
+/**************************************************************************/
+/*  test_renderer_canvas_render_rd.h                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RENDERER_CANVAS_RENDER_RD_H
+#define TEST_RENDERER_CANVAS_RENDER_RD_H
+
+#include "servers/rendering/renderer_rd/renderer_canvas_render_rd.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRendererCanvasRenderRD {
+
+static uint32_t get_tile_light(const LocalVector<uint32_t> &p_tiles, uint32_t p_tile, uint32_t p_light) {
+	const uint32_t *tile = p_tiles.ptr() + p_tile * RendererCanvasRenderRD::LIGHT_TILE_STRIDE;
+	return (tile[1 + (p_light >> 2)] >> ((p_light & 3) * 8)) & 0xFF;
+}
+
+TEST_CASE("[RendererCanvasRenderRD] Light tiles grow to fit large render targets") {
+	uint32_t columns = 0;
+	uint32_t rows = 0;
+
+	CHECK(RendererCanvasRenderRD::light_tiles_get_size(Size2i(1920, 1080), columns, rows) == RendererCanvasRenderRD::LIGHT_TILE_SIZE_MIN);
+	CHECK(columns == 60);
+	CHECK(rows == 34);
+
+	// 240x135 tiles of 32 pixels are too many, 64 pixels fit.
+	CHECK(RendererCanvasRenderRD::light_tiles_get_size(Size2i(7680, 4320), columns, rows) == 64);
+	CHECK(columns == 120);
+	CHECK(rows == 68);
+
+	CHECK(RendererCanvasRenderRD::light_tiles_get_size(Size2i(16384, 16384), columns, rows) == 256);
+	CHECK(columns == 64);
+	CHECK(rows == 64);
+	CHECK(columns * rows <= RendererCanvasRenderRD::LIGHT_TILE_MAX_COUNT);
+}
+
+TEST_CASE("[RendererCanvasRenderRD] Lights are binned into the tiles they overlap") {
+	uint32_t columns = 0;
+	uint32_t rows = 0;
+	uint32_t tile_size = RendererCanvasRenderRD::light_tiles_get_size(Size2i(256, 256), columns, rows);
+	REQUIRE(tile_size == 32);
+
+	LocalVector<uint32_t> tiles;
+	tiles.resize(columns * rows * RendererCanvasRenderRD::LIGHT_TILE_STRIDE);
+	memset(tiles.ptr(), 0, sizeof(uint32_t) * tiles.size());
+
+	SUBCASE("Lights only touch their own tiles") {
+		RendererCanvasRenderRD::light_tiles_add_light(tiles.ptr(), columns, rows, tile_size, Rect2(40, 8, 16, 16), 5);
+		RendererCanvasRenderRD::light_tiles_add_light(tiles.ptr(), columns, rows, tile_size, Rect2(48, 16, 40, 8), 7);
+
+		CHECK(tiles[1 * RendererCanvasRenderRD::LIGHT_TILE_STRIDE] == 2);
+		CHECK(get_tile_light(tiles, 1, 0) == 5);
+		CHECK(get_tile_light(tiles, 1, 1) == 7);
+		CHECK(tiles[2 * RendererCanvasRenderRD::LIGHT_TILE_STRIDE] == 1);
+		CHECK(get_tile_light(tiles, 2, 0) == 7);
+
+		for (uint32_t i = 0; i < columns * rows; i++) {
+			if (i != 1 && i != 2) {
+				CHECK_MESSAGE(tiles[i * RendererCanvasRenderRD::LIGHT_TILE_STRIDE] == 0, "Tile ", i, " should have no lights.");
+			}
+		}
+	}
+
+	SUBCASE("Tiles keep the first MAX_LIGHTS_PER_TILE lights") {
+		const uint32_t light_count = RendererCanvasRenderRD::MAX_LIGHTS_PER_TILE + 8;
+		for (uint32_t i = 0; i < light_count; i++) {
+			// Covers the 2x2 tiles at the top left corner.
+			RendererCanvasRenderRD::light_tiles_add_light(tiles.ptr(), columns, rows, tile_size, Rect2(16, 16, 32, 32), i);
+		}
+
+		const uint32_t corner_tiles[4] = { 0, 1, columns, columns + 1 };
+		for (uint32_t tile : corner_tiles) {
+			CHECK(tiles[tile * RendererCanvasRenderRD::LIGHT_TILE_STRIDE] == RendererCanvasRenderRD::MAX_LIGHTS_PER_TILE);
+			bool indices_match = true;
+			for (uint32_t i = 0; i < RendererCanvasRenderRD::MAX_LIGHTS_PER_TILE; i++) {
+				indices_match = indices_match && get_tile_light(tiles, tile, i) == i;
+			}
+			CHECK_MESSAGE(indices_match, "Tile ", tile, " should hold the first lights in order.");
+		}
+		CHECK(tiles[2 * RendererCanvasRenderRD::LIGHT_TILE_STRIDE] == 0);
+		CHECK(tiles[2 * columns * RendererCanvasRenderRD::LIGHT_TILE_STRIDE] == 0);
+	}
+}
+
+typedef RendererCanvasRender::Item RenderItem;
+
+static RendererCanvasRender::Item::CommandRect *add_rect(RenderItem &p_item, const Rect2 &p_rect, uint16_t p_flags = 0) {
+	RendererCanvasRender::Item::CommandRect *rect = p_item.alloc_command<RendererCanvasRender::Item::CommandRect>();
+	rect->rect = p_rect;
+	rect->modulate = Color(1, 1, 1);
+	rect->flags = p_flags;
+	return rect;
+}
+
+// Takes a slot for each drawn rect, walking the commands the way _render_item() does.
+static LocalVector<uint32_t> get_rect_slots(const RenderItem *const *p_items, int p_item_count, double p_time, uint32_t p_instance_count, uint32_t &r_cursor) {
+	LocalVector<uint32_t> slots;
+	for (int i = 0; i < p_item_count; i++) {
+		bool skipping = false;
+		for (const RenderItem::Command *c = p_items[i]->commands; c; c = c->next) {
+			if (c->type == RenderItem::Command::TYPE_ANIMATION_SLICE) {
+				const RenderItem::CommandAnimationSlice *as = static_cast<const RenderItem::CommandAnimationSlice *>(c);
+				double local_time = Math::fposmod(p_time - as->offset, as->animation_length);
+				skipping = !(local_time >= as->slice_begin && local_time < as->slice_end);
+			} else if (!skipping && c->type == RenderItem::Command::TYPE_RECT) {
+				slots.push_back(RendererCanvasRenderRD::rect_batch_get_slot(static_cast<const RenderItem::CommandRect *>(c), r_cursor, p_instance_count));
+			}
+		}
+	}
+	return slots;
+}
+
+static bool instance_has_rect(const RendererCanvasRenderRD::BatchInstanceData &p_instance, const Rect2 &p_rect) {
+	return Rect2(p_instance.dst_rect[0], p_instance.dst_rect[1], p_instance.dst_rect[2], p_instance.dst_rect[3]).is_equal_approx(p_rect);
+}
+
+TEST_CASE("[RendererCanvasRenderRD] Batched rects find their instance data from the cursor") {
+	RenderItem first;
+	first.final_transform = Transform2D(0, Vector2(100, 0));
+	add_rect(first, Rect2(0, 0, 8, 8));
+	add_rect(first, Rect2(0, 0, 8, 8), RendererCanvasRender::CANVAS_RECT_MSDF);
+	add_rect(first, Rect2(16, 16, -8, -8));
+
+	// Only the rect in the active slice is drawn.
+	RenderItem second;
+	RenderItem::CommandAnimationSlice *slice = second.alloc_command<RenderItem::CommandAnimationSlice>();
+	slice->animation_length = 1;
+	slice->slice_begin = 0.5;
+	slice->slice_end = 1;
+	add_rect(second, Rect2(0, 0, 1, 1));
+	slice = second.alloc_command<RenderItem::CommandAnimationSlice>();
+	slice->animation_length = 1;
+	slice->slice_begin = 0;
+	slice->slice_end = 0.5;
+	add_rect(second, Rect2(0, 0, 2, 2));
+
+	const RenderItem *items[2] = { &first, &second };
+	LocalVector<RendererCanvasRenderRD::BatchInstanceData> instances;
+
+	SUBCASE("Every batchable rect gets its own slot") {
+		RendererCanvasRenderRD::rect_batch_fill_instances(items, 2, Transform2D(), 0.25, 128, instances);
+		REQUIRE(instances.size() == 3);
+
+		uint32_t cursor = 0;
+		LocalVector<uint32_t> slots = get_rect_slots(items, 2, 0.25, instances.size(), cursor);
+		CHECK(cursor == instances.size());
+		REQUIRE(slots.size() == 4);
+		CHECK(slots[0] == 0);
+		CHECK(slots[1] == UINT32_MAX); // MSDF rects are drawn on their own.
+		CHECK(slots[2] == 1);
+		CHECK(slots[3] == 2);
+
+		CHECK(instance_has_rect(instances[0], Rect2(0, 0, 8, 8)));
+		CHECK(instance_has_rect(instances[1], Rect2(8, 8, 8, 8)));
+		CHECK(instance_has_rect(instances[2], Rect2(0, 0, 2, 2)));
+		CHECK(instances[0].world[4] == doctest::Approx(100));
+		CHECK(instances[2].world[4] == doctest::Approx(0));
+	}
+
+	SUBCASE("Rects past the buffer capacity are drawn one by one") {
+		RendererCanvasRenderRD::rect_batch_fill_instances(items, 2, Transform2D(), 0.25, 2, instances);
+		REQUIRE(instances.size() == 2);
+
+		uint32_t cursor = 0;
+		LocalVector<uint32_t> slots = get_rect_slots(items, 2, 0.25, instances.size(), cursor);
+		CHECK(cursor == 3);
+		REQUIRE(slots.size() == 4);
+		CHECK(slots[0] == 0);
+		CHECK(slots[2] == 1);
+		CHECK(slots[3] == UINT32_MAX);
+	}
+}
+
+TEST_CASE("[RendererCanvasRenderRD] Rect batches break on draw state changes") {
+	RenderItem clip;
+	RenderItem other_clip;
+
+	RendererCanvasRenderRD::RectBatch batch;
+	batch.material = RID::from_uint64(1);
+	batch.clip = &clip;
+	batch.pipeline = RID::from_uint64(2);
+	batch.texture = RID::from_uint64(3);
+	batch.start = 4;
+	batch.count = 2;
+
+	RendererCanvasRenderRD::RectBatch rect = batch;
+	rect.start = 6;
+	rect.count = 1;
+	CHECK(RendererCanvasRenderRD::rect_batch_can_join(batch, rect));
+
+	SUBCASE("Texture") {
+		rect.texture = RID::from_uint64(4);
+		CHECK_FALSE(RendererCanvasRenderRD::rect_batch_can_join(batch, rect));
+	}
+
+	SUBCASE("Material") {
+		rect.material = RID();
+		CHECK_FALSE(RendererCanvasRenderRD::rect_batch_can_join(batch, rect));
+	}
+
+	SUBCASE("Clip") {
+		rect.clip = &other_clip;
+		CHECK_FALSE(RendererCanvasRenderRD::rect_batch_can_join(batch, rect));
+		rect.clip = nullptr;
+		CHECK_FALSE(RendererCanvasRenderRD::rect_batch_can_join(batch, rect));
+	}
+
+	SUBCASE("Lit basis") {
+		rect.basis[0] = 2;
+		CHECK_FALSE(RendererCanvasRenderRD::rect_batch_can_join(batch, rect));
+	}
+
+	SUBCASE("Slots that don't follow the batch") {
+		rect.start = 7;
+		CHECK_FALSE(RendererCanvasRenderRD::rect_batch_can_join(batch, rect));
+		rect.start = 5;
+		CHECK_FALSE(RendererCanvasRenderRD::rect_batch_can_join(batch, rect));
+	}
+
+	SUBCASE("Flushed batch") {
+		batch.count = 0;
+		rect.start = 4;
+		CHECK_FALSE(RendererCanvasRenderRD::rect_batch_can_join(batch, rect));
+	}
+}
+
+TEST_CASE("[RendererCanvasRenderRD] Polygon arena") {
+	typedef RendererCanvasRenderRD::PolygonArena PolygonArena;
+	const uint32_t page_size = RendererCanvasRenderRD::POLYGON_ARENA_PAGE_SIZE;
+
+	PolygonArena arena;
+	LocalVector<RID> empty_buffers;
+	PolygonArena::Allocation a;
+	PolygonArena::Allocation b;
+	PolygonArena::Allocation c;
+
+	CHECK_FALSE(arena.allocate(64, a));
+	CHECK(arena.add_page(RID::from_uint64(1), page_size) == 0);
+
+	SUBCASE("Allocations are aligned and packed in their page") {
+		REQUIRE(arena.allocate(100, a));
+		CHECK(a.page == 0);
+		CHECK(a.offset == 0);
+		CHECK(a.size == 112);
+		REQUIRE(arena.allocate(16, b));
+		CHECK(b.offset == 112);
+		CHECK_FALSE(arena.allocate(page_size, c));
+	}
+
+	SUBCASE("Freed ranges are reused after the frame delay") {
+		REQUIRE(arena.allocate(64, a));
+		REQUIRE(arena.allocate(64, b));
+		arena.free(a, 10);
+		arena.free(b, 10);
+
+		arena.reclaim(11, 2, empty_buffers);
+		REQUIRE(arena.allocate(16, c));
+		CHECK(c.offset == 128);
+
+		arena.reclaim(12, 2, empty_buffers);
+		const RBMap<uint32_t, uint32_t> &free_ranges = arena.pages[0].free_ranges;
+		CHECK(free_ranges.size() == 2);
+		REQUIRE(free_ranges.has(0));
+		CHECK(free_ranges[0] == 128);
+		REQUIRE(arena.allocate(128, c));
+		CHECK(c.offset == 0);
+		CHECK(empty_buffers.is_empty());
+	}
+
+	SUBCASE("Freed ranges are merged with the free ranges they touch") {
+		REQUIRE(arena.allocate(64, a));
+		REQUIRE(arena.allocate(64, b));
+		REQUIRE(arena.allocate(64, c));
+		const RBMap<uint32_t, uint32_t> &free_ranges = arena.pages[0].free_ranges;
+
+		arena.free(b, 0);
+		arena.reclaim(0, 0, empty_buffers);
+		CHECK(free_ranges.size() == 2);
+		CHECK(free_ranges.has(64));
+
+		// Merged with the next range.
+		arena.free(a, 1);
+		arena.reclaim(1, 0, empty_buffers);
+		CHECK(free_ranges.size() == 2);
+		REQUIRE(free_ranges.has(0));
+		CHECK(free_ranges[0] == 128);
+
+		// Merged with both, the page is whole again and kept.
+		arena.free(c, 2);
+		arena.reclaim(2, 0, empty_buffers);
+		REQUIRE(free_ranges.size() == 1);
+		CHECK(free_ranges[0] == page_size);
+		CHECK(arena.pages[0].buffer.is_valid());
+		CHECK(empty_buffers.is_empty());
+	}
+
+	SUBCASE("Only one empty page is kept") {
+		// Too big for the first page, it gets a page of its own size.
+		CHECK(arena.add_page(RID::from_uint64(2), page_size * 2) == 1);
+		REQUIRE(arena.allocate(page_size * 2, a));
+		CHECK(a.page == 1);
+		REQUIRE(arena.allocate(64, b));
+		CHECK(b.page == 0);
+
+		arena.free(a, 5);
+		arena.free(b, 5);
+		arena.reclaim(6, 1, empty_buffers);
+		REQUIRE(empty_buffers.size() == 1);
+		CHECK(empty_buffers[0] == RID::from_uint64(2));
+		CHECK(arena.pages[1].buffer.is_null());
+
+		// The released slot is reused by the next page.
+		CHECK(arena.add_page(RID::from_uint64(3), page_size) == 1);
+	}
+
+	LocalVector<RID> buffers;
+	arena.clear(buffers);
+	CHECK(arena.pages.is_empty());
+	CHECK(arena.pending_frames.is_empty());
+}
+
+TEST_CASE("[RendererCanvasRenderRD] Shadow maps are reused until what they were rendered from changes") {
+	typedef RendererCanvasRenderRD::ShadowCaster ShadowCaster;
+
+	LocalVector<ShadowCaster> casters;
+	for (int i = 0; i < 2; i++) {
+		ShadowCaster caster;
+		caster.occluder = RID::from_uint64(i + 1);
+		caster.version = 1;
+		caster.xform = Transform2D(0, Vector2(i * 100, 0));
+		casters.push_back(caster);
+	}
+
+	RendererCanvasRenderRD::ShadowCache cache;
+	CHECK_FALSE(RendererCanvasRenderRD::shadow_cache_update(cache, true, 0, 100, casters));
+	CHECK(cache.valid);
+	CHECK(RendererCanvasRenderRD::shadow_cache_update(cache, true, 0, 100, casters));
+
+	SUBCASE("Occluder version") {
+		casters[1].version = 2;
+		CHECK_FALSE(RendererCanvasRenderRD::shadow_cache_update(cache, true, 0, 100, casters));
+		CHECK(RendererCanvasRenderRD::shadow_cache_update(cache, true, 0, 100, casters));
+	}
+
+	SUBCASE("Occluder transform") {
+		casters[0].xform.rotate(0.1);
+		CHECK_FALSE(RendererCanvasRenderRD::shadow_cache_update(cache, true, 0, 100, casters));
+		CHECK(RendererCanvasRenderRD::shadow_cache_update(cache, true, 0, 100, casters));
+	}
+
+	SUBCASE("Casters added, removed or replaced") {
+		ShadowCaster caster = casters[1];
+		casters.resize(1);
+		CHECK_FALSE(RendererCanvasRenderRD::shadow_cache_update(cache, true, 0, 100, casters));
+		casters.push_back(caster);
+		CHECK_FALSE(RendererCanvasRenderRD::shadow_cache_update(cache, true, 0, 100, casters));
+		casters[1].occluder = RID::from_uint64(3);
+		CHECK_FALSE(RendererCanvasRenderRD::shadow_cache_update(cache, true, 0, 100, casters));
+	}
+
+	SUBCASE("Near and far") {
+		CHECK_FALSE(RendererCanvasRenderRD::shadow_cache_update(cache, true, 1, 100, casters));
+		CHECK_FALSE(RendererCanvasRenderRD::shadow_cache_update(cache, true, 1, 200, casters));
+		CHECK(RendererCanvasRenderRD::shadow_cache_update(cache, true, 1, 200, casters));
+	}
+
+	SUBCASE("Shadow row rendered by another light") {
+		CHECK_FALSE(RendererCanvasRenderRD::shadow_cache_update(cache, false, 0, 100, casters));
+		CHECK(RendererCanvasRenderRD::shadow_cache_update(cache, true, 0, 100, casters));
+	}
+
+	SUBCASE("Invalidated cache") {
+		cache.valid = false;
+		CHECK_FALSE(RendererCanvasRenderRD::shadow_cache_update(cache, true, 0, 100, casters));
+	}
+}
+
+} // namespace TestRendererCanvasRenderRD
+
+#endif // TEST_RENDERER_CANVAS_RENDER_RD_H
@@ -91,6 +91,7 @@
 #include "tests/scene/test_arraymesh.h"
 #include "tests/scene/test_audio_stream_wav.h"
 #include "tests/scene/test_bit_map.h"
+#include "tests/scene/test_canvas_item.h"
 #include "tests/scene/test_code_edit.h"
 #include "tests/scene/test_color_picker.h"
 #include "tests/scene/test_curve.h"
@@ -99,12 +100,18 @@
 #include "tests/scene/test_node.h"
 #include "tests/scene/test_path_2d.h"
 #include "tests/scene/test_primitives.h"
+#include "tests/scene/test_sprite_batch_2d.h"
 #include "tests/scene/test_sprite_frames.h"
 #include "tests/scene/test_text_edit.h"
 #include "tests/scene/test_theme.h"
+#include "tests/scene/test_tile_map.h"
 #include "tests/scene/test_viewport.h"
 #include "tests/scene/test_visual_shader.h"
 
+#include "tests/servers/test_broad_phase_2d.h"
+#include "tests/servers/test_canvas_cull.h"
+#include "tests/servers/test_physics_server_2d.h"
+#include "tests/servers/test_renderer_canvas_render_rd.h"
 #include "tests/servers/test_text_server.h"
 #include "tests/test_validate_testing.h"
 